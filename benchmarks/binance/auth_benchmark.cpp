@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "binance/auth.h"
+#include "perf_scope.h"
+
+/// @brief signs a logon payload, as done by `FixApp::toAdmin` on every (re)logon
+class LogonSignFixture : public benchmark::Fixture {
+ public:
+  void SetUp([[maybe_unused]] const benchmark::State& state) override {
+    // the test key pair is shared with the unit tests
+    const std::filesystem::path root =
+        std::filesystem::absolute(__FILE__).parent_path().parent_path().parent_path();
+    api_key_ = "dummy";
+    pem_path_ =
+        (root / "tests" / "binance" / "test_resources" / "valid_key.pem").string();
+    auth_ = std::make_unique<binance::Auth>(api_key_, pem_path_);
+  }
+
+  void TearDown([[maybe_unused]] const benchmark::State& state) override {
+    auth_.reset();
+  }
+
+  std::string api_key_;
+  std::string pem_path_;
+  std::unique_ptr<binance::Auth> auth_;
+  const std::string payload_ =
+      "A\x01TRDR1\x01SPOT\x01"
+      "1\x01"
+      "20250915-03:27:02.028992";
+};
+
+/// @brief previous behaviour: read + parse the PEM, derive the keypair, then sign
+BENCHMARK_DEFINE_F(LogonSignFixture, BENCH_LogonSign_FromPem)(benchmark::State& state) {
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        binance::Auth::sign_payload(payload_, auth_->get_seed_from_pem()));
+  }
+
+  state.counters["Signatures/sec"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+/// @brief current behaviour: sign from the key loaded at startup
+BENCHMARK_DEFINE_F(LogonSignFixture, BENCH_LogonSign_Cached)(benchmark::State& state) {
+  auth_->load_keys();
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(auth_->sign_payload(payload_));
+  }
+
+  state.counters["Signatures/sec"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(LogonSignFixture, BENCH_LogonSign_FromPem)->Iterations(5'000);
+BENCHMARK_REGISTER_F(LogonSignFixture, BENCH_LogonSign_Cached)->Iterations(5'000);
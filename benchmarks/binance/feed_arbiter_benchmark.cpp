@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <memory>
+#include <string>
+
+#include "binance/feed_arbiter.h"
+#include "binance/market_message_variant.h"
+#include "concurrentqueue.h"
+#include "perf_scope.h"
+
+/// @brief measures the cost the hot-standby deduplication adds to the PX session thread
+class FeedArbiterFixture : public benchmark::Fixture {
+ public:
+  /// @brief deterministically build a run of single-entry increments with rising ids
+  void SetUp([[maybe_unused]] const benchmark::State& state) override {
+    for (int i = 0; i < MSG_COUNT; ++i) {
+      auto msg = FIX44::MarketDataIncrementalRefresh();
+      auto change = FIX44::MarketDataIncrementalRefresh::NoMDEntries();
+      change.set(FIX::Symbol("BTCUSDT"));
+      change.set(FIX::MDUpdateAction(FIX::MDUpdateAction_NEW));
+      change.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+      change.set(FIX::MDEntryPx(MID_PRICE - (i % 500)));
+      change.set(FIX::MDEntrySize(1));
+      const std::string id = std::to_string(FIRST_ID + i);
+      change.setField(binance::FeedArbiter::FIRST_BOOK_UPDATE_ID_TAG, id);
+      change.setField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, id);
+      msg.addGroup(change);
+      test_messages_[i] = msg;
+    }
+    reset_arbiter();
+  }
+
+  void reset_arbiter() {
+    arbiter_ = std::make_unique<binance::FeedArbiter>(queue_);
+    arbiter_->on_session_up(binance::FeedSource::PRIMARY);
+    arbiter_->on_session_up(binance::FeedSource::STANDBY);
+  }
+
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> queue_;
+  std::unique_ptr<binance::FeedArbiter> arbiter_;
+  binance::MarketMessageVariant sink_;
+  static constexpr uint64_t FIRST_ID = 70'000'000'000;
+  static constexpr int MID_PRICE = 100'000;
+  static constexpr int MSG_COUNT = 1000;
+  std::array<FIX44::MarketDataIncrementalRefresh, MSG_COUNT> test_messages_;
+};
+
+/// @brief baseline: enqueue straight onto the order queue, as before the arbiter
+BENCHMARK_DEFINE_F(FeedArbiterFixture, BENCH_FeedArbiter_DirectEnqueue)
+(benchmark::State& state) {
+  int i = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    queue_.enqueue(binance::MarketMessageVariant{test_messages_[i++]});
+    queue_.try_dequeue(sink_);
+    if (i == MSG_COUNT) {
+      i = 0;
+    }
+  }
+
+  state.counters["Updates/sec"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+/// @brief a new update, forwarded onto the order queue
+BENCHMARK_DEFINE_F(FeedArbiterFixture, BENCH_FeedArbiter_Forward)
+(benchmark::State& state) {
+  int i = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    arbiter_->on_increment(test_messages_[i++], binance::FeedSource::PRIMARY);
+    queue_.try_dequeue(sink_);
+    if (i == MSG_COUNT) {
+      // ids restart, so must the arbiter (amortised over MSG_COUNT iterations)
+      reset_arbiter();
+      i = 0;
+    }
+  }
+
+  state.counters["Updates/sec"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+/// @brief the standby's copy of an update already forwarded, suppressed
+BENCHMARK_DEFINE_F(FeedArbiterFixture, BENCH_FeedArbiter_Duplicate)
+(benchmark::State& state) {
+  for (const auto& msg : test_messages_) {
+    arbiter_->on_increment(msg, binance::FeedSource::PRIMARY);
+    queue_.try_dequeue(sink_);
+  }
+  int i = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        arbiter_->on_increment(test_messages_[i++], binance::FeedSource::STANDBY));
+    if (i == MSG_COUNT) {
+      i = 0;
+    }
+  }
+
+  state.counters["Updates/sec"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(FeedArbiterFixture, BENCH_FeedArbiter_DirectEnqueue)
+    ->Iterations(500'000);
+BENCHMARK_REGISTER_F(FeedArbiterFixture, BENCH_FeedArbiter_Forward)->Iterations(500'000);
+BENCHMARK_REGISTER_F(FeedArbiterFixture, BENCH_FeedArbiter_Duplicate)
+    ->Iterations(500'000);
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "core/bbo_book.h"
+#include "core/level_mirror.h"
+#include "core/order_book.h"
+#include "perf_scope.h"
+
+/// Depth-1 (`MAX_DEPTH` 1) updates: the full book, which clears a side's btree on every
+/// change, against the top-of-book, which overwrites a price/size pair.
+
+namespace {
+
+constexpr uint64_t MID_PRICE = 100'000;
+constexpr size_t MSG_COUNT = 1'000;
+
+/// @brief a depth-1 stream: each message changes the top of one side, the sides
+/// alternate and the prices walk around the mid
+class DepthOneFixture : public benchmark::Fixture {
+ public:
+  void SetUp([[maybe_unused]] const benchmark::State& state) override {
+    updates_.clear();
+    for (size_t i = 0; i < MSG_COUNT; ++i) {
+      const bool is_bid = i % 2 == 0;
+      const uint64_t offset = 1 + (i / 2) % 10;
+      const uint64_t px = is_bid ? MID_PRICE - offset : MID_PRICE + offset;
+      const uint64_t sz = 1 + i % 7;
+      FIX44::MarketDataIncrementalRefresh msg;
+      FIX44::MarketDataIncrementalRefresh::NoMDEntries change;
+      change.set(FIX::Symbol("BTCUSDT"));
+      change.set(FIX::MDUpdateAction(FIX::MDUpdateAction_CHANGE));
+      change.set(
+          FIX::MDEntryType(is_bid ? FIX::MDEntryType_BID : FIX::MDEntryType_OFFER));
+      change.set(FIX::MDEntryPx(static_cast<double>(px)));
+      change.set(FIX::MDEntrySize(static_cast<double>(sz)));
+      msg.addGroup(change);
+      messages_[i] = msg;
+      core::OrderBook::to_level_updates(msg, updates_);
+    }
+  }
+
+  std::array<FIX44::MarketDataIncrementalRefresh, MSG_COUNT> messages_;
+  /// @brief the messages' level updates, one each
+  std::vector<core::LevelUpdate> updates_;
+};
+
+}  // namespace
+
+/// @brief the btree path: a change clears the side first
+BENCHMARK_DEFINE_F(DepthOneFixture, BENCH_BtreeDepthOne)(benchmark::State& state) {
+  core::OrderBook book;
+  size_t i = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    book.apply_increment(messages_[i], true);
+    i = (i + 1) % MSG_COUNT;
+  }
+  state.counters["Updates/sec"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+/// @brief the same messages into the top-of-book
+BENCHMARK_DEFINE_F(DepthOneFixture, BENCH_BboDepthOne)(benchmark::State& state) {
+  core::BboBook book;
+  size_t i = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    book.apply_increment(messages_[i]);
+    i = (i + 1) % MSG_COUNT;
+  }
+  state.counters["Updates/sec"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+/// @brief the top-of-book update alone, parsing excluded: stores and a publish
+BENCHMARK_DEFINE_F(DepthOneFixture, BENCH_BboDepthOneLevels)(benchmark::State& state) {
+  core::BboBook book;
+  size_t i = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    book.apply_levels({&updates_[i], 1}, std::nullopt);
+    i = (i + 1) % MSG_COUNT;
+  }
+  benchmark::DoNotOptimize(book.get_bbo());
+  state.counters["Updates/sec"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(DepthOneFixture, BENCH_BtreeDepthOne)->Iterations(500'000);
+BENCHMARK_REGISTER_F(DepthOneFixture, BENCH_BboDepthOne)->Iterations(500'000);
+BENCHMARK_REGISTER_F(DepthOneFixture, BENCH_BboDepthOneLevels)->Iterations(5'000'000);
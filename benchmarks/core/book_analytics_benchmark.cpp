@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "core/bid_ask.h"
+#include "core/book_analytics.h"
+#include "perf_scope.h"
+
+/// @brief a deep book and a deterministic stream of level changes, mostly near the
+/// touch, like a real feed
+class BookAnalyticsFixture : public benchmark::Fixture {
+ public:
+  void SetUp([[maybe_unused]] const benchmark::State& state) override {
+    bids_.clear();
+    asks_.clear();
+    for (uint64_t i = 1; i <= DEPTH_LEVELS; ++i) {
+      bids_[MID_PRICE - i] = 100'000;
+      asks_[MID_PRICE + i] = 100'000;
+    }
+
+    std::mt19937_64 rng{42};
+    std::geometric_distribution<uint64_t> level_dist(0.05);
+    std::uniform_int_distribution<uint64_t> size_dist(1, 200'000);
+    for (auto& change : changes_) {
+      change.is_bid = rng() % 2 == 0;
+      const uint64_t offset = 1 + std::min(level_dist(rng), DEPTH_LEVELS - 1);
+      change.px = change.is_bid ? MID_PRICE - offset : MID_PRICE + offset;
+      change.sz = size_dist(rng);
+    }
+  }
+
+ protected:
+  struct Change {
+    bool is_bid;
+    uint64_t px;
+    uint64_t sz;
+  };
+
+  absl::btree_map<uint64_t, uint64_t, std::greater<>> bids_;
+  absl::btree_map<uint64_t, uint64_t> asks_;
+  static constexpr uint64_t DEPTH_LEVELS = 5'000;
+  static constexpr uint64_t MID_PRICE = 10'000'000;
+  static constexpr size_t MSG_COUNT = 1'000;
+  std::array<Change, MSG_COUNT> changes_;
+
+  /// @return the size replaced
+  uint64_t apply(const Change& change) {
+    auto set = [&change](auto& levels) {
+      const auto [it, is_new] = levels.try_emplace(change.px, change.sz);
+      const uint64_t old_sz = is_new ? 0 : it->second;
+      it->second = change.sz;
+      return old_sz;
+    };
+    return change.is_bid ? set(bids_) : set(asks_);
+  }
+
+  /// @brief same layout as `core::OrderBook::to_vector`
+  std::vector<core::BidAsk> to_vector() const {
+    std::vector<core::BidAsk> v;
+    v.reserve(std::max(bids_.size(), asks_.size()));
+    auto bid_it = bids_.begin();
+    auto ask_it = asks_.begin();
+    for (; bid_it != bids_.end() || ask_it != asks_.end();) {
+      core::BidAsk ba{};
+      if (bid_it != bids_.end()) {
+        ba.bid_px = bid_it->first;
+        ba.bid_sz = bid_it->second;
+        ++bid_it;
+      }
+      if (ask_it != asks_.end()) {
+        ba.ask_px = ask_it->first;
+        ba.ask_sz = ask_it->second;
+        ++ask_it;
+      }
+      v.push_back(ba);
+    }
+    return v;
+  }
+};
+
+/// @brief dirty tracking, only the levels near the touch are walked again
+BENCHMARK_DEFINE_F(BookAnalyticsFixture, BENCH_BookAnalytics_Incremental)
+(benchmark::State& state) {
+  core::BookAnalyzer analyzer;
+  analyzer.publish(bids_, asks_);
+  size_t i = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    const Change& change = changes_[i];
+    const uint64_t old_sz = apply(change);
+    change.is_bid ? analyzer.on_bid_change(change.px, old_sz, change.sz)
+                  : analyzer.on_ask_change(change.px, old_sz, change.sz);
+    analyzer.publish(bids_, asks_);
+    benchmark::DoNotOptimize(analyzer.get());
+    i = (i + 1) % MSG_COUNT;
+  }
+
+  state.counters["Updates/sec"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+/// @brief the naive approach: copy the book out and recompute everything
+BENCHMARK_DEFINE_F(BookAnalyticsFixture, BENCH_BookAnalytics_NaiveRecompute)
+(benchmark::State& state) {
+  const core::BookAnalyticsConfig config;
+  size_t i = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    apply(changes_[i]);
+    benchmark::DoNotOptimize(core::BookAnalytics::compute(to_vector(), config));
+    i = (i + 1) % MSG_COUNT;
+  }
+
+  state.counters["Updates/sec"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(BookAnalyticsFixture, BENCH_BookAnalytics_Incremental)
+    ->Iterations(500'000);
+BENCHMARK_REGISTER_F(BookAnalyticsFixture, BENCH_BookAnalytics_NaiveRecompute)
+    ->Iterations(20'000);
@@ -2,6 +2,7 @@
 #include <fmt/ranges.h>
 
 #include "core/order_book.h"
+#include "perf_scope.h"
 #include "spdlog/spdlog.h"
 
 /// @brief the order book is composed of two asymmetrically-sorted collections,
@@ -29,6 +30,7 @@ class BookSideFixture : public benchmark::Fixture {
 /// @brief deterministically populate the order book
 BENCHMARK_DEFINE_F(BookSideFixture, BENCH_BookUpdate)(benchmark::State& state) {
   int i = 0;
+  const bench::PerfScope perf(state);
   for (auto _ : state) {
     bids_[i] = MID_PRICE - i;
     if (i == MID_PRICE - 1) {
@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "core/bid_ask.h"
+#include "core/order_book.h"
+#include "perf_scope.h"
+
+/// A long session of a depth-`WINDOW` stream replayed into the book: the touch drifts,
+/// the levels it crosses are deleted, those it leaves behind far from it never are.
+/// Unbounded, the book keeps them all and `to_vector` walks them all; trimmed to the
+/// window, it stays the same size whatever the session's length.
+
+namespace {
+
+constexpr size_t WINDOW = 100;
+/// @brief 100 updates a second
+constexpr size_t MESSAGES_PER_HOUR = 36'000;
+constexpr size_t UPDATES_PER_MESSAGE = 10;
+
+/// @brief `state.range(0)` hours replayed into a book trimmed to `state.range(1)` levels
+/// a side (0 for unbounded)
+class LongReplayFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State& state) override {
+    book_ = std::make_unique<core::OrderBook>();
+    book_->set_max_levels(static_cast<size_t>(state.range(1)));
+    std::mt19937_64 rng{42};
+    uint64_t mid = MID_PRICE;
+    std::vector<core::LevelUpdate> updates;
+    const auto messages = static_cast<size_t>(state.range(0)) * MESSAGES_PER_HOUR;
+    for (size_t i = 0; i < messages; ++i) {
+      updates.clear();
+      const uint64_t next_mid = mid + rng() % 7 - 3;
+      for (uint64_t px = std::min(mid, next_mid); px <= std::max(mid, next_mid); ++px) {
+        const core::BookSide crossed =
+            next_mid > mid ? core::BookSide::ASK : core::BookSide::BID;
+        updates.push_back({.side = crossed, .px = px, .sz = 0});
+      }
+      mid = next_mid;
+      for (size_t j = 0; j < UPDATES_PER_MESSAGE; ++j) {
+        const bool is_bid = rng() % 2 == 0;
+        const uint64_t offset = 1 + rng() % WINDOW;
+        updates.push_back({.side = is_bid ? core::BookSide::BID : core::BookSide::ASK,
+                           .px = is_bid ? mid - offset : mid + offset,
+                           .sz = rng() % 4 == 0 ? 0 : 1 + rng() % 1'000});
+      }
+      book_->apply_levels(updates, std::nullopt);
+    }
+    // a message's worth, replayed by the apply benchmark
+    updates_ = updates;
+  }
+
+  void TearDown([[maybe_unused]] const benchmark::State& state) override {
+    book_.reset();
+  }
+
+ protected:
+  static constexpr uint64_t MID_PRICE = 10'000'000;
+  std::unique_ptr<core::OrderBook> book_;
+  std::vector<core::LevelUpdate> updates_;
+
+  void set_counters(benchmark::State& state) const {
+    const core::OrderBook::Footprint footprint = book_->get_footprint();
+    state.counters["Levels"] =
+        static_cast<double>(footprint.bid_levels + footprint.ask_levels);
+    state.counters["KB"] = static_cast<double>(footprint.bytes) / 1'024.0;
+  }
+};
+
+}  // namespace
+
+/// @brief the UI's copy of the whole book
+BENCHMARK_DEFINE_F(LongReplayFixture, BENCH_ToVectorAfterReplay)
+(benchmark::State& state) {
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    std::vector<core::BidAsk> rows = book_->to_vector();
+    benchmark::DoNotOptimize(rows.data());
+  }
+  set_counters(state);
+}
+
+/// @brief a message applied to the long-lived book, trimming included
+BENCHMARK_DEFINE_F(LongReplayFixture, BENCH_ApplyAfterReplay)(benchmark::State& state) {
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    book_->apply_levels(updates_, std::nullopt);
+  }
+  set_counters(state);
+}
+
+BENCHMARK_REGISTER_F(LongReplayFixture, BENCH_ToVectorAfterReplay)
+    ->ArgNames({"hours", "max_levels"})
+    ->ArgsProduct({{1, 4}, {0, WINDOW}});
+BENCHMARK_REGISTER_F(LongReplayFixture, BENCH_ApplyAfterReplay)
+    ->ArgNames({"hours", "max_levels"})
+    ->ArgsProduct({{1, 4}, {0, WINDOW}});
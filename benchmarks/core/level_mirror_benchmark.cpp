@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "absl/container/btree_map.h"
+#include "core/level_kernels.h"
+#include "core/level_mirror.h"
+#include "perf_scope.h"
+
+/// @brief one side of a book, `state.range(0)` levels deep, as a btree and as a mirror.
+/// each query sweeps ~90% of the side, so the scan dominates
+class DepthQueryFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State& state) override {
+    const auto levels = static_cast<uint64_t>(state.range(0));
+    asks_.clear();
+    total_sz_ = 0;
+    for (uint64_t i = 0; i < levels; ++i) {
+      const uint64_t sz = 10'000 + (i * 7'919) % 90'000;
+      asks_[MID_PRICE + i] = sz;
+      total_sz_ += sz;
+    }
+    mirror_ = std::make_unique<core::LevelMirror>(false, levels);
+    mirror_->assign(asks_);
+    sweep_sz_ = total_sz_ / 10 * 9;
+  }
+
+ protected:
+  static constexpr uint64_t MID_PRICE = 10'000'000;
+  absl::btree_map<uint64_t, uint64_t> asks_;
+  std::unique_ptr<core::LevelMirror> mirror_;
+  uint64_t total_sz_ = 0;
+  uint64_t sweep_sz_ = 0;
+
+  void run_mirror(benchmark::State& state, const core::LevelKernels& kernels) {
+    const bench::PerfScope perf(state);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(mirror_->price_to_fill(sweep_sz_, kernels));
+      benchmark::DoNotOptimize(mirror_->notional_to_fill(sweep_sz_, kernels));
+    }
+    state.SetLabel(std::string(core::LevelKernels::to_str_view(kernels.level)));
+    state.counters["Queries/sec"] =
+        benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+  }
+};
+
+/// @brief baseline: walk the btree
+BENCHMARK_DEFINE_F(DepthQueryFixture, BENCH_DepthQuery_BTree)(benchmark::State& state) {
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    uint64_t remaining = sweep_sz_;
+    uint64_t notional = 0;
+    uint64_t last_px = 0;
+    for (const auto& [px, sz] : asks_) {
+      const uint64_t take = std::min(remaining, sz);
+      notional += take * px;
+      remaining -= take;
+      last_px = px;
+      if (remaining == 0) {
+        break;
+      }
+    }
+    benchmark::DoNotOptimize(last_px);
+    benchmark::DoNotOptimize(notional);
+  }
+  state.counters["Queries/sec"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_DEFINE_F(DepthQueryFixture, BENCH_DepthQuery_MirrorScalar)
+(benchmark::State& state) {
+  run_mirror(state, *core::LevelKernels::get(core::SimdLevel::SCALAR));
+}
+
+/// @brief the kernels picked for this CPU
+BENCHMARK_DEFINE_F(DepthQueryFixture, BENCH_DepthQuery_MirrorSimd)
+(benchmark::State& state) {
+  run_mirror(state, core::LevelKernels::get());
+}
+
+BENCHMARK_REGISTER_F(DepthQueryFixture, BENCH_DepthQuery_BTree)
+    ->Arg(100)
+    ->Arg(1'000)
+    ->Arg(5'000);
+BENCHMARK_REGISTER_F(DepthQueryFixture, BENCH_DepthQuery_MirrorScalar)
+    ->Arg(100)
+    ->Arg(1'000)
+    ->Arg(5'000);
+BENCHMARK_REGISTER_F(DepthQueryFixture, BENCH_DepthQuery_MirrorSimd)
+    ->Arg(100)
+    ->Arg(1'000)
+    ->Arg(5'000);
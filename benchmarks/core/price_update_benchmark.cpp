@@ -1,6 +1,7 @@
 #include <benchmark/benchmark.h>
 
 #include "core/order_book.h"
+#include "perf_scope.h"
 #include "spdlog/spdlog.h"
 
 class PriceUpdateFixture : public benchmark::Fixture {
@@ -96,6 +97,7 @@ class PriceUpdateFixture : public benchmark::Fixture {
 /// @brief deterministically populate the order book
 BENCHMARK_DEFINE_F(PriceUpdateFixture, BENCH_PriceUpdate)(benchmark::State& state) {
   int i = 0;
+  const bench::PerfScope perf(state);
   for (auto _ : state) {
     book_->apply_increment(test_messages_[i++], false);
     if (i == MSG_COUNT - 1) {
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <vector>
+
+#include "binance/symbol.h"
+#include "core/bid_ask.h"
+#include "core/order_book.h"
+#include "engine/book_checkpoint.h"
+#include "perf_scope.h"
+
+/// Warm start: the cost of checkpointing a full (5000 levels a side) book, and of
+/// getting it back on restart. Compare the restore with parsing and applying a
+/// snapshot of the same depth, `BENCH_Pipeline_ParseSnapshot` and
+/// `BENCH_Pipeline_ApplySnapshot`.
+
+namespace {
+
+constexpr size_t LEVELS = engine::BookCheckpoint::MAX_LEVELS;
+
+/// @brief a full book around a BTC price, one-cent levels
+core::OrderBook make_book() {
+  std::vector<core::PriceLevel> bids;
+  std::vector<core::PriceLevel> asks;
+  for (uint64_t i = 0; i < LEVELS; ++i) {
+    bids.push_back({.px = 2'748'100 - i, .sz = 1'000 + (i * 37) % 90'000});
+    asks.push_back({.px = 2'748'101 + i, .sz = 1'000 + (i * 53) % 90'000});
+  }
+  return core::OrderBook::from_levels(bids, asks, 1);
+}
+
+std::filesystem::path checkpoint_path() {
+  return std::filesystem::temp_directory_path() /
+         std::format("tradercpp_bench_{}", ::getpid()) / "book.ckpt";
+}
+
+}  // namespace
+
+/// @brief one checkpoint, taken under the book's lock
+static void BENCH_Checkpoint_Save(benchmark::State& state) {
+  const core::OrderBook book = make_book();
+  const auto path = checkpoint_path();
+  engine::BookCheckpoint checkpoint(path, binance::SymbolEnum::BTCUSDT);
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    checkpoint.save(book);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(2 * LEVELS));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(2 * LEVELS * sizeof(core::PriceLevel)));
+  std::filesystem::remove_all(path.parent_path());
+}
+
+/// @brief cold start from a checkpoint: map the file, verify it, rebuild the book
+static void BENCH_Checkpoint_Restore(benchmark::State& state) {
+  const auto path = checkpoint_path();
+  engine::BookCheckpoint(path, binance::SymbolEnum::BTCUSDT).save(make_book());
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    const engine::BookCheckpoint checkpoint(path, binance::SymbolEnum::BTCUSDT);
+    benchmark::DoNotOptimize(checkpoint.restore());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(2 * LEVELS));
+  std::filesystem::remove_all(path.parent_path());
+}
+
+BENCHMARK(BENCH_Checkpoint_Save)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BENCH_Checkpoint_Restore)->Unit(benchmark::kMicrosecond);
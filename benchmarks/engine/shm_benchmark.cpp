@@ -0,0 +1,191 @@
+#include <benchmark/benchmark.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "binance/symbol.h"
+#include "core/bid_ask.h"
+#include "engine/engine.h"
+#include "engine/shm_book.h"
+#include "engine/shm_publisher.h"
+#include "perf_scope.h"
+
+namespace {
+
+uint64_t now_ns() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+}
+
+/// @brief Forked processes looping on the segment the parent mapped, until stopped.
+/// Children inherit the mapping (MAP_SHARED), share a stop flag in an anonymous shared
+/// page and leave with `_exit`, so that they never unlink the parent's segment.
+class ChildProcesses {
+ public:
+  ChildProcesses() {
+    void* addr = ::mmap(nullptr, sizeof(std::atomic<bool>), PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+      throw std::runtime_error("cannot map the stop flag");
+    }
+    stop_ = new (addr) std::atomic<bool>(false);
+  }
+
+  ~ChildProcesses() {
+    stop();
+    ::munmap(stop_, sizeof(std::atomic<bool>));
+  }
+
+  ChildProcesses(const ChildProcesses&) = delete;
+  ChildProcesses& operator=(const ChildProcesses&) = delete;
+
+  /// @brief fork a child running `loop` until the stop flag is raised
+  void spawn(const std::function<void(const std::atomic<bool>&)>& loop) {
+    const pid_t pid = ::fork();
+    if (pid < 0) {
+      throw std::runtime_error("cannot fork");
+    }
+    if (pid == 0) {
+      loop(*stop_);
+      ::_exit(0);
+    }
+    pids_.push_back(pid);
+  }
+
+  void stop() {
+    stop_->store(true, std::memory_order_release);
+    for (const pid_t pid : pids_) {
+      ::waitpid(pid, nullptr, 0);
+    }
+    pids_.clear();
+  }
+
+ private:
+  std::atomic<bool>* stop_ = nullptr;
+  std::vector<pid_t> pids_;
+};
+
+/// @brief a full-depth book, as published by the engine
+engine::BookSnapshot make_snapshot(const uint16_t rows) {
+  engine::BookSnapshot snapshot;
+  snapshot.row_count = rows;
+  for (uint16_t i = 0; i < rows; ++i) {
+    snapshot.levels[i] = core::BidAsk(100 + i, 10'000'000 - i, 10'000'001 + i, 200 + i);
+  }
+  return snapshot;
+}
+
+std::string segment_name(const std::string& bench) {
+  return std::format("/tradercpp_bench_{}_{}", bench, ::getpid());
+}
+
+}  // namespace
+
+/// @brief writer cost per book publish, as paid by the engine's book thread.
+/// arg 0: rows in the book, arg 1: reader processes spinning on the same slot
+static void BENCH_Shm_PublishBook(benchmark::State& state) {
+  const auto rows = static_cast<uint16_t>(state.range(0));
+  engine::ShmPublisher publisher(segment_name("publish"));
+  engine::BookSnapshot snapshot = make_snapshot(rows);
+
+  ChildProcesses readers;
+  for (int64_t i = 0; i < state.range(1); ++i) {
+    readers.spawn([&publisher](const std::atomic<bool>& stop) {
+      const engine::ShmBookReader reader(publisher.get_name());
+      engine::ShmBook book{};
+      while (!stop.load(std::memory_order_acquire)) {
+        reader.read_book(0, book);
+        benchmark::DoNotOptimize(book.message_count);
+      }
+    });
+  }
+
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    ++snapshot.message_count;
+    publisher.publish_book(binance::SymbolEnum::BTCUSDT, snapshot);
+  }
+  readers.stop();
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief reader cost per consistent book copy.
+/// arg 0: rows in the book, arg 1: whether a writer process publishes continuously
+static void BENCH_Shm_ReadBook(benchmark::State& state) {
+  const auto rows = static_cast<uint16_t>(state.range(0));
+  engine::ShmPublisher publisher(segment_name("read"));
+  engine::BookSnapshot snapshot = make_snapshot(rows);
+  publisher.publish_book(binance::SymbolEnum::BTCUSDT, snapshot);
+
+  ChildProcesses writer;
+  if (state.range(1) != 0) {
+    writer.spawn([&publisher, snapshot](const std::atomic<bool>& stop) mutable {
+      while (!stop.load(std::memory_order_acquire)) {
+        ++snapshot.message_count;
+        publisher.publish_book(binance::SymbolEnum::BTCUSDT, snapshot);
+      }
+    });
+  }
+
+  const engine::ShmBookReader reader(publisher.get_name());
+  engine::ShmBook book{};
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(reader.read_book(0, book));
+  }
+  writer.stop();
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief publish-to-visible latency across processes: a writer process publishes
+/// about every 20 µs, the benchmark spins on the version and, for each new book,
+/// measures the time since its publish stamp. arg 0: rows in the book
+static void BENCH_Shm_Visibility(benchmark::State& state) {
+  const auto rows = static_cast<uint16_t>(state.range(0));
+  engine::ShmPublisher publisher(segment_name("visibility"));
+  const engine::ShmBookReader reader(publisher.get_name());
+
+  ChildProcesses writer;
+  writer.spawn([&publisher, snapshot = make_snapshot(rows)](
+                   const std::atomic<bool>& stop) mutable {
+    constexpr uint64_t PERIOD_NS = 20'000;
+    uint64_t next = now_ns();
+    while (!stop.load(std::memory_order_acquire)) {
+      if (now_ns() >= next) {
+        ++snapshot.message_count;
+        publisher.publish_book(binance::SymbolEnum::BTCUSDT, snapshot);
+        next += PERIOD_NS;
+      }
+    }
+  });
+
+  engine::ShmBook book{};
+  uint64_t seen = reader.book_version(0);
+  uint64_t latency_ns = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    while (reader.book_version(0) == seen) {
+      engine::shm_cpu_relax();
+    }
+    seen = reader.read_book(0, book);
+    latency_ns += now_ns() - book.publish_ns;
+  }
+  writer.stop();
+  state.counters["visibility_ns"] = benchmark::Counter(
+      static_cast<double>(latency_ns), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BENCH_Shm_PublishBook)->ArgsProduct({{10, 100}, {0, 1, 4}});
+BENCHMARK(BENCH_Shm_ReadBook)->ArgsProduct({{10, 100}, {0, 1}});
+BENCHMARK(BENCH_Shm_Visibility)->Arg(10)->Arg(100)->UseRealTime();
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""
+Generate the Binance market-data FIX fixtures used by the pipeline benchmarks.
+
+The messages follow the shape of the Binance SPOT FIX market-data stream
+(see binance/spot-fix-md.xml): a MarketDataSnapshot (W) 5000 levels deep per side,
+MarketDataIncrementalRefresh (X) messages with 1-50 entries each, carrying
+FirstBookUpdateID/LastBookUpdateID on their first entry, and trade stream
+MarketDataIncrementalRefresh (X) messages with 1-5 trades each.
+Output is deterministic (fixed seed), one message per line, with SOH written as '|'.
+Recorded messages in the same format can be dropped in instead.
+
+Usage: benchmarks/fixtures/generate_fixtures.py [output_dir]
+"""
+
+import os
+import random
+import sys
+from datetime import datetime, timedelta, timezone
+
+SEED = 20251019
+SYMBOL = "BTCUSDT"
+MID_PRICE_TICKS = 10_000_000  # 100,000.00 USDT, 0.01 tick
+SNAPSHOT_LEVELS = 5_000
+INCREMENT_COUNT = 400
+TRADE_MESSAGE_COUNT = 400
+MAX_TRADES = 5
+FIRST_TRADE_ID = 5_100_000_000
+MAX_ENTRIES = 50
+FIRST_UPDATE_ID = 72_000_000_000  # update ids exceed 32 bits in production
+
+SOH = "\x01"
+START_TIME = datetime(2025, 10, 19, 12, 0, 0, tzinfo=timezone.utc)
+
+
+def fmt_px(ticks):
+    return f"{ticks // 100}.{ticks % 100:02d}"
+
+
+def fmt_sz(ticks):
+    return f"{ticks // 100_000}.{ticks % 100_000:05d}"
+
+
+def fmt_time(ts):
+    return ts.strftime("%Y%m%d-%H:%M:%S.") + f"{ts.microsecond:06d}"
+
+
+def random_size(rng):
+    # mostly small resting orders with the odd large one, 0.00001 - ~20 BTC
+    return max(1, min(2_000_000, int(rng.lognormvariate(9.0, 1.8))))
+
+
+def encode(msg_type, seq_num, ts, body_fields):
+    """build a complete FIX 4.4 message with BodyLength and CheckSum"""
+    header = [
+        ("35", msg_type),
+        ("49", "SPOT"),
+        ("56", "TRDR2"),
+        ("34", str(seq_num)),
+        ("52", fmt_time(ts)),
+    ]
+    body = "".join(f"{tag}={value}{SOH}" for tag, value in header + body_fields)
+    head = f"8=FIX.4.4{SOH}9={len(body)}{SOH}"
+    checksum = sum((head + body).encode("ascii")) % 256
+    return f"{head}{body}10={checksum:03d}{SOH}"
+
+
+def build_snapshot(rng, book, update_id, seq_num, ts):
+    fields = [("262", "BOOK"), ("55", SYMBOL), ("25044", str(update_id))]
+    entries = []
+    for side, sign in (("0", -1), ("1", 1)):
+        px = MID_PRICE_TICKS + sign
+        for _ in range(SNAPSHOT_LEVELS):
+            sz = random_size(rng)
+            book[side][px] = sz
+            entries += [("269", side), ("270", fmt_px(px)), ("271", fmt_sz(sz))]
+            # mostly contiguous ticks near the touch, sparser further out
+            px += sign * (1 + (rng.random() < 0.3) * rng.randint(1, 3))
+    return encode("W", seq_num, ts, fields + [("268", str(len(entries) // 3))] + entries)
+
+
+def build_increment(rng, book, first_id, last_id, entry_count, seq_num, ts):
+    entries = []
+    for i in range(entry_count):
+        side = rng.choice(("0", "1"))
+        levels = book[side]
+        best = max(levels) if side == "0" else min(levels)
+        roll = rng.random()
+        if roll < 0.2 and len(levels) > 1:
+            # cancel a level near the touch
+            px = best - rng.randint(0, 20) if side == "0" else best + rng.randint(0, 20)
+            if px not in levels:
+                px = best
+            action = "2"
+            levels.pop(px)
+        else:
+            # new/changed level, usually within a few ticks of the touch
+            offset = min(int(rng.expovariate(0.15)), 500) - (roll > 0.9)
+            px = best - offset if side == "0" else best + offset
+            other = book["1" if side == "0" else "0"]
+            if (side == "0" and px >= min(other)) or (side == "1" and px <= max(other)):
+                # never cross the book
+                px = best
+            action = "1" if px in levels else "0"
+            levels[px] = random_size(rng)
+
+        group = [("279", action), ("270", fmt_px(px))]
+        if action != "2":
+            group.append(("271", fmt_sz(levels[px])))
+        group.append(("269", side))
+        if i == 0:
+            group += [("55", SYMBOL), ("25043", str(first_id)), ("25044", str(last_id))]
+        entries += group
+
+    fields = [("262", "BOOK"), ("268", str(entry_count))]
+    return encode("X", seq_num, ts, fields + entries)
+
+
+def build_trades(rng, book, first_trade_id, trade_count, seq_num, ts):
+    entries = []
+    for i in range(trade_count):
+        # the aggressor takes the touch on the other side
+        side = rng.choice(("1", "2"))  # AggressorSide: 1 buy, 2 sell
+        px = min(book["1"]) if side == "1" else max(book["0"])
+        group = [("279", "0"), ("270", fmt_px(px)), ("271", fmt_sz(random_size(rng))),
+                 ("269", "2")]
+        if i == 0:
+            group.append(("55", SYMBOL))
+        group += [("60", fmt_time(ts)), ("1003", str(first_trade_id + i)), ("2446", side)]
+        entries += group
+
+    fields = [("262", "TRADE"), ("268", str(trade_count))]
+    return encode("X", seq_num, ts, fields + entries)
+
+
+def main():
+    out_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.abspath(__file__))
+    rng = random.Random(SEED)
+    book = {"0": {}, "1": {}}
+    ts = START_TIME
+    seq_num = 2
+    update_id = FIRST_UPDATE_ID
+
+    snapshot = build_snapshot(rng, book, update_id, seq_num, ts)
+    with open(os.path.join(out_dir, "md_snapshot_5000.fix"), "w") as f:
+        f.write(snapshot.replace(SOH, "|") + "\n")
+
+    with open(os.path.join(out_dir, "md_increments.fix"), "w") as f:
+        for i in range(INCREMENT_COUNT):
+            seq_num += 1
+            ts += timedelta(microseconds=rng.randint(50, 5_000))
+            # every entry count from 1 to MAX_ENTRIES, equally often
+            entry_count = 1 + (i * 7) % MAX_ENTRIES
+            first_id = update_id + 1
+            update_id += rng.randint(1, entry_count)
+            msg = build_increment(rng, book, first_id, update_id, entry_count, seq_num, ts)
+            f.write(msg.replace(SOH, "|") + "\n")
+
+    # trades against the book as it ended up, on their own session
+    trade_id = FIRST_TRADE_ID
+    seq_num = 2
+    with open(os.path.join(out_dir, "md_trades.fix"), "w") as f:
+        for _ in range(TRADE_MESSAGE_COUNT):
+            seq_num += 1
+            ts += timedelta(microseconds=rng.randint(50, 5_000))
+            trade_count = 1 + rng.randrange(MAX_TRADES)
+            msg = build_trades(rng, book, trade_id, trade_count, seq_num, ts)
+            trade_id += trade_count
+            f.write(msg.replace(SOH, "|") + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,7 +1,11 @@
 #include <benchmark/benchmark.h>
 
 #include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string_view>
 
+#include "perf_scope.h"
 #include "spdlog/spdlog.h"
 #include "utils/logging.h"
 
@@ -14,4 +18,40 @@ struct Initializer {
 };
 static Initializer init;
 
-BENCHMARK_MAIN();
+/// @brief take our own `--perf_counters=<sets>` flag out of argv before Google
+/// Benchmark sees it. sets: comma separated core,cache,tlb, or all (default) or none
+static std::string_view take_perf_counters_flag(int& argc, char** argv) {
+  constexpr std::string_view FLAG = "--perf_counters=";
+  std::string_view spec = "all";
+  int out = 1;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg.starts_with(FLAG)) {
+      spec = arg.substr(FLAG.size());
+    } else {
+      argv[out++] = argv[i];
+    }
+  }
+  argc = out;
+  argv[argc] = nullptr;
+  return spec;
+}
+
+int main(int argc, char** argv) {
+  const std::string_view perf_counters = take_perf_counters_flag(argc, argv);
+  try {
+    bench::PerfScope::configure(perf_counters);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+  benchmark::AddCustomContext("perf_counters", std::string(perf_counters));
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
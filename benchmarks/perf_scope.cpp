@@ -0,0 +1,57 @@
+#include "perf_scope.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/perf_counters.h"
+
+namespace bench {
+
+namespace {
+
+std::vector<utils::PerfCounters::Set>& configured_sets() {
+  static std::vector<utils::PerfCounters::Set> sets =
+      utils::PerfCounters::parse_sets("all");
+  return sets;
+}
+
+/// @brief opened once per benchmark thread, counters count the calling thread only
+utils::PerfCounters& thread_counters() {
+  thread_local utils::PerfCounters counters(configured_sets());
+  return counters;
+}
+
+}  // namespace
+
+// static
+void PerfScope::configure(const std::string_view spec) {
+  configured_sets() = utils::PerfCounters::parse_sets(spec);
+}
+
+PerfScope::PerfScope(benchmark::State& state) : state_(state) {
+  thread_counters().start();
+}
+
+PerfScope::~PerfScope() {
+  utils::PerfCounters& counters = thread_counters();
+  counters.stop();
+  double cycles = 0;
+  double instructions = 0;
+  for (const auto& reading : counters.read()) {
+    state_.counters[std::string(reading.name)] =
+        benchmark::Counter(reading.value, benchmark::Counter::kAvgIterations);
+    if (reading.name == "cycles") {
+      cycles = reading.value;
+    } else if (reading.name == "instructions") {
+      instructions = reading.value;
+    }
+  }
+  if (cycles > 0 && instructions > 0) {
+    state_.counters["IPC"] = instructions / cycles;
+  }
+}
+
+}  // namespace bench
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <string_view>
+
+namespace bench {
+
+/// @brief Counts hardware events (see @ref utils::PerfCounters) from its construction,
+/// just before the timed loop, to the end of the benchmark, and reports them per
+/// iteration in the benchmark's counters, and so in `bench_results.json`.
+/// Does nothing when the counters are disabled or not permitted.
+/// e.g.
+///   const bench::PerfScope perf(state);
+///   for (auto _ : state) { ... }
+class PerfScope {
+ public:
+  explicit PerfScope(benchmark::State& state);
+  ~PerfScope();
+
+  PerfScope(const PerfScope&) = delete;
+  PerfScope& operator=(const PerfScope&) = delete;
+
+  /// @brief select the counter sets, see @ref utils::PerfCounters::parse_sets.
+  /// call before running the benchmarks
+  static void configure(std::string_view spec);
+
+ private:
+  benchmark::State& state_;
+};
+
+}  // namespace bench
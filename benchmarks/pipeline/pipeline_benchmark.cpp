@@ -0,0 +1,347 @@
+#include <benchmark/benchmark.h>
+#include <quickfix/DataDictionary.h>
+#include <quickfix/Message.h>
+#include <quickfix/SessionID.h>
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+#include <quickfix/fix44/MessageCracker.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "binance/market_message_variant.h"
+#include "concurrentqueue.h"
+#include "core/order_book.h"
+#include "engine/engine.h"
+#include "perf_scope.h"
+#include "ui/order_book_box.h"
+
+/// End-to-end benchmarks of the market-data pipeline, stage by stage, replaying the
+/// Binance-shaped messages in `benchmarks/fixtures` (see `generate_fixtures.py`):
+/// parse -> crack -> enqueue/dequeue -> apply to the book -> publish -> `to_table`.
+/// Every stage reports items (messages) and bytes (raw FIX) per second, so that a
+/// regression in any one of them shows up on its own.
+
+namespace {
+
+/// @brief where the fixtures, and the QuickFIX data dictionary, live
+std::filesystem::path repo_root() {
+  return std::filesystem::absolute(__FILE__).parent_path().parent_path().parent_path();
+}
+
+std::filesystem::path fixtures_dir() {
+  return repo_root() / "benchmarks" / "fixtures";
+}
+
+/// @brief one FIX message per line, SOH written as '|'
+std::vector<std::string> load_messages(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error(
+        std::format("cannot open fixture. path [{}]", path.string()));
+  }
+  std::vector<std::string> out;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::ranges::replace(line, '|', '\x01');
+    out.push_back(std::move(line));
+  }
+  return out;
+}
+
+size_t entry_count(const FIX::Message& msg) {
+  FIX::NoMDEntries entries;
+  msg.getField(entries);
+  return static_cast<size_t>(entries.getValue());
+}
+
+/// @brief fixtures, loaded and parsed once for all benchmarks
+struct Fixtures {
+  FIX::DataDictionary dictionary;
+  std::string snapshot_raw;
+  FIX44::MarketDataSnapshotFullRefresh snapshot;
+  std::vector<std::string> increments_raw;
+  std::vector<FIX44::MarketDataIncrementalRefresh> increments;
+  size_t increments_bytes = 0;
+
+  static const Fixtures& get() {
+    static const Fixtures fixtures;
+    return fixtures;
+  }
+
+ private:
+  Fixtures()
+      : dictionary((repo_root() / "binance" / "spot-fix-md.xml").string()),
+        snapshot_raw(load_messages(fixtures_dir() / "md_snapshot_5000.fix").at(0)),
+        snapshot(FIX::Message(snapshot_raw, dictionary, true)),
+        increments_raw(load_messages(fixtures_dir() / "md_increments.fix")) {
+    for (const std::string& raw : increments_raw) {
+      increments.emplace_back(FIX::Message(raw, dictionary, true));
+      increments_bytes += raw.size();
+    }
+  }
+};
+
+/// @brief cracks messages the way `binance::FixApp` does, minus the queue
+class VariantCracker : public FIX44::MessageCracker {
+ public:
+  using FIX44::MessageCracker::onMessage;
+  binance::MarketMessageVariant last;
+
+  void onMessage(const FIX44::MarketDataSnapshotFullRefresh& m,
+                 const FIX::SessionID&) override {
+    last = binance::MarketMessageVariant{m};
+  }
+  void onMessage(const FIX44::MarketDataIncrementalRefresh& m,
+                 const FIX::SessionID&) override {
+    last = binance::MarketMessageVariant{m};
+  }
+};
+
+const FIX::SessionID SESSION_ID{"FIX.4.4", "TRDR2", "SPOT", "PX"};
+
+void set_rates(benchmark::State& state, const size_t messages, const size_t bytes) {
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * messages));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+}  // namespace
+
+class PipelineFixture : public benchmark::Fixture {
+ public:
+  void SetUp([[maybe_unused]] const benchmark::State& state) override {
+    fixtures_ = &Fixtures::get();
+  }
+
+ protected:
+  const Fixtures* fixtures_ = nullptr;
+
+  /// @brief a book primed with the 5000-level snapshot
+  std::unique_ptr<core::OrderBook> make_book() const {
+    auto book = std::make_unique<core::OrderBook>();
+    book->apply_snapshot(fixtures_->snapshot);
+    return book;
+  }
+};
+
+// ─────────── QuickFIX ───────────
+
+/// @brief raw FIX -> `FIX::Message`, with the checks a data-dictionary session makes
+BENCHMARK_DEFINE_F(PipelineFixture, BENCH_Pipeline_ParseIncrements)
+(benchmark::State& state) {
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    for (const std::string& raw : fixtures_->increments_raw) {
+      FIX::Message msg(raw, fixtures_->dictionary, true);
+      fixtures_->dictionary.validate(msg);
+      benchmark::DoNotOptimize(msg);
+    }
+  }
+  set_rates(state, fixtures_->increments_raw.size(), fixtures_->increments_bytes);
+}
+
+BENCHMARK_DEFINE_F(PipelineFixture, BENCH_Pipeline_ParseSnapshot)
+(benchmark::State& state) {
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    FIX::Message msg(fixtures_->snapshot_raw, fixtures_->dictionary, true);
+    fixtures_->dictionary.validate(msg);
+    benchmark::DoNotOptimize(msg);
+  }
+  set_rates(state, 1, fixtures_->snapshot_raw.size());
+}
+
+/// @brief `FIX::Message` -> typed message in a `MarketMessageVariant`
+BENCHMARK_DEFINE_F(PipelineFixture, BENCH_Pipeline_Crack)(benchmark::State& state) {
+  VariantCracker cracker;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    for (const FIX::Message& msg : fixtures_->increments) {
+      cracker.crack(msg, SESSION_ID);
+    }
+    benchmark::DoNotOptimize(cracker.last);
+  }
+  set_rates(state, fixtures_->increments.size(), fixtures_->increments_bytes);
+}
+
+// ─────────── Queue ───────────
+
+/// @brief FIX thread -> book thread hand-off, on one thread (no contention)
+BENCHMARK_DEFINE_F(PipelineFixture, BENCH_Pipeline_EnqueueDequeue)
+(benchmark::State& state) {
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> queue;
+  binance::MarketMessageVariant out;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    for (const auto& msg : fixtures_->increments) {
+      queue.enqueue(binance::MarketMessageVariant{msg});
+      queue.try_dequeue(out);
+    }
+    benchmark::DoNotOptimize(out);
+  }
+  set_rates(state, fixtures_->increments.size(), fixtures_->increments_bytes);
+}
+
+// ─────────── Book ───────────
+
+BENCHMARK_DEFINE_F(PipelineFixture, BENCH_Pipeline_ApplySnapshot)
+(benchmark::State& state) {
+  core::OrderBook book;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    book.apply_snapshot(fixtures_->snapshot);
+  }
+  set_rates(state, 1, fixtures_->snapshot_raw.size());
+  state.counters["Entries/sec"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * entry_count(fixtures_->snapshot)),
+      benchmark::Counter::kIsRate);
+}
+
+/// @brief increments with exactly `state.range(0)` entries, or all of them for 0
+BENCHMARK_DEFINE_F(PipelineFixture, BENCH_Pipeline_ApplyIncrement)
+(benchmark::State& state) {
+  const auto wanted = static_cast<size_t>(state.range(0));
+  std::vector<const FIX44::MarketDataIncrementalRefresh*> messages;
+  size_t bytes = 0;
+  size_t entries = 0;
+  for (size_t i = 0; i < fixtures_->increments.size(); ++i) {
+    const size_t count = entry_count(fixtures_->increments[i]);
+    if (wanted == 0 || count == wanted) {
+      messages.push_back(&fixtures_->increments[i]);
+      bytes += fixtures_->increments_raw[i].size();
+      entries += count;
+    }
+  }
+
+  const auto book = make_book();
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    for (const auto* msg : messages) {
+      book->apply_increment(*msg, false);
+    }
+  }
+  set_rates(state, messages.size(), bytes);
+  state.counters["Entries/sec"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * entries), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_DEFINE_F(PipelineFixture, BENCH_Pipeline_ToVector)(benchmark::State& state) {
+  const auto book = make_book();
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(book->to_vector());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+/// @brief what the engine copies out for readers, after each burst of messages
+BENCHMARK_DEFINE_F(PipelineFixture, BENCH_Pipeline_Publish)(benchmark::State& state) {
+  const auto book = make_book();
+  const auto snapshot = std::make_unique<engine::BookSnapshot>();
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(book->top_levels(snapshot->levels));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// ─────────── Engine ───────────
+
+/// @brief increments in, on the engine's book thread, until all applied and published:
+/// cross-thread throughput of the engine on its own
+BENCHMARK_DEFINE_F(PipelineFixture, BENCH_Pipeline_Engine)(benchmark::State& state) {
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> order_queue;
+  moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> trade_queue;
+  engine::Engine engine(order_queue, trade_queue, 5'000, std::move(*make_book()));
+  engine.start();
+  uint64_t applied = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    for (const auto& msg : fixtures_->increments) {
+      order_queue.enqueue(binance::MarketMessageVariant{msg});
+    }
+    applied += fixtures_->increments.size();
+    while (engine.get_book().message_count < applied) {
+      std::this_thread::yield();
+    }
+  }
+  engine.stop();
+  set_rates(state, fixtures_->increments.size(), fixtures_->increments_bytes);
+}
+
+// ─────────── UI ───────────
+
+BENCHMARK_DEFINE_F(PipelineFixture, BENCH_Pipeline_ToTable)(benchmark::State& state) {
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> order_queue;
+  moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> trade_queue;
+  // not started: renders the snapshot published at construction
+  const engine::Engine engine(order_queue, trade_queue, 5'000, std::move(*make_book()));
+  const ui::OrderBookBox box(engine);
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(box.to_table());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// ─────────── All together ───────────
+
+/// @brief raw FIX in, book updated: parse, crack, enqueue, dequeue, apply
+BENCHMARK_DEFINE_F(PipelineFixture, BENCH_Pipeline_EndToEnd)(benchmark::State& state) {
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> queue;
+  VariantCracker cracker;
+  const auto book = make_book();
+  binance::MarketMessageVariant out;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    for (const std::string& raw : fixtures_->increments_raw) {
+      FIX::Message msg(raw, fixtures_->dictionary, true);
+      fixtures_->dictionary.validate(msg);
+      cracker.crack(msg, SESSION_ID);
+      queue.enqueue(std::move(cracker.last));
+      queue.try_dequeue(out);
+      std::visit(
+          [&book](const auto& m) {
+            using T = std::decay_t<decltype(m)>;
+            if constexpr (std::is_same_v<T, FIX44::MarketDataSnapshotFullRefresh>) {
+              book->apply_snapshot(m);
+            } else if constexpr (std::is_same_v<T, FIX44::MarketDataIncrementalRefresh>) {
+              book->apply_increment(m, false);
+            } else {
+              book->apply_top(m);
+            }
+          },
+          out);
+    }
+  }
+  set_rates(state, fixtures_->increments_raw.size(), fixtures_->increments_bytes);
+}
+
+BENCHMARK_REGISTER_F(PipelineFixture, BENCH_Pipeline_ParseIncrements);
+BENCHMARK_REGISTER_F(PipelineFixture, BENCH_Pipeline_ParseSnapshot);
+BENCHMARK_REGISTER_F(PipelineFixture, BENCH_Pipeline_Crack);
+BENCHMARK_REGISTER_F(PipelineFixture, BENCH_Pipeline_EnqueueDequeue);
+BENCHMARK_REGISTER_F(PipelineFixture, BENCH_Pipeline_ApplySnapshot);
+BENCHMARK_REGISTER_F(PipelineFixture, BENCH_Pipeline_ApplyIncrement)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(50);
+BENCHMARK_REGISTER_F(PipelineFixture, BENCH_Pipeline_ToVector);
+BENCHMARK_REGISTER_F(PipelineFixture, BENCH_Pipeline_Publish);
+BENCHMARK_REGISTER_F(PipelineFixture, BENCH_Pipeline_Engine)->UseRealTime();
+BENCHMARK_REGISTER_F(PipelineFixture, BENCH_Pipeline_ToTable);
+BENCHMARK_REGISTER_F(PipelineFixture, BENCH_Pipeline_EndToEnd);
@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <vector>
+
+#include "binance/side.h"
+#include "binance/symbol.h"
+#include "core/trade.h"
+#include "perf_scope.h"
+#include "tape/tape_format.h"
+#include "tape/tape_reader.h"
+#include "tape/tape_writer.h"
+#include "utils/spsc_queue.h"
+
+namespace {
+
+/// @brief 2023-10-20 12:34:56 UTC
+constexpr uint64_t TS_US = 1'697'805'296'000'000;
+
+/// @brief a random walk around a BTC price, a trade every ~250 µs
+std::vector<tape::TapeTrade> make_trades(const size_t count) {
+  std::vector<tape::TapeTrade> trades;
+  trades.reserve(count);
+  uint64_t px = 2'748'100;
+  uint64_t state = 42;
+  for (uint64_t i = 0; i < count; ++i) {
+    state = state * 6'364'136'223'846'793'005u + 1'442'695'040'888'963'407u;
+    px = px + (state >> 62) - 1;
+    trades.push_back({.px = px,
+                      .sz = 100 + (state >> 40) % 50'000,
+                      .id = 3'000'000'000 + i,
+                      .ts_us = TS_US + i * 250 + (state >> 56) % 100,
+                      .side = (state >> 33) & 1 ? binance::SideEnum::SELL
+                                                : binance::SideEnum::BUY});
+  }
+  return trades;
+}
+
+}  // namespace
+
+/// @brief columnar encoding of one block, the writer thread's cost per trade
+static void BENCH_Tape_EncodeBlock(benchmark::State& state) {
+  const std::vector<tape::TapeTrade> trades = make_trades(tape::TapeWriter::BLOCK_TRADES);
+  std::vector<uint8_t> out;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    out.clear();
+    tape::encode_block(trades, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trades.size()));
+  state.counters["bytes_per_trade"] =
+      static_cast<double>(out.size()) / static_cast<double>(trades.size());
+}
+
+/// @brief decoding one block, the reader's cost per trade
+static void BENCH_Tape_DecodeBlock(benchmark::State& state) {
+  const std::vector<tape::TapeTrade> trades = make_trades(tape::TapeWriter::BLOCK_TRADES);
+  std::vector<uint8_t> encoded;
+  tape::encode_block(trades, encoded);
+  std::vector<tape::TapeTrade> out;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    tape::decode_block(encoded, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trades.size()));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(encoded.size()));
+}
+
+/// @brief the trade thread's cost per trade: one push into the writer's buffer
+/// (popped straight back here, so that it never fills)
+static void BENCH_Tape_Push(benchmark::State& state) {
+  auto queue = std::make_unique<
+      utils::SpscQueue<tape::TapeTrade, tape::TapeWriter::QUEUE_CAPACITY>>();
+  tape::TapeTrade trade = make_trades(1).front();
+  tape::TapeTrade out;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    ++trade.id;
+    benchmark::DoNotOptimize(queue->try_push(trade));
+    benchmark::DoNotOptimize(queue->try_pop(out));
+  }
+}
+
+/// @brief a full pass over a mapped day file of 1M trades
+static void BENCH_Tape_ScanFile(benchmark::State& state) {
+  constexpr size_t COUNT = 1'000'000;
+  const auto dir = std::filesystem::temp_directory_path() /
+                   std::format("tradercpp_bench_tape_scan_{}", ::getpid());
+  {
+    tape::TapeWriter writer(dir, binance::SymbolEnum::BTCUSDT);
+    for (const tape::TapeTrade& t : make_trades(COUNT)) {
+      while (!writer.push(core::Trade(t.px, t.sz, t.id, t.side, {}, t.ts_us))) {
+        // the buffer is smaller than the file: let the writer catch up
+      }
+    }
+  }
+  const auto path = tape::TapeWriter::file_path(dir, binance::SymbolEnum::BTCUSDT, TS_US);
+  tape::TapeReader reader(path);
+  const auto bytes = static_cast<int64_t>(std::filesystem::file_size(path));
+
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    uint64_t volume = 0;
+    reader.for_each([&volume](const tape::TapeTrade& t) { volume += t.sz; });
+    benchmark::DoNotOptimize(volume);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(reader.size()));
+  state.SetBytesProcessed(state.iterations() * bytes);
+  std::filesystem::remove_all(dir);
+}
+
+BENCHMARK(BENCH_Tape_EncodeBlock);
+BENCHMARK(BENCH_Tape_DecodeBlock);
+BENCHMARK(BENCH_Tape_Push);
+BENCHMARK(BENCH_Tape_ScanFile)->Unit(benchmark::kMillisecond);
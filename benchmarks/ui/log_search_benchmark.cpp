@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+
+#include "perf_scope.h"
+#include "ui/log_box/log_line.h"
+#include "ui/log_box/log_search.h"
+#include "ui/log_box/log_tailer.h"
+
+/// Log box: indexing a line as it is tailed, and a search over a large scrollback.
+/// A render only reads the lines on screen, so neither shows up in the frame time.
+
+namespace {
+
+constexpr int LINES = 200'000;
+
+std::filesystem::path write_log() {
+  const auto path = std::filesystem::temp_directory_path() /
+                    std::format("tradercpp_bench_log_{}", ::getpid()) / "trader.log";
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::trunc);
+  constexpr std::array levels = {"debug", "info", "warning", "error"};
+  for (int i = 0; i < LINES; ++i) {
+    file << std::format(
+        "[2025-01-02 03:04:05.678] [{}] [{}] market data incremental refresh, "
+        "entries [{}], update id [{}]\n",
+        levels[static_cast<size_t>(i) % levels.size()], 4000 + i % 8, i % 50, i);
+  }
+  return path;
+}
+
+}  // namespace
+
+/// @brief the index entry of one line, parsed on the tailer thread
+static void BENCH_LogLine_Parse(benchmark::State& state) {
+  const std::string line =
+      "[2025-01-02 03:04:05.678] [info] [4242] market data incremental refresh, "
+      "entries [12], update id [1234567]";
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ui::LogLineMeta::parse(line));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief a full search of the scrollback, level (index only) or text
+static void BENCH_LogSearch_Full(benchmark::State& state) {
+  const auto path = write_log();
+  ui::LogTailer tailer(path);
+  tailer.poll_file();
+  ui::LogSearch search(tailer);
+  const bool is_text = state.range(0) != 0;
+  ui::LogFilter filter;
+  filter.min_level = is_text ? ui::LogLevel::trace : ui::LogLevel::error;
+  uint32_t i = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    // a new filter restarts the search
+    ++i;
+    filter.text = is_text ? std::format("update id [{}]", i % LINES) : "";
+    filter.thread_id = is_text ? 0 : 4000 + i % 8;
+    search.set_filter(filter);
+    while (search.search_step()) {
+    }
+    benchmark::DoNotOptimize(search.get_match_count());
+  }
+  state.SetItemsProcessed(state.iterations() * LINES);
+  std::filesystem::remove_all(path.parent_path());
+}
+
+BENCHMARK(BENCH_LogLine_Parse);
+BENCHMARK(BENCH_LogSearch_Full)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
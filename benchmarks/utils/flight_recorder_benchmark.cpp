@@ -0,0 +1,28 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "perf_scope.h"
+#include "utils/flight_recorder.h"
+
+/// @brief the cost of one event on the hot path, with the recorder always on
+static void BENCH_FlightRecorder_Record(benchmark::State& state) {
+  utils::FlightRecorder recorder;
+  uint64_t i = 0;
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    recorder.record(utils::FlightEvent::BOOK_APPLY, 1, ++i, 0);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief the timestamp counter read alone, the bulk of a record
+static void BENCH_FlightRecorder_Now(benchmark::State& state) {
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(utils::FlightRecorder::now());
+  }
+}
+
+BENCHMARK(BENCH_FlightRecorder_Record);
+BENCHMARK(BENCH_FlightRecorder_Now);
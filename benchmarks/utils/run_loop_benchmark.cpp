@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+#include <sys/resource.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "perf_scope.h"
+#include "utils/run_loop.h"
+
+/// `state.range(0)` low-priority stages waking every millisecond to poll, as the tape
+/// writer does: a thread each, sleeping on its own, or coroutines sharing one loop
+/// thread. The same wakes either way; the counters are the process's context switches
+/// and the threads the stages take.
+
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr auto PERIOD = 1ms;
+/// @brief each iteration lets the stages run this long
+constexpr auto WINDOW = 50ms;
+
+/// @brief voluntary and involuntary, of all the process's threads
+uint64_t get_context_switches() {
+  rusage usage{};
+  ::getrusage(RUSAGE_SELF, &usage);
+  return static_cast<uint64_t>(usage.ru_nvcsw + usage.ru_nivcsw);
+}
+
+utils::Task poll_stage(std::atomic<uint64_t>& wakes, const std::stop_token stoken) {
+  for (;;) {
+    const bool is_running = co_await utils::RunLoop::sleep_for(PERIOD, stoken);
+    if (!is_running) {
+      break;
+    }
+    wakes.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+/// @brief runs the stages for `WINDOW` per iteration, reports the context switches
+void run_window(benchmark::State& state,
+                const std::atomic<uint64_t>& wakes,
+                const size_t threads) {
+  const uint64_t switches_before = get_context_switches();
+  const uint64_t wakes_before = wakes.load();
+  const bench::PerfScope perf(state);
+  for (auto _ : state) {
+    std::this_thread::sleep_for(WINDOW);
+  }
+  state.counters["CtxSwitches"] = benchmark::Counter(
+      static_cast<double>(get_context_switches() - switches_before),
+      benchmark::Counter::kIsRate);
+  state.counters["Wakes"] = benchmark::Counter(
+      static_cast<double>(wakes.load() - wakes_before), benchmark::Counter::kIsRate);
+  state.counters["Threads"] = static_cast<double>(threads);
+}
+
+}  // namespace
+
+/// @brief a thread per stage
+static void BENCH_Stages_Threads(benchmark::State& state) {
+  std::atomic<uint64_t> wakes{0};
+  std::vector<std::jthread> stages;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    stages.emplace_back([&wakes](const std::stop_token& stoken) {
+      while (!stoken.stop_requested()) {
+        std::this_thread::sleep_for(PERIOD);
+        wakes.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  run_window(state, wakes, stages.size());
+}
+
+/// @brief the stages as coroutines on one loop
+static void BENCH_Stages_RunLoop(benchmark::State& state) {
+  std::atomic<uint64_t> wakes{0};
+  auto loop = std::make_unique<utils::RunLoop>("bench_loop");
+  loop->start();
+  std::stop_source stop;
+  std::vector<utils::TaskHandle> stages;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    stages.push_back(loop->spawn(poll_stage(wakes, stop.get_token())));
+  }
+  run_window(state, wakes, 1);
+  stop.request_stop();
+  for (const utils::TaskHandle& stage : stages) {
+    stage.wait();
+  }
+}
+
+BENCHMARK(BENCH_Stages_Threads)
+    ->ArgName("stages")
+    ->Arg(2)
+    ->Arg(5)
+    ->Iterations(20)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BENCH_Stages_RunLoop)
+    ->ArgName("stages")
+    ->Arg(2)
+    ->Arg(5)
+    ->Iterations(20)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+
+# ----------------------------------------------------------
+# BOLT post-link optimiser for a binary linked with TRADER_BOLT=ON
+#
+# How it works:
+# 1. Instrument: llvm-bolt writes an instrumented copy of the binary.
+# 2. Train: run the instrumented copy on a representative workload, it dumps a profile.
+# 3. Optimise: llvm-bolt lays out the original binary from that profile, hot code
+#    packed together, cold code split away.
+# Skips (exit 0) when llvm-bolt is not installed, the input binary is left untouched.
+#
+# usage: scripts/bolt.sh <binary> <output> -- <training command, {} is the binary>
+# e.g.   scripts/bolt.sh build/Pgo/benchmarks/benchmarks benchmarks.bolt -- {} --benchmark_filter=Pipeline
+# ----------------------------------------------------------
+
+set -euo pipefail
+
+if [ "$#" -lt 4 ] || [ "$3" != "--" ]; then
+    echo "usage: $0 <binary> <output> -- <training command, {} is the binary>"
+    exit 1
+fi
+binary=$1
+output=$2
+shift 3
+
+if ! command -v llvm-bolt > /dev/null; then
+    echo "llvm-bolt not found, skipping BOLT. binary [$binary]"
+    exit 0
+fi
+
+work_dir=$(mktemp -d)
+trap 'rm -rf "$work_dir"' EXIT
+instrumented="$work_dir/instrumented"
+profile="$work_dir/profile.fdata"
+
+echo "instrumenting. binary [$binary]"
+llvm-bolt "$binary" -instrument -instrumentation-file="$profile" -o "$instrumented"
+
+echo "training. command [$*]"
+training=()
+for arg in "$@"; do
+    training+=("${arg//\{\}/$instrumented}")
+done
+"${training[@]}"
+
+echo "optimising. output [$output]"
+llvm-bolt "$binary" -o "$output" -data="$profile" \
+    -reorder-blocks=ext-tsp \
+    -reorder-functions=cdsort \
+    -split-functions \
+    -split-all-cold \
+    -icf=1 \
+    -use-gnu-stack
@@ -17,18 +17,26 @@ timestamp = int(time.time() * 1e9)  # nanoseconds
 with open("bench_results.json") as f:
     data = json.load(f)
 
+# hardware counters per iteration, present when the benchmarks ran with --perf_counters
+PERF_FIELDS = ["cycles", "instructions", "IPC", "L1D-misses", "LLC-misses",
+               "branch-misses", "dTLB-misses"]
+
 lines = []
 for bm in data.get("benchmarks", []):
     name = bm["name"].replace(" ", "_").replace("/", "_")
     real_time = bm.get("real_time", 0.0)
     cpu_time = bm.get("cpu_time", 0.0)
     items_per_sec = bm.get("items_per_second", 0.0)
+    bytes_per_sec = bm.get("bytes_per_second", 0.0)
     iterations = bm.get("iterations", 0)
+    perf = "".join(
+        f",{field.replace('-', '_')}={bm[field]}" for field in PERF_FIELDS if field in bm
+    )
 
     # Line Protocol with 'source' as a tag
     line = (
         f"benchmarks,name={name},commit={commit},branch={branch},source={source} "
-        f"real_time={real_time},cpu_time={cpu_time},items_per_sec={items_per_sec},iterations={iterations} "
+        f"real_time={real_time},cpu_time={cpu_time},items_per_sec={items_per_sec},bytes_per_sec={bytes_per_sec},iterations={iterations}{perf} "
         f"{timestamp}"
     )
     lines.append(line)
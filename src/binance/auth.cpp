@@ -18,6 +18,8 @@
 #include <string>
 #include <vector>
 
+#include "spdlog/spdlog.h"
+
 namespace binance {
 
 Auth::Auth(std::string& api_key, std::string& private_pem_path)
@@ -25,6 +27,22 @@ Auth::Auth(std::string& api_key, std::string& private_pem_path)
   if (sodium_init() < 0) {
     throw std::runtime_error("libsodium failed to initialize");
   }
+  // keep the expanded key out of swap (and out of core dumps where supported).
+  // RLIMIT_MEMLOCK can deny this for unprivileged users, which is survivable.
+  if (sodium_mlock(secret_key_.data(), secret_key_.size()) == 0) {
+    is_key_locked_ = true;
+  } else {
+    spdlog::warn("could not lock signing key memory, key may be swapped to disk");
+  }
+}
+
+Auth::~Auth() {
+  if (is_key_locked_) {
+    // zeroes the memory before unlocking
+    sodium_munlock(secret_key_.data(), secret_key_.size());
+  } else {
+    sodium_memzero(secret_key_.data(), secret_key_.size());
+  }
 }
 
 const std::string& Auth::get_api_key() const {
@@ -32,14 +50,40 @@ const std::string& Auth::get_api_key() const {
 }
 
 std::string Auth::sign_payload(const std::string& payload) {
-  const std::vector<unsigned char> seed = get_seed_from_pem();
-  const std::string signature = sign_payload(payload, seed);
-  return signature;
+  std::lock_guard lock(mutex_);
+  if (!is_key_loaded_) {
+    load_keys_locked();
+  }
+  return sign_with_secret_key(payload, secret_key_);
+}
+
+void Auth::load_keys() {
+  std::lock_guard lock(mutex_);
+  if (!is_key_loaded_) {
+    load_keys_locked();
+  }
+}
+
+void Auth::load_keys_locked() {
+  std::vector<unsigned char> seed = read_seed_locked();
+  // the public key is embedded in the secret key, it is not needed separately
+  std::array<unsigned char, crypto_sign_PUBLICKEYBYTES> pk{};
+  const int rc = crypto_sign_seed_keypair(pk.data(), secret_key_.data(), seed.data());
+  sodium_memzero(seed.data(), seed.size());
+  if (rc != 0) {
+    sodium_memzero(secret_key_.data(), secret_key_.size());
+    throw std::runtime_error("Failed to generate keypair from seed");
+  }
+  is_key_loaded_ = true;
+  spdlog::info("loaded signing key. locked [{}]", is_key_locked_);
 }
 
 std::vector<unsigned char> Auth::get_seed_from_pem() const {
   std::lock_guard lock(mutex_);
+  return read_seed_locked();
+}
 
+std::vector<unsigned char> Auth::read_seed_locked() const {
   // fopen is unsafe, wrap in RAII
   const auto file_closer = [](gsl::owner<FILE*> fp) {
     if (fp) {
@@ -89,11 +133,20 @@ std::string Auth::sign_payload(const std::string& payload,
     throw std::runtime_error("Failed to generate keypair from seed");
   }
 
+  std::string signature = sign_with_secret_key(payload, sk);
+  sodium_memzero(sk.data(), sk.size());
+  return signature;
+}
+
+// static
+std::string Auth::sign_with_secret_key(
+    const std::string& payload,
+    const std::array<unsigned char, crypto_sign_SECRETKEYBYTES>& secret_key) {
   std::array<unsigned char, crypto_sign_BYTES> sig{};
   if (crypto_sign_detached(
           sig.data(), nullptr,
           static_cast<const unsigned char*>(static_cast<const void*>(payload.data())),
-          payload.size(), sk.data()) != 0) {
+          payload.size(), secret_key.data()) != 0) {
     throw std::runtime_error("Failed to sign payload");
   }
 
@@ -107,7 +160,10 @@ std::string Auth::sign_payload(const std::string& payload,
 }
 
 void Auth::clear_keys() {
+  std::lock_guard lock(mutex_);
   // logon successful, nullify access keys
+  sodium_memzero(secret_key_.data(), secret_key_.size());
+  is_key_loaded_ = false;
   std::ranges::fill(api_key_, 0);
   api_key_.clear();
   std::ranges::fill(private_pem_path_, 0);
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <sodium/crypto_sign.h>
+
+#include <array>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -13,11 +16,15 @@ namespace binance {
 class Auth final : public IAuth {
  public:
   Auth(std::string& api_key, std::string& private_pem_path);
+  ~Auth() override;
 
-  /// Generate a payload signature using a private key.
-  /// Expand the key to a 64-byte secret key (using libsodium), sign a payload,
-  /// output base64 signature.
-  /// This function will fetch the PEM file from disk.
+  // the expanded key lives in locked memory owned by this instance
+  Auth(const Auth&) = delete;
+  Auth& operator=(const Auth&) = delete;
+
+  /// Generate a payload signature using the cached private key.
+  /// The key is loaded from the PEM file and expanded on first use (see
+  /// @ref binance::Auth::load_keys ), subsequent calls sign from memory.
   /// @param payload payload to be signed
   /// @return base64 payload signature
   std::string sign_payload(const std::string& payload) override;
@@ -37,15 +44,35 @@ class Auth final : public IAuth {
   /// @return 32-byte Ed25519 seed
   std::vector<unsigned char> get_seed_from_pem() const;
 
+  /// Read the PEM file once and expand the seed into a 64-byte secret key, held in
+  /// locked (non-swappable) memory. Idempotent - later calls are no-ops.
+  /// Call at startup to keep file I/O and key derivation off the logon path.
+  void load_keys();
+
   void clear_keys() override;
 
  private:
   // when authenticating with Binance, each session authenticates independently,
-  // and in parallel. requires synchronisation because of file access.
+  // and in parallel. requires synchronisation because of file access and key loading.
   alignas(utils::Env::CACHE_LINE_SIZE) mutable std::mutex mutex_;
 
   std::string& api_key_;
   std::string& private_pem_path_;
+
+  /// @brief expanded Ed25519 secret key (seed + public key), locked with `sodium_mlock`
+  alignas(utils::Env::CACHE_LINE_SIZE)
+      std::array<unsigned char, crypto_sign_SECRETKEYBYTES> secret_key_{};
+  bool is_key_loaded_ = false;
+  bool is_key_locked_ = false;
+
+  /// @brief load keys, caller must hold `mutex_`
+  void load_keys_locked();
+  /// @brief read the PEM file, caller must hold `mutex_`
+  std::vector<unsigned char> read_seed_locked() const;
+  /// @brief sign a payload with an expanded 64-byte secret key, output base64
+  static std::string sign_with_secret_key(
+      const std::string& payload,
+      const std::array<unsigned char, crypto_sign_SECRETKEYBYTES>& secret_key);
 };
 
 }  // namespace binance
@@ -1,9 +1,13 @@
 #include "config.h"
 
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
 #include <format>
 #include <ranges>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../utils/env.h"
@@ -56,8 +60,34 @@ Config Config::from_env() {
 
   spdlog::info("MAX_DEPTH, value [{}]", MAX_DEPTH);
 
+  // optional
+  bool is_dual_depth = false;
+  if (const char* val = std::getenv("PX_DUAL_DEPTH")) {
+    const std::string_view str{val};
+    is_dual_depth = str == "1" || str == "true";
+    spdlog::info("fetched envar. key [PX_DUAL_DEPTH], value [{}]", str);
+  }
+  if (is_dual_depth && MAX_DEPTH == 1) {
+    spdlog::warn("dual depth needs a depth above 1, subscribing once. depth [{}]",
+                 MAX_DEPTH);
+    is_dual_depth = false;
+  }
+  // the levels past the subscription's window are stale, by default
+  size_t book_max_levels = MAX_DEPTH;
+  if (const char* val = std::getenv("BOOK_MAX_LEVELS")) {
+    const std::string_view str{val};
+    const auto [ptr, ec] =
+        std::from_chars(str.data(), str.data() + str.size(), book_max_levels);
+    if (ec != std::errc() || ptr != str.data() + str.size()) {
+      throw std::runtime_error(
+          std::format("could not parse book max levels, value [{}]", str));
+    }
+  }
+  spdlog::info("fetched envar. key [BOOK_MAX_LEVELS], value [{}]", book_max_levels);
+
   // copy
-  return Config{api_key, private_key, fix_config, symbols, px_cpu, tx_cpu};
+  return Config{api_key, private_key, fix_config,    symbols,
+                px_cpu,  tx_cpu,      is_dual_depth, book_max_levels};
 };
 
 }  // namespace binance
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <format>
 #include <stdexcept>
@@ -19,6 +20,12 @@ struct Config {
   const std::vector<std::string> symbols;
   const uint8_t px_cpu;
   const uint8_t tx_cpu;
+  /// @brief subscribe to the top of book (depth 1) alongside the deep book, and fuse
+  /// the two ( @ref binance::FeedArbiter )
+  const bool is_dual_depth;
+  /// @brief levels kept a side of the book, the worst beyond are dropped
+  /// ( @ref core::OrderBook::set_max_levels ). 0 for unbounded
+  const size_t book_max_levels;
 
   // Constructor that initializes all const members
   Config(std::string api,
@@ -26,13 +33,17 @@ struct Config {
          std::string fix_config,
          std::vector<std::string> syms,
          uint8_t px,
-         uint8_t tx)
+         uint8_t tx,
+         bool dual_depth = false,
+         size_t max_levels = MAX_DEPTH)
       : api_key(std::move(api)),
         private_key_path(std::move(private_key)),
         fix_config_path(std::move(fix_config)),
         symbols(std::move(syms)),
         px_cpu(px),
-        tx_cpu(tx) {}
+        tx_cpu(tx),
+        is_dual_depth(dual_depth),
+        book_max_levels(max_levels) {}
 
   /// @brief load Binance configuration parameters from environment variables
   static Config from_env();
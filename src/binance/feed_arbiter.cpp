@@ -0,0 +1,316 @@
+#include "feed_arbiter.h"
+
+#include <quickfix/FieldMap.h>
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "../utils/double.h"
+#include "config.h"
+#include "market_message_variant.h"
+#include "spdlog/spdlog.h"
+#include "symbol.h"
+#include "top_of_book.h"
+
+namespace binance {
+
+/// @brief Binance update ids exceed 32 bits, so they can't be read as `FIX::IntField`
+static std::optional<uint64_t> to_uint64(const std::string& str) {
+  uint64_t value = 0;
+  const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+  if (ec != std::errc() || ptr != str.data() + str.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+FeedArbiter::FeedArbiter(moodycamel::ConcurrentQueue<MarketMessageVariant>& queue,
+                         const bool is_dual_depth)
+    : queue_(queue), is_arbitrating_(is_dual_depth) {}
+
+bool FeedArbiter::on_snapshot(const FIX44::MarketDataSnapshotFullRefresh& msg,
+                              const FeedSource source) {
+  if (!is_arbitrating_.load(std::memory_order_relaxed)) {
+    queue_.enqueue(MarketMessageVariant{msg});
+    return true;
+  }
+  const std::optional<UpdateIds> ids = get_update_ids(msg);
+  std::lock_guard lock(mutex_);
+  if (!is_accepted_locked(ids, source, true)) {
+    return false;
+  }
+  queue_.enqueue(MarketMessageVariant{msg});
+  on_forwarded_locked(source);
+  return true;
+}
+
+bool FeedArbiter::on_increment(const FIX44::MarketDataIncrementalRefresh& msg,
+                               const FeedSource source) {
+  // the primary alone: the hot path, nothing to check
+  if (!is_arbitrating_.load(std::memory_order_relaxed)) {
+    queue_.enqueue(MarketMessageVariant{msg});
+    return true;
+  }
+  const std::optional<UpdateIds> ids = get_update_ids(msg);
+  std::lock_guard lock(mutex_);
+  if (!is_accepted_locked(ids, source, false)) {
+    return false;
+  }
+  queue_.enqueue(MarketMessageVariant{msg});
+  on_forwarded_locked(source);
+  return true;
+}
+
+bool FeedArbiter::on_top(const FIX44::MarketDataSnapshotFullRefresh& msg,
+                         const FeedSource source) {
+  return forward_top(get_top(msg), source);
+}
+
+bool FeedArbiter::on_top(const FIX44::MarketDataIncrementalRefresh& msg,
+                         const FeedSource source) {
+  return forward_top(get_top(msg), source);
+}
+
+bool FeedArbiter::forward_top(const std::optional<TopOfBook>& top,
+                              const FeedSource source) {
+  // without an update id it can't be placed against the deep stream
+  if (!top) {
+    return false;
+  }
+  std::lock_guard lock(mutex_);
+  if (!is_top_accepted_locked(*top)) {
+    return false;
+  }
+  queue_.enqueue(MarketMessageVariant{*top});
+  on_forwarded_locked(source);
+  ++stats_.top_forwarded;
+  return true;
+}
+
+void FeedArbiter::on_session_created(const FeedSource source) {
+  if (source == FeedSource::STANDBY) {
+    is_arbitrating_.store(true, std::memory_order_relaxed);
+  }
+}
+
+void FeedArbiter::on_session_up(const FeedSource source) {
+  std::lock_guard lock(mutex_);
+  is_up_[to_index(source)] = true;
+  spdlog::info("price feed up. source [{}]", to_str_view(source));
+}
+
+void FeedArbiter::on_session_down(const FeedSource source) {
+  std::lock_guard lock(mutex_);
+  is_up_[to_index(source)] = false;
+  // the standby dropped while the primary feeds the book: nothing to fail over
+  if (source == FeedSource::STANDBY && is_up_[to_index(FeedSource::PRIMARY)]) {
+    spdlog::warn("price feed down, primary still up. source [{}]", to_str_view(source));
+    return;
+  }
+  if (is_up_[to_index(other(source))]) {
+    failover_started_ = std::chrono::steady_clock::now();
+    spdlog::warn("price feed down, failing over. from [{}], to [{}]",
+                 to_str_view(source), to_str_view(other(source)));
+  } else {
+    spdlog::error("price feed down, no standby available. source [{}]",
+                  to_str_view(source));
+  }
+}
+
+FeedArbiter::Stats FeedArbiter::get_stats() const {
+  std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+bool FeedArbiter::is_accepted_locked(const std::optional<UpdateIds>& ids,
+                                     const FeedSource source,
+                                     const bool is_snapshot) {
+  // without update ids there's nothing to deduplicate on - only take the primary's,
+  // unless it's down
+  if (!ids) {
+    return source == FeedSource::PRIMARY || !is_up_[to_index(FeedSource::PRIMARY)];
+  }
+
+  const uint16_t sym = Symbol::to_uint(ids->symbol);
+  if (sym >= SYMBOL_COUNT_) {
+    spdlog::error("feed arbiter, unsupported symbol. value [{}]", sym);
+    return false;
+  }
+  uint64_t& last = last_update_id_[sym];
+  if (ids->last <= last) {
+    ++stats_.duplicates;
+    return false;
+  }
+  // a snapshot replaces the book wholesale, so it can't leave a gap
+  if (!is_snapshot && last != 0 && ids->first > last + 1) {
+    ++stats_.gaps;
+    spdlog::warn("price feed gap. source [{}], expected [{}], received [{}]",
+                 to_str_view(source), last + 1, ids->first);
+  }
+  last = ids->last;
+  return true;
+}
+
+bool FeedArbiter::is_top_accepted_locked(const TopOfBook& top) {
+  const uint16_t sym = Symbol::to_uint(top.symbol);
+  if (sym >= SYMBOL_COUNT_) {
+    spdlog::error("feed arbiter, unsupported symbol. value [{}]", sym);
+    return false;
+  }
+  uint64_t& last_top = last_top_update_id_[sym];
+  if (top.last_update_id <= last_top) {
+    ++stats_.duplicates;
+    return false;
+  }
+  // the deep stream has already forwarded this update, and everything before it
+  if (top.last_update_id <= last_update_id_[sym]) {
+    ++stats_.top_behind;
+    return false;
+  }
+  last_top = top.last_update_id;
+  return true;
+}
+
+void FeedArbiter::on_forwarded_locked(const FeedSource source) {
+  ++stats_.forwarded;
+  if (failover_started_ && is_up_[to_index(source)] &&
+      !is_up_[to_index(other(source))]) {
+    stats_.last_failover_time = std::chrono::steady_clock::now() - *failover_started_;
+    ++stats_.failovers;
+    failover_started_.reset();
+    spdlog::warn("price feed failed over. to [{}], time ns [{}]", to_str_view(source),
+                 stats_.last_failover_time.count());
+  }
+}
+
+// static
+std::optional<FeedArbiter::UpdateIds> FeedArbiter::get_update_ids(
+    const FIX44::MarketDataSnapshotFullRefresh& msg) {
+  if (!msg.isSetField(FIX::FIELD::Symbol) || !msg.isSetField(LAST_BOOK_UPDATE_ID_TAG)) {
+    return std::nullopt;
+  }
+  const std::optional<uint64_t> last = to_uint64(msg.getField(LAST_BOOK_UPDATE_ID_TAG));
+  if (!last) {
+    return std::nullopt;
+  }
+  return UpdateIds{Symbol::from_str(msg.getField(FIX::FIELD::Symbol)), *last, *last};
+}
+
+// static
+std::optional<FeedArbiter::UpdateIds> FeedArbiter::get_update_ids(
+    const FIX44::MarketDataIncrementalRefresh& msg) {
+  if (!msg.hasGroup(1, FIX::FIELD::NoMDEntries)) {
+    return std::nullopt;
+  }
+  // by reference: a copy of the group per message is the cost arbitration adds
+  const FIX::FieldMap& group = msg.getGroupRef(1, FIX::FIELD::NoMDEntries);
+  if (!group.isSetField(FIX::FIELD::Symbol) ||
+      !group.isSetField(LAST_BOOK_UPDATE_ID_TAG)) {
+    return std::nullopt;
+  }
+  const std::optional<uint64_t> last = to_uint64(group.getField(LAST_BOOK_UPDATE_ID_TAG));
+  if (!last) {
+    return std::nullopt;
+  }
+  std::optional<uint64_t> first = last;
+  if (group.isSetField(FIRST_BOOK_UPDATE_ID_TAG)) {
+    first = to_uint64(group.getField(FIRST_BOOK_UPDATE_ID_TAG));
+  }
+  return UpdateIds{Symbol::from_str(group.getField(FIX::FIELD::Symbol)),
+                   first.value_or(*last), *last};
+}
+
+// static
+std::optional<FeedArbiter::UpdateIds> FeedArbiter::get_update_ids(const TopOfBook& top) {
+  return UpdateIds{top.symbol, top.last_update_id, top.last_update_id};
+}
+
+// static
+std::optional<TopOfBook> FeedArbiter::get_top(
+    const FIX44::MarketDataSnapshotFullRefresh& msg) {
+  const std::optional<UpdateIds> ids = get_update_ids(msg);
+  if (!ids) {
+    return std::nullopt;
+  }
+  TopOfBook top{.symbol = ids->symbol, .last_update_id = ids->last};
+  FIX44::MarketDataSnapshotFullRefresh::NoMDEntries group;
+  FIX::MDEntryType e_tp;
+  FIX::MDEntryPx e_px;
+  FIX::MDEntrySize e_sz;
+  for (int i = 1; msg.hasGroup(i, FIX::FIELD::NoMDEntries); ++i) {
+    msg.getGroup(i, group);
+    group.get(e_tp);
+    const TopOfBook::Level level{
+        .px = Config::price_to_ticks(group.get(e_px).getValue(), top.symbol),
+        .sz = utils::Double::toUint64(group.get(e_sz).getValue(),
+                                      Config::get_size_ticks_per_unit(top.symbol))};
+    // one level a side at depth 1, else the best
+    if (e_tp == FIX::MDEntryType_BID) {
+      if (!top.bid || level.px > top.bid->px) {
+        top.bid = level;
+      }
+    } else if (e_tp == FIX::MDEntryType_OFFER) {
+      if (!top.ask || level.px < top.ask->px) {
+        top.ask = level;
+      }
+    }
+  }
+  return top;
+}
+
+// static
+std::optional<TopOfBook> FeedArbiter::get_top(
+    const FIX44::MarketDataIncrementalRefresh& msg) {
+  const std::optional<UpdateIds> ids = get_update_ids(msg);
+  if (!ids) {
+    return std::nullopt;
+  }
+  TopOfBook top{.symbol = ids->symbol, .last_update_id = ids->last};
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries group;
+  FIX::MDEntryType e_tp;
+  FIX::MDUpdateAction action;
+  FIX::MDEntryPx e_px;
+  FIX::MDEntrySize e_sz;
+  for (int i = 1; msg.hasGroup(i, FIX::FIELD::NoMDEntries); ++i) {
+    msg.getGroup(i, group);
+    group.get(e_tp);
+    group.get(action);
+    TopOfBook::Level level{
+        .px = Config::price_to_ticks(group.get(e_px).getValue(), top.symbol)};
+    if (action != FIX::MDUpdateAction_DELETE) {
+      level.sz = utils::Double::toUint64(group.get(e_sz).getValue(),
+                                         Config::get_size_ticks_per_unit(top.symbol));
+    }
+    // the new best wins over the delete of the old one, in either order: a delete
+    // stands only as the side's one entry
+    std::optional<TopOfBook::Level>* side = nullptr;
+    if (e_tp == FIX::MDEntryType_BID) {
+      side = &top.bid;
+    } else if (e_tp == FIX::MDEntryType_OFFER) {
+      side = &top.ask;
+    }
+    if (side != nullptr && (level.sz != 0 || !*side || (*side)->sz == 0)) {
+      *side = level;
+    }
+  }
+  return top;
+}
+
+// static
+std::string_view FeedArbiter::to_str_view(const FeedSource source) {
+  switch (source) {
+    case FeedSource::PRIMARY:
+      return "PRIMARY";
+    case FeedSource::STANDBY:
+      return "STANDBY";
+  }
+  return "UNKNOWN";
+}
+
+}  // namespace binance
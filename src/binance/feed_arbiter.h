@@ -0,0 +1,154 @@
+#pragma once
+
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+#include "../utils/env.h"
+#include "concurrentqueue.h"
+#include "market_message_variant.h"
+#include "symbol.h"
+#include "top_of_book.h"
+
+namespace binance {
+
+/// @brief the price session a market message arrived on
+enum class FeedSource : uint8_t {
+  PRIMARY = 0,
+  STANDBY = 1,
+};
+
+/// @brief Merges the primary and the (optional) hot-standby price sessions into one
+/// ordered stream of book messages.
+/// Both sessions subscribe to the same book, so every update arrives twice. Only
+/// messages that advance the book (by Binance's `LastBookUpdateID`) are forwarded,
+/// whichever session delivers them first. When the primary drops, the standby's next
+/// message is forwarded straight away - no reconnect wait, no snapshot gap.
+/// Book levels carry absolute sizes, so a message that partially overlaps what was
+/// already forwarded is still safe to apply.
+/// With a depth-1 subscription alongside the deep one, its best bid and offer are
+/// forwarded as @ref binance::TopOfBook when they are ahead of the deep stream (by the
+/// same update ids), and dropped once the deep stream has got there first.
+/// With neither a standby nor a depth-1 stream there is nothing to arbitrate: the book
+/// messages are queued as they come, without reading their ids or taking the lock.
+class FeedArbiter {
+ public:
+  /// @brief Binance custom fields, not part of the FIX spec
+  static inline constexpr int FIRST_BOOK_UPDATE_ID_TAG = 25043;
+  static inline constexpr int LAST_BOOK_UPDATE_ID_TAG = 25044;
+
+  /// @brief book update ids carried by a market message
+  struct UpdateIds {
+    SymbolEnum symbol;
+    uint64_t first;
+    uint64_t last;
+  };
+
+  /// @brief counters, for monitoring. only of arbitrated messages
+  struct Stats {
+    uint64_t forwarded = 0;
+    uint64_t duplicates = 0;
+    uint64_t gaps = 0;
+    uint64_t failovers = 0;
+    /// @brief depth-1 messages forwarded ahead of the deep stream
+    uint64_t top_forwarded = 0;
+    /// @brief depth-1 messages the deep stream had already covered
+    uint64_t top_behind = 0;
+    /// @brief time from a session dropping to the other session's first forwarded
+    /// message
+    std::chrono::nanoseconds last_failover_time{0};
+  };
+
+  /// @param is_dual_depth a depth-1 stream comes alongside the deep one: always
+  /// arbitrated
+  explicit FeedArbiter(moodycamel::ConcurrentQueue<MarketMessageVariant>& queue,
+                       bool is_dual_depth = false);
+
+  /// @brief forward a snapshot if it is newer than the book the consumer holds.
+  /// runs on the FIX session threads
+  /// @return true if the message was forwarded
+  bool on_snapshot(const FIX44::MarketDataSnapshotFullRefresh& msg, FeedSource source);
+  /// @brief forward an increment if it advances the book.
+  /// runs on the FIX session threads
+  /// @return true if the message was forwarded
+  bool on_increment(const FIX44::MarketDataIncrementalRefresh& msg, FeedSource source);
+  /// @brief forward the best bid and offer of a depth-1 subscription's message if it is
+  /// ahead of both streams. runs on the FIX session threads
+  /// @return true if the message was forwarded
+  bool on_top(const FIX44::MarketDataSnapshotFullRefresh& msg, FeedSource source);
+  bool on_top(const FIX44::MarketDataIncrementalRefresh& msg, FeedSource source);
+
+  /// @brief a session is configured. before any session logs on: a standby turns
+  /// arbitration on
+  void on_session_created(FeedSource source);
+  /// @brief a session logged on
+  void on_session_up(FeedSource source);
+  /// @brief a session logged out, or dropped
+  void on_session_down(FeedSource source);
+
+  Stats get_stats() const;
+
+  /// @brief read the symbol and `LastBookUpdateID` of a snapshot
+  static std::optional<UpdateIds> get_update_ids(
+      const FIX44::MarketDataSnapshotFullRefresh& msg);
+  /// @brief read the symbol and `First/LastBookUpdateID` of an increment.
+  /// Binance only sets the ids on the first entry of each message.
+  static std::optional<UpdateIds> get_update_ids(
+      const FIX44::MarketDataIncrementalRefresh& msg);
+  static std::optional<UpdateIds> get_update_ids(const TopOfBook& top);
+  /// @brief read the best bid and offer of a depth-1 subscription's snapshot
+  static std::optional<TopOfBook> get_top(
+      const FIX44::MarketDataSnapshotFullRefresh& msg);
+  /// @brief read the best bid and offer of a depth-1 subscription's increment, the last
+  /// entry of each side
+  static std::optional<TopOfBook> get_top(const FIX44::MarketDataIncrementalRefresh& msg);
+
+  static std::string_view to_str_view(FeedSource source);
+
+ private:
+  static inline constexpr size_t SOURCE_COUNT_ = 2;
+  static inline constexpr size_t SYMBOL_COUNT_ = 2;
+
+  // both session threads forward through here. the check-and-enqueue must be atomic,
+  // otherwise two sessions could enqueue out of order
+  alignas(utils::Env::CACHE_LINE_SIZE) mutable std::mutex mutex_;
+  moodycamel::ConcurrentQueue<MarketMessageVariant>& queue_;
+  /// @brief a standby or a depth-1 stream: else the book messages skip the checks.
+  /// set before the sessions' threads start
+  std::atomic<bool> is_arbitrating_;
+  /// @brief last book update id forwarded, per symbol
+  std::array<uint64_t, SYMBOL_COUNT_> last_update_id_{};
+  /// @brief last depth-1 update id forwarded, per symbol
+  std::array<uint64_t, SYMBOL_COUNT_> last_top_update_id_{};
+  std::array<bool, SOURCE_COUNT_> is_up_{};
+  /// @brief when a session went down, while the other one is expected to take over
+  std::optional<std::chrono::steady_clock::time_point> failover_started_;
+  Stats stats_;
+
+  /// @brief decide whether to forward, caller must hold `mutex_`
+  bool is_accepted_locked(const std::optional<UpdateIds>& ids,
+                          FeedSource source,
+                          bool is_snapshot);
+  /// @brief decide whether to forward a depth-1 message, caller must hold `mutex_`
+  bool is_top_accepted_locked(const TopOfBook& top);
+  /// @brief the shared tail of the `on_top` overloads
+  bool forward_top(const std::optional<TopOfBook>& top, FeedSource source);
+  /// @brief account for a forwarded message, caller must hold `mutex_`
+  void on_forwarded_locked(FeedSource source);
+
+  static constexpr size_t to_index(const FeedSource s) noexcept {
+    return static_cast<size_t>(s);
+  }
+  static constexpr FeedSource other(const FeedSource s) noexcept {
+    return s == FeedSource::PRIMARY ? FeedSource::STANDBY : FeedSource::PRIMARY;
+  }
+};
+
+}  // namespace binance
@@ -10,38 +10,77 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <format>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "../utils/flight_recorder.h"
+#include "../utils/thread_placement.h"
 #include "../utils/threading.h"
 #include "message_handling_mode.h"
 #include "spdlog/spdlog.h"
 
 namespace binance {
 
+namespace {
+
+/// @brief the session a message arrived on, as kept by the flight recorder
+enum FlightSession : uint32_t {
+  FLIGHT_PX = 0,
+  FLIGHT_PX_STANDBY = 1,
+  FLIGHT_TX = 2,
+  FLIGHT_OTHER = 3,
+};
+
+/// @brief keep the receipt of `msg` in the flight recorder, by its MsgSeqNum
+void record_received(const utils::FlightEvent event,
+                     const FlightSession session,
+                     const FIX::Message& msg) {
+  FIX::MsgSeqNum seq_num;
+  uint64_t seq = 0;
+  if (msg.getHeader().getFieldIfSet(seq_num)) {
+    seq = static_cast<uint64_t>(seq_num.getValue());
+  }
+  utils::FlightRecorder::global().record(event, session, seq);
+}
+
+}  // namespace
+
 // PUBLIC
 
 FixApp::FixApp(const std::vector<std::string>& symbols,
                std::unique_ptr<IAuth> auth,
                const uint16_t MAX_DEPTH,
                const uint8_t px_cpu,
-               const uint8_t tx_cpu)
-    : symbols_(symbols),
+               const uint8_t tx_cpu,
+               const bool is_dual_depth)
+    : feed_arbiter_(order_queue_, is_dual_depth),
+      symbols_(symbols),
       auth_(std::move(auth)),
       MAX_DEPTH_(MAX_DEPTH),
       px_cpu_(px_cpu),
-      tx_cpu_(tx_cpu) {}
+      tx_cpu_(tx_cpu),
+      is_dual_depth_(is_dual_depth) {}
 
 void FixApp::subscribe_to_prices(const FIX::SessionID& session_id) const {
-  spdlog::info("subscribing to depth. qualifier [{}], id [{}]",
-               session_id.getSessionQualifier(), session_id.toString());
+  // Generate a unique request ID for this session's request
+  const std::string time = std::to_string(std::time(nullptr));
+  subscribe_to_depth(session_id, MAX_DEPTH_, "MDReq-" + time);
+  if (is_dual_depth_) {
+    // the top moves on every book update, the deep book on the deep stream's cadence
+    subscribe_to_depth(session_id, 1, TOP_MD_REQ_ID_PREFIX_ + time);
+  }
+}
 
-  FIX44::MarketDataRequest md_req;
+void FixApp::subscribe_to_depth(const FIX::SessionID& session_id,
+                                const uint16_t depth,
+                                const std::string& req_id) const {
+  spdlog::info("subscribing to depth. qualifier [{}], id [{}], depth [{}], req id [{}]",
+               session_id.getSessionQualifier(), session_id.toString(), depth, req_id);
 
-  // Generate a unique request ID for this session's request
-  const std::string req_id = "MDReq-" + std::to_string(std::time(nullptr));
+  FIX44::MarketDataRequest md_req;
   md_req.set(FIX::MDReqID(req_id));
 
   // Set subscription type (1 = Subscribe)
@@ -49,7 +88,7 @@ void FixApp::subscribe_to_prices(const FIX::SessionID& session_id) const {
       FIX::SubscriptionRequestType(FIX::SubscriptionRequestType_SNAPSHOT_PLUS_UPDATES));
 
   // NB: Careful with Binance depth, use either 1 or 5000
-  md_req.set(FIX::MarketDepth(MAX_DEPTH_));
+  md_req.set(FIX::MarketDepth(depth));
 
   // Create NoMDEntryTypes group for requesting BID and OFFER
   FIX44::MarketDataRequest::NoMDEntryTypes e_types;
@@ -120,6 +159,9 @@ static std::string replace_soh(const std::string& input) {
 void FixApp::onCreate(const FIX::SessionID& sessionId) {
   spdlog::info("session created. qualifier [{}], id [{}]",
                sessionId.getSessionQualifier(), sessionId.toString());
+  if (sessionId.getSessionQualifier() == PX_STANDBY_SESSION_QUALIFIER_) {
+    feed_arbiter_.on_session_created(FeedSource::STANDBY);
+  }
 };
 void FixApp::onLogon(const FIX::SessionID& sessionId) {
   spdlog::info("Session logon, qualifier [{}], id [{}]", sessionId.getSessionQualifier(),
@@ -133,12 +175,23 @@ void FixApp::onLogon(const FIX::SessionID& sessionId) {
   spdlog::info("naming FIX session thread, name [{}], id [{}]", thread_name,
                utils::Threading::get_os_thread_id());
 
+  // placed by role if planned, else on the configured cpus
+  const bool is_placed = utils::ThreadPlacement::pin_current_thread(thread_name);
   if (sessionId.getSessionQualifier() == PX_SESSION_QUALIFIER_) {
-    utils::Threading::set_thread_cpu(px_cpu_);
+    if (!is_placed) {
+      utils::Threading::set_thread_cpu(px_cpu_);
+    }
     utils::Threading::set_thread_realtime();
+    feed_arbiter_.on_session_up(FeedSource::PRIMARY);
+    subscribe_to_prices(sessionId);
+  } else if (sessionId.getSessionQualifier() == PX_STANDBY_SESSION_QUALIFIER_) {
+    // NB: not pinned to the PX cpu, two realtime threads would starve each other there
+    feed_arbiter_.on_session_up(FeedSource::STANDBY);
     subscribe_to_prices(sessionId);
   } else if (sessionId.getSessionQualifier() == TX_SESSION_QUALIFIER_) {
-    utils::Threading::set_thread_cpu(tx_cpu_);
+    if (!is_placed) {
+      utils::Threading::set_thread_cpu(tx_cpu_);
+    }
     subscribe_to_trades(sessionId);
   } else if (sessionId.getSessionQualifier() == OX_SESSION_QUALIFIER_) {
     // do nothing for order session
@@ -150,6 +203,11 @@ void FixApp::onLogon(const FIX::SessionID& sessionId) {
 void FixApp::onLogout(const FIX::SessionID& sessionId) {
   spdlog::info("session logout. qualifier [{}], id [{}]", sessionId.getSessionQualifier(),
                sessionId.toString());
+  if (sessionId.getSessionQualifier() == PX_SESSION_QUALIFIER_) {
+    feed_arbiter_.on_session_down(FeedSource::PRIMARY);
+  } else if (sessionId.getSessionQualifier() == PX_STANDBY_SESSION_QUALIFIER_) {
+    feed_arbiter_.on_session_down(FeedSource::STANDBY);
+  }
 };
 
 void FixApp::toAdmin(FIX::Message& msg, const FIX::SessionID& sessionId) {
@@ -212,17 +270,56 @@ void FixApp::fromApp(const FIX::Message& msg,
   FIX44::MessageCracker::crack(msg, sessionId);
 }
 
+bool FixApp::is_top_of_book(const FIX::Message& msg) const {
+  return is_dual_depth_ && msg.isSetField(FIX::FIELD::MDReqID) &&
+         msg.getField(FIX::FIELD::MDReqID).starts_with(TOP_MD_REQ_ID_PREFIX_);
+}
+
 void FixApp::onMessage(const FIX44::MarketDataSnapshotFullRefresh& m,
-                       [[maybe_unused]] const FIX::SessionID& sessionID) {
-  order_queue_.enqueue(MarketMessageVariant{m});
+                       const FIX::SessionID& sessionID) {
+  constexpr auto EVENT = utils::FlightEvent::FIX_SNAPSHOT;
+  if (sessionID.getSessionQualifier() == PX_SESSION_QUALIFIER_) {
+    record_received(EVENT, FLIGHT_PX, m);
+    if (is_top_of_book(m)) {
+      // only the top, it must not replace the deep book
+      feed_arbiter_.on_top(m, FeedSource::PRIMARY);
+    } else {
+      feed_arbiter_.on_snapshot(m, FeedSource::PRIMARY);
+    }
+  } else if (sessionID.getSessionQualifier() == PX_STANDBY_SESSION_QUALIFIER_) {
+    record_received(EVENT, FLIGHT_PX_STANDBY, m);
+    if (is_top_of_book(m)) {
+      feed_arbiter_.on_top(m, FeedSource::STANDBY);
+    } else {
+      feed_arbiter_.on_snapshot(m, FeedSource::STANDBY);
+    }
+  } else {
+    record_received(EVENT, FLIGHT_OTHER, m);
+    order_queue_.enqueue(MarketMessageVariant{m});
+  }
 }
 void FixApp::onMessage(const FIX44::MarketDataIncrementalRefresh& m,
                        const FIX::SessionID& sessionID) {
+  constexpr auto EVENT = utils::FlightEvent::FIX_INCREMENT;
   if (sessionID.getSessionQualifier() == PX_SESSION_QUALIFIER_) {
-    order_queue_.enqueue(MarketMessageVariant{m});
+    record_received(EVENT, FLIGHT_PX, m);
+    if (is_top_of_book(m)) {
+      feed_arbiter_.on_top(m, FeedSource::PRIMARY);
+    } else {
+      feed_arbiter_.on_increment(m, FeedSource::PRIMARY);
+    }
+  } else if (sessionID.getSessionQualifier() == PX_STANDBY_SESSION_QUALIFIER_) {
+    record_received(EVENT, FLIGHT_PX_STANDBY, m);
+    if (is_top_of_book(m)) {
+      feed_arbiter_.on_top(m, FeedSource::STANDBY);
+    } else {
+      feed_arbiter_.on_increment(m, FeedSource::STANDBY);
+    }
   } else if (sessionID.getSessionQualifier() == TX_SESSION_QUALIFIER_) {
+    record_received(EVENT, FLIGHT_TX, m);
     trade_queue_.enqueue(m);
   } else {
+    record_received(EVENT, FLIGHT_OTHER, m);
     spdlog::error(
         "invalid session for market data incremental refresh, qualifier [{}], id [{}]",
         sessionID.getSessionQualifier(), sessionID.toString());
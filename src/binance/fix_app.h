@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "concurrentqueue.h"
+#include "feed_arbiter.h"
 #include "iauth.h"
 #include "market_message_variant.h"
 
@@ -24,14 +25,16 @@ class FixApp final : public FIX::Application, public FIX44::MessageCracker {
          std::unique_ptr<IAuth> auth,
          const uint16_t MAX_DEPTH,
          const uint8_t px_cpu,
-         const uint8_t tx_cpu);
+         const uint8_t tx_cpu,
+         const bool is_dual_depth = false);
   ~FixApp() override = default;
 
   // Use the FIX44::MessageCracker to pull in the relevant overloads. This resolves the
   // ambiguity caused by multiple base classes having the same function name.
   using FIX44::MessageCracker::onMessage;
 
-  /// @brief
+  /// @brief subscribe to the book at `MAX_DEPTH`, and to its top (depth 1) as well if
+  /// dual depth
   void subscribe_to_prices(const FIX::SessionID& session_id) const;
   /// @brief
   void subscribe_to_trades(const FIX::SessionID& session_id) const;
@@ -40,6 +43,8 @@ class FixApp final : public FIX::Application, public FIX44::MessageCracker {
   moodycamel::ConcurrentQueue<MarketMessageVariant> order_queue_;
   /// @brief queue of trade messages from Binance
   moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> trade_queue_;
+  /// @brief deduplicates the primary and hot-standby price sessions onto `order_queue_`
+  FeedArbiter feed_arbiter_;
 
   // TODO: performance implication of a polymorphic queue
   // TODO: perhaps better to run two queues, or something else
@@ -48,13 +53,24 @@ class FixApp final : public FIX::Application, public FIX44::MessageCracker {
  private:
   static inline constexpr std::string THREAD_NAME_ = "fix_session";
   static inline constexpr std::string PX_SESSION_QUALIFIER_ = "PX";
+  /// @brief optional hot-standby price session, enabled by adding it to the fixconfig
+  static inline constexpr std::string PX_STANDBY_SESSION_QUALIFIER_ = "PXB";
   static inline constexpr std::string TX_SESSION_QUALIFIER_ = "TX";
   static inline constexpr std::string OX_SESSION_QUALIFIER_ = "OX";
+  /// @brief tells the depth-1 subscription's messages from the deep one's
+  static inline constexpr std::string TOP_MD_REQ_ID_PREFIX_ = "MDReqTop-";
   const std::vector<std::string>& symbols_;
   const std::unique_ptr<IAuth> auth_;
   const uint16_t MAX_DEPTH_;
   const uint8_t px_cpu_;
   const uint8_t tx_cpu_;
+  const bool is_dual_depth_;
+
+  void subscribe_to_depth(const FIX::SessionID& session_id,
+                          uint16_t depth,
+                          const std::string& req_id) const;
+  /// @brief from the depth-1 subscription of a dual-depth session, by its `MDReqID`
+  bool is_top_of_book(const FIX::Message& msg) const;
 
   void onCreate(const FIX::SessionID&) override;
   void onLogon(const FIX::SessionID&) override;
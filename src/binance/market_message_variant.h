@@ -5,12 +5,16 @@
 
 #include <variant>
 
+#include "top_of_book.h"
+
 namespace binance {
 
 /// @brief a union type for price-update messages,
 /// so that they can be placed on the same queue,
-/// so that order can be maintained
+/// so that order can be maintained.
+/// `TopOfBook` is the depth-1 stream's, when fused with the deep one
 using MarketMessageVariant = std::variant<FIX44::MarketDataSnapshotFullRefresh,
-                                          FIX44::MarketDataIncrementalRefresh>;
+                                          FIX44::MarketDataIncrementalRefresh,
+                                          TopOfBook>;
 
 }  // namespace binance
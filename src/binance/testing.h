@@ -0,0 +1,29 @@
+#pragma once
+
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+
+namespace binance {
+
+/// @brief FIX message builders for tests (see also @ref utils::Testing )
+class Testing {
+ public:
+  /// @brief a BTCUSDT increment of one entry. a DELETE carries no size
+  static FIX44::MarketDataIncrementalRefresh make_increment(const char action,
+                                                            const char type,
+                                                            const double px,
+                                                            const double sz) {
+    FIX44::MarketDataIncrementalRefresh msg;
+    FIX44::MarketDataIncrementalRefresh::NoMDEntries group;
+    group.set(FIX::Symbol("BTCUSDT"));
+    group.set(FIX::MDUpdateAction(action));
+    group.set(FIX::MDEntryType(type));
+    group.set(FIX::MDEntryPx(px));
+    if (action != FIX::MDUpdateAction_DELETE) {
+      group.set(FIX::MDEntrySize(sz));
+    }
+    msg.addGroup(group);
+    return msg;
+  }
+};
+
+}  // namespace binance
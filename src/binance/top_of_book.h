@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "symbol.h"
+
+namespace binance {
+
+/// @brief the best bid and offer from a depth-1 (book ticker) subscription, which
+/// Binance sends as the top moves rather than on the deep streams' cadence. Both
+/// streams share the book's update ids, which is what reconciles the two.
+/// prices and sizes in ticks
+struct TopOfBook {
+  /// @brief a side's best level. size 0: the level at `px` was deleted, and no new best
+  /// came with it
+  struct Level {
+    uint64_t px = 0;
+    uint64_t sz = 0;
+
+    bool operator==(const Level&) const = default;
+  };
+
+  SymbolEnum symbol = SymbolEnum::BTCUSDT;
+  /// @brief Binance's `LastBookUpdateID`, in the deep stream's sequence
+  uint64_t last_update_id = 0;
+  /// @brief nullopt for a side the message does not carry
+  std::optional<Level> bid = std::nullopt;
+  std::optional<Level> ask = std::nullopt;
+
+  bool operator==(const TopOfBook&) const = default;
+};
+
+}  // namespace binance
@@ -31,10 +31,13 @@ Worker::Worker(std::unique_ptr<FixApp> app,
 
 // static member function
 Worker Worker::from_conf(Config& conf) {
-  std::unique_ptr<IAuth> auth =
-      std::make_unique<Auth>(conf.api_key, conf.private_key_path);
+  auto signer = std::make_unique<Auth>(conf.api_key, conf.private_key_path);
+  // load and expand the signing key up front, so that (re)logons only sign.
+  // also fails fast on a bad key, before any connection is attempted
+  signer->load_keys();
+  std::unique_ptr<IAuth> auth = std::move(signer);
   auto app = std::make_unique<FixApp>(conf.symbols, std::move(auth), conf.MAX_DEPTH,
-                                      conf.px_cpu, conf.tx_cpu);
+                                      conf.px_cpu, conf.tx_cpu, conf.is_dual_depth);
   auto settings = FIX::SessionSettings{conf.fix_config_path};
   auto store = std::make_unique<FIX::FileStoreFactory>(settings);
   auto log = std::make_unique<FIX::FileLogFactory>(settings);
@@ -66,4 +69,8 @@ Worker::get_trade_queue() const {
   return app_->trade_queue_;
 }
 
+const FeedArbiter& Worker::get_feed_arbiter() const {
+  return app_->feed_arbiter_;
+}
+
 }  // namespace binance
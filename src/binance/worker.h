@@ -11,6 +11,7 @@
 
 #include "concurrentqueue.h"
 #include "config.h"
+#include "feed_arbiter.h"
 #include "fix_app.h"
 #include "market_message_variant.h"
 
@@ -35,6 +36,8 @@ class Worker final {
   moodycamel::ConcurrentQueue<MarketMessageVariant>& get_order_queue() const;
   moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh>& get_trade_queue()
       const;
+  /// @brief price-feed deduplication (primary/hot-standby), e.g. for its stats
+  const FeedArbiter& get_feed_arbiter() const;
 
  private:
   // FIX
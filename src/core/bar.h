@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+namespace core {
+
+/// @brief OHLCV bar, prices and sizes in ticks.
+/// trivially copyable, so that it can be published through a `utils::SeqLock`
+struct Bar {
+ public:
+  /// @brief start of the bar's time bucket (epoch microseconds). 0 == empty bar
+  uint64_t start_us = 0;
+  uint64_t open = 0;
+  uint64_t high = 0;
+  uint64_t low = 0;
+  uint64_t close = 0;
+  uint64_t volume = 0;
+  /// @brief volume where the buyer was the aggressor (Binance tag 2446)
+  uint64_t buy_volume = 0;
+  /// @brief volume where the seller was the aggressor (Binance tag 2446)
+  uint64_t sell_volume = 0;
+  /// @brief sum of price * size, in ticks^2.
+  /// NB: headroom - a day of BTCUSDT volume is ~1e16, uint64_t holds ~1.8e19
+  uint64_t notional = 0;
+  uint64_t trade_count = 0;
+
+  bool is_empty() const { return trade_count == 0; }
+
+  /// @brief volume-weighted average price, in price ticks
+  double vwap() const {
+    return volume == 0 ? 0.0
+                       : static_cast<double>(notional) / static_cast<double>(volume);
+  }
+
+  bool operator==(const Bar& other) const = default;
+};
+
+}  // namespace core
@@ -0,0 +1,251 @@
+#include "bbo_book.h"
+
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "../binance/config.h"
+#include "../binance/symbol.h"
+#include "../binance/top_of_book.h"
+#include "../utils/double.h"
+#include "bid_ask.h"
+#include "book_analytics.h"
+#include "level_mirror.h"
+#include "order_book.h"
+#include "spdlog/spdlog.h"
+
+namespace core {
+
+BboBook::BboBook(const BookAnalyticsConfig analytics_config)
+    : config_(analytics_config) {
+  published_.store(state_);
+}
+
+BboBook::BboBook(BboBook&& other) noexcept
+    : config_(other.config_), state_(other.state_) {
+  published_.store(state_);
+}
+
+// static function
+BboBook BboBook::from_levels(const std::span<const PriceLevel> bids,
+                             const std::span<const PriceLevel> asks,
+                             const uint64_t last_update_id) {
+  BboBook book;
+  if (!bids.empty()) {
+    book.state_.bid_px = bids.front().px;
+    book.state_.bid_sz = bids.front().sz;
+  }
+  if (!asks.empty()) {
+    book.state_.ask_px = asks.front().px;
+    book.state_.ask_sz = asks.front().sz;
+  }
+  book.state_.last_update_id = last_update_id;
+  book.state_.provisional = true;
+  book.published_.store(book.state_);
+  return book;
+}
+
+void BboBook::apply_snapshot(const FIX44::MarketDataSnapshotFullRefresh& msg) {
+  FIX::Symbol symbol;
+  msg.get(symbol);
+  spdlog::info("MD snapshot message. symbol [{}]", symbol.getString());
+
+  const binance::SymbolEnum sym = binance::Symbol::from_str(symbol.getValue());
+  if (sym != binance::SymbolEnum::BTCUSDT) {
+    spdlog::error("wrong symbol, skipping snapshot. value [{}]",
+                  binance::Symbol::to_str(sym));
+    return;
+  }
+
+  state_.bid_px = 0;
+  state_.bid_sz = 0;
+  state_.ask_px = 0;
+  state_.ask_sz = 0;
+  state_.last_update_id = OrderBook::read_last_update_id(msg).value_or(0);
+
+  FIX::NoMDEntries entries;
+  msg.get(entries);
+  const int num_entries = entries.getValue();
+  FIX44::MarketDataSnapshotFullRefresh::NoMDEntries group;
+  FIX::MDEntryType e_tp;
+  FIX::MDEntryPx e_px;
+  FIX::MDEntrySize e_sz;
+  for (int i = 1; i <= num_entries; i++) {
+    msg.getGroup(i, group);
+    group.get(e_tp);
+    group.get(e_px);
+    group.get(e_sz);
+    const uint64_t px = utils::Double::toUint64(
+        e_px.getValue(), binance::Config::get_price_ticks_per_unit(sym));
+    const uint64_t sz = utils::Double::toUint64(
+        e_sz.getValue(), binance::Config::get_size_ticks_per_unit(sym));
+    // the best of each side, whatever the entries' order
+    if (e_tp == FIX::MDEntryType_BID) {
+      if (state_.bid_sz == 0 || px > state_.bid_px) {
+        state_.bid_px = px;
+        state_.bid_sz = sz;
+      }
+    } else if (e_tp == FIX::MDEntryType_OFFER) {
+      if (state_.ask_sz == 0 || px < state_.ask_px) {
+        state_.ask_px = px;
+        state_.ask_sz = sz;
+      }
+    } else {
+      spdlog::error("unknown bid/offer type [{}]", e_tp.getString());
+    }
+  }
+  // the live book has replaced whatever the book was restored from
+  state_.provisional = false;
+  publish();
+}
+
+void BboBook::apply_increment(const FIX44::MarketDataIncrementalRefresh& msg) {
+  updates_.clear();
+  const std::optional<uint64_t> last_update_id =
+      OrderBook::to_level_updates(msg, updates_);
+  apply_levels(updates_, last_update_id);
+}
+
+void BboBook::apply_levels(const std::span<const LevelUpdate> updates,
+                           const std::optional<uint64_t> last_update_id) {
+  if (last_update_id) {
+    state_.last_update_id = *last_update_id;
+  }
+  for (const LevelUpdate& update : updates) {
+    if (update.symbol != binance::SymbolEnum::BTCUSDT) {
+      spdlog::error("wrong symbol, skipping price increment. value [{}]",
+                    binance::Symbol::to_str(update.symbol));
+      continue;
+    }
+    uint64_t& px = update.side == BookSide::BID ? state_.bid_px : state_.ask_px;
+    uint64_t& sz = update.side == BookSide::BID ? state_.bid_sz : state_.ask_sz;
+    if (update.sz != 0) {
+      px = update.px;
+      sz = update.sz;
+    } else if (update.px == px) {
+      // a delete of another price is of a level already replaced
+      px = 0;
+      sz = 0;
+    }
+  }
+  publish();
+}
+
+void BboBook::apply_top(const binance::TopOfBook& top) {
+  if (top.symbol != binance::SymbolEnum::BTCUSDT) {
+    spdlog::error("wrong symbol, skipping top of book. value [{}]",
+                  binance::Symbol::to_str(top.symbol));
+    return;
+  }
+  if (top.last_update_id <= state_.last_update_id) {
+    return;
+  }
+  state_.last_update_id = top.last_update_id;
+  if (top.bid) {
+    apply_top_level(*top.bid, state_.bid_px, state_.bid_sz);
+  }
+  if (top.ask) {
+    apply_top_level(*top.ask, state_.ask_px, state_.ask_sz);
+  }
+  publish();
+}
+
+std::vector<BidAsk> BboBook::to_vector() const {
+  std::array<BidAsk, 1> row;
+  return {row.begin(), row.begin() + top_levels(row)};
+}
+
+size_t BboBook::top_levels(const std::span<BidAsk> out) const {
+  const Bbo bbo = published_.load();
+  if (out.empty() || (bbo.bid_sz == 0 && bbo.ask_sz == 0)) {
+    return 0;
+  }
+  BidAsk& row = out.front();
+  row = BidAsk{};
+  if (bbo.bid_sz != 0) {
+    row.bid_px = bbo.bid_px;
+    row.bid_sz = bbo.bid_sz;
+  }
+  if (bbo.ask_sz != 0) {
+    row.ask_px = bbo.ask_px;
+    row.ask_sz = bbo.ask_sz;
+  }
+  return 1;
+}
+
+BookAnalytics BboBook::get_analytics() const {
+  const Bbo bbo = published_.load();
+  // one level a side, as `core::BookAnalyzer` folds a map's
+  std::vector<std::pair<uint64_t, uint64_t>> bids;
+  std::vector<std::pair<uint64_t, uint64_t>> asks;
+  if (bbo.bid_sz != 0) {
+    bids.emplace_back(bbo.bid_px, bbo.bid_sz);
+  }
+  if (bbo.ask_sz != 0) {
+    asks.emplace_back(bbo.ask_px, bbo.ask_sz);
+  }
+  BookAnalytics out;
+  BookAnalyzer::fold_touch(bids, config_, out.bid);
+  BookAnalyzer::fold_depth(bids, true, config_, out.bid);
+  BookAnalyzer::fold_touch(asks, config_, out.ask);
+  BookAnalyzer::fold_depth(asks, false, config_, out.ask);
+  out.finalize();
+  out.sequence = bbo.sequence;
+  return out;
+}
+
+OrderBook::LevelCounts BboBook::copy_levels(const std::span<PriceLevel> bids,
+                                            const std::span<PriceLevel> asks) const {
+  const Bbo bbo = published_.load();
+  OrderBook::LevelCounts counts{.last_update_id = bbo.last_update_id};
+  if (bbo.bid_sz != 0 && !bids.empty()) {
+    bids[counts.bids++] = PriceLevel{bbo.bid_px, bbo.bid_sz};
+  }
+  if (bbo.ask_sz != 0 && !asks.empty()) {
+    asks[counts.asks++] = PriceLevel{bbo.ask_px, bbo.ask_sz};
+  }
+  return counts;
+}
+
+uint64_t BboBook::get_last_update_id() const {
+  return published_.load().last_update_id;
+}
+
+bool BboBook::is_provisional() const {
+  return published_.load().provisional;
+}
+
+OrderBook::Footprint BboBook::get_footprint() const {
+  const Bbo bbo = published_.load();
+  return OrderBook::Footprint{
+      .bid_levels = bbo.bid_sz != 0 ? 1u : 0u,
+      .ask_levels = bbo.ask_sz != 0 ? 1u : 0u,
+      .bytes = sizeof(BboBook),
+  };
+}
+
+// static function
+void BboBook::apply_top_level(const binance::TopOfBook::Level& level,
+                              uint64_t& px,
+                              uint64_t& sz) {
+  if (level.sz != 0) {
+    px = level.px;
+    sz = level.sz;
+  } else if (level.px == px) {
+    px = 0;
+    sz = 0;
+  }
+}
+
+void BboBook::publish() {
+  ++state_.sequence;
+  published_.store(state_);
+}
+
+}  // namespace core
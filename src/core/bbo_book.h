@@ -0,0 +1,112 @@
+#pragma once
+
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "../binance/top_of_book.h"
+#include "../utils/env.h"
+#include "../utils/seqlock.h"
+#include "bid_ask.h"
+#include "book_analytics.h"
+#include "order_book.h"
+
+namespace core {
+
+/// @brief the best bid and offer, and what they are as of, in one cache line.
+/// prices and sizes in ticks, size 0 for an empty side
+struct alignas(utils::Env::CACHE_LINE_SIZE) Bbo {
+  uint64_t bid_px = 0;
+  uint64_t bid_sz = 0;
+  uint64_t ask_px = 0;
+  uint64_t ask_sz = 0;
+  /// @brief Binance's `LastBookUpdateID` of the last message applied, 0 if unknown
+  uint64_t last_update_id = 0;
+  /// @brief messages applied
+  uint64_t sequence = 0;
+  /// @brief see @ref core::OrderBook::is_provisional
+  bool provisional = false;
+
+  bool operator==(const Bbo&) const = default;
+};
+static_assert(sizeof(Bbo) == utils::Env::CACHE_LINE_SIZE, "must fit one cache line");
+
+/// @brief Top-of-book for depth-1 subscriptions (`MAX_DEPTH` 1), where a side only ever
+/// holds one level: instead of a btree cleared on every change, two price/size pairs
+/// set with plain stores and published through a @ref utils::SeqLock once per message.
+/// Readers copy the published line lock-free; the analytics are derived from it on
+/// read. Same interface as @ref core::OrderBook where the engine uses it, picked at
+/// compile time by @ref core::BookFor.
+/// Single writer.
+class BboBook {
+ public:
+  explicit BboBook(BookAnalyticsConfig analytics_config = {});
+  /// @brief the writer's state moves, readers of `other` must be done
+  BboBook(BboBook&& other) noexcept;
+  BboBook(const BboBook&) = delete;
+  BboBook& operator=(const BboBook&) = delete;
+
+  /// @brief a provisional book from the best of each side, e.g. a checkpoint's
+  /// @param bids best (highest) first
+  /// @param asks best (lowest) first
+  static BboBook from_levels(std::span<const PriceLevel> bids,
+                             std::span<const PriceLevel> asks,
+                             uint64_t last_update_id);
+
+  /// @brief keep the best level of each side of the snapshot
+  void apply_snapshot(const FIX44::MarketDataSnapshotFullRefresh& msg);
+  /// @brief a new or changed level replaces the side's, a deleted one empties it
+  void apply_increment(const FIX44::MarketDataIncrementalRefresh& msg);
+  /// @brief apply level updates, in order, as one message
+  /// @param last_update_id nullopt to keep the book's
+  void apply_levels(std::span<const LevelUpdate> updates,
+                    std::optional<uint64_t> last_update_id);
+  /// @brief replace the sides `top` carries, if it is newer than the book. a deleted
+  /// level empties its side only if it is the side's
+  void apply_top(const binance::TopOfBook& top);
+  /// @brief nothing to trim, a side only ever holds one level
+  void set_max_levels([[maybe_unused]] size_t max_levels) {}
+
+  // ─────────── Readers, any thread, lock-free ───────────
+
+  Bbo get_bbo() const { return published_.load(); }
+  /// @brief one row, or none if both sides are empty
+  std::vector<BidAsk> to_vector() const;
+  /// @brief see @ref core::OrderBook::top_levels
+  size_t top_levels(std::span<BidAsk> out) const;
+  /// @brief derived from the touch: best sizes, spread, microprice, imbalance
+  BookAnalytics get_analytics() const;
+  /// @brief see @ref core::OrderBook::copy_levels
+  OrderBook::LevelCounts copy_levels(std::span<PriceLevel> bids,
+                                     std::span<PriceLevel> asks) const;
+  uint64_t get_last_update_id() const;
+  bool is_provisional() const;
+  /// @brief see @ref core::OrderBook::get_footprint. the book is its own storage
+  OrderBook::Footprint get_footprint() const;
+
+ private:
+  const BookAnalyticsConfig config_;
+  /// @brief the writer's copy, published whole after each message
+  Bbo state_;
+  utils::SeqLock<Bbo> published_;
+  /// @brief an increment's level updates, reused
+  std::vector<LevelUpdate> updates_;
+
+  void publish();
+  /// @brief a deleted level empties the side only if it is the side's
+  static void apply_top_level(const binance::TopOfBook::Level& level,
+                              uint64_t& px,
+                              uint64_t& sz);
+};
+
+/// @brief the book for a subscription depth: top-of-book for depth 1, else the full
+/// book, e.g. `BookFor<binance::Config::MAX_DEPTH>`
+template <uint16_t MAX_DEPTH>
+using BookFor = std::conditional_t<MAX_DEPTH == 1, BboBook, OrderBook>;
+
+}  // namespace core
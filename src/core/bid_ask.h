@@ -2,6 +2,8 @@
 
 #include <fmt/core.h>
 
+#include <cstdint>
+
 #include "../utils/env.h"
 
 namespace core {
@@ -29,6 +31,14 @@ struct alignas(utils::Env::CACHE_LINE_SIZE) BidAsk {
   }
 };
 
+/// @brief one price level of one side, price and size in ticks
+struct PriceLevel {
+  uint64_t px = 0;
+  uint64_t sz = 0;
+
+  bool operator==(const PriceLevel& other) const = default;
+};
+
 }  // namespace core
 
 // BidAsk formatter functions
@@ -0,0 +1,62 @@
+#include "book_analytics.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "bid_ask.h"
+
+namespace core {
+
+// static
+BookAnalytics BookAnalytics::compute(const std::vector<BidAsk>& book,
+                                     const BookAnalyticsConfig& config) {
+  std::vector<std::pair<uint64_t, uint64_t>> bids;
+  std::vector<std::pair<uint64_t, uint64_t>> asks;
+  bids.reserve(book.size());
+  asks.reserve(book.size());
+  for (const BidAsk& row : book) {
+    if (row.bid_px != BidAsk::SENTINEL_) {
+      bids.emplace_back(row.bid_px, row.bid_sz);
+    }
+    if (row.ask_px != BidAsk::SENTINEL_) {
+      asks.emplace_back(row.ask_px, row.ask_sz);
+    }
+  }
+
+  BookAnalytics out;
+  BookAnalyzer::fold_touch(bids, config, out.bid);
+  BookAnalyzer::fold_depth(bids, true, config, out.bid);
+  BookAnalyzer::fold_touch(asks, config, out.ask);
+  BookAnalyzer::fold_depth(asks, false, config, out.ask);
+  out.finalize();
+  return out;
+}
+
+void BookAnalytics::finalize() {
+  is_two_sided = !bid.is_empty() && !ask.is_empty();
+  spread = 0;
+  microprice = 0.0;
+  if (is_two_sided) {
+    spread = ask.best_px > bid.best_px ? ask.best_px - bid.best_px : 0;
+    const uint64_t touch_sz = bid.best_sz + ask.best_sz;
+    // the bid is weighted by the ask size and vice versa:
+    // a heavy bid pulls the fair price towards the ask
+    microprice = touch_sz == 0
+                     ? (static_cast<double>(bid.best_px) +
+                        static_cast<double>(ask.best_px)) /
+                           2.0
+                     : (static_cast<double>(bid.best_px) *
+                            static_cast<double>(ask.best_sz) +
+                        static_cast<double>(ask.best_px) *
+                            static_cast<double>(bid.best_sz)) /
+                           static_cast<double>(touch_sz);
+  }
+  const uint64_t top_k_sz = bid.top_k_sz + ask.top_k_sz;
+  imbalance = top_k_sz == 0 ? 0.0
+                            : (static_cast<double>(bid.top_k_sz) -
+                               static_cast<double>(ask.top_k_sz)) /
+                                  static_cast<double>(top_k_sz);
+}
+
+}  // namespace core
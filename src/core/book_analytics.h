@@ -0,0 +1,312 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../utils/seqlock.h"
+#include "bid_ask.h"
+
+namespace core {
+
+/// @brief what the book analytics measure. prices and sizes in ticks
+struct BookAnalyticsConfig {
+ public:
+  static inline constexpr size_t DEPTH_OFFSET_COUNT = 4;
+  static inline constexpr size_t SWEEP_COUNT = 3;
+
+  /// @brief levels summed per side for the size imbalance
+  size_t top_k = 5;
+  /// @brief cumulative depth is reported within these distances from the best price.
+  /// BTCUSDT: $0.10, $1, $10, $100
+  std::array<uint64_t, DEPTH_OFFSET_COUNT> depth_offsets = {10, 100, 1'000, 10'000};
+  /// @brief notional to sweep these sizes from the touch. BTCUSDT: 0.1, 1, 10 BTC
+  std::array<uint64_t, SWEEP_COUNT> sweep_sizes = {10'000, 100'000, 1'000'000};
+};
+
+/// @brief derived signals for one side of the book
+struct BookSideStats {
+ public:
+  uint64_t best_px = 0;
+  uint64_t best_sz = 0;
+  /// @brief total size of the best `top_k` levels
+  uint64_t top_k_sz = 0;
+  /// @brief total size within each of `depth_offsets` of the best price
+  std::array<uint64_t, BookAnalyticsConfig::DEPTH_OFFSET_COUNT> depth_sz{};
+  /// @brief price * size (ticks^2) paid/received to sweep each of `sweep_sizes`
+  std::array<uint64_t, BookAnalyticsConfig::SWEEP_COUNT> sweep_notional{};
+  /// @brief false if the side is too thin to fill the sweep (notional is partial)
+  std::array<bool, BookAnalyticsConfig::SWEEP_COUNT> sweep_filled{};
+
+  bool is_empty() const { return best_sz == 0 && best_px == 0; }
+  bool operator==(const BookSideStats& other) const = default;
+};
+
+/// @brief derived order book signals, published after each applied message.
+/// trivially copyable, so that it can be published through a `utils::SeqLock`
+struct BookAnalytics {
+ public:
+  BookSideStats bid;
+  BookSideStats ask;
+  /// @brief both sides have at least one level
+  bool is_two_sided = false;
+  /// @brief ask - bid, in price ticks
+  uint64_t spread = 0;
+  /// @brief size-weighted mid of the touch, in price ticks
+  double microprice = 0.0;
+  /// @brief (bid - ask) / (bid + ask) over the top-K sizes, in [-1, 1]
+  double imbalance = 0.0;
+  /// @brief number of book messages applied so far
+  uint64_t sequence = 0;
+
+  bool operator==(const BookAnalytics& other) const = default;
+
+  /// @brief naive, full recompute from a book's `to_vector()`, O(depth).
+  /// reference implementation for tests and benchmarks
+  static BookAnalytics compute(const std::vector<BidAsk>& book,
+                               const BookAnalyticsConfig& config);
+  /// @brief fill the fields derived from the two sides
+  void finalize();
+};
+
+/// @brief Keeps `BookAnalytics` up to date as an order book changes, in O(changed
+/// levels) rather than O(depth):
+/// - depth windows are adjusted by each level's size delta, and shifted by the levels
+///   between the old and new window edges when the best price moves
+/// - top-K and sweeps only depend on the first few levels. each side remembers the
+///   worst price they reached, changes beyond it leave the side clean, otherwise only
+///   those levels are walked again on publish
+/// Single writer (the book's thread), lock-free readers.
+class BookAnalyzer {
+ public:
+  explicit BookAnalyzer(BookAnalyticsConfig config = {}) : config_(config) {}
+
+  BookAnalyzer(const BookAnalyzer&) = delete;
+  BookAnalyzer& operator=(const BookAnalyzer&) = delete;
+
+  /// @brief a bid level was added (old_sz = 0), resized or removed (new_sz = 0).
+  /// writer only
+  void on_bid_change(const uint64_t px, const uint64_t old_sz, const uint64_t new_sz) {
+    bid_.on_change(px, old_sz, new_sz, true, config_);
+  }
+  /// @brief an ask level was added (old_sz = 0), resized or removed (new_sz = 0).
+  /// writer only
+  void on_ask_change(const uint64_t px, const uint64_t old_sz, const uint64_t new_sz) {
+    ask_.on_change(px, old_sz, new_sz, false, config_);
+  }
+  /// @brief the whole book changed (e.g. snapshot or clear). writer only
+  void on_reset() noexcept {
+    bid_.is_reset = true;
+    ask_.is_reset = true;
+  }
+
+  /// @brief refresh what changed and publish a snapshot. writer only
+  /// @param bids the bid map, best first
+  /// @param asks the ask map, best first
+  template <typename BidMap, typename AskMap>
+  void publish(const BidMap& bids, const AskMap& asks) {
+    bid_.refresh(bids, true, config_);
+    ask_.refresh(asks, false, config_);
+    BookAnalytics out;
+    out.bid = bid_.stats;
+    out.ask = ask_.stats;
+    out.sequence = ++sequence_;
+    out.finalize();
+    snapshot_.store(out);
+  }
+
+  /// @brief latest published snapshot. any thread
+  BookAnalytics get() const { return snapshot_.load(); }
+  const BookAnalyticsConfig& get_config() const { return config_; }
+
+  /// @brief fold levels (best first) into best, top-K and sweeps
+  /// @return the worst price that still affects them, and whether the walk ran out of
+  /// levels (in which case any new level matters)
+  template <typename Levels>
+  static std::pair<uint64_t, bool> fold_touch(const Levels& levels,
+                                              const BookAnalyticsConfig& config,
+                                              BookSideStats& out);
+  /// @brief fold levels (best first) into the depth windows around `best_px`
+  template <typename Levels>
+  static void fold_depth(const Levels& levels,
+                         bool is_bid,
+                         const BookAnalyticsConfig& config,
+                         BookSideStats& out);
+
+ private:
+  struct Side {
+    BookSideStats stats;
+    /// @brief the best price the depth windows are currently measured from
+    uint64_t window_px = 0;
+    /// @brief top-K/sweep changes at or better than this price touch the stats
+    uint64_t limit_px = 0;
+    bool is_exhausted = true;
+    bool is_dirty = true;
+    bool is_reset = true;
+
+    /// @brief worst price inside the depth window of `offset` around `best`
+    static uint64_t window_edge(const uint64_t best,
+                                const uint64_t offset,
+                                const bool is_bid) noexcept {
+      return is_bid ? (best > offset ? best - offset : 0) : best + offset;
+    }
+
+    void on_change(const uint64_t px,
+                   const uint64_t old_sz,
+                   const uint64_t new_sz,
+                   const bool is_bid,
+                   const BookAnalyticsConfig& config) {
+      if (is_reset) {
+        return;
+      }
+      is_dirty = is_dirty || is_exhausted || (is_bid ? px >= limit_px : px <= limit_px);
+      if (stats.is_empty()) {
+        return;
+      }
+      for (size_t d = 0; d < BookAnalyticsConfig::DEPTH_OFFSET_COUNT; ++d) {
+        const uint64_t edge = window_edge(window_px, config.depth_offsets[d], is_bid);
+        if (is_bid ? px >= edge : px <= edge) {
+          // unsigned wrap-around cancels out, the sum stays exact
+          stats.depth_sz[d] += new_sz;
+          stats.depth_sz[d] -= old_sz;
+        }
+      }
+    }
+
+    template <typename Map>
+    void refresh(const Map& levels, const bool is_bid, const BookAnalyticsConfig& config) {
+      if (is_reset || stats.is_empty()) {
+        std::tie(limit_px, is_exhausted) = fold_touch(levels, config, stats);
+        fold_depth(levels, is_bid, config, stats);
+        window_px = stats.best_px;
+        is_dirty = false;
+        is_reset = false;
+        return;
+      }
+      if (!is_dirty) {
+        return;
+      }
+      std::tie(limit_px, is_exhausted) = fold_touch(levels, config, stats);
+      is_dirty = false;
+      if (stats.is_empty()) {
+        stats.depth_sz = {};
+        return;
+      }
+      if (stats.best_px == window_px) {
+        return;
+      }
+      // the best price moved: shift each window edge, summing only the levels between
+      // the old and the new edge
+      const auto comp = levels.key_comp();
+      for (size_t d = 0; d < BookAnalyticsConfig::DEPTH_OFFSET_COUNT; ++d) {
+        const uint64_t old_edge = window_edge(window_px, config.depth_offsets[d], is_bid);
+        const uint64_t new_edge =
+            window_edge(stats.best_px, config.depth_offsets[d], is_bid);
+        if (comp(old_edge, new_edge)) {
+          // window grew
+          stats.depth_sz[d] += sum_between(levels, old_edge, new_edge);
+        } else if (comp(new_edge, old_edge)) {
+          // window shrank
+          stats.depth_sz[d] -= sum_between(levels, new_edge, old_edge);
+        }
+      }
+      window_px = stats.best_px;
+    }
+
+    /// @brief total size of the levels strictly worse than `better`, and at or better
+    /// than `worse`
+    template <typename Map>
+    static uint64_t sum_between(const Map& levels,
+                                const uint64_t better,
+                                const uint64_t worse) {
+      const auto comp = levels.key_comp();
+      uint64_t sum = 0;
+      for (auto it = levels.upper_bound(better);
+           it != levels.end() && !comp(worse, it->first); ++it) {
+        sum += it->second;
+      }
+      return sum;
+    }
+  };
+
+  const BookAnalyticsConfig config_;
+  Side bid_;
+  Side ask_;
+  uint64_t sequence_ = 0;
+  utils::SeqLock<BookAnalytics> snapshot_;
+};
+
+// static
+template <typename Levels>
+std::pair<uint64_t, bool> BookAnalyzer::fold_touch(const Levels& levels,
+                                                   const BookAnalyticsConfig& config,
+                                                   BookSideStats& out) {
+  out.best_px = 0;
+  out.best_sz = 0;
+  out.top_k_sz = 0;
+  out.sweep_notional = {};
+  std::array<uint64_t, BookAnalyticsConfig::SWEEP_COUNT> remaining = config.sweep_sizes;
+
+  uint64_t limit_px = 0;
+  size_t level = 0;
+  auto it = levels.begin();
+  for (; it != levels.end(); ++it, ++level) {
+    const uint64_t px = it->first;
+    const uint64_t sz = it->second;
+    if (level == 0) {
+      out.best_px = px;
+      out.best_sz = sz;
+    }
+
+    // both conditions only get harder to meet further from the touch,
+    // so the first level that contributes nothing ends the walk
+    bool is_needed = false;
+    if (level < config.top_k) {
+      out.top_k_sz += sz;
+      is_needed = true;
+    }
+    for (size_t s = 0; s < BookAnalyticsConfig::SWEEP_COUNT; ++s) {
+      if (remaining[s] > 0) {
+        const uint64_t take = std::min(remaining[s], sz);
+        out.sweep_notional[s] += take * px;
+        remaining[s] -= take;
+        is_needed = true;
+      }
+    }
+    if (!is_needed) {
+      break;
+    }
+    limit_px = px;
+  }
+
+  for (size_t s = 0; s < BookAnalyticsConfig::SWEEP_COUNT; ++s) {
+    out.sweep_filled[s] = remaining[s] == 0;
+  }
+  return {limit_px, it == levels.end()};
+}
+
+// static
+template <typename Levels>
+void BookAnalyzer::fold_depth(const Levels& levels,
+                              const bool is_bid,
+                              const BookAnalyticsConfig& config,
+                              BookSideStats& out) {
+  out.depth_sz = {};
+  const uint64_t max_offset = *std::ranges::max_element(config.depth_offsets);
+  for (const auto& [px, sz] : levels) {
+    const uint64_t distance = is_bid ? out.best_px - px : px - out.best_px;
+    if (distance > max_offset) {
+      break;
+    }
+    for (size_t d = 0; d < BookAnalyticsConfig::DEPTH_OFFSET_COUNT; ++d) {
+      if (distance <= config.depth_offsets[d]) {
+        out.depth_sz[d] += sz;
+      }
+    }
+  }
+}
+
+}  // namespace core
@@ -0,0 +1,335 @@
+#include "level_kernels.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define TRADER_HAS_AVX2_KERNELS 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define TRADER_HAS_NEON_KERNELS 1
+#endif
+
+namespace core {
+
+namespace {
+
+// ─────────── Scalar ───────────
+
+uint64_t sum_scalar(const uint64_t* values, const size_t n) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < n; ++i) {
+    sum += values[i];
+  }
+  return sum;
+}
+
+void prefix_sum_scalar(const uint64_t* values, const size_t n, uint64_t* out) {
+  uint64_t running = 0;
+  for (size_t i = 0; i < n; ++i) {
+    running += values[n - 1 - i];
+    out[i] = running;
+  }
+}
+
+size_t find_cumulative_scalar(const uint64_t* values,
+                              const size_t n,
+                              const uint64_t target,
+                              uint64_t& before) {
+  uint64_t running = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t next = running + values[n - 1 - i];
+    if (next >= target) {
+      before = running;
+      return i;
+    }
+    running = next;
+  }
+  before = running;
+  return n;
+}
+
+uint64_t dot_scalar(const uint64_t* px, const uint64_t* sz, const size_t n) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < n; ++i) {
+    sum += px[i] * sz[i];
+  }
+  return sum;
+}
+
+constexpr LevelKernels SCALAR_KERNELS{SimdLevel::SCALAR, sum_scalar, prefix_sum_scalar,
+                                      find_cumulative_scalar, dot_scalar};
+
+// ─────────── AVX2 ───────────
+
+#if defined(TRADER_HAS_AVX2_KERNELS)
+
+__attribute__((target("avx2"))) inline uint64_t hsum_avx2(const __m256i v) {
+  const __m128i lo = _mm256_castsi256_si128(v);
+  const __m128i hi = _mm256_extracti128_si256(v, 1);
+  const __m128i s = _mm_add_epi64(lo, hi);
+  return static_cast<uint64_t>(_mm_cvtsi128_si64(s)) +
+         static_cast<uint64_t>(_mm_extract_epi64(s, 1));
+}
+
+__attribute__((target("avx2"))) uint64_t sum_avx2(const uint64_t* values,
+                                                  const size_t n) {
+  __m256i acc0 = _mm256_setzero_si256();
+  __m256i acc1 = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_add_epi64(
+        acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+    acc1 = _mm256_add_epi64(
+        acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 4)));
+  }
+  uint64_t sum = hsum_avx2(_mm256_add_epi64(acc0, acc1));
+  for (; i < n; ++i) {
+    sum += values[i];
+  }
+  return sum;
+}
+
+__attribute__((target("avx2"))) void prefix_sum_avx2(const uint64_t* values,
+                                                     const size_t n,
+                                                     uint64_t* out) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i carry = zero;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    // the 4 levels closest to the touch that are left, reversed into best-first order
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + n - i - 4));
+    x = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(0, 1, 2, 3));
+    // in-register scan: add the lanes shifted by 1, then by 2
+    x = _mm256_add_epi64(
+        x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), zero,
+                              0x03));
+    x = _mm256_add_epi64(
+        x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), zero,
+                              0x0F));
+    x = _mm256_add_epi64(x, carry);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), x);
+    carry = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+  uint64_t running = static_cast<uint64_t>(_mm256_extract_epi64(carry, 0));
+  for (; i < n; ++i) {
+    running += values[n - 1 - i];
+    out[i] = running;
+  }
+}
+
+__attribute__((target("avx2"))) size_t find_cumulative_avx2(const uint64_t* values,
+                                                            const size_t n,
+                                                            const uint64_t target,
+                                                            uint64_t& before) {
+  // skip whole blocks of 8 levels while the target is out of reach,
+  // then settle the last block level by level
+  uint64_t running = 0;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const uint64_t* block = values + n - i - 8;
+    const __m256i s =
+        _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)),
+                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 4)));
+    const uint64_t block_sum = hsum_avx2(s);
+    if (running + block_sum >= target) {
+      break;
+    }
+    running += block_sum;
+  }
+  for (; i < n; ++i) {
+    const uint64_t next = running + values[n - 1 - i];
+    if (next >= target) {
+      before = running;
+      return i;
+    }
+    running = next;
+  }
+  before = running;
+  return n;
+}
+
+__attribute__((target("avx2"))) uint64_t dot_avx2(const uint64_t* px,
+                                                  const uint64_t* sz,
+                                                  const size_t n) {
+  // AVX2 has no 64-bit multiply, `mul_epu32` multiplies the low 32 bits of each lane.
+  // prices and sizes in ticks fit comfortably, anything wider falls back to scalar
+  __m256i acc = _mm256_setzero_si256();
+  __m256i high_bits = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(px + i));
+    const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sz + i));
+    high_bits = _mm256_or_si256(high_bits, _mm256_or_si256(p, s));
+    acc = _mm256_add_epi64(acc, _mm256_mul_epu32(p, s));
+  }
+  if (!_mm256_testz_si256(high_bits, _mm256_set1_epi64x(
+                                         static_cast<int64_t>(0xFFFF'FFFF'0000'0000ull)))) {
+    return dot_scalar(px, sz, n);
+  }
+  uint64_t sum = hsum_avx2(acc);
+  for (; i < n; ++i) {
+    sum += px[i] * sz[i];
+  }
+  return sum;
+}
+
+constexpr LevelKernels AVX2_KERNELS{SimdLevel::AVX2, sum_avx2, prefix_sum_avx2,
+                                    find_cumulative_avx2, dot_avx2};
+
+#endif
+
+// ─────────── NEON ───────────
+
+#if defined(TRADER_HAS_NEON_KERNELS)
+
+uint64_t sum_neon(const uint64_t* values, const size_t n) {
+  uint64x2_t acc0 = vdupq_n_u64(0);
+  uint64x2_t acc1 = vdupq_n_u64(0);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc0 = vaddq_u64(acc0, vld1q_u64(values + i));
+    acc1 = vaddq_u64(acc1, vld1q_u64(values + i + 2));
+  }
+  uint64_t sum = vaddvq_u64(vaddq_u64(acc0, acc1));
+  for (; i < n; ++i) {
+    sum += values[i];
+  }
+  return sum;
+}
+
+void prefix_sum_neon(const uint64_t* values, const size_t n, uint64_t* out) {
+  const uint64x2_t zero = vdupq_n_u64(0);
+  uint64x2_t carry = zero;
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    // the 2 levels closest to the touch that are left, reversed into best-first order
+    uint64x2_t x = vld1q_u64(values + n - i - 2);
+    x = vextq_u64(x, x, 1);
+    // [a, b] -> [a, a + b]
+    x = vaddq_u64(x, vextq_u64(zero, x, 1));
+    x = vaddq_u64(x, carry);
+    vst1q_u64(out + i, x);
+    carry = vdupq_laneq_u64(x, 1);
+  }
+  uint64_t running = vgetq_lane_u64(carry, 0);
+  for (; i < n; ++i) {
+    running += values[n - 1 - i];
+    out[i] = running;
+  }
+}
+
+size_t find_cumulative_neon(const uint64_t* values,
+                            const size_t n,
+                            const uint64_t target,
+                            uint64_t& before) {
+  // skip whole blocks of 4 levels while the target is out of reach,
+  // then settle the last block level by level
+  uint64_t running = 0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const uint64_t* block = values + n - i - 4;
+    const uint64_t block_sum =
+        vaddvq_u64(vaddq_u64(vld1q_u64(block), vld1q_u64(block + 2)));
+    if (running + block_sum >= target) {
+      break;
+    }
+    running += block_sum;
+  }
+  for (; i < n; ++i) {
+    const uint64_t next = running + values[n - 1 - i];
+    if (next >= target) {
+      before = running;
+      return i;
+    }
+    running = next;
+  }
+  before = running;
+  return n;
+}
+
+uint64_t dot_neon(const uint64_t* px, const uint64_t* sz, const size_t n) {
+  // widening 32x32->64 multiply-accumulate. prices and sizes in ticks fit comfortably,
+  // anything wider falls back to scalar
+  uint64x2_t acc = vdupq_n_u64(0);
+  uint64x2_t high_bits = vdupq_n_u64(0);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const uint64x2_t p = vld1q_u64(px + i);
+    const uint64x2_t s = vld1q_u64(sz + i);
+    high_bits = vorrq_u64(high_bits, vorrq_u64(p, s));
+    acc = vmlal_u32(acc, vmovn_u64(p), vmovn_u64(s));
+  }
+  if ((vmaxvq_u32(vreinterpretq_u32_u64(vshrq_n_u64(high_bits, 32)))) != 0) {
+    return dot_scalar(px, sz, n);
+  }
+  uint64_t sum = vaddvq_u64(acc);
+  for (; i < n; ++i) {
+    sum += px[i] * sz[i];
+  }
+  return sum;
+}
+
+constexpr LevelKernels NEON_KERNELS{SimdLevel::NEON, sum_neon, prefix_sum_neon,
+                                    find_cumulative_neon, dot_neon};
+
+#endif
+
+const LevelKernels& select_kernels() {
+#if defined(TRADER_HAS_AVX2_KERNELS)
+  if (__builtin_cpu_supports("avx2")) {
+    return AVX2_KERNELS;
+  }
+#elif defined(TRADER_HAS_NEON_KERNELS)
+  // NEON is part of the aarch64 baseline
+  return NEON_KERNELS;
+#endif
+  return SCALAR_KERNELS;
+}
+
+}  // namespace
+
+// static
+const LevelKernels& LevelKernels::get() {
+  static const LevelKernels& kernels = select_kernels();
+  return kernels;
+}
+
+// static
+const LevelKernels* LevelKernels::get(const SimdLevel level) {
+  switch (level) {
+    case SimdLevel::SCALAR:
+      return &SCALAR_KERNELS;
+    case SimdLevel::AVX2:
+#if defined(TRADER_HAS_AVX2_KERNELS)
+      if (__builtin_cpu_supports("avx2")) {
+        return &AVX2_KERNELS;
+      }
+#endif
+      return nullptr;
+    case SimdLevel::NEON:
+#if defined(TRADER_HAS_NEON_KERNELS)
+      return &NEON_KERNELS;
+#else
+      return nullptr;
+#endif
+  }
+  return nullptr;
+}
+
+// static
+std::string_view LevelKernels::to_str_view(const SimdLevel level) {
+  switch (level) {
+    case SimdLevel::SCALAR:
+      return "scalar";
+    case SimdLevel::AVX2:
+      return "avx2";
+    case SimdLevel::NEON:
+      return "neon";
+  }
+  return "?";
+}
+
+}  // namespace core
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace core {
+
+/// @brief instruction set used by a @ref core::LevelKernels table
+enum class SimdLevel : uint8_t {
+  SCALAR = 0,
+  AVX2 = 1,
+  NEON = 2,
+};
+
+/// @brief Vectorised scans over contiguous level arrays (see @ref core::LevelMirror).
+/// Levels are stored worst-first, so every kernel walks from the end of the array (the
+/// touch) towards its start.
+/// The best table for the running CPU is selected once, at first use. every table
+/// returns identical results.
+struct LevelKernels {
+ public:
+  /// @brief sum of `values[0, n)`
+  using SumFn = uint64_t (*)(const uint64_t* values, size_t n);
+  /// @brief cumulative sums from the end: `out[i] = values[n-1] + ... + values[n-1-i]`
+  using PrefixSumFn = void (*)(const uint64_t* values, size_t n, uint64_t* out);
+  /// @brief walk from the end until the running sum reaches `target`.
+  /// @return the number of levels fully before the one that reaches it (n if never
+  /// reached), `before` receives their sum
+  using FindCumulativeFn = size_t (*)(const uint64_t* values,
+                                      size_t n,
+                                      uint64_t target,
+                                      uint64_t& before);
+  /// @brief sum of `px[i] * sz[i]` over `[0, n)`
+  using DotFn = uint64_t (*)(const uint64_t* px, const uint64_t* sz, size_t n);
+
+  SimdLevel level;
+  SumFn sum;
+  PrefixSumFn prefix_sum;
+  FindCumulativeFn find_cumulative;
+  DotFn dot;
+
+  /// @brief the fastest table supported by this CPU
+  static const LevelKernels& get();
+  /// @brief a specific table, or nullptr if this CPU/build does not support it.
+  /// useful for tests and benchmarks
+  static const LevelKernels* get(SimdLevel level);
+  static std::string_view to_str_view(SimdLevel level);
+};
+
+}  // namespace core
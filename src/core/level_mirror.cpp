@@ -0,0 +1,155 @@
+#include "level_mirror.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <optional>
+#include <span>
+
+#include "../utils/env.h"
+#include "level_kernels.h"
+
+namespace core {
+
+LevelMirror::LevelMirror(const bool is_bid, const size_t capacity)
+    : is_bid_(is_bid),
+      capacity_(std::max<size_t>(capacity, 1)),
+      storage_(2 * capacity_),
+      px_(make_array(storage_)),
+      sz_(make_array(storage_)),
+      begin_(storage_),
+      end_(storage_) {}
+
+void LevelMirror::AlignedDelete::operator()(uint64_t* p) const {
+  ::operator delete[](p, std::align_val_t{utils::Env::CACHE_LINE_SIZE});
+}
+
+// static
+LevelMirror::AlignedArray LevelMirror::make_array(const size_t count) {
+  return AlignedArray(static_cast<uint64_t*>(::operator new[](
+      count * sizeof(uint64_t), std::align_val_t{utils::Env::CACHE_LINE_SIZE})));
+}
+
+void LevelMirror::clear() {
+  begin_ = storage_;
+  end_ = storage_;
+  is_truncated_ = false;
+}
+
+size_t LevelMirror::lower_bound(const uint64_t px) const {
+  // worst-first, i.e. ascending prices for bids, descending for asks
+  const uint64_t* first = px_.get() + begin_;
+  const uint64_t* last = px_.get() + end_;
+  const uint64_t* it = is_bid_ ? std::lower_bound(first, last, px)
+                               : std::lower_bound(first, last, px, std::greater<>{});
+  return static_cast<size_t>(it - px_.get());
+}
+
+void LevelMirror::compact() {
+  const size_t count = size();
+  const size_t new_begin = capacity_ - count;
+  std::memmove(px_.get() + new_begin, px_.get() + begin_, count * sizeof(uint64_t));
+  std::memmove(sz_.get() + new_begin, sz_.get() + begin_, count * sizeof(uint64_t));
+  begin_ = new_begin;
+  end_ = new_begin + count;
+}
+
+void LevelMirror::set(const uint64_t px, const uint64_t sz) {
+  size_t pos = lower_bound(px);
+  if (pos != end_ && px_[pos] == px) {
+    if (sz != 0) {
+      sz_[pos] = sz;
+      return;
+    }
+    if (pos == begin_) {
+      // the worst level, e.g. trimmed from the book: the slack in front grows instead
+      ++begin_;
+      return;
+    }
+    // remove, pulling the better levels back by one
+    const size_t tail = end_ - pos - 1;
+    std::memmove(px_.get() + pos, px_.get() + pos + 1, tail * sizeof(uint64_t));
+    std::memmove(sz_.get() + pos, sz_.get() + pos + 1, tail * sizeof(uint64_t));
+    --end_;
+    return;
+  }
+  if (sz == 0) {
+    return;
+  }
+  if (pos == begin_ && is_truncated_) {
+    // worse than every mirrored level, and the book has unknown levels in between
+    return;
+  }
+  if (size() == capacity_) {
+    if (pos == begin_) {
+      is_truncated_ = true;
+      return;
+    }
+    // drop the worst level
+    ++begin_;
+    is_truncated_ = true;
+  }
+  if (end_ == storage_) {
+    const size_t offset = pos - begin_;
+    compact();
+    pos = begin_ + offset;
+  }
+  // insert, pushing the better levels forward by one
+  std::memmove(px_.get() + pos + 1, px_.get() + pos, (end_ - pos) * sizeof(uint64_t));
+  std::memmove(sz_.get() + pos + 1, sz_.get() + pos, (end_ - pos) * sizeof(uint64_t));
+  px_[pos] = px;
+  sz_[pos] = sz;
+  ++end_;
+}
+
+std::optional<uint64_t> LevelMirror::size_to_price(const uint64_t limit_px,
+                                                   const LevelKernels& k) const {
+  // the levels at or better than the limit are a contiguous run at the end
+  const size_t first = lower_bound(limit_px);
+  if (is_truncated_ && first == begin_ && (size() == 0 || px_[begin_] != limit_px)) {
+    // the limit is past the worst mirrored level
+    return std::nullopt;
+  }
+  return k.sum(sz_.get() + first, end_ - first);
+}
+
+std::optional<uint64_t> LevelMirror::price_to_fill(const uint64_t sz,
+                                                   const LevelKernels& k) const {
+  if (sz == 0) {
+    return size() == 0 ? std::nullopt : std::optional{px_[end_ - 1]};
+  }
+  uint64_t before = 0;
+  const size_t levels = k.find_cumulative(sz_.get() + begin_, size(), sz, before);
+  if (levels == size()) {
+    return std::nullopt;
+  }
+  return px_[end_ - 1 - levels];
+}
+
+std::optional<uint64_t> LevelMirror::notional_to_fill(const uint64_t sz,
+                                                      const LevelKernels& k) const {
+  if (sz == 0) {
+    return 0;
+  }
+  uint64_t before = 0;
+  const size_t levels = k.find_cumulative(sz_.get() + begin_, size(), sz, before);
+  if (levels == size()) {
+    return std::nullopt;
+  }
+  // the levels swept whole, plus what is left of the order at the last level
+  const size_t last = end_ - 1 - levels;
+  return k.dot(px_.get() + last + 1, sz_.get() + last + 1, levels) +
+         (sz - before) * px_[last];
+}
+
+size_t LevelMirror::cumulative_sizes(const std::span<uint64_t> out,
+                                     const LevelKernels& k) const {
+  const size_t count = std::min(out.size(), size());
+  k.prefix_sum(sz_.get() + end_ - count, count, out.data());
+  return count;
+}
+
+}  // namespace core
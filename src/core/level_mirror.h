@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+
+#include "level_kernels.h"
+
+namespace core {
+
+enum class BookSide : uint8_t {
+  BID = 0,
+  ASK = 1,
+};
+
+/// @brief Contiguous structure-of-arrays copy of the top levels of one side of the book,
+/// for vectorised scans (see @ref core::LevelKernels) instead of pointer chasing.
+/// Levels are stored worst-first so that changes near the touch, the common case, only
+/// move the few levels in front of them. Slack in front of the worst level lets the
+/// mirror drop its worst level in O(1) when full.
+/// Invariant: holds exactly the book levels at or better than its worst level.
+/// Not thread-safe, guarded by the owning book.
+class LevelMirror {
+ public:
+  LevelMirror(bool is_bid, size_t capacity);
+
+  LevelMirror(const LevelMirror&) = delete;
+  LevelMirror& operator=(const LevelMirror&) = delete;
+
+  /// @brief add, resize or (size 0) remove a level
+  void set(uint64_t px, uint64_t sz);
+  /// @brief replace the contents with the best levels of a book side, best first
+  template <typename Levels>
+  void assign(const Levels& levels) {
+    clear();
+    size_t count = 0;
+    for (auto it = levels.begin(); it != levels.end(); ++it, ++count) {
+      if (count == capacity_) {
+        is_truncated_ = true;
+        break;
+      }
+    }
+    // fill from the back, so that the best level lands last
+    begin_ = capacity_ - count;
+    end_ = capacity_;
+    size_t i = end_;
+    for (auto it = levels.begin(); i > begin_; ++it) {
+      --i;
+      px_[i] = it->first;
+      sz_[i] = it->second;
+    }
+  }
+  void clear();
+
+  size_t size() const { return end_ - begin_; }
+  size_t capacity() const { return capacity_; }
+  /// @brief heap held, fixed at construction
+  size_t bytes() const { return 2 * storage_ * sizeof(uint64_t); }
+  /// @brief the book has levels worse than the mirror's worst level
+  bool is_truncated() const { return is_truncated_; }
+  /// @brief truncated and shrunk to less than half its capacity, time to `assign` again
+  bool needs_refill() const { return is_truncated_ && size() < capacity_ / 2; }
+
+  /// @brief prices, worst first
+  std::span<const uint64_t> prices() const { return {px_.get() + begin_, size()}; }
+  /// @brief sizes, worst first
+  std::span<const uint64_t> sizes() const { return {sz_.get() + begin_, size()}; }
+
+  // ─────────── Queries ───────────
+  // prices/sizes in ticks. nullopt when the answer lies beyond the mirrored levels
+
+  /// @brief total size resting at prices no worse than `limit_px`
+  std::optional<uint64_t> size_to_price(uint64_t limit_px,
+                                        const LevelKernels& k = LevelKernels::get()) const;
+  /// @brief the worst price touched when sweeping `sz` from the touch
+  std::optional<uint64_t> price_to_fill(uint64_t sz,
+                                        const LevelKernels& k = LevelKernels::get()) const;
+  /// @brief price * size (ticks^2) to sweep `sz` from the touch
+  std::optional<uint64_t> notional_to_fill(
+      uint64_t sz,
+      const LevelKernels& k = LevelKernels::get()) const;
+  /// @brief cumulative size of the best `out.size()` levels, best first.
+  /// @return the number of levels written
+  size_t cumulative_sizes(std::span<uint64_t> out,
+                          const LevelKernels& k = LevelKernels::get()) const;
+
+ private:
+  struct AlignedDelete {
+    void operator()(uint64_t* p) const;
+  };
+  using AlignedArray = std::unique_ptr<uint64_t[], AlignedDelete>;
+  static AlignedArray make_array(size_t count);
+
+  const bool is_bid_;
+  const size_t capacity_;
+  /// @brief twice the capacity, the first half is slack for dropping the worst level
+  const size_t storage_;
+  AlignedArray px_;
+  AlignedArray sz_;
+  /// @brief live levels are [begin_, end_), worst first
+  size_t begin_;
+  size_t end_;
+  bool is_truncated_ = false;
+
+  /// @brief index of the first level at or better than `px`
+  size_t lower_bound(uint64_t px) const;
+  /// @brief move the live levels back to the middle of the storage, restoring room past
+  /// the best level and slack for dropping the worst
+  void compact();
+};
+
+}  // namespace core
@@ -1,25 +1,93 @@
 #include "order_book.h"
 
+#include <quickfix/FieldMap.h>
+
+#include <charconv>
+#include <cmath>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
 #include "../binance/config.h"
+#include "../binance/feed_arbiter.h"
 #include "../binance/symbol.h"
+#include "../binance/top_of_book.h"
 #include "../utils/double.h"
 #include "absl/container/btree_map.h"
 #include "bid_ask.h"
+#include "book_analytics.h"
+#include "level_mirror.h"
 #include "spdlog/spdlog.h"
 
 namespace core {
 
+// static function
+std::optional<uint64_t> OrderBook::read_last_update_id(const FIX::FieldMap& fields) {
+  if (!fields.isSetField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG)) {
+    return std::nullopt;
+  }
+  const std::string& str = fields.getField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG);
+  uint64_t value = 0;
+  const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+  if (ec != std::errc{} || ptr != str.data() + str.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
 OrderBook::OrderBook(absl::btree_map<uint64_t, uint64_t, std::greater<>> bid_map,
-                     absl::btree_map<uint64_t, uint64_t> ask_map)
-    : bid_map_(std::move(bid_map)), ask_map_(std::move(ask_map)) {}
+                     absl::btree_map<uint64_t, uint64_t> ask_map,
+                     BookAnalyticsConfig analytics_config)
+    : bid_map_(std::move(bid_map)),
+      ask_map_(std::move(ask_map)),
+      analyzer_(analytics_config) {
+  bid_mirror_.assign(bid_map_);
+  ask_mirror_.assign(ask_map_);
+  analyzer_.publish(bid_map_, ask_map_);
+}
 
 // move constructor
 OrderBook::OrderBook(OrderBook&& other) noexcept
-    : bid_map_(std::move(other.bid_map_)), ask_map_(std::move(other.ask_map_)) {
+    : bid_map_(std::move(other.bid_map_)),
+      ask_map_(std::move(other.ask_map_)),
+      analyzer_(other.analyzer_.get_config()) {
   // lock other.mutex_ to ensure safe access to its internal maps while moving
   std::lock_guard lock(other.mutex_);
+  last_update_id_ = other.last_update_id_;
+  top_ = other.top_;
+  is_behind_top_ = other.is_behind_top_;
+  max_levels_ = other.max_levels_;
+  trimmed_levels_ = other.trimmed_levels_;
+  provisional_.store(other.provisional_.load(std::memory_order_relaxed),
+                     std::memory_order_relaxed);
 
   // mutex_ does not move; each instance has its own mutex
+  // the analyzer and mirrors do not move either, rebuild them from the moved levels
+  bid_mirror_.assign(bid_map_);
+  ask_mirror_.assign(ask_map_);
+  analyzer_.publish(bid_map_, ask_map_);
+}
+
+// static function
+OrderBook OrderBook::from_levels(const std::span<const PriceLevel> bids,
+                                 const std::span<const PriceLevel> asks,
+                                 const uint64_t last_update_id) {
+  absl::btree_map<uint64_t, uint64_t, std::greater<>> bid_map;
+  absl::btree_map<uint64_t, uint64_t> ask_map;
+  // sorted input: appending at the end is amortised O(1)
+  for (const PriceLevel& level : bids) {
+    bid_map.emplace_hint(bid_map.end(), level.px, level.sz);
+  }
+  for (const PriceLevel& level : asks) {
+    ask_map.emplace_hint(ask_map.end(), level.px, level.sz);
+  }
+  OrderBook book(std::move(bid_map), std::move(ask_map));
+  book.last_update_id_ = last_update_id;
+  book.provisional_.store(true, std::memory_order_relaxed);
+  return book;
 }
 
 // move-assignment constructor
@@ -60,6 +128,76 @@ std::vector<BidAsk> OrderBook::to_vector() {
   return v;
 }
 
+size_t OrderBook::top_levels(const std::span<BidAsk> out) const {
+  std::lock_guard lock(mutex_);
+  auto bid_it = bid_map_.begin();
+  auto ask_it = ask_map_.begin();
+  size_t rows = 0;
+  for (; rows < out.size() && (bid_it != bid_map_.end() || ask_it != ask_map_.end());
+       ++rows) {
+    BidAsk& ba = out[rows];
+    ba = BidAsk{};
+    if (bid_it != bid_map_.end()) {
+      ba.bid_px = bid_it->first;
+      ba.bid_sz = bid_it->second;
+      ++bid_it;
+    }
+    if (ask_it != ask_map_.end()) {
+      ba.ask_px = ask_it->first;
+      ba.ask_sz = ask_it->second;
+      ++ask_it;
+    }
+  }
+  return rows;
+}
+
+BookAnalytics OrderBook::get_analytics() const {
+  return analyzer_.get();
+}
+
+OrderBook::LevelCounts OrderBook::copy_levels(const std::span<PriceLevel> bids,
+                                              const std::span<PriceLevel> asks) const {
+  std::lock_guard lock(mutex_);
+  LevelCounts counts{.last_update_id = last_update_id_};
+  for (auto it = bid_map_.begin(); it != bid_map_.end() && counts.bids < bids.size();
+       ++it) {
+    bids[counts.bids++] = PriceLevel{it->first, it->second};
+  }
+  for (auto it = ask_map_.begin(); it != ask_map_.end() && counts.asks < asks.size();
+       ++it) {
+    asks[counts.asks++] = PriceLevel{it->first, it->second};
+  }
+  return counts;
+}
+
+uint64_t OrderBook::get_last_update_id() const {
+  std::lock_guard lock(mutex_);
+  return last_update_id_;
+}
+
+bool OrderBook::is_provisional() const {
+  return provisional_.load(std::memory_order_relaxed);
+}
+
+void OrderBook::set_max_levels(const size_t max_levels) {
+  std::lock_guard lock(mutex_);
+  max_levels_ = max_levels;
+  trim();
+  refill_mirrors();
+  analyzer_.publish(bid_map_, ask_map_);
+}
+
+OrderBook::Footprint OrderBook::get_footprint() const {
+  std::lock_guard lock(mutex_);
+  return Footprint{
+      .bid_levels = bid_map_.size(),
+      .ask_levels = ask_map_.size(),
+      .bytes = (bid_map_.size() + ask_map_.size()) * LEVEL_BYTES + bid_mirror_.bytes() +
+               ask_mirror_.bytes(),
+      .trimmed_levels = trimmed_levels_,
+  };
+}
+
 void OrderBook::apply_snapshot(const FIX44::MarketDataSnapshotFullRefresh& msg) {
   std::lock_guard lock(mutex_);
   FIX::Symbol symbol;
@@ -75,6 +213,7 @@ void OrderBook::apply_snapshot(const FIX44::MarketDataSnapshotFullRefresh& msg)
 
   bid_map_.clear();
   ask_map_.clear();
+  last_update_id_ = read_last_update_id(msg).value_or(0);
 
   FIX::NoMDEntries entries;
   msg.get(entries);
@@ -103,6 +242,20 @@ void OrderBook::apply_snapshot(const FIX44::MarketDataSnapshotFullRefresh& msg)
       spdlog::error("unknown bid/offer type [{}]", e_tp.getString());
     }
   }
+  // the depth-1 stream can be ahead of the snapshot too
+  if (top_ && last_update_id_ != 0 && last_update_id_ < top_->last_update_id) {
+    overlay_top(*top_);
+  } else {
+    top_.reset();
+  }
+  trim();
+
+  bid_mirror_.assign(bid_map_);
+  ask_mirror_.assign(ask_map_);
+  analyzer_.on_reset();
+  analyzer_.publish(bid_map_, ask_map_);
+  // the live book has replaced whatever the book was restored from
+  provisional_.store(false, std::memory_order_relaxed);
 }
 
 void OrderBook::apply_increment(const FIX44::MarketDataIncrementalRefresh& msg,
@@ -119,6 +272,14 @@ void OrderBook::apply_increment(const FIX44::MarketDataIncrementalRefresh& msg,
   FIX::MDUpdateAction action;
   for (int i = 1; i <= num_entries; i++) {
     msg.getGroup(i, group);
+    // Binance only sets the update ids on the first entry
+    if (i == 1) {
+      const std::optional<uint64_t> id = read_last_update_id(group);
+      if (id) {
+        last_update_id_ = *id;
+      }
+      on_deep_update_id(id);
+    }
 
     // Update symbol if present or first group
     if (i == 1 || group.isSetField(FIX::FIELD::Symbol)) {
@@ -151,6 +312,263 @@ void OrderBook::apply_increment(const FIX44::MarketDataIncrementalRefresh& msg,
         spdlog::error("unknown bid/offer FIX::MDEntryType. value [{}]", e_tp.getValue());
     }
   }
+
+  trim();
+  refill_mirrors();
+  analyzer_.publish(bid_map_, ask_map_);
+}
+
+// static function
+std::optional<uint64_t> OrderBook::to_level_updates(
+    const FIX44::MarketDataIncrementalRefresh& msg,
+    std::vector<LevelUpdate>& out) {
+  FIX::NoMDEntries entries;
+  msg.get(entries);
+  const int num_entries = entries.getValue();
+
+  std::optional<uint64_t> last_update_id;
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries group;
+  FIX::Symbol fsym;
+  binance::SymbolEnum symbol = binance::SymbolEnum::BTCUSDT;
+  FIX::MDEntryType e_tp;
+  FIX::MDUpdateAction action;
+  FIX::MDEntryPx e_px;
+  FIX::MDEntrySize e_sz;
+  for (int i = 1; i <= num_entries; i++) {
+    msg.getGroup(i, group);
+    // Binance only sets the update ids on the first entry
+    if (i == 1) {
+      last_update_id = read_last_update_id(group);
+    }
+    if (i == 1 || group.isSetField(FIX::FIELD::Symbol)) {
+      group.get(fsym);
+      symbol = binance::Symbol::from_str(fsym.getValue());
+    }
+    group.get(e_tp);
+    if (e_tp.getValue() != FIX::MDEntryType_BID &&
+        e_tp.getValue() != FIX::MDEntryType_OFFER) {
+      spdlog::error("unknown bid/offer FIX::MDEntryType. value [{}]", e_tp.getValue());
+      continue;
+    }
+    const BookSide side =
+        e_tp.getValue() == FIX::MDEntryType_BID ? BookSide::BID : BookSide::ASK;
+    group.get(action);
+    const uint64_t px = utils::Double::toUint64(
+        group.get(e_px).getValue(), binance::Config::get_price_ticks_per_unit(symbol));
+    uint64_t sz = 0;
+    switch (action.getValue()) {
+      case FIX::MDUpdateAction_DELETE:
+        break;
+      case FIX::MDUpdateAction_NEW:
+      case FIX::MDUpdateAction_CHANGE:
+        sz = utils::Double::toUint64(group.get(e_sz).getValue(),
+                                     binance::Config::get_size_ticks_per_unit(symbol));
+        break;
+      default:
+        spdlog::error("unknown price action. value [{}]", action.getValue());
+        continue;
+    }
+    out.push_back(LevelUpdate{.symbol = symbol, .side = side, .px = px, .sz = sz});
+  }
+  return last_update_id;
+}
+
+void OrderBook::apply_levels(const std::span<const LevelUpdate> updates,
+                             const std::optional<uint64_t> last_update_id) {
+  std::lock_guard lock(mutex_);
+  if (last_update_id) {
+    last_update_id_ = *last_update_id;
+  }
+  on_deep_update_id(last_update_id);
+  for (const LevelUpdate& update : updates) {
+    if (update.symbol != binance::SymbolEnum::BTCUSDT) {
+      spdlog::error("wrong symbol, skipping price increment. value [{}]",
+                    binance::Symbol::to_str(update.symbol));
+      continue;
+    }
+    if (update.side == BookSide::BID) {
+      if (!is_behind_top_ || !is_shadowed<true>(update.px)) {
+        set_level<true>(bid_map_, update.px, update.sz);
+      }
+    } else if (!is_behind_top_ || !is_shadowed<false>(update.px)) {
+      set_level<false>(ask_map_, update.px, update.sz);
+    }
+  }
+  trim();
+  refill_mirrors();
+  analyzer_.publish(bid_map_, ask_map_);
+}
+
+void OrderBook::apply_top(const binance::TopOfBook& top) {
+  std::lock_guard lock(mutex_);
+  if (top.symbol != binance::SymbolEnum::BTCUSDT) {
+    spdlog::error("wrong symbol, skipping top of book. value [{}]",
+                  binance::Symbol::to_str(top.symbol));
+    return;
+  }
+  if (top.last_update_id <= last_update_id_ ||
+      (top_ && top.last_update_id <= top_->last_update_id)) {
+    return;
+  }
+  overlay_top(top);
+  top_ = top;
+  trim();
+  refill_mirrors();
+  analyzer_.publish(bid_map_, ask_map_);
+}
+
+void OrderBook::on_deep_update_id(const std::optional<uint64_t> last_update_id) {
+  // without an id the message can't be placed against the top: applied whole
+  is_behind_top_ = top_ && last_update_id && *last_update_id < top_->last_update_id;
+  if (top_ && last_update_id && !is_behind_top_) {
+    top_.reset();
+  }
+}
+
+template <bool IS_BID>
+bool OrderBook::is_shadowed(const uint64_t px) const {
+  const std::optional<binance::TopOfBook::Level>& level = IS_BID ? top_->bid : top_->ask;
+  if (!level) {
+    return false;
+  }
+  // a deleted level says nothing of the better ones
+  if (level->sz == 0) {
+    return px == level->px;
+  }
+  return IS_BID ? px >= level->px : px <= level->px;
+}
+
+void OrderBook::overlay_top(const binance::TopOfBook& top) {
+  if (top.bid) {
+    overlay_level<true>(bid_map_, *top.bid);
+  }
+  if (top.ask) {
+    overlay_level<false>(ask_map_, *top.ask);
+  }
+}
+
+template <bool IS_BID>
+void OrderBook::overlay_level(auto& bid_ask_map, const binance::TopOfBook::Level& level) {
+  // a deleted level goes alone: the better ones may be the new best
+  if (level.sz == 0) {
+    set_level<IS_BID>(bid_ask_map, level.px, 0);
+    return;
+  }
+  // both maps are ordered best first
+  while (!bid_ask_map.empty() && (IS_BID ? bid_ask_map.begin()->first > level.px
+                                         : bid_ask_map.begin()->first < level.px)) {
+    set_level<IS_BID>(bid_ask_map, bid_ask_map.begin()->first, 0);
+  }
+  set_level<IS_BID>(bid_ask_map, level.px, level.sz);
+}
+
+void OrderBook::trim() {
+  if (max_levels_ == 0) {
+    return;
+  }
+  trim_side<true>(bid_map_);
+  trim_side<false>(ask_map_);
+}
+
+template <bool IS_BID>
+void OrderBook::trim_side(auto& bid_ask_map) {
+  // both maps are ordered best first: the worst level is the last, erased in amortised
+  // O(1), and a level is trimmed at most once per insertion
+  while (bid_ask_map.size() > max_levels_) {
+    const auto worst = std::prev(bid_ask_map.end());
+    on_level_change<IS_BID>(worst->first, worst->second, 0);
+    bid_ask_map.erase(worst);
+    ++trimmed_levels_;
+  }
+}
+
+void OrderBook::refill_mirrors() {
+  if (bid_mirror_.needs_refill()) {
+    bid_mirror_.assign(bid_map_);
+  }
+  if (ask_mirror_.needs_refill()) {
+    ask_mirror_.assign(ask_map_);
+  }
+}
+
+std::optional<uint64_t> OrderBook::size_within(const BookSide side,
+                                               const uint64_t px_distance) const {
+  std::lock_guard lock(mutex_);
+  const LevelMirror& mirror = get_mirror(side);
+  if (mirror.size() == 0) {
+    return 0;
+  }
+  const uint64_t best = mirror.prices().back();
+  const uint64_t limit = side == BookSide::BID
+                             ? (best > px_distance ? best - px_distance : 0)
+                             : best + px_distance;
+  return mirror.size_to_price(limit);
+}
+
+std::optional<uint64_t> OrderBook::size_within_bps_of_mid(const BookSide side,
+                                                          const double bps) const {
+  std::lock_guard lock(mutex_);
+  if (bid_mirror_.size() == 0 || ask_mirror_.size() == 0) {
+    return std::nullopt;
+  }
+  const double mid = (static_cast<double>(bid_mirror_.prices().back()) +
+                      static_cast<double>(ask_mirror_.prices().back())) /
+                     2.0;
+  constexpr double BPS_PER_UNIT = 10'000.0;
+  const double distance = mid * bps / BPS_PER_UNIT;
+  // round towards the mid, so that the limit is never outside the band
+  if (side == BookSide::BID) {
+    const double limit = std::ceil(mid - distance);
+    return bid_mirror_.size_to_price(limit <= 0.0 ? 0 : static_cast<uint64_t>(limit));
+  }
+  return ask_mirror_.size_to_price(static_cast<uint64_t>(std::floor(mid + distance)));
+}
+
+std::optional<uint64_t> OrderBook::price_to_fill(const BookSide side,
+                                                 const uint64_t sz) const {
+  std::lock_guard lock(mutex_);
+  return get_mirror(side).price_to_fill(sz);
+}
+
+std::optional<uint64_t> OrderBook::notional_to_fill(const BookSide side,
+                                                    const uint64_t sz) const {
+  std::lock_guard lock(mutex_);
+  return get_mirror(side).notional_to_fill(sz);
+}
+
+size_t OrderBook::cumulative_sizes(const BookSide side,
+                                   const std::span<uint64_t> out) const {
+  std::lock_guard lock(mutex_);
+  return get_mirror(side).cumulative_sizes(out);
+}
+
+template <bool IS_BID>
+void OrderBook::on_level_change(const uint64_t px,
+                                const uint64_t old_sz,
+                                const uint64_t new_sz) {
+  if constexpr (IS_BID) {
+    analyzer_.on_bid_change(px, old_sz, new_sz);
+    bid_mirror_.set(px, new_sz);
+  } else {
+    analyzer_.on_ask_change(px, old_sz, new_sz);
+    ask_mirror_.set(px, new_sz);
+  }
+}
+
+template <bool IS_BID>
+void OrderBook::set_level(auto& bid_ask_map, const uint64_t px, const uint64_t sz) {
+  // keep the analytics in step with each level, using the size it replaces
+  if (sz == 0) {
+    const auto it = bid_ask_map.find(px);
+    if (it != bid_ask_map.end()) {
+      on_level_change<IS_BID>(px, it->second, 0);
+      bid_ask_map.erase(it);
+    }
+    return;
+  }
+  const auto [it, is_new] = bid_ask_map.try_emplace(px, sz);
+  on_level_change<IS_BID>(px, is_new ? 0 : it->second, sz);
+  it->second = sz;
 }
 
 void OrderBook::handle_price_level_update(
@@ -162,14 +580,25 @@ void OrderBook::handle_price_level_update(
   uint64_t px =
       utils::Double::toUint64(group.get(temp_vars_.e_px).getValue(),
                               binance::Config::get_price_ticks_per_unit(symbol));
+  constexpr bool IS_BID =
+      std::is_same_v<std::decay_t<decltype(bid_ask_map)>, decltype(bid_map_)>;
+  if (is_behind_top_ && is_shadowed<IS_BID>(px)) {
+    return;
+  }
   //
   switch (action.getValue()) {
     case FIX::MDUpdateAction_DELETE:
-      bid_ask_map.erase(px);
+      set_level<IS_BID>(bid_ask_map, px, 0);
       break;
     case FIX::MDUpdateAction_CHANGE: {
       if (is_book_clear_needed) {
         bid_ask_map.clear();
+        analyzer_.on_reset();
+        if constexpr (IS_BID) {
+          bid_mirror_.clear();
+        } else {
+          ask_mirror_.clear();
+        }
       }
       [[fallthrough]];
     }
@@ -177,7 +606,7 @@ void OrderBook::handle_price_level_update(
       uint64_t sz =
           utils::Double::toUint64(group.get(temp_vars_.e_sz).getValue(),
                                   binance::Config::get_size_ticks_per_unit(symbol));
-      bid_ask_map[px] = sz;
+      set_level<IS_BID>(bid_ask_map, px, sz);
     } break;
     default:
       spdlog::error("unknown price action. value [{}]", action.getValue());
@@ -1,23 +1,48 @@
 #pragma once
 
+#include <quickfix/FieldMap.h>
 #include <quickfix/fix44/MarketDataIncrementalRefresh.h>
 #include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
 
+#include <atomic>
 #include <functional>
 #include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
 
 #include "../binance/symbol.h"
+#include "../binance/top_of_book.h"
 #include "../utils/env.h"
 #include "absl/container/btree_map.h"
 #include "bid_ask.h"
+#include "book_analytics.h"
+#include "level_mirror.h"
 
 namespace core {
 
+/// @brief one level's new size, what an increment's entry boils down to. size 0
+/// deletes the level
+struct LevelUpdate {
+  binance::SymbolEnum symbol = binance::SymbolEnum::BTCUSDT;
+  BookSide side = BookSide::BID;
+  /// @brief in ticks
+  uint64_t px = 0;
+  uint64_t sz = 0;
+
+  bool operator==(const LevelUpdate&) const = default;
+};
+
 /// An order book class backed by two (synchronised) bid/ask maps
 class OrderBook {
  public:
+  /// @brief levels per side kept in the contiguous mirror used by the queries below.
+  /// Binance serves at most 5000 levels
+  static inline constexpr size_t MIRROR_LEVELS = 5'000;
+
   explicit OrderBook(absl::btree_map<uint64_t, uint64_t, std::greater<>> bid_map = {},
-                     absl::btree_map<uint64_t, uint64_t> ask_map = {});
+                     absl::btree_map<uint64_t, uint64_t> ask_map = {},
+                     BookAnalyticsConfig analytics_config = {});
 
   // Mutex is not copyable:
   // 1. Delete copy constructor and copy assignment
@@ -27,12 +52,98 @@ class OrderBook {
   OrderBook(OrderBook&&) noexcept;
   // OrderBook& operator=(OrderBook&&) noexcept;
 
+  /// @brief a provisional book, e.g. restored from a checkpoint: usable straight away,
+  /// but only approximate until the next snapshot replaces it
+  /// @param bids best (highest) first
+  /// @param asks best (lowest) first
+  static OrderBook from_levels(std::span<const PriceLevel> bids,
+                               std::span<const PriceLevel> asks,
+                               uint64_t last_update_id);
+
   void apply_snapshot(const FIX44::MarketDataSnapshotFullRefresh&);
   void apply_increment(const FIX44::MarketDataIncrementalRefresh&,
                        bool is_book_clear_needed);
+  /// @brief the level updates of an increment, appended to `out`, in order. unlike
+  /// `apply_increment`, a change never clears the side (`MAX_DEPTH` 1)
+  /// @return the increment's `LastBookUpdateID`, if set
+  static std::optional<uint64_t> to_level_updates(
+      const FIX44::MarketDataIncrementalRefresh& msg,
+      std::vector<LevelUpdate>& out);
+  /// @brief Binance's `LastBookUpdateID`, when set on `fields`: a message, or the first
+  /// entry of an increment
+  static std::optional<uint64_t> read_last_update_id(const FIX::FieldMap& fields);
+  /// @brief apply level updates as one message, e.g. conflated ones
+  /// @param last_update_id nullopt to keep the book's
+  void apply_levels(std::span<const LevelUpdate> updates,
+                    std::optional<uint64_t> last_update_id);
+  /// @brief fuse the depth-1 stream's best bid and offer into the deep book: the levels
+  /// better than a side's new best go, the best takes its size; a deleted best goes
+  /// alone. Until a deep message
+  /// reaches the top's update id, the deep entries at or better than the top are older
+  /// than it and skipped; from then on the deep book is whole again.
+  /// A top no newer than the book is ignored
+  void apply_top(const binance::TopOfBook& top);
   /// @brief return the contents of the order book as a simple vector.
   /// useful for generating the UI
   std::vector<BidAsk> to_vector();
+  /// @brief copy the best `out.size()` rows, laid out as in `to_vector`, into `out`.
+  /// bounded and allocation free, for publishing the top of the book to readers
+  /// @return the number of rows written
+  size_t top_levels(std::span<BidAsk> out) const;
+  /// @brief derived signals (microprice, imbalance, depth, sweep cost), as of the last
+  /// applied message. lock-free, any thread
+  BookAnalytics get_analytics() const;
+
+  // ─────────── Depth queries ───────────
+  // vectorised scans over the top `MIRROR_LEVELS` levels of a side.
+  // prices and sizes in ticks, nullopt when the answer lies beyond the mirrored levels
+
+  /// @brief total size resting within `px_distance` of the best price
+  std::optional<uint64_t> size_within(BookSide side, uint64_t px_distance) const;
+  /// @brief total size resting within `bps` basis points of the mid price
+  std::optional<uint64_t> size_within_bps_of_mid(BookSide side, double bps) const;
+  /// @brief the worst price touched when sweeping `sz` from the touch
+  std::optional<uint64_t> price_to_fill(BookSide side, uint64_t sz) const;
+  /// @brief price * size (ticks^2) to sweep `sz` from the touch
+  std::optional<uint64_t> notional_to_fill(BookSide side, uint64_t sz) const;
+  /// @brief cumulative size of the best `out.size()` levels, best first
+  /// @return the number of levels written
+  size_t cumulative_sizes(BookSide side, std::span<uint64_t> out) const;
+
+  // ─────────── Checkpoints ───────────
+
+  /// @brief levels copied by `copy_levels`, and the update id they are as of
+  struct LevelCounts {
+    size_t bids = 0;
+    size_t asks = 0;
+    uint64_t last_update_id = 0;
+  };
+  /// @brief copy the best `bids.size()` and `asks.size()` levels of each side, best
+  /// first, consistent with the returned update id (one lock)
+  LevelCounts copy_levels(std::span<PriceLevel> bids, std::span<PriceLevel> asks) const;
+  /// @brief Binance's `LastBookUpdateID` of the last message applied, 0 if unknown
+  uint64_t get_last_update_id() const;
+  /// @brief built by `from_levels` and not yet reconciled by a snapshot. lock-free
+  bool is_provisional() const;
+
+  // ─────────── Footprint ───────────
+
+  /// @brief keep at most `max_levels` levels a side: after each applied message the
+  /// worst go. Binance does not delete the levels that leave a depth-N window, they
+  /// would otherwise linger. 0 for unbounded, the default. trims straight away
+  void set_max_levels(size_t max_levels);
+  /// @brief the levels held and the memory they take
+  struct Footprint {
+    size_t bid_levels = 0;
+    size_t ask_levels = 0;
+    /// @brief estimated: the maps' levels at `LEVEL_BYTES`, plus the mirrors
+    size_t bytes = 0;
+    /// @brief levels dropped by `set_max_levels`' policy, ever
+    uint64_t trimmed_levels = 0;
+  };
+  Footprint get_footprint() const;
+  /// @brief a level's share of a btree: its price and size, in leaves about 3/4 full
+  static inline constexpr size_t LEVEL_BYTES = 24;
 
  private:
   // mutex for reading/writing to bid/ask maps
@@ -42,11 +153,54 @@ class OrderBook {
   absl::btree_map<uint64_t, uint64_t, std::greater<>> bid_map_;
   /// @brief sorted list of offers (ascending), key=price, value=size
   absl::btree_map<uint64_t, uint64_t> ask_map_;
+  /// @brief `LastBookUpdateID` of the last message applied, under mutex_
+  uint64_t last_update_id_ = 0;
+  /// @brief written under mutex_, read lock-free
+  std::atomic<bool> provisional_{false};
+  /// @brief the depth-1 stream's best levels while it is ahead of the deep stream,
+  /// under mutex_. see `apply_top`
+  std::optional<binance::TopOfBook> top_;
+  /// @brief the deep message being applied is older than `top_`, under mutex_
+  bool is_behind_top_ = false;
+  /// @brief levels kept a side, 0 for unbounded. under mutex_
+  size_t max_levels_ = 0;
+  /// @brief under mutex_
+  uint64_t trimmed_levels_ = 0;
+  /// @brief updated incrementally under mutex_, published lock-free
+  BookAnalyzer analyzer_;
+  /// @brief contiguous copies of the top levels, updated under mutex_
+  LevelMirror bid_mirror_{true, MIRROR_LEVELS};
+  LevelMirror ask_mirror_{false, MIRROR_LEVELS};
+  const LevelMirror& get_mirror(const BookSide side) const {
+    return side == BookSide::BID ? bid_mirror_ : ask_mirror_;
+  }
+  /// @brief re-copy the mirrors that shrank too far, once per message
+  void refill_mirrors();
   // Temporary variables can share a cache line
   struct {
     FIX::MDEntryPx e_px;
     FIX::MDEntrySize e_sz;
   } temp_vars_;
+  /// @brief set a level's size, 0 to delete it. under mutex_
+  template <bool IS_BID>
+  void set_level(auto& bid_ask_map, uint64_t px, uint64_t sz);
+  /// @brief keep the analytics and the mirror in step with a level's size. under mutex_
+  template <bool IS_BID>
+  void on_level_change(uint64_t px, uint64_t old_sz, uint64_t new_sz);
+  /// @brief drop the worst levels beyond `max_levels_`, once per message. under mutex_
+  void trim();
+  template <bool IS_BID>
+  void trim_side(auto& bid_ask_map);
+  /// @brief a deep message as of `last_update_id` is about to apply: behind `top_`,
+  /// or caught up with it. under mutex_
+  void on_deep_update_id(std::optional<uint64_t> last_update_id);
+  /// @brief a deep entry older than `top_`'s side. under mutex_
+  template <bool IS_BID>
+  bool is_shadowed(uint64_t px) const;
+  /// @brief make `top`'s sides the best levels. under mutex_
+  void overlay_top(const binance::TopOfBook& top);
+  template <bool IS_BID>
+  void overlay_level(auto& bid_ask_map, const binance::TopOfBook::Level& level);
   inline void handle_price_level_update(
       auto& bid_ask_map,
       binance::SymbolEnum symbol,
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+
 #include "../binance/side.h"
 #include "../utils/env.h"
 
@@ -11,19 +14,23 @@ namespace core {
 /// @brief Binance trade object
 struct alignas(utils::Env::CACHE_LINE_SIZE) Trade {
  public:
+  Trade() = default;
   Trade(const uint64_t px,
         const uint64_t sz,
         const uint64_t id,
         const SideEnum side,
-        std::array<char, 16> time)
-      : px(px), sz(sz), id(id), side(side), time(time) {}
+        std::array<char, 16> time,
+        const uint64_t ts_us = 0)
+      : px(px), sz(sz), id(id), ts_us(ts_us), side(side), time(time) {}
 
-  uint64_t px;
-  uint64_t sz;
-  uint64_t id;
-  SideEnum side;
+  uint64_t px = 0;
+  uint64_t sz = 0;
+  uint64_t id = 0;
+  // transact time, epoch microseconds
+  uint64_t ts_us = 0;
+  SideEnum side{};
   // 15 characters + newline, e.g. "07:17:50.031794"
-  std::array<char, 16> time;
+  std::array<char, 16> time{};
 };
 
 }  // namespace core
@@ -0,0 +1,114 @@
+#include "trade_aggregator.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "../binance/side.h"
+#include "bar.h"
+#include "trade.h"
+
+namespace core {
+
+TradeAggregator::TradeAggregator() {
+  for (size_t r = 0; r < RESOLUTION_COUNT; ++r) {
+    series_[r].write([r](Series& s) { s.resolution_us = RESOLUTIONS_US[r]; });
+  }
+}
+
+void TradeAggregator::on_trade(const Trade& trade) {
+  for (size_t r = 0; r < RESOLUTION_COUNT; ++r) {
+    const uint64_t res = RESOLUTIONS_US[r];
+    const uint64_t start = trade.ts_us - (trade.ts_us % res);
+    series_[r].write([&trade, res, start](Series& s) {
+      // late trade for a bucket that has already left the ring
+      if (start + (BAR_COUNT * res) <= s.latest_start_us) {
+        return;
+      }
+      Bar& bar = s.bars[(start / res) % BAR_COUNT];
+      if (bar.start_us != start) {
+        // recycle the slot
+        bar = Bar{};
+        bar.start_us = start;
+      }
+      apply(bar, trade);
+      s.latest_start_us = std::max(s.latest_start_us, start);
+    });
+  }
+
+  totals_.write([&trade](Bar& totals) {
+    if (totals.is_empty()) {
+      totals.start_us = trade.ts_us;
+    }
+    apply(totals, trade);
+  });
+}
+
+TradeAggregator::Series TradeAggregator::get_series(const Resolution resolution) const {
+  return series_[to_index(resolution)].load();
+}
+
+Bar TradeAggregator::get_totals() const {
+  return totals_.load();
+}
+
+uint64_t TradeAggregator::version() const {
+  return totals_.version();
+}
+
+// static
+std::string_view TradeAggregator::to_str_view(const Resolution resolution) {
+  switch (resolution) {
+    case Resolution::SECOND_1:
+      return "1s";
+    case Resolution::MINUTE_1:
+      return "1m";
+    case Resolution::MINUTE_5:
+      return "5m";
+  }
+  return "?";
+}
+
+// static
+void TradeAggregator::apply(Bar& bar, const Trade& trade) {
+  if (bar.is_empty()) {
+    bar.open = trade.px;
+    bar.high = trade.px;
+    bar.low = trade.px;
+  } else {
+    bar.high = std::max(bar.high, trade.px);
+    bar.low = std::min(bar.low, trade.px);
+  }
+  bar.close = trade.px;
+  bar.volume += trade.sz;
+  if (trade.side == binance::SideEnum::BUY) {
+    bar.buy_volume += trade.sz;
+  } else {
+    bar.sell_volume += trade.sz;
+  }
+  bar.notional += trade.px * trade.sz;
+  ++bar.trade_count;
+}
+
+std::vector<Bar> TradeAggregator::Series::latest(const size_t count) const {
+  std::vector<Bar> out;
+  if (resolution_us == 0) {
+    return out;
+  }
+  const size_t buckets = std::min(count, BAR_COUNT);
+  out.reserve(buckets);
+  uint64_t start = latest_start_us;
+  for (size_t i = 0; i < buckets; ++i) {
+    const Bar& bar = bars[(start / resolution_us) % BAR_COUNT];
+    if (bar.start_us == start && !bar.is_empty()) {
+      out.push_back(bar);
+    }
+    if (start < resolution_us) {
+      break;
+    }
+    start -= resolution_us;
+  }
+  std::ranges::reverse(out);
+  return out;
+}
+
+}  // namespace core
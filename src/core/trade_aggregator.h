@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "../utils/seqlock.h"
+#include "bar.h"
+#include "trade.h"
+
+namespace core {
+
+/// @brief Incremental trade aggregation: OHLCV bars at several resolutions at once,
+/// with VWAP, aggressor buy/sell volume split and trade counts, plus session totals.
+/// Bars live in fixed-size rings indexed by time bucket, so each trade is O(1) with no
+/// allocation. Single writer (the trade thread), lock-free readers from any thread.
+class TradeAggregator {
+ public:
+  enum class Resolution : uint8_t {
+    SECOND_1 = 0,
+    MINUTE_1 = 1,
+    MINUTE_5 = 2,
+  };
+  static inline constexpr size_t RESOLUTION_COUNT = 3;
+  /// @brief bucket width per resolution, in microseconds
+  static inline constexpr std::array<uint64_t, RESOLUTION_COUNT> RESOLUTIONS_US = {
+      1'000'000, 60'000'000, 300'000'000};
+  /// @brief bars kept per resolution, i.e. ~2 minutes of 1s bars, ~2 hours of 1m bars
+  static inline constexpr size_t BAR_COUNT = 128;
+
+  /// @brief a ring of bars for one resolution
+  struct Series {
+   public:
+    uint64_t resolution_us = 0;
+    /// @brief start of the most recent bucket that has seen a trade
+    uint64_t latest_start_us = 0;
+    std::array<Bar, BAR_COUNT> bars{};
+
+    /// @brief the bars of the most recent `count` buckets, oldest first.
+    /// buckets without trades are skipped
+    std::vector<Bar> latest(size_t count) const;
+  };
+
+  TradeAggregator();
+
+  TradeAggregator(const TradeAggregator&) = delete;
+  TradeAggregator& operator=(const TradeAggregator&) = delete;
+
+  /// @brief fold a trade into every resolution and the session totals.
+  /// writer thread only
+  void on_trade(const Trade& trade);
+
+  /// @brief consistent copy of one resolution's bars. any thread
+  Series get_series(Resolution resolution) const;
+  /// @brief session totals as one bar (open = first trade, start = first trade time).
+  /// any thread
+  Bar get_totals() const;
+  /// @brief bumped on every trade, for cheap change detection
+  uint64_t version() const;
+
+  static std::string_view to_str_view(Resolution resolution);
+
+ private:
+  std::array<utils::SeqLock<Series>, RESOLUTION_COUNT> series_;
+  utils::SeqLock<Bar> totals_;
+
+  static void apply(Bar& bar, const Trade& trade);
+  static constexpr size_t to_index(const Resolution r) noexcept {
+    return static_cast<size_t>(r);
+  }
+};
+
+}  // namespace core
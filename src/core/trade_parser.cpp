@@ -0,0 +1,122 @@
+#include "trade_parser.h"
+
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../binance/config.h"
+#include "../binance/side.h"
+#include "../binance/symbol.h"
+#include "../utils/double.h"
+#include "spdlog/spdlog.h"
+#include "trade.h"
+
+namespace core {
+
+// static
+size_t TradeParser::parse(const FIX44::MarketDataIncrementalRefresh& msg,
+                          std::vector<Trade>& out) {
+  const size_t initial_size = out.size();
+  FIX::NoMDEntries entries;
+  msg.get(entries);
+  const int num_entries = entries.getValue();
+
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries group;
+  FIX::Symbol fsym;
+  std::optional<binance::SymbolEnum> symbol;
+  FIX::MDEntryPx e_px;
+  FIX::MDEntrySize e_sz;
+  FIX::MDEntryType e_type;
+  FIX::TransactTime e_time;
+  uint64_t price, size;
+  FIX::TradeID trade_id;
+  std::string trade_id_str;
+  uint64_t trade_id_uint;
+  // Binance's "side" field ("AggressorSide") is a custom field, not part of the FIX spec
+  constexpr int AGGRESSOR_TAG = 2446;
+  FIX::CharField side_field(AGGRESSOR_TAG);
+  binance::SideEnum side{};
+  for (int i = 1; i <= num_entries; i++) {
+    trade_id_str.clear();
+    trade_id_uint = 0;
+
+    msg.getGroup(i, group);
+
+    // Update symbol if present or first group
+    if (i == 1 || group.isSetField(FIX::FIELD::Symbol)) {
+      group.get(fsym);
+      symbol = binance::Symbol::from_str(fsym.getValue());
+    }
+    if (!symbol) {
+      spdlog::error("missing symbol, skipping trade entry. value [{}]", fsym.getValue());
+      continue;
+    }
+    // debug
+    if (symbol != binance::SymbolEnum::BTCUSDT) {
+      spdlog::error("wrong symbol, skipping increment. value [{}]",
+                    binance::Symbol::to_str(symbol.value()));
+      continue;
+    }
+
+    group.get(e_type);
+    switch (e_type.getValue()) {
+      case FIX::MDEntryType_TRADE: {
+        if (group.isSetField(AGGRESSOR_TAG)) {
+          price = utils::Double::toUint64(
+              group.get(e_px).getValue(),
+              binance::Config::get_price_ticks_per_unit(symbol.value()));
+
+          size = utils::Double::toUint64(
+              group.get(e_sz).getValue(),
+              binance::Config::get_size_ticks_per_unit(symbol.value()));
+
+          group.getField(trade_id);
+          trade_id_str = trade_id.getValue();
+          std::from_chars(trade_id_str.data(), trade_id_str.data() + trade_id_str.size(),
+                          trade_id_uint);
+
+          group.getField(side_field);
+          side = binance::Side::from_str(side_field.getValue());
+
+          constexpr size_t TIME_STRLEN = 16;
+          std::array<char, TIME_STRLEN> tm_arr{};
+          uint64_t ts_us = 0;
+          if (group.isSetField(FIX::FIELD::TransactTime)) {
+            group.getField(e_time);
+            FIX::UtcTimeStamp tval = e_time.getValue();
+            std::snprintf(tm_arr.data(), tm_arr.size(), "%02u:%02u:%02u.%06u",
+                          std::min<unsigned>(tval.getHour(), 23),
+                          std::min<unsigned>(tval.getMinute(), 59),
+                          std::min<unsigned>(tval.getSecond(), 59),
+                          std::min<unsigned>(tval.getMicroecond(), 999999));
+            ts_us = static_cast<uint64_t>(tval.getTimeT()) * 1'000'000u +
+                    static_cast<uint64_t>(tval.getMicroecond());
+          } else {
+            // fall back to receive time, so that the trade still lands in a bar
+            ts_us = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count());
+          }
+
+          out.emplace_back(price, size, trade_id_uint, side, tm_arr, ts_us);
+        } else {
+          spdlog::error("trade with no side. message [{}]", msg.toString());
+        }
+      } break;
+      default:
+        spdlog::error("unknown trade FIX::MDEntryType. value [{}]", e_type.getValue());
+    }
+  }
+  return out.size() - initial_size;
+}
+
+}  // namespace core
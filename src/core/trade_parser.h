@@ -0,0 +1,23 @@
+#pragma once
+
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "trade.h"
+
+namespace core {
+
+/// @brief Turns Binance trade stream messages into @ref core::Trade, prices and sizes
+/// in ticks. Free of any UI, shared by the trade box and the headless profiling harness.
+class TradeParser {
+ public:
+  /// @brief append the trades in `msg` to `out`. entries of another symbol, or that are
+  /// not trades, are logged and skipped
+  /// @return the number of trades appended
+  static size_t parse(const FIX44::MarketDataIncrementalRefresh& msg,
+                      std::vector<Trade>& out);
+};
+
+}  // namespace core
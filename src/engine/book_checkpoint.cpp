@@ -0,0 +1,277 @@
+#include "book_checkpoint.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "spdlog/spdlog.h"
+
+namespace engine {
+
+namespace {
+
+/// @brief FNV-1a, a 64-bit word at a time: cheap over a few hundred KB
+class Checksum {
+ public:
+  void add(const uint64_t word) { hash_ = (hash_ ^ word) * PRIME; }
+  void add(const std::span<const core::PriceLevel> levels) {
+    for (const core::PriceLevel& level : levels) {
+      add(level.px);
+      add(level.sz);
+    }
+  }
+  uint64_t get() const { return hash_; }
+
+ private:
+  static inline constexpr uint64_t PRIME = 0x100000001B3;
+  uint64_t hash_ = 0xCBF29CE484222325;
+};
+
+uint64_t checksum(const CheckpointSlotHeader& header,
+                  const std::span<const core::PriceLevel> bids,
+                  const std::span<const core::PriceLevel> asks) {
+  Checksum sum;
+  sum.add(header.sequence);
+  sum.add(header.last_update_id);
+  sum.add(header.saved_at_us);
+  sum.add((static_cast<uint64_t>(header.bid_count) << 32) | header.ask_count);
+  sum.add(bids.first(header.bid_count));
+  sum.add(asks.first(header.ask_count));
+  return sum.get();
+}
+
+uint64_t now_us() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count());
+}
+
+size_t slot_size(const size_t max_levels) {
+  return sizeof(CheckpointSlotHeader) + 2 * max_levels * sizeof(core::PriceLevel);
+}
+
+}  // namespace
+
+BookCheckpoint::BookCheckpoint(std::filesystem::path path,
+                               const binance::SymbolEnum symbol,
+                               const std::chrono::seconds interval,
+                               const size_t max_levels)
+    : path_(std::move(path)),
+      symbol_(symbol),
+      interval_(interval),
+      max_levels_(max_levels),
+      size_(file_size(max_levels)) {
+  if (interval_.count() <= 0 || max_levels_ == 0 || max_levels_ > UINT32_MAX) {
+    throw std::runtime_error(
+        std::format("invalid book checkpoint. interval [{}], max levels [{}]",
+                    interval_.count(), max_levels_));
+  }
+  if (path_.has_parent_path()) {
+    std::filesystem::create_directories(path_.parent_path());
+  }
+  const int fd = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error(
+        std::format("cannot open book checkpoint. path [{}], error [{}]", path_.string(),
+                    std::strerror(errno)));
+  }
+  struct stat st{};
+  const bool is_sized = ::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == size_;
+  if (!is_sized && ::ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+    const int err = errno;
+    ::close(fd);
+    throw std::runtime_error(
+        std::format("cannot size book checkpoint. path [{}], error [{}]", path_.string(),
+                    std::strerror(err)));
+  }
+  void* addr = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error(
+        std::format("cannot map book checkpoint. path [{}], error [{}]", path_.string(),
+                    std::strerror(errno)));
+  }
+  data_ = static_cast<uint8_t*>(addr);
+
+  CheckpointHeader header{};
+  std::memcpy(&header, data_, sizeof(header));
+  const std::string_view name = binance::Symbol::to_str_view(symbol_);
+  if (!is_sized || header.magic != CHECKPOINT_MAGIC ||
+      header.version != CHECKPOINT_VERSION || header.max_levels != max_levels_ ||
+      std::string_view(header.symbol.data(),
+                       ::strnlen(header.symbol.data(), header.symbol.size())) != name) {
+    if (header.magic != 0) {
+      spdlog::warn("book checkpoint of another symbol or layout, starting afresh. "
+                   "path [{}]",
+                   path_.string());
+    }
+    reset();
+  }
+  if (const std::optional<size_t> latest = find_latest()) {
+    sequence_ = slot_header(*latest).sequence;
+  }
+}
+
+BookCheckpoint::~BookCheckpoint() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+  }
+}
+
+// static function
+std::unique_ptr<BookCheckpoint> BookCheckpoint::from_env() {
+  const char* path = std::getenv("BOOK_CHECKPOINT_PATH");
+  if (path == nullptr || *path == '\0') {
+    spdlog::info("envar not set, not checkpointing the book. key [BOOK_CHECKPOINT_PATH]");
+    return nullptr;
+  }
+  std::chrono::seconds interval = DEFAULT_INTERVAL;
+  if (const char* val = std::getenv("BOOK_CHECKPOINT_INTERVAL_S")) {
+    const std::string_view str{val};
+    int64_t seconds = 0;
+    const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), seconds);
+    if (ec != std::errc() || ptr != str.data() + str.size()) {
+      throw std::runtime_error(
+          std::format("could not parse book checkpoint interval, value [{}]", str));
+    }
+    interval = std::chrono::seconds(seconds);
+  }
+  spdlog::info("checkpointing the book. path [{}], interval [{}s]", path,
+               interval.count());
+  return std::make_unique<BookCheckpoint>(path, binance::SymbolEnum::BTCUSDT, interval);
+}
+
+template <typename Book>
+Book BookCheckpoint::restore() const {
+  const auto start = std::chrono::steady_clock::now();
+  const std::optional<size_t> latest = find_latest();
+  if (!latest) {
+    spdlog::info("no book checkpoint to restore. path [{}]", path_.string());
+    return Book{};
+  }
+  const CheckpointSlotHeader& header = slot_header(*latest);
+  Book book = Book::from_levels(bids(*latest).first(header.bid_count),
+                                asks(*latest).first(header.ask_count),
+                                header.last_update_id);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const uint64_t now = now_us();
+  spdlog::info(
+      "book checkpoint restored, provisional until the first snapshot. path [{}], "
+      "bids [{}], asks [{}], last update id [{}], age s [{}], load us [{}]",
+      path_.string(), header.bid_count, header.ask_count, header.last_update_id,
+      now > header.saved_at_us ? (now - header.saved_at_us) / 1'000'000 : 0,
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+  return book;
+}
+
+template <typename Book>
+void BookCheckpoint::save(const Book& book) {
+  const uint64_t sequence = sequence_ + 1;
+  const size_t slot = sequence % CHECKPOINT_SLOTS;
+  CheckpointSlotHeader& header = slot_header(slot);
+  // invalidate the slot first: the other one stays the latest until this one is whole
+  header.sequence = 0;
+  header.checksum = 0;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+
+  const core::OrderBook::LevelCounts counts = book.copy_levels(bids(slot), asks(slot));
+  header.last_update_id = counts.last_update_id;
+  header.saved_at_us = now_us();
+  header.bid_count = static_cast<uint32_t>(counts.bids);
+  header.ask_count = static_cast<uint32_t>(counts.asks);
+  header.sequence = sequence;
+  const uint64_t sum = checksum(header, bids(slot), asks(slot));
+  // the checksum is stored last, a crash before it leaves the slot invalid
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  header.checksum = sum;
+
+  sequence_ = sequence;
+  ++saved_;
+  spdlog::debug("book checkpoint saved. sequence [{}], bids [{}], asks [{}]", sequence,
+                counts.bids, counts.asks);
+}
+
+template core::OrderBook BookCheckpoint::restore<core::OrderBook>() const;
+template core::BboBook BookCheckpoint::restore<core::BboBook>() const;
+template void BookCheckpoint::save<core::OrderBook>(const core::OrderBook&);
+template void BookCheckpoint::save<core::BboBook>(const core::BboBook&);
+
+std::chrono::seconds BookCheckpoint::get_interval() const {
+  return interval_;
+}
+
+const std::filesystem::path& BookCheckpoint::get_path() const {
+  return path_;
+}
+
+uint64_t BookCheckpoint::get_saved() const {
+  return saved_;
+}
+
+// static function
+size_t BookCheckpoint::file_size(const size_t max_levels) {
+  return sizeof(CheckpointHeader) + CHECKPOINT_SLOTS * slot_size(max_levels);
+}
+
+CheckpointSlotHeader& BookCheckpoint::slot_header(const size_t slot) const {
+  return *reinterpret_cast<CheckpointSlotHeader*>(data_ + sizeof(CheckpointHeader) +
+                                                  slot * slot_size(max_levels_));
+}
+
+std::span<core::PriceLevel> BookCheckpoint::bids(const size_t slot) const {
+  auto* levels = reinterpret_cast<core::PriceLevel*>(&slot_header(slot) + 1);
+  return {levels, max_levels_};
+}
+
+std::span<core::PriceLevel> BookCheckpoint::asks(const size_t slot) const {
+  return {bids(slot).data() + max_levels_, max_levels_};
+}
+
+std::optional<size_t> BookCheckpoint::find_latest() const {
+  std::optional<size_t> latest;
+  uint64_t latest_sequence = 0;
+  for (size_t slot = 0; slot < CHECKPOINT_SLOTS; ++slot) {
+    const CheckpointSlotHeader& header = slot_header(slot);
+    if (header.sequence <= latest_sequence || header.bid_count > max_levels_ ||
+        header.ask_count > max_levels_ ||
+        header.checksum != checksum(header, bids(slot), asks(slot))) {
+      continue;
+    }
+    latest = slot;
+    latest_sequence = header.sequence;
+  }
+  return latest;
+}
+
+void BookCheckpoint::reset() {
+  std::memset(data_, 0, size_);
+  CheckpointHeader header{
+      .magic = CHECKPOINT_MAGIC,
+      .version = CHECKPOINT_VERSION,
+      .max_levels = static_cast<uint32_t>(max_levels_),
+      .symbol = {},
+  };
+  const std::string_view name = binance::Symbol::to_str_view(symbol_);
+  std::copy_n(name.begin(), std::min(name.size(), header.symbol.size() - 1),
+              header.symbol.begin());
+  std::memcpy(data_, &header, sizeof(header));
+}
+
+}  // namespace engine
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+
+#include "../binance/symbol.h"
+#include "../core/bbo_book.h"
+#include "../core/bid_ask.h"
+#include "../core/order_book.h"
+
+namespace engine {
+
+// ─────────── Layout ───────────
+// [CheckpointHeader][slot 0][slot 1], a slot being
+// [CheckpointSlotHeader][bids: PriceLevel x max_levels][asks: PriceLevel x max_levels]
+
+/// @brief "TRDRCKP1"
+inline constexpr uint64_t CHECKPOINT_MAGIC = 0x31504B4352445254;
+/// @brief bumped on any change to the structs below
+inline constexpr uint32_t CHECKPOINT_VERSION = 1;
+inline constexpr size_t CHECKPOINT_SLOTS = 2;
+
+struct CheckpointHeader {
+  uint64_t magic;
+  uint32_t version;
+  /// @brief levels per side each slot has room for
+  uint32_t max_levels;
+  std::array<char, 16> symbol;
+};
+static_assert(sizeof(CheckpointHeader) == 32);
+
+struct CheckpointSlotHeader {
+  /// @brief checkpoints ever written to the file, the highest valid slot is the latest.
+  /// 0 for a slot never written
+  uint64_t sequence;
+  /// @brief Binance's `LastBookUpdateID` the levels are as of
+  uint64_t last_update_id;
+  /// @brief wall clock, epoch microseconds
+  uint64_t saved_at_us;
+  uint32_t bid_count;
+  uint32_t ask_count;
+  /// @brief over the fields above and the levels in use, written last
+  uint64_t checksum;
+  std::array<uint64_t, 3> reserved;
+};
+static_assert(sizeof(CheckpointSlotHeader) == 64);
+static_assert(sizeof(core::PriceLevel) == 16);
+
+/// @brief Checkpoints the order book to a memory-mapped file, so that a restart has an
+/// approximate book in milliseconds instead of after logon, subscription and a
+/// multi-thousand-level snapshot.
+/// The file holds two slots, written alternately: a checkpoint torn by a crash fails
+/// its checksum and the previous one is used. A restored book is provisional
+/// ( @ref core::OrderBook::is_provisional ) until the first live snapshot replaces it.
+/// Single writer. The mapping is shared, so a checkpoint survives a crash of the
+/// process as soon as `save` returns.
+class BookCheckpoint {
+ public:
+  /// @brief levels per side kept, as many as the book mirrors
+  static inline constexpr size_t MAX_LEVELS = core::OrderBook::MIRROR_LEVELS;
+  static inline constexpr std::chrono::seconds DEFAULT_INTERVAL{5};
+
+  /// @brief open, or create, and map the file. a file of another symbol or layout is
+  /// started afresh
+  /// @throws std::runtime_error when the file cannot be opened, sized or mapped
+  BookCheckpoint(std::filesystem::path path,
+                 binance::SymbolEnum symbol,
+                 std::chrono::seconds interval = DEFAULT_INTERVAL,
+                 size_t max_levels = MAX_LEVELS);
+  ~BookCheckpoint();
+
+  BookCheckpoint(const BookCheckpoint&) = delete;
+  BookCheckpoint& operator=(const BookCheckpoint&) = delete;
+
+  /// @brief `BOOK_CHECKPOINT_PATH` (optional): where to checkpoint the BTCUSDT book,
+  /// nullptr when not set. `BOOK_CHECKPOINT_INTERVAL_S` (optional): how often
+  static std::unique_ptr<BookCheckpoint> from_env();
+
+  /// @brief the latest valid checkpoint as a provisional book, or an empty book
+  /// @tparam Book @ref core::OrderBook or @ref core::BboBook
+  template <typename Book = core::OrderBook>
+  Book restore() const;
+  /// @brief copy the best levels of `book` over the older slot
+  template <typename Book>
+  void save(const Book& book);
+
+  std::chrono::seconds get_interval() const;
+  const std::filesystem::path& get_path() const;
+  /// @brief checkpoints written by this instance
+  uint64_t get_saved() const;
+  /// @brief bytes mapped
+  static size_t file_size(size_t max_levels);
+
+ private:
+  const std::filesystem::path path_;
+  const binance::SymbolEnum symbol_;
+  const std::chrono::seconds interval_;
+  const size_t max_levels_;
+  const size_t size_;
+  uint8_t* data_ = nullptr;
+  /// @brief of the latest valid slot, 0 if none
+  uint64_t sequence_ = 0;
+  uint64_t saved_ = 0;
+
+  CheckpointSlotHeader& slot_header(size_t slot) const;
+  std::span<core::PriceLevel> bids(size_t slot) const;
+  std::span<core::PriceLevel> asks(size_t slot) const;
+  /// @brief the valid slot with the highest sequence
+  std::optional<size_t> find_latest() const;
+  /// @brief zero the file and write the header
+  void reset();
+};
+
+}  // namespace engine
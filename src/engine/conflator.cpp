@@ -0,0 +1,90 @@
+#include "conflator.h"
+
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+
+#include "spdlog/spdlog.h"
+
+namespace engine {
+
+Conflator::Conflator(const size_t trigger_depth, const size_t capacity)
+    : trigger_depth_(trigger_depth),
+      capacity_(capacity),
+      // at most half full, short probes
+      mask_(std::bit_ceil(capacity * 2) - 1),
+      slots_(mask_ + 1, EMPTY_) {
+  if (trigger_depth_ == 0 || capacity_ == 0) {
+    throw std::runtime_error(
+        std::format("conflator trigger depth and capacity must be positive. depth [{}], "
+                    "capacity [{}]",
+                    trigger_depth_, capacity_));
+  }
+  used_slots_.reserve(capacity_);
+  updates_.reserve(capacity_);
+}
+
+// static function
+std::unique_ptr<Conflator> Conflator::from_env() {
+  size_t depth = DEFAULT_TRIGGER_DEPTH;
+  if (const char* val = std::getenv("BOOK_CONFLATION_DEPTH")) {
+    const std::string_view str{val};
+    const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), depth);
+    if (ec != std::errc() || ptr != str.data() + str.size()) {
+      throw std::runtime_error(
+          std::format("could not parse book conflation depth, value [{}]", str));
+    }
+  }
+  spdlog::info("fetched envar. key [BOOK_CONFLATION_DEPTH], value [{}]", depth);
+  if (depth == 0) {
+    return nullptr;
+  }
+  return std::make_unique<Conflator>(depth);
+}
+
+bool Conflator::add(const core::LevelUpdate& update) {
+  size_t slot = hash(update) & mask_;
+  while (slots_[slot] != EMPTY_) {
+    core::LevelUpdate& pending = updates_[slots_[slot] - 1];
+    if (is_same_level(pending, update)) {
+      pending.sz = update.sz;
+      return true;
+    }
+    slot = (slot + 1) & mask_;
+  }
+  if (updates_.size() == capacity_) {
+    return false;
+  }
+  updates_.push_back(update);
+  slots_[slot] = static_cast<uint32_t>(updates_.size());
+  used_slots_.push_back(slot);
+  return true;
+}
+
+void Conflator::clear() {
+  for (const size_t slot : used_slots_) {
+    slots_[slot] = EMPTY_;
+  }
+  used_slots_.clear();
+  updates_.clear();
+}
+
+// static function
+size_t Conflator::hash(const core::LevelUpdate& update) {
+  // Fibonacci hashing: nearby prices, the common case, land far apart
+  const uint64_t key = update.px ^ (static_cast<uint64_t>(update.symbol) << 57) ^
+                       (static_cast<uint64_t>(update.side) << 56);
+  return static_cast<size_t>((key * 0x9E37'79B9'7F4A'7C15ull) >> 32);
+}
+
+// static function
+bool Conflator::is_same_level(const core::LevelUpdate& a, const core::LevelUpdate& b) {
+  return a.px == b.px && a.side == b.side && a.symbol == b.symbol;
+}
+
+}  // namespace engine
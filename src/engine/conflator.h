@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "../core/order_book.h"
+
+namespace engine {
+
+/// @brief Collapses book level updates per (symbol, side, price) to the latest size, so
+/// that a book worker behind its queue applies each touched level once instead of
+/// replaying every stale increment: it catches up in time bounded by the levels
+/// touched, not by the messages queued.
+/// A small open-addressing map (linear probing, power-of-two slots at most half full)
+/// indexes the pending updates, which stay in first-seen order. Clearing only resets the
+/// slots in use. Not thread-safe, owned by the book worker.
+class Conflator {
+ public:
+  /// @brief conflate once the order queue holds this many messages
+  static inline constexpr size_t DEFAULT_TRIGGER_DEPTH = 1'024;
+  /// @brief distinct levels pending before a flush is needed
+  static inline constexpr size_t DEFAULT_CAPACITY = 4'096;
+
+  /// @throws std::runtime_error if `trigger_depth` or `capacity` is 0
+  explicit Conflator(size_t trigger_depth = DEFAULT_TRIGGER_DEPTH,
+                     size_t capacity = DEFAULT_CAPACITY);
+
+  Conflator(const Conflator&) = delete;
+  Conflator& operator=(const Conflator&) = delete;
+
+  /// @brief `BOOK_CONFLATION_DEPTH` (optional): the order queue depth from which the
+  /// book worker conflates, 0 for off
+  /// @return nullptr if off
+  static std::unique_ptr<Conflator> from_env();
+
+  size_t get_trigger_depth() const { return trigger_depth_; }
+  size_t get_capacity() const { return capacity_; }
+
+  /// @brief replace the pending size of the update's level, or add the level
+  /// @return false if the level is new and `capacity` levels are pending: flush first
+  bool add(const core::LevelUpdate& update);
+  /// @brief the pending updates, one per level, in the order the levels were first seen
+  std::span<const core::LevelUpdate> get_updates() const { return updates_; }
+  size_t size() const { return updates_.size(); }
+  bool empty() const { return updates_.empty(); }
+  void clear();
+
+ private:
+  static inline constexpr uint32_t EMPTY_ = 0;
+
+  const size_t trigger_depth_;
+  const size_t capacity_;
+  /// @brief `slots_.size() - 1`
+  const size_t mask_;
+  /// @brief index into `updates_` + 1, `EMPTY_` for a free slot
+  std::vector<uint32_t> slots_;
+  /// @brief slots taken, to clear only those
+  std::vector<size_t> used_slots_;
+  std::vector<core::LevelUpdate> updates_;
+
+  static size_t hash(const core::LevelUpdate& update);
+  static bool is_same_level(const core::LevelUpdate& a, const core::LevelUpdate& b);
+};
+
+}  // namespace engine
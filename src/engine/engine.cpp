@@ -0,0 +1,474 @@
+#include "engine.h"
+
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "../binance/symbol.h"
+#include "../binance/top_of_book.h"
+#include "../core/bbo_book.h"
+#include "../core/order_book.h"
+#include "../core/trade_parser.h"
+#include "../utils/run_loop.h"
+#include "../utils/thread_placement.h"
+#include "../utils/threading.h"
+#include "shm_publisher.h"
+#include "spdlog/spdlog.h"
+
+namespace engine {
+
+namespace {
+
+/// Adaptive backoff strategy for spin+sleep polling
+/// Performs an adaptive backoff by spinning then sleeping, increasing sleep
+/// time exponentially. Yield 10x times, followed by a 2x sleep capped at
+/// 1ms
+class AdaptiveBackoff {
+ public:
+  void wait() {
+    constexpr uint8_t MIN_SPINS = 10;
+    constexpr uint16_t MAX_SLEEP_US = 1'000;
+    if (spin_count_ < MIN_SPINS) {
+      ++spin_count_;
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(sleep_time_us_));
+      sleep_time_us_ = std::min(static_cast<uint16_t>(sleep_time_us_ * 2u), MAX_SLEEP_US);
+    }
+  }
+  void reset() {
+    spin_count_ = 0;
+    sleep_time_us_ = INITIAL_SLEEP_US;
+  }
+
+ private:
+  static inline constexpr uint8_t INITIAL_SLEEP_US = 10;
+  uint8_t spin_count_ = 0;
+  uint16_t sleep_time_us_ = INITIAL_SLEEP_US;
+};
+
+/// @brief no conflation at depth 1: a change replaces the side's level, conflating per
+/// price would lose the order of the changes
+std::unique_ptr<Conflator> unless_depth_one(std::unique_ptr<Conflator> conflator,
+                                            const bool is_depth_one) {
+  if (conflator && is_depth_one) {
+    spdlog::warn("book conflation needs a depth above 1, not conflating");
+    return nullptr;
+  }
+  return conflator;
+}
+
+/// @brief a cold-start time, -1 while not reached
+std::optional<std::chrono::microseconds> to_time(const int64_t us) {
+  if (us < 0) {
+    return std::nullopt;
+  }
+  return std::chrono::microseconds(us);
+}
+
+}  // namespace
+
+std::vector<core::Trade> TradeTape::to_vector() const {
+  const size_t count = std::min<uint64_t>(total, MAX_TRADES);
+  std::vector<core::Trade> out;
+  out.reserve(count);
+  for (uint64_t i = total - count; i < total; ++i) {
+    out.push_back(trades[i % MAX_TRADES]);
+  }
+  return out;
+}
+
+template <typename Book>
+BasicEngine<Book>::BasicEngine(
+    moodycamel::ConcurrentQueue<binance::MarketMessageVariant>& order_queue,
+    moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh>& trade_queue,
+    const uint16_t max_depth,
+    Book book,
+    std::unique_ptr<ShmPublisher> shm,
+    std::unique_ptr<tape::TapeWriter> tape,
+    std::unique_ptr<BookCheckpoint> checkpoint,
+    std::unique_ptr<Conflator> conflator)
+    : IS_BOOK_CLEAR_NEEDED_(max_depth == 1),
+      order_queue_(order_queue),
+      trade_queue_(trade_queue),
+      shm_(std::move(shm)),
+      tape_(std::move(tape)),
+      checkpoint_(std::move(checkpoint)),
+      conflator_(
+          unless_depth_one(std::move(conflator), IS_BOOK_CLEAR_NEEDED_ || IS_BBO_)),
+      book_(std::move(book)) {
+  // readers see the initial book before the first message
+  publish_book();
+}
+
+template <typename Book>
+BasicEngine<Book>::~BasicEngine() {
+  stop();
+}
+
+template <typename Book>
+void BasicEngine<Book>::start() {
+  book_worker_ = std::jthread{[this](const std::stop_token& stoken) {
+    run_worker(std::string(THREAD_NAME_BOOK_), [&] { poll_order_queue(stoken); });
+  }};
+  trade_worker_ = std::jthread{[this](const std::stop_token& stoken) {
+    run_worker(std::string(THREAD_NAME_TRADE_), [&] { poll_trade_queue(stoken); });
+  }};
+  if (checkpoint_) {
+    checkpoint_stop_ = std::stop_source{};
+    checkpointer_ =
+        utils::RunLoop::background().spawn(run_checkpoints(checkpoint_stop_.get_token()));
+  }
+}
+
+template <typename Book>
+void BasicEngine<Book>::stop() {
+  book_worker_.request_stop();
+  trade_worker_.request_stop();
+  checkpoint_stop_.request_stop();
+  const bool was_running = book_worker_.joinable();
+  if (book_worker_.joinable()) {
+    book_worker_.join();
+  }
+  if (trade_worker_.joinable()) {
+    trade_worker_.join();
+  }
+  checkpointer_.wait();
+  // after the trade thread, its only producer
+  if (tape_) {
+    tape_->stop();
+  }
+  // the book is final: the next start resumes from here
+  if (checkpoint_ && was_running) {
+    checkpoint_book();
+  }
+}
+
+template <typename Book>
+std::exception_ptr BasicEngine<Book>::get_exception() const {
+  std::lock_guard lock(exception_mutex_);
+  return thread_exception_;
+}
+
+template <typename Book>
+BookSnapshot BasicEngine<Book>::get_book() const {
+  return book_snapshot_.load();
+}
+
+template <typename Book>
+uint64_t BasicEngine<Book>::get_book_version() const {
+  return book_snapshot_.version();
+}
+
+template <typename Book>
+TradeTape BasicEngine<Book>::get_trades() const {
+  return trade_tape_.load();
+}
+
+template <typename Book>
+uint64_t BasicEngine<Book>::get_trades_version() const {
+  return trade_tape_.version();
+}
+
+template <typename Book>
+core::BookAnalytics BasicEngine<Book>::get_analytics() const {
+  return book_.get_analytics();
+}
+
+template <typename Book>
+const core::TradeAggregator& BasicEngine<Book>::get_aggregator() const {
+  return aggregator_;
+}
+
+template <typename Book>
+Stats BasicEngine<Book>::get_stats() const {
+  const core::OrderBook::Footprint footprint = book_.get_footprint();
+  return Stats{
+      .book_messages = book_messages_.load(std::memory_order_relaxed),
+      .book_publishes = book_publishes_.load(std::memory_order_relaxed),
+      .conflated_messages = conflated_messages_.load(std::memory_order_relaxed),
+      .conflated_updates = conflated_updates_.load(std::memory_order_relaxed),
+      .conflated_levels = conflated_levels_.load(std::memory_order_relaxed),
+      .trade_messages = trade_messages_.load(std::memory_order_relaxed),
+      .trades = trade_count_.load(std::memory_order_relaxed),
+      .book_levels = footprint.bid_levels + footprint.ask_levels,
+      .book_bytes = footprint.bytes,
+      .trimmed_levels = footprint.trimmed_levels,
+      .order_queue_depth = order_queue_.size_approx(),
+      .trade_queue_depth = trade_queue_.size_approx(),
+      .first_book_time = to_time(first_book_us_.load(std::memory_order_relaxed)),
+      .first_live_book_time =
+          to_time(first_live_book_us_.load(std::memory_order_relaxed)),
+  };
+}
+
+template <typename Book>
+void BasicEngine<Book>::run_worker(const std::string& name,
+                                   const std::function<void()>& poll) {
+  utils::Threading::set_thread_name(name);
+  spdlog::info("starting engine worker thread, name [{}], id [{}]", name,
+               utils::Threading::get_os_thread_id());
+  try {
+    utils::ThreadPlacement::pin_current_thread(name);
+    poll();
+    spdlog::info("closing worker thread, name [{}]", name);
+  } catch (const std::exception& e) {
+    spdlog::error("error in worker thread. name [{}], error [{}]", name, e.what());
+    keep_exception();
+  } catch (...) {
+    spdlog::error("error in worker thread - unknown error. name [{}]", name);
+    keep_exception();
+  }
+}
+
+template <typename Book>
+void BasicEngine<Book>::keep_exception() {
+  std::lock_guard lock(exception_mutex_);
+  if (!thread_exception_) {
+    thread_exception_ = std::current_exception();
+  }
+}
+
+// book thread
+template <typename Book>
+void BasicEngine<Book>::poll_order_queue(const std::stop_token& stoken) {
+  AdaptiveBackoff backoff;
+  binance::MarketMessageVariant msg;
+  uint16_t unpublished = 0;
+  while (!stoken.stop_requested()) {
+    if (order_queue_.try_dequeue(msg)) {
+      if (conflator_ && order_queue_.size_approx() >= conflator_->get_trigger_depth()) {
+        // behind: catch up on the latest levels, not on every stale increment
+        conflate(msg);
+        unpublished = 0;
+      } else {
+        apply(msg);
+        if (++unpublished >= MAX_UNPUBLISHED_) {
+          publish_book();
+          unpublished = 0;
+        }
+      }
+      backoff.reset();
+      continue;
+    }
+    // drained: readers get one snapshot per burst, not one per message
+    if (unpublished > 0) {
+      publish_book();
+      unpublished = 0;
+    }
+    backoff.wait();
+  }
+}
+
+template <typename Book>
+void BasicEngine<Book>::apply(const binance::MarketMessageVariant& msg) {
+  const uint64_t start = utils::FlightRecorder::now();
+  std::visit(
+      [this](const auto& m) {
+        using T = std::decay_t<decltype(m)>;
+        if constexpr (std::is_same_v<T, FIX44::MarketDataSnapshotFullRefresh>) {
+          book_.apply_snapshot(m);
+        } else if constexpr (std::is_same_v<T, FIX44::MarketDataIncrementalRefresh>) {
+          if constexpr (IS_BBO_) {
+            book_.apply_increment(m);
+          } else {
+            book_.apply_increment(m, IS_BOOK_CLEAR_NEEDED_);
+          }
+        } else if constexpr (std::is_same_v<T, binance::TopOfBook>) {
+          book_.apply_top(m);
+        }
+      },
+      msg);
+  const uint64_t count = book_messages_.fetch_add(1, std::memory_order_relaxed) + 1;
+  recorder_.record(utils::FlightEvent::BOOK_APPLY, static_cast<uint32_t>(msg.index()),
+                   count, utils::FlightRecorder::now() - start);
+}
+
+template <typename Book>
+void BasicEngine<Book>::conflate(binance::MarketMessageVariant& msg) {
+  // bounded: the messages queued by now, not those arriving meanwhile
+  size_t budget = order_queue_.size_approx();
+  for (;;) {
+    if (const auto* increment = std::get_if<FIX44::MarketDataIncrementalRefresh>(&msg)) {
+      conflate_increment(*increment);
+    } else {
+      // a snapshot or a top of book is a barrier: the levels before it go first
+      flush_conflated();
+      apply(msg);
+    }
+    if (budget == 0 || !order_queue_.try_dequeue(msg)) {
+      break;
+    }
+    --budget;
+  }
+  flush_conflated();
+  publish_book();
+}
+
+template <typename Book>
+void BasicEngine<Book>::conflate_increment(
+    const FIX44::MarketDataIncrementalRefresh& msg) {
+  level_updates_.clear();
+  const std::optional<uint64_t> update_id =
+      core::OrderBook::to_level_updates(msg, level_updates_);
+  for (const core::LevelUpdate& update : level_updates_) {
+    if (!conflator_->add(update)) {
+      // full: apply what is pending, as of the previous message
+      flush_conflated();
+      conflator_->add(update);
+    }
+  }
+  if (update_id) {
+    conflated_update_id_ = update_id;
+  }
+  book_messages_.fetch_add(1, std::memory_order_relaxed);
+  conflated_messages_.fetch_add(1, std::memory_order_relaxed);
+  conflated_updates_.fetch_add(level_updates_.size(), std::memory_order_relaxed);
+}
+
+template <typename Book>
+void BasicEngine<Book>::flush_conflated() {
+  if (conflator_->empty() && !conflated_update_id_) {
+    return;
+  }
+  const uint64_t start = utils::FlightRecorder::now();
+  book_.apply_levels(conflator_->get_updates(), conflated_update_id_);
+  const size_t levels = conflator_->size();
+  conflated_levels_.fetch_add(levels, std::memory_order_relaxed);
+  conflator_->clear();
+  conflated_update_id_.reset();
+  recorder_.record(utils::FlightEvent::BOOK_CONFLATE, static_cast<uint32_t>(levels),
+                   book_messages_.load(std::memory_order_relaxed),
+                   utils::FlightRecorder::now() - start);
+}
+
+template <typename Book>
+void BasicEngine<Book>::publish_book() {
+  book_staging_.row_count = static_cast<uint16_t>(book_.top_levels(book_staging_.levels));
+  book_staging_.message_count = book_messages_.load(std::memory_order_relaxed);
+  book_staging_.provisional = book_.is_provisional();
+  book_snapshot_.store(book_staging_);
+  on_first_books(book_staging_);
+  // the book only holds BTCUSDT (see `core::OrderBook::apply_snapshot`)
+  if (shm_) {
+    shm_->publish_book(binance::SymbolEnum::BTCUSDT, book_staging_);
+  }
+  book_publishes_.fetch_add(1, std::memory_order_relaxed);
+  recorder_.record(utils::FlightEvent::BOOK_PUBLISH, book_staging_.row_count,
+                   book_staging_.message_count, order_queue_.size_approx());
+}
+
+template <typename Book>
+void BasicEngine<Book>::on_first_books(const BookSnapshot& book) {
+  if (book.row_count == 0 || first_live_book_us_.load(std::memory_order_relaxed) >= 0) {
+    return;
+  }
+  const int64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - created_at_)
+                                 .count();
+  if (first_book_us_.load(std::memory_order_relaxed) < 0) {
+    first_book_us_.store(elapsed_us, std::memory_order_relaxed);
+    spdlog::info("first book published. provisional [{}], levels [{}], startup us [{}]",
+                 book.provisional, book.row_count, elapsed_us);
+  }
+  if (!book.provisional) {
+    first_live_book_us_.store(elapsed_us, std::memory_order_relaxed);
+    spdlog::info("first live book published. levels [{}], startup us [{}]",
+                 book.row_count, elapsed_us);
+  }
+}
+
+// trade thread
+template <typename Book>
+void BasicEngine<Book>::poll_trade_queue(const std::stop_token& stoken) {
+  AdaptiveBackoff backoff;
+  FIX44::MarketDataIncrementalRefresh msg;
+  while (!stoken.stop_requested()) {
+    if (trade_queue_.try_dequeue(msg)) {
+      on_trade(msg);
+      backoff.reset();
+    } else {
+      backoff.wait();
+    }
+  }
+}
+
+template <typename Book>
+void BasicEngine<Book>::on_trade(const FIX44::MarketDataIncrementalRefresh& msg) {
+  trades_.clear();
+  core::TradeParser::parse(msg, trades_);
+  for (const core::Trade& trade : trades_) {
+    aggregator_.on_trade(trade);
+    trade_tape_.write([&trade](TradeTape& tape) {
+      tape.trades[tape.total % TradeTape::MAX_TRADES] = trade;
+      ++tape.total;
+    });
+    // `core::TradeParser` only keeps BTCUSDT trades
+    if (shm_) {
+      shm_->publish_trade(binance::SymbolEnum::BTCUSDT, trade);
+    }
+    if (tape_) {
+      tape_->push(trade);
+    }
+  }
+  trade_count_.fetch_add(trades_.size(), std::memory_order_relaxed);
+  const uint64_t count = trade_messages_.fetch_add(1, std::memory_order_relaxed) + 1;
+  recorder_.record(utils::FlightEvent::TRADES, static_cast<uint32_t>(trades_.size()),
+                   count, trade_queue_.size_approx());
+}
+
+// background loop
+template <typename Book>
+utils::Task BasicEngine<Book>::run_checkpoints(const std::stop_token stoken) {
+  spdlog::info("starting engine checkpoints on the background loop, interval [{}s]",
+               checkpoint_->get_interval().count());
+  try {
+    for (;;) {
+      const bool is_running =
+          co_await utils::RunLoop::sleep_for(checkpoint_->get_interval(), stoken);
+      if (!is_running) {
+        // woken early by a stop request: `stop` writes the last checkpoint, once the
+        // book thread has stopped
+        break;
+      }
+      checkpoint_book();
+    }
+    spdlog::info("closing engine checkpoints");
+  } catch (const std::exception& e) {
+    spdlog::error("error in engine checkpoints. error [{}]", e.what());
+    keep_exception();
+  } catch (...) {
+    spdlog::error("error in engine checkpoints - unknown error");
+    keep_exception();
+  }
+}
+
+template <typename Book>
+void BasicEngine<Book>::checkpoint_book() {
+  // a provisional book is older than it looks: keep the checkpoint it came from
+  const uint64_t messages = book_messages_.load(std::memory_order_relaxed);
+  if (book_.is_provisional() || messages == checkpointed_messages_) {
+    return;
+  }
+  // copies the levels under the book's lock, once per interval
+  checkpoint_->save(book_);
+  checkpointed_messages_ = messages;
+}
+
+template class BasicEngine<core::OrderBook>;
+template class BasicEngine<core::BboBook>;
+
+}  // namespace engine
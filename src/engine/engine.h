@@ -0,0 +1,251 @@
+#pragma once
+
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../binance/config.h"
+#include "../binance/market_message_variant.h"
+#include "../core/bid_ask.h"
+#include "../core/bbo_book.h"
+#include "../core/book_analytics.h"
+#include "../core/order_book.h"
+#include "../core/trade.h"
+#include "../core/trade_aggregator.h"
+#include "../tape/tape_writer.h"
+#include "../utils/env.h"
+#include "../utils/flight_recorder.h"
+#include "../utils/run_loop.h"
+#include "../utils/seqlock.h"
+#include "book_checkpoint.h"
+#include "concurrentqueue.h"
+#include "conflator.h"
+#include "shm_publisher.h"
+
+namespace engine {
+
+/// @brief the top of the book as last published, best level first
+struct BookSnapshot {
+ public:
+  static inline constexpr size_t MAX_LEVELS = binance::Config::MAX_DEPTH;
+
+  /// @brief rows in use in `levels`
+  uint16_t row_count = 0;
+  /// @brief book messages applied when this snapshot was taken
+  uint64_t message_count = 0;
+  /// @brief restored from a checkpoint, not yet reconciled by a live snapshot:
+  /// approximate
+  bool provisional = false;
+  std::array<core::BidAsk, MAX_LEVELS> levels{};
+};
+
+/// @brief the most recent trades, in a fixed ring
+struct TradeTape {
+ public:
+  static inline constexpr size_t MAX_TRADES = 100;
+
+  /// @brief trades ever written, the next one goes to `trades[total % MAX_TRADES]`
+  uint64_t total = 0;
+  std::array<core::Trade, MAX_TRADES> trades{};
+
+  /// @brief the trades in the ring, oldest first
+  std::vector<core::Trade> to_vector() const;
+};
+
+/// @brief counters, readable from any thread
+struct Stats {
+ public:
+  uint64_t book_messages = 0;
+  uint64_t book_publishes = 0;
+  /// @brief book messages folded into conflated batches, of `book_messages`
+  uint64_t conflated_messages = 0;
+  /// @brief level updates in those messages, and levels applied after conflation
+  uint64_t conflated_updates = 0;
+  uint64_t conflated_levels = 0;
+  uint64_t trade_messages = 0;
+  uint64_t trades = 0;
+  /// @brief levels held by the book, both sides, and the memory they take (estimated)
+  size_t book_levels = 0;
+  size_t book_bytes = 0;
+  /// @brief levels dropped by the book's max-levels policy
+  uint64_t trimmed_levels = 0;
+  /// @brief approximate, messages waiting on each queue
+  size_t order_queue_depth = 0;
+  size_t trade_queue_depth = 0;
+  /// @brief cold start: from the engine's construction to the first non-empty book
+  /// published (restored from a checkpoint, or live), and to the first live one
+  std::optional<std::chrono::microseconds> first_book_time = std::nullopt;
+  std::optional<std::chrono::microseconds> first_live_book_time = std::nullopt;
+};
+
+/// @brief The market data engine, free of any UI: consumes the order and trade queues
+/// filled by the FIX sessions, maintains the order book and the trade bars, and
+/// publishes snapshots for readers (the terminal UI, metrics).
+/// Each pipeline runs on its own worker thread and is the single writer of its state.
+/// Readers only ever copy published snapshots, lock-free, so that however often or
+/// slowly they read, they never hold up book maintenance. Snapshots can also be
+/// published to shared memory for other processes ( @ref engine::ShmPublisher ),
+/// trades persisted to disk ( @ref tape::TapeWriter ), and the book checkpointed for a
+/// warm start ( @ref engine::BookCheckpoint ), both on the background loop.
+/// A book worker that falls behind its queue conflates ( @ref engine::Conflator ):
+/// pending increments collapse to the latest size per level, snapshots are barriers.
+/// @tparam Book the book the worker maintains, @ref core::OrderBook or, for depth-1
+/// subscriptions, @ref core::BboBook. see @ref engine::Engine
+template <typename Book>
+class BasicEngine {
+ public:
+  static inline constexpr bool IS_BBO_ = std::is_same_v<Book, core::BboBook>;
+  static inline constexpr std::string_view THREAD_NAME_BOOK_ = "engine_book";
+  static inline constexpr std::string_view THREAD_NAME_TRADE_ = "engine_trade";
+  /// @brief publish at least once every this many book messages during a burst,
+  /// otherwise once the queue is drained
+  static inline constexpr uint16_t MAX_UNPUBLISHED_ = 64;
+
+  BasicEngine(
+      moodycamel::ConcurrentQueue<binance::MarketMessageVariant>& order_queue,
+      moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh>& trade_queue,
+      uint16_t max_depth = binance::Config::MAX_DEPTH,
+      Book book = Book{},
+      std::unique_ptr<ShmPublisher> shm = nullptr,
+      std::unique_ptr<tape::TapeWriter> tape = nullptr,
+      std::unique_ptr<BookCheckpoint> checkpoint = nullptr,
+      std::unique_ptr<Conflator> conflator = nullptr);
+  ~BasicEngine();
+
+  BasicEngine(const BasicEngine&) = delete;
+  BasicEngine& operator=(const BasicEngine&) = delete;
+
+  /// @brief start the book and trade worker threads, and the checkpoints if any
+  void start();
+  /// @brief stop and join the worker threads, then write a last checkpoint
+  void stop();
+  /// @brief the first exception raised by a worker thread or the checkpoints, if any
+  std::exception_ptr get_exception() const;
+
+  // ─────────── Readers, any thread ───────────
+
+  BookSnapshot get_book() const;
+  /// @brief bumped on every book publish, for cheap change detection
+  uint64_t get_book_version() const;
+  TradeTape get_trades() const;
+  /// @brief bumped on every trade, for cheap change detection
+  uint64_t get_trades_version() const;
+  /// @brief derived book signals, as of the last applied message
+  core::BookAnalytics get_analytics() const;
+  /// @brief bars built from the trades seen
+  const core::TradeAggregator& get_aggregator() const;
+  Stats get_stats() const;
+
+ private:
+  /// when working with Binance, if MAX_DEPTH is set to 1,
+  /// price-update `FIX::MDUpdateAction_CHANGE` events need to clear the book.
+  /// this boolean evaluates this condition, for the full book: a `core::BboBook` only
+  /// ever holds one level a side
+  const bool IS_BOOK_CLEAR_NEEDED_;
+
+  // queues from the FIX threads
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant>& order_queue_;
+  moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh>& trade_queue_;
+  /// @brief optional, shared-memory copies of the snapshots
+  const std::unique_ptr<ShmPublisher> shm_;
+  /// @brief optional, persists the trades to disk
+  const std::unique_ptr<tape::TapeWriter> tape_;
+  /// @brief optional, periodic copies of the book for a warm start
+  const std::unique_ptr<BookCheckpoint> checkpoint_;
+  /// @brief optional, collapses the backlog when the book worker lags. nullptr at depth
+  /// 1, a change replaces the side's level there
+  const std::unique_ptr<Conflator> conflator_;
+  /// @brief recent hot-path events, dumped on a crash
+  utils::FlightRecorder& recorder_ = utils::FlightRecorder::global();
+
+  // book worker state
+  Book book_;
+  /// @brief staging area for the next publish, book worker only
+  BookSnapshot book_staging_;
+  utils::SeqLock<BookSnapshot> book_snapshot_;
+  alignas(utils::Env::CACHE_LINE_SIZE) std::atomic<uint64_t> book_messages_{0};
+  std::atomic<uint64_t> book_publishes_{0};
+  std::atomic<uint64_t> conflated_messages_{0};
+  std::atomic<uint64_t> conflated_updates_{0};
+  std::atomic<uint64_t> conflated_levels_{0};
+  /// @brief an increment's level updates, reused
+  std::vector<core::LevelUpdate> level_updates_;
+  /// @brief `LastBookUpdateID` of the last increment conflated
+  std::optional<uint64_t> conflated_update_id_;
+  // cold start, in microseconds since `created_at_`, -1 until reached
+  const std::chrono::steady_clock::time_point created_at_ =
+      std::chrono::steady_clock::now();
+  std::atomic<int64_t> first_book_us_{-1};
+  std::atomic<int64_t> first_live_book_us_{-1};
+
+  // checkpoint state
+  /// @brief book messages applied as of the last checkpoint
+  uint64_t checkpointed_messages_ = 0;
+
+  // trade worker state
+  core::TradeAggregator aggregator_;
+  utils::SeqLock<TradeTape> trade_tape_;
+  /// @brief trades parsed from the last message, reused
+  std::vector<core::Trade> trades_;
+  alignas(utils::Env::CACHE_LINE_SIZE) std::atomic<uint64_t> trade_messages_{0};
+  std::atomic<uint64_t> trade_count_{0};
+
+  // threads
+  mutable std::mutex exception_mutex_;
+  std::exception_ptr thread_exception_;
+  std::jthread book_worker_;
+  std::jthread trade_worker_;
+  std::stop_source checkpoint_stop_;
+  utils::TaskHandle checkpointer_;
+
+  /// @brief poll the order queue, apply to the book, publish.
+  /// runs on the book thread ( @ref engine::BasicEngine::THREAD_NAME_BOOK_ )
+  void poll_order_queue(const std::stop_token& stoken);
+  /// @brief poll the trade queue, feed the bars and the tape.
+  /// runs on the trade thread ( @ref engine::BasicEngine::THREAD_NAME_TRADE_ )
+  void poll_trade_queue(const std::stop_token& stoken);
+  void apply(const binance::MarketMessageVariant& msg);
+  /// @brief conflate `msg` and the messages queued behind it, as many as were queued
+  /// when it was dequeued, then apply the levels and publish
+  void conflate(binance::MarketMessageVariant& msg);
+  /// @brief fold an increment's level updates into the conflator
+  void conflate_increment(const FIX44::MarketDataIncrementalRefresh& msg);
+  /// @brief apply the conflated levels to the book as one message
+  void flush_conflated();
+  void publish_book();
+  void on_trade(const FIX44::MarketDataIncrementalRefresh& msg);
+  /// @brief checkpoint the book every interval.
+  /// runs on the background loop ( @ref utils::RunLoop::background )
+  utils::Task run_checkpoints(std::stop_token stoken);
+  /// @brief save the book, unless it is provisional or unchanged since the last save
+  void checkpoint_book();
+  /// @brief record the cold-start times the first time they are reached
+  void on_first_books(const BookSnapshot& book);
+  /// @brief name the thread, log and keep the first exception of `poll`
+  void run_worker(const std::string& name, const std::function<void()>& poll);
+  /// @brief keep the exception being handled, if it is the first
+  void keep_exception();
+};
+
+extern template class BasicEngine<core::OrderBook>;
+extern template class BasicEngine<core::BboBook>;
+
+/// @brief the engine for the configured subscription depth, its book picked at compile
+/// time: no per-update branch on the depth
+using Engine = BasicEngine<core::BookFor<binance::Config::MAX_DEPTH>>;
+
+}  // namespace engine
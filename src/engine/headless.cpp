@@ -0,0 +1,179 @@
+#include "headless.h"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "../binance/config.h"
+#include "../binance/symbol.h"
+#include "../core/bid_ask.h"
+#include "../utils/thread_telemetry.h"
+#include "engine.h"
+#include "spdlog/spdlog.h"
+
+namespace engine {
+
+namespace {
+
+std::atomic<bool> stop_requested{false};
+static_assert(std::atomic<bool>::is_always_lock_free, "must be async-signal-safe");
+
+void handle_stop_signal(int /*sig*/) {
+  Headless::request_stop();
+}
+
+/// @brief a price in ticks as a decimal, "-" for an empty side
+std::string format_px(const uint64_t px) {
+  if (px == core::BidAsk::SENTINEL_) {
+    return "-";
+  }
+  return std::format(
+      "{:.2f}",
+      static_cast<double>(px) /
+          binance::Config::get_price_ticks_per_unit(binance::SymbolEnum::BTCUSDT));
+}
+
+/// @brief a cold-start time in milliseconds, "-" until reached
+std::string format_ms(const std::optional<std::chrono::microseconds> time) {
+  if (!time) {
+    return "-";
+  }
+  return std::format("{:.1f}", static_cast<double>(time->count()) / 1'000.0);
+}
+
+/// @brief level updates conflated per level applied, "-" before any conflation
+std::string format_ratio(const uint64_t updates, const uint64_t levels) {
+  if (levels == 0) {
+    return "-";
+  }
+  return std::format("{:.1f}",
+                     static_cast<double>(updates) / static_cast<double>(levels));
+}
+
+}  // namespace
+
+Headless::Headless(const Engine& engine,
+                   const std::chrono::seconds metrics_interval,
+                   std::ostream& out,
+                   const utils::ThreadTelemetry* telemetry)
+    : engine_(engine),
+      metrics_interval_(metrics_interval),
+      out_(out),
+      telemetry_(telemetry) {
+  if (metrics_interval_.count() <= 0) {
+    throw std::runtime_error(std::format("metrics interval must be positive. value [{}]",
+                                         metrics_interval_.count()));
+  }
+}
+
+// static
+Headless Headless::from_env(const Engine& engine,
+                            std::ostream& out,
+                            const utils::ThreadTelemetry* telemetry) {
+  std::chrono::seconds interval = DEFAULT_METRICS_INTERVAL;
+  if (const char* val = std::getenv("METRICS_INTERVAL_S")) {
+    const std::string_view str{val};
+    int64_t seconds = 0;
+    const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), seconds);
+    if (ec != std::errc() || ptr != str.data() + str.size()) {
+      throw std::runtime_error(
+          std::format("could not parse metrics interval, value [{}]", str));
+    }
+    interval = std::chrono::seconds(seconds);
+  }
+  spdlog::info("fetched envar. key [METRICS_INTERVAL_S], value [{}]", interval.count());
+  return Headless{engine, interval, out, telemetry};
+}
+
+// static
+bool Headless::is_enabled_by_env() {
+  const char* val = std::getenv("HEADLESS");
+  if (val == nullptr) {
+    return false;
+  }
+  const std::string_view str{val};
+  return str == "1" || str == "true";
+}
+
+// static
+void Headless::request_stop() {
+  stop_requested.store(true, std::memory_order_relaxed);
+}
+
+void Headless::run() {
+  stop_requested.store(false, std::memory_order_relaxed);
+  std::signal(SIGINT, handle_stop_signal);
+  std::signal(SIGTERM, handle_stop_signal);
+  spdlog::info("running headless. metrics interval [{}s]", metrics_interval_.count());
+
+  constexpr std::chrono::milliseconds TICK{100};
+  Stats before = engine_.get_stats();
+  auto last = std::chrono::steady_clock::now();
+  while (!stop_requested.load(std::memory_order_relaxed)) {
+    std::this_thread::sleep_for(TICK);
+    if (engine_.get_exception()) {
+      spdlog::error("engine worker failed, leaving headless mode");
+      break;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last < metrics_interval_) {
+      continue;
+    }
+    const Stats stats = engine_.get_stats();
+    const std::string line = format_metrics(
+        stats, before, std::chrono::duration<double>(now - last).count(),
+        engine_.get_book());
+    out_ << line << '\n';
+    spdlog::info("engine metrics. {}", line);
+    if (telemetry_ != nullptr) {
+      for (const utils::ThreadUsage& usage : telemetry_->get_usage()) {
+        const std::string thread_line = usage.format_metrics();
+        out_ << thread_line << '\n';
+        spdlog::info("thread metrics. {}", thread_line);
+      }
+    }
+    out_ << std::flush;
+    before = stats;
+    last = now;
+  }
+  std::signal(SIGINT, SIG_DFL);
+  std::signal(SIGTERM, SIG_DFL);
+  spdlog::info("leaving headless mode");
+}
+
+// static
+std::string Headless::format_metrics(const Stats& now,
+                                     const Stats& before,
+                                     const double seconds,
+                                     const BookSnapshot& book) {
+  const auto rate = [seconds](const uint64_t to, const uint64_t from) {
+    return seconds > 0 ? static_cast<double>(to - from) / seconds : 0.0;
+  };
+  const core::BidAsk top = book.row_count > 0 ? book.levels[0] : core::BidAsk{};
+  return std::format(
+      "book_msgs={} book_msgs_per_sec={:.0f} book_publishes={} conflated_msgs={} "
+      "conflation_ratio={} trade_msgs={} trades={} trades_per_sec={:.0f} order_queue={} "
+      "trade_queue={} levels={} book_levels={} book_kb={} trimmed_levels={} best_bid={} "
+      "best_ask={} provisional={} first_book_ms={} first_live_book_ms={}",
+      now.book_messages, rate(now.book_messages, before.book_messages),
+      now.book_publishes, now.conflated_messages,
+      format_ratio(now.conflated_updates, now.conflated_levels), now.trade_messages,
+      now.trades,
+      rate(now.trades, before.trades), now.order_queue_depth, now.trade_queue_depth,
+      book.row_count, now.book_levels, now.book_bytes / 1'024, now.trimmed_levels,
+      format_px(top.bid_px), format_px(top.ask_px),
+      book.provisional ? 1 : 0, format_ms(now.first_book_time),
+      format_ms(now.first_live_book_time));
+}
+
+}  // namespace engine
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <string>
+
+#include "../utils/thread_telemetry.h"
+#include "engine.h"
+
+namespace engine {
+
+/// @brief Runs the engine without a UI, as a daemon: blocks until SIGINT/SIGTERM and
+/// writes one metrics line (logfmt) per interval, to the output stream and the log, and
+/// one per named thread if thread telemetry is on.
+class Headless {
+ public:
+  static inline constexpr std::chrono::seconds DEFAULT_METRICS_INTERVAL{10};
+
+  /// @param telemetry optional, the threads' usage reported with the metrics
+  Headless(const Engine& engine,
+           std::chrono::seconds metrics_interval,
+           std::ostream& out,
+           const utils::ThreadTelemetry* telemetry = nullptr);
+  /// @brief read `HEADLESS` (optional, default false) and `METRICS_INTERVAL_S` (optional)
+  static Headless from_env(const Engine& engine,
+                           std::ostream& out,
+                           const utils::ThreadTelemetry* telemetry = nullptr);
+  /// @brief whether `HEADLESS` asks for the daemon rather than the terminal UI
+  static bool is_enabled_by_env();
+
+  /// @brief block until a stop is requested, reporting metrics every interval
+  void run();
+  /// @brief ask `run` to return. async-signal-safe
+  static void request_stop();
+
+  /// @brief a logfmt line comparing two readings taken `seconds` apart
+  static std::string format_metrics(const Stats& now,
+                                    const Stats& before,
+                                    double seconds,
+                                    const BookSnapshot& book);
+
+ private:
+  const Engine& engine_;
+  const std::chrono::seconds metrics_interval_;
+  std::ostream& out_;
+  const utils::ThreadTelemetry* telemetry_;
+};
+
+}  // namespace engine
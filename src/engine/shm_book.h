@@ -0,0 +1,235 @@
+#pragma once
+
+// Client header for the engine's shared-memory market data: the segment layout and a
+// read-only reader. Self-contained (standard library and POSIX only) so that other
+// local processes can include it without the rest of the tree.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace engine {
+
+// ─────────── Layout ───────────
+
+/// @brief "TRDRSHM1", written last by the publisher once the segment is initialised
+inline constexpr uint64_t SHM_MAGIC = 0x314D485352445254;
+/// @brief bumped on any change to the structs below
+inline constexpr uint32_t SHM_LAYOUT_VERSION = 1;
+inline constexpr size_t SHM_MAX_SYMBOLS = 8;
+inline constexpr size_t SHM_MAX_LEVELS = 100;
+inline constexpr size_t SHM_MAX_TRADES = 100;
+inline constexpr size_t SHM_SLOT_ALIGN = 128;
+/// @brief `ShmBook::flags`: restored from a checkpoint, not yet reconciled by a live
+/// snapshot
+inline constexpr uint32_t SHM_BOOK_PROVISIONAL = 1u << 0;
+
+/// @brief one row of the book, prices and sizes in ticks, UINT64_MAX for an empty side
+struct ShmLevel {
+  uint64_t bid_sz;
+  uint64_t bid_px;
+  uint64_t ask_px;
+  uint64_t ask_sz;
+};
+
+struct ShmBook {
+  /// @brief book messages applied by the engine when published
+  uint64_t message_count;
+  /// @brief `CLOCK_MONOTONIC` (steady clock) at publish, for visibility latency
+  uint64_t publish_ns;
+  uint32_t row_count;
+  /// @brief `SHM_BOOK_*` bits
+  uint32_t flags;
+  /// @brief best level first
+  std::array<ShmLevel, SHM_MAX_LEVELS> levels;
+};
+
+struct ShmTrade {
+  uint64_t px;
+  uint64_t sz;
+  uint64_t id;
+  /// @brief transact time, epoch microseconds
+  uint64_t ts_us;
+  /// @brief FIX AggressorSide: '1' buy, '2' sell
+  char side;
+  std::array<char, 7> reserved;
+};
+
+struct ShmTrades {
+  /// @brief trades ever written, the next one goes to `trades[total % SHM_MAX_TRADES]`
+  uint64_t total;
+  uint64_t publish_ns;
+  std::array<ShmTrade, SHM_MAX_TRADES> trades;
+};
+
+/// @brief one symbol. each payload has its own sequence (odd == write in progress),
+/// on its own cache lines so that book and trade readers do not disturb each other
+struct alignas(SHM_SLOT_ALIGN) ShmSlot {
+  /// @brief NUL-terminated, empty when the slot is unused. immutable once published
+  std::array<char, 16> symbol;
+  uint64_t price_ticks_per_unit;
+  uint64_t size_ticks_per_unit;
+  alignas(SHM_SLOT_ALIGN) std::atomic<uint64_t> book_seq;
+  alignas(SHM_SLOT_ALIGN) ShmBook book;
+  alignas(SHM_SLOT_ALIGN) std::atomic<uint64_t> trades_seq;
+  alignas(SHM_SLOT_ALIGN) ShmTrades trades;
+};
+
+struct ShmHeader {
+  std::atomic<uint64_t> magic;
+  uint32_t layout_version;
+  uint32_t slot_count;
+  uint64_t segment_size;
+  int64_t writer_pid;
+};
+
+struct ShmSegment {
+  alignas(SHM_SLOT_ALIGN) ShmHeader header;
+  std::array<ShmSlot, SHM_MAX_SYMBOLS> slots;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "lock-free atomics are address-free, as required across processes");
+static_assert(std::is_trivially_copyable_v<ShmBook> &&
+              std::is_trivially_copyable_v<ShmTrades>);
+
+// ─────────── Sequence protocol ───────────
+
+inline void shm_cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+/// @brief single writer: update `value` in place under `seq`
+template <typename T, typename Fn>
+void shm_write(std::atomic<uint64_t>& seq, T& value, Fn&& fn) noexcept {
+  const uint64_t s = seq.load(std::memory_order_relaxed);
+  seq.store(s + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  fn(value);
+  seq.store(s + 2, std::memory_order_release);
+}
+
+/// @brief copy `value` into `out` consistently, retrying while the writer is mid-update
+/// @return the number of completed writes the copy reflects, 0 if never written
+template <typename T>
+uint64_t shm_read(const std::atomic<uint64_t>& seq, const T& value, T& out) noexcept {
+  for (;;) {
+    const uint64_t before = seq.load(std::memory_order_acquire);
+    if ((before & 1u) == 0) {
+      std::memcpy(static_cast<void*>(&out), &value, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq.load(std::memory_order_relaxed) == before) {
+        return before / 2;
+      }
+    }
+    shm_cpu_relax();
+  }
+}
+
+// ─────────── Reader ───────────
+
+/// @brief Maps the segment read-only. Snapshots are plain memory copies under the
+/// slot's sequence: no syscalls, no locks, and the publisher never waits for readers.
+class ShmBookReader {
+ public:
+  /// @param name POSIX shared-memory name, e.g. "/tradercpp_md"
+  /// @throws std::runtime_error when the segment is missing or of another layout
+  explicit ShmBookReader(const std::string& name) {
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      throw std::runtime_error(
+          std::format("cannot open shared memory. name [{}], error [{}]", name,
+                      std::strerror(errno)));
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmSegment)) {
+      ::close(fd);
+      throw std::runtime_error(
+          std::format("shared memory too small. name [{}], size [{}], expected [{}]",
+                      name, st.st_size, sizeof(ShmSegment)));
+    }
+    void* addr = ::mmap(nullptr, sizeof(ShmSegment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+      throw std::runtime_error(
+          std::format("cannot map shared memory. name [{}], error [{}]", name,
+                      std::strerror(errno)));
+    }
+    segment_ = static_cast<const ShmSegment*>(addr);
+    if (segment_->header.magic.load(std::memory_order_acquire) != SHM_MAGIC ||
+        segment_->header.layout_version != SHM_LAYOUT_VERSION) {
+      ::munmap(const_cast<ShmSegment*>(segment_), sizeof(ShmSegment));
+      throw std::runtime_error(
+          std::format("shared memory not initialised, or of another layout. name [{}]",
+                      name));
+    }
+  }
+
+  ~ShmBookReader() {
+    if (segment_ != nullptr) {
+      ::munmap(const_cast<ShmSegment*>(segment_), sizeof(ShmSegment));
+    }
+  }
+
+  ShmBookReader(const ShmBookReader&) = delete;
+  ShmBookReader& operator=(const ShmBookReader&) = delete;
+
+  /// @brief the slot publishing `symbol`, if any
+  std::optional<size_t> find(const std::string_view symbol) const {
+    for (size_t i = 0; i < segment_->header.slot_count; ++i) {
+      if (symbol == std::string_view(segment_->slots[i].symbol.data())) {
+        return i;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// @brief consistent copy of a slot's book
+  /// @return the publish count it reflects, 0 if nothing was published yet
+  uint64_t read_book(const size_t slot, ShmBook& out) const {
+    const ShmSlot& s = segment_->slots.at(slot);
+    return shm_read(s.book_seq, s.book, out);
+  }
+
+  /// @brief consistent copy of a slot's recent trades
+  /// @return the number of trades it reflects
+  uint64_t read_trades(const size_t slot, ShmTrades& out) const {
+    const ShmSlot& s = segment_->slots.at(slot);
+    return shm_read(s.trades_seq, s.trades, out);
+  }
+
+  /// @brief cheap change detection, without copying
+  uint64_t book_version(const size_t slot) const {
+    return segment_->slots.at(slot).book_seq.load(std::memory_order_acquire) / 2;
+  }
+
+  const ShmSlot& get_slot(const size_t slot) const { return segment_->slots.at(slot); }
+  const ShmHeader& get_header() const { return segment_->header; }
+
+ private:
+  const ShmSegment* segment_ = nullptr;
+};
+
+}  // namespace engine
@@ -0,0 +1,152 @@
+#include "shm_publisher.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "../binance/config.h"
+#include "../binance/symbol.h"
+#include "../core/trade.h"
+#include "engine.h"
+#include "shm_book.h"
+#include "spdlog/spdlog.h"
+
+namespace engine {
+
+namespace {
+
+/// @brief the symbols given a slot, in `SymbolEnum` order, so the slot is the enum value
+constexpr std::array<binance::SymbolEnum, 2> SYMBOLS = {binance::SymbolEnum::BTCUSDT,
+                                                        binance::SymbolEnum::ETHUSDT};
+static_assert(SYMBOLS.size() <= SHM_MAX_SYMBOLS);
+static_assert(BookSnapshot::MAX_LEVELS <= SHM_MAX_LEVELS);
+
+uint64_t now_ns() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+}
+
+}  // namespace
+
+ShmPublisher::ShmPublisher(std::string name) : name_(std::move(name)) {
+  const int fd = ::shm_open(name_.c_str(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    throw std::runtime_error(
+        std::format("cannot create shared memory. name [{}], error [{}]", name_,
+                    std::strerror(errno)));
+  }
+  if (::ftruncate(fd, sizeof(ShmSegment)) != 0) {
+    const int err = errno;
+    ::close(fd);
+    throw std::runtime_error(
+        std::format("cannot size shared memory. name [{}], error [{}]", name_,
+                    std::strerror(err)));
+  }
+  void* addr =
+      ::mmap(nullptr, sizeof(ShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error(
+        std::format("cannot map shared memory. name [{}], error [{}]", name_,
+                    std::strerror(errno)));
+  }
+
+  // a segment left by a previous run: invalidate it before resetting it
+  auto* previous = static_cast<ShmSegment*>(addr);
+  previous->header.magic.store(0, std::memory_order_release);
+  segment_ = new (addr) ShmSegment();
+  for (const binance::SymbolEnum symbol : SYMBOLS) {
+    ShmSlot& slot = get_slot(symbol);
+    const std::string str = binance::Symbol::to_str(symbol);
+    std::copy_n(str.begin(), std::min(str.size(), slot.symbol.size() - 1),
+                slot.symbol.begin());
+    slot.price_ticks_per_unit = binance::Config::get_price_ticks_per_unit(symbol);
+    slot.size_ticks_per_unit = binance::Config::get_size_ticks_per_unit(symbol);
+  }
+  segment_->header.layout_version = SHM_LAYOUT_VERSION;
+  segment_->header.slot_count = SYMBOLS.size();
+  segment_->header.segment_size = sizeof(ShmSegment);
+  segment_->header.writer_pid = ::getpid();
+  // readers check the magic last
+  segment_->header.magic.store(SHM_MAGIC, std::memory_order_release);
+  spdlog::info("publishing market data to shared memory. name [{}], size [{}]", name_,
+               sizeof(ShmSegment));
+}
+
+ShmPublisher::~ShmPublisher() {
+  if (segment_ != nullptr) {
+    segment_->header.magic.store(0, std::memory_order_release);
+    ::munmap(segment_, sizeof(ShmSegment));
+    ::shm_unlink(name_.c_str());
+  }
+}
+
+// static
+std::unique_ptr<ShmPublisher> ShmPublisher::from_env() {
+  const char* val = std::getenv("SHM_NAME");
+  if (val == nullptr || *val == '\0') {
+    spdlog::info("envar not set, not publishing to shared memory. key [SHM_NAME]");
+    return nullptr;
+  }
+  spdlog::info("fetched envar. key [SHM_NAME], value [{}]", val);
+  return std::make_unique<ShmPublisher>(val);
+}
+
+void ShmPublisher::publish_book(const binance::SymbolEnum symbol,
+                                const BookSnapshot& book) noexcept {
+  ShmSlot& slot = get_slot(symbol);
+  const uint64_t publish_ns = now_ns();
+  shm_write(slot.book_seq, slot.book, [&book, publish_ns](ShmBook& out) {
+    out.message_count = book.message_count;
+    out.publish_ns = publish_ns;
+    out.row_count = book.row_count;
+    out.flags = book.provisional ? SHM_BOOK_PROVISIONAL : 0;
+    for (size_t i = 0; i < book.row_count; ++i) {
+      const core::BidAsk& level = book.levels[i];
+      out.levels[i] = ShmLevel{level.bid_sz, level.bid_px, level.ask_px, level.ask_sz};
+    }
+  });
+}
+
+void ShmPublisher::publish_trade(const binance::SymbolEnum symbol,
+                                 const core::Trade& trade) noexcept {
+  ShmSlot& slot = get_slot(symbol);
+  const uint64_t publish_ns = now_ns();
+  shm_write(slot.trades_seq, slot.trades, [&trade, publish_ns](ShmTrades& out) {
+    out.trades[out.total % SHM_MAX_TRADES] =
+        ShmTrade{.px = trade.px,
+                 .sz = trade.sz,
+                 .id = trade.id,
+                 .ts_us = trade.ts_us,
+                 .side = static_cast<char>(trade.side),
+                 .reserved = {}};
+    ++out.total;
+    out.publish_ns = publish_ns;
+  });
+}
+
+const std::string& ShmPublisher::get_name() const {
+  return name_;
+}
+
+ShmSlot& ShmPublisher::get_slot(const binance::SymbolEnum symbol) noexcept {
+  return segment_->slots[static_cast<size_t>(symbol)];
+}
+
+}  // namespace engine
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "../binance/symbol.h"
+#include "../core/trade.h"
+#include "shm_book.h"
+
+namespace engine {
+
+struct BookSnapshot;
+
+/// @brief Publishes the engine's book and trades into a POSIX shared-memory segment
+/// (layout in `shm_book.h`), so that local processes can read them with
+/// @ref engine::ShmBookReader. One slot per symbol, each payload under its own
+/// sequence. Single writer per payload: the book thread for books, the trade thread
+/// for trades.
+class ShmPublisher {
+ public:
+  /// @brief create (or reset) and map the segment
+  /// @param name POSIX shared-memory name, e.g. "/tradercpp_md"
+  /// @throws std::runtime_error when the segment cannot be created or mapped
+  explicit ShmPublisher(std::string name);
+  /// @brief unmap and unlink the segment
+  ~ShmPublisher();
+
+  ShmPublisher(const ShmPublisher&) = delete;
+  ShmPublisher& operator=(const ShmPublisher&) = delete;
+
+  /// @brief `SHM_NAME` (optional): the segment to publish to. nullptr when not set
+  static std::unique_ptr<ShmPublisher> from_env();
+
+  /// @brief book thread only
+  void publish_book(binance::SymbolEnum symbol, const BookSnapshot& book) noexcept;
+  /// @brief trade thread only
+  void publish_trade(binance::SymbolEnum symbol, const core::Trade& trade) noexcept;
+
+  const std::string& get_name() const;
+
+ private:
+  const std::string name_;
+  ShmSegment* segment_ = nullptr;
+  ShmSlot& get_slot(binance::SymbolEnum symbol) noexcept;
+};
+
+}  // namespace engine
@@ -1,13 +1,27 @@
 #include <exception>
+#include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "binance/config.h"
 #include "binance/worker.h"
+#include "core/bbo_book.h"
+#include "engine/book_checkpoint.h"
+#include "engine/conflator.h"
+#include "engine/engine.h"
+#include "engine/headless.h"
+#include "engine/shm_publisher.h"
 #include "spdlog/spdlog.h"
+#include "tape/tape_writer.h"
 #include "ui/app/ui_app.h"
 #include "utils/crash.h"
+#include "utils/jitter_probe.h"
 #include "utils/logging.h"
 #include "utils/process.h"
+#include "utils/run_loop.h"
+#include "utils/thread_placement.h"
+#include "utils/thread_telemetry.h"
 #include "utils/threading.h"
 
 int main() {
@@ -16,22 +30,68 @@ int main() {
     utils::Logging::configure();
     utils::Crash::configure_handlers();
     utils::Process::set_high_priority();
+    // where each named thread runs, before any is started. threads started unnamed
+    // (e.g. by quickfix) keep main's cpus
+    utils::ThreadPlacement::install(utils::ThreadPlacement::from_env());
+    utils::ThreadPlacement::pin_current_thread("main");
+    // check that the hot threads' cpus are quiet, before the threads start
+    if (const auto probe = utils::JitterProbe::from_env()) {
+      const std::vector<utils::JitterReport> reports =
+          probe->run(utils::JitterProbe::get_default_cpus());
+      probe->log(reports);
+      if (engine::Headless::is_enabled_by_env()) {
+        for (const utils::JitterReport& report : reports) {
+          std::cout << report.format_metrics() << '\n';
+        }
+      }
+    }
+
+    // each named thread's cpu time, context switches and faults, for the ui and metrics
+    const auto telemetry = utils::ThreadTelemetry::from_env();
+    if (telemetry) {
+      telemetry->start();
+    }
 
     // Binance market data connectivity
     auto b_conf = binance::Config::from_env();
     auto b_worker = binance::Worker::from_conf(b_conf);
     b_worker.start();
 
-    // ui app (reads from Binance's queues)
-    auto ui =
-        ui::App::from_env(b_worker.get_order_queue(), b_worker.get_trade_queue(), b_conf);
-    // blocking
-    ui.start();
+    // engine (reads from Binance's queues, maintains the book and the bars,
+    // optionally publishes them to shared memory for other processes, persists
+    // the trades and checkpoints the book, starting from the last checkpoint,
+    // conflates the backlog when the book worker lags, bounds the book's levels)
+    auto checkpoint = engine::BookCheckpoint::from_env();
+    using Book = core::BookFor<binance::Config::MAX_DEPTH>;
+    Book book = checkpoint ? checkpoint->restore<Book>() : Book{};
+    book.set_max_levels(b_conf.book_max_levels);
+    engine::Engine engine(b_worker.get_order_queue(), b_worker.get_trade_queue(),
+                          b_conf.MAX_DEPTH, std::move(book),
+                          engine::ShmPublisher::from_env(), tape::TapeWriter::from_env(),
+                          std::move(checkpoint), engine::Conflator::from_env());
+    engine.start();
+
+    if (engine::Headless::is_enabled_by_env()) {
+      // blocking, until SIGINT/SIGTERM
+      engine::Headless::from_env(engine, std::cout, telemetry.get()).run();
+    } else {
+      // ui app (reads the engine's snapshots)
+      auto ui = ui::App::from_env(engine, b_conf, telemetry.get());
+      // blocking
+      ui.start();
+
+      if (ui.thread_exception) {
+        std::rethrow_exception(ui.thread_exception);
+      }
+    }
 
-    if (ui.thread_exception) {
-      std::rethrow_exception(ui.thread_exception);
+    engine.stop();
+    if (const std::exception_ptr e = engine.get_exception()) {
+      std::rethrow_exception(e);
     }
     b_worker.stop();
+    // the low-priority stages' loop, while logging is still up
+    utils::RunLoop::background().stop();
     spdlog::info("goodbye");
   } catch (const std::exception& e) {
     spdlog::critical("[EXCEPTION] Caught exception. ex [{}]", e.what());
@@ -0,0 +1,202 @@
+#include "tape_format.h"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace tape {
+
+namespace {
+
+/// @brief a varint is at most 10 bytes
+constexpr size_t MAX_VARINT_BYTES = 10;
+
+uint64_t zigzag(const int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(const uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+/// @brief wrapping difference, as a signed delta
+int64_t delta(const uint64_t to, const uint64_t from) {
+  return static_cast<int64_t>(to - from);
+}
+
+void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back(static_cast<uint8_t>(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(v));
+}
+
+/// @brief reads the varint at `p`, bounded by `end`
+/// @throws std::runtime_error if it runs past `end`
+uint64_t get_varint(const uint8_t*& p, const uint8_t* end) {
+  uint64_t v = 0;
+  for (unsigned shift = 0; shift < 7 * MAX_VARINT_BYTES; shift += 7) {
+    if (p == end) {
+      break;
+    }
+    const uint8_t byte = *p++;
+    v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return v;
+    }
+  }
+  throw std::runtime_error("corrupt tape block: truncated varint");
+}
+
+BlockHeader read_header(const std::span<const uint8_t> data) {
+  BlockHeader header{};
+  if (data.size() < sizeof(BlockHeader)) {
+    return header;
+  }
+  std::memcpy(&header, data.data(), sizeof(BlockHeader));
+  return header;
+}
+
+bool is_valid(const BlockHeader& header, const size_t available) {
+  if (header.magic != BLOCK_MAGIC || header.count == 0 ||
+      header.count > MAX_BLOCK_TRADES ||
+      sizeof(BlockHeader) + header.payload_bytes > available) {
+    return false;
+  }
+  uint32_t previous = 0;
+  for (const uint32_t offset : header.column_offsets) {
+    if (offset < previous || offset > header.payload_bytes) {
+      return false;
+    }
+    previous = offset;
+  }
+  return true;
+}
+
+}  // namespace
+
+IndexEntry encode_block(const std::span<const TapeTrade> trades,
+                        std::vector<uint8_t>& out) {
+  if (trades.empty() || trades.size() > MAX_BLOCK_TRADES) {
+    throw std::runtime_error(
+        std::format("invalid tape block size. trades [{}]", trades.size()));
+  }
+  const auto [min_ts, max_ts] = std::ranges::minmax(trades, {}, &TapeTrade::ts_us);
+  BlockHeader header{
+      .magic = BLOCK_MAGIC,
+      .count = static_cast<uint32_t>(trades.size()),
+      .min_ts_us = min_ts.ts_us,
+      .max_ts_us = max_ts.ts_us,
+      .first_id = trades.front().id,
+      .first_px = trades.front().px,
+      .min_sz = std::ranges::min(trades, {}, &TapeTrade::sz).sz,
+      .payload_bytes = 0,
+      .column_offsets = {},
+      .reserved = 0,
+  };
+
+  const size_t start = out.size();
+  out.resize(start + sizeof(BlockHeader));
+  const size_t payload = out.size();
+  const auto column_offset = [&] { return static_cast<uint32_t>(out.size() - payload); };
+
+  uint64_t previous = header.first_id;
+  for (const TapeTrade& t : trades) {
+    put_varint(out, zigzag(delta(t.id, previous)));
+    previous = t.id;
+  }
+  header.column_offsets[0] = column_offset();
+  previous = header.min_ts_us;
+  for (const TapeTrade& t : trades) {
+    put_varint(out, zigzag(delta(t.ts_us, previous)));
+    previous = t.ts_us;
+  }
+  header.column_offsets[1] = column_offset();
+  previous = header.first_px;
+  for (const TapeTrade& t : trades) {
+    put_varint(out, zigzag(delta(t.px, previous)));
+    previous = t.px;
+  }
+  header.column_offsets[2] = column_offset();
+  for (const TapeTrade& t : trades) {
+    put_varint(out, t.sz - header.min_sz);
+  }
+  header.column_offsets[3] = column_offset();
+  const size_t sides = out.size();
+  out.resize(sides + (trades.size() + 7) / 8, 0);
+  for (size_t i = 0; i < trades.size(); ++i) {
+    if (trades[i].side == binance::SideEnum::SELL) {
+      out[sides + i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+    }
+  }
+  header.payload_bytes = column_offset();
+  std::memcpy(out.data() + start, &header, sizeof(BlockHeader));
+
+  return IndexEntry{
+      .offset = start,
+      .min_ts_us = header.min_ts_us,
+      .max_ts_us = header.max_ts_us,
+      .count = header.count,
+      .reserved = 0,
+  };
+}
+
+size_t block_size(const std::span<const uint8_t> data) {
+  const BlockHeader header = read_header(data);
+  return is_valid(header, data.size()) ? sizeof(BlockHeader) + header.payload_bytes : 0;
+}
+
+void decode_block(const std::span<const uint8_t> data, std::vector<TapeTrade>& out) {
+  const BlockHeader header = read_header(data);
+  if (!is_valid(header, data.size())) {
+    throw std::runtime_error(std::format("invalid tape block. magic [{:#x}], count [{}]",
+                                         header.magic, header.count));
+  }
+  out.resize(header.count);
+  const uint8_t* payload = data.data() + sizeof(BlockHeader);
+  const auto column = [&](const size_t i) {
+    return payload + (i == 0 ? 0 : header.column_offsets[i - 1]);
+  };
+
+  const uint8_t* p = column(0);
+  const uint8_t* end = column(1);
+  uint64_t previous = header.first_id;
+  for (TapeTrade& t : out) {
+    t.id = previous + static_cast<uint64_t>(unzigzag(get_varint(p, end)));
+    previous = t.id;
+  }
+  p = column(1);
+  end = column(2);
+  previous = header.min_ts_us;
+  for (TapeTrade& t : out) {
+    t.ts_us = previous + static_cast<uint64_t>(unzigzag(get_varint(p, end)));
+    previous = t.ts_us;
+  }
+  p = column(2);
+  end = column(3);
+  previous = header.first_px;
+  for (TapeTrade& t : out) {
+    t.px = previous + static_cast<uint64_t>(unzigzag(get_varint(p, end)));
+    previous = t.px;
+  }
+  p = column(3);
+  end = column(4);
+  for (TapeTrade& t : out) {
+    t.sz = header.min_sz + get_varint(p, end);
+  }
+  const uint8_t* sides = column(4);
+  const auto side_bytes = static_cast<size_t>(payload + header.payload_bytes - sides);
+  if (side_bytes < (out.size() + 7) / 8) {
+    throw std::runtime_error("corrupt tape block: truncated side column");
+  }
+  for (size_t i = 0; i < out.size(); ++i) {
+    out[i].side = ((sides[i / 8] >> (i % 8)) & 1u) != 0 ? binance::SideEnum::SELL
+                                                        : binance::SideEnum::BUY;
+  }
+}
+
+}  // namespace tape
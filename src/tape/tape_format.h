@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../binance/side.h"
+
+namespace tape {
+
+// ─────────── File layout ───────────
+//
+// One file per symbol and UTC day, `<dir>/<SYMBOL>/<YYYY-MM-DD>.tape`:
+//
+//   FileHeader
+//   (BlockHeader, columns)*          appended as trades arrive
+//   IndexEntry[block_count]          footer, written when the file is closed
+//   Trailer
+//
+// A file without a trailer (the writer died) is still readable: the blocks are
+// self-describing, the reader and the writer rebuild the index by walking them.
+// All integers are little-endian, the structs are written as-is.
+
+/// @brief "TRDRTAP1"
+inline constexpr uint64_t FILE_MAGIC = 0x3150415452445254;
+/// @brief "TRDRIDX1"
+inline constexpr uint64_t TRAILER_MAGIC = 0x3158444952445254;
+/// @brief "TBLK"
+inline constexpr uint32_t BLOCK_MAGIC = 0x4B4C4254;
+inline constexpr uint32_t FORMAT_VERSION = 1;
+/// @brief a block holds at most this many trades
+inline constexpr uint32_t MAX_BLOCK_TRADES = 65'536;
+
+/// @brief one trade, prices and sizes in ticks (see @ref core::OrderBook)
+struct TapeTrade {
+  uint64_t px = 0;
+  uint64_t sz = 0;
+  uint64_t id = 0;
+  /// @brief transact time, epoch microseconds
+  uint64_t ts_us = 0;
+  binance::SideEnum side = binance::SideEnum::BUY;
+
+  bool operator==(const TapeTrade&) const = default;
+};
+
+struct FileHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t reserved;
+  /// @brief NUL-terminated
+  std::array<char, 16> symbol;
+  /// @brief midnight UTC of the file's day, epoch microseconds
+  uint64_t day_start_us;
+};
+
+/// @brief Columns follow the header, each at its offset from the end of the header:
+/// - id: zig-zag varint deltas, from `first_id`
+/// - ts_us: zig-zag varint deltas, from `min_ts_us`
+/// - px: zig-zag varint deltas, from `first_px`
+/// - sz: varint, frame of reference `min_sz`
+/// - side: bitmap, 1 for sell
+struct BlockHeader {
+  uint32_t magic;
+  uint32_t count;
+  /// @brief time range covered, for range scans
+  uint64_t min_ts_us;
+  uint64_t max_ts_us;
+  uint64_t first_id;
+  uint64_t first_px;
+  uint64_t min_sz;
+  /// @brief bytes of columns after the header
+  uint32_t payload_bytes;
+  /// @brief where the ts_us, px, sz and side columns start (id starts at 0)
+  std::array<uint32_t, 4> column_offsets;
+  uint32_t reserved;
+};
+
+struct IndexEntry {
+  /// @brief of the block header, from the start of the file
+  uint64_t offset;
+  uint64_t min_ts_us;
+  uint64_t max_ts_us;
+  uint32_t count;
+  uint32_t reserved;
+};
+
+struct Trailer {
+  uint64_t index_offset;
+  uint64_t block_count;
+  uint64_t magic;
+};
+
+static_assert(sizeof(FileHeader) == 40 && sizeof(BlockHeader) == 72 &&
+              sizeof(IndexEntry) == 32 && sizeof(Trailer) == 24);
+
+// ─────────── Block codec ───────────
+
+/// @brief append one block of `trades` (1 to `MAX_BLOCK_TRADES`) to `out`
+/// @return its index entry, `offset` relative to the start of `out` before the append
+IndexEntry encode_block(std::span<const TapeTrade> trades, std::vector<uint8_t>& out);
+
+/// @brief validate the block at the start of `data`
+/// @return its total size (header and columns), 0 if not a complete, valid block
+size_t block_size(std::span<const uint8_t> data);
+
+/// @brief decode the block at the start of `data` into `out` (replaced)
+/// @throws std::runtime_error if it is not a complete, valid block
+void decode_block(std::span<const uint8_t> data, std::vector<TapeTrade>& out);
+
+}  // namespace tape
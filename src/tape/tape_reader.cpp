@@ -0,0 +1,116 @@
+#include "tape_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace tape {
+
+TapeReader::TapeReader(const std::filesystem::path& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error(std::format("cannot open tape file. path [{}], error [{}]",
+                                         path.string(), std::strerror(errno)));
+  }
+  struct stat st{};
+  if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+    ::close(fd);
+    throw std::runtime_error(
+        std::format("tape file too small. path [{}]", path.string()));
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error(std::format("cannot map tape file. path [{}], error [{}]",
+                                         path.string(), std::strerror(errno)));
+  }
+  data_ = static_cast<const uint8_t*>(addr);
+  // decoded front to back
+  ::madvise(addr, size_, MADV_SEQUENTIAL);
+
+  std::memcpy(&header_, data_, sizeof(header_));
+  if (header_.magic != FILE_MAGIC || header_.version != FORMAT_VERSION) {
+    ::munmap(addr, size_);
+    throw std::runtime_error(
+        std::format("not a tape file, or of another version. path [{}]", path.string()));
+  }
+  header_.symbol.back() = '\0';
+
+  Trailer trailer{};
+  if (size_ >= sizeof(FileHeader) + sizeof(Trailer)) {
+    std::memcpy(&trailer, data_ + size_ - sizeof(Trailer), sizeof(Trailer));
+  }
+  if (trailer.magic == TRAILER_MAGIC &&
+      trailer.index_offset + trailer.block_count * sizeof(IndexEntry) + sizeof(Trailer) ==
+          size_) {
+    index_.resize(trailer.block_count);
+    std::memcpy(index_.data(), data_ + trailer.index_offset,
+                trailer.block_count * sizeof(IndexEntry));
+    return;
+  }
+  // still being written, or the writer died: walk the complete blocks
+  recovered_ = true;
+  size_t offset = sizeof(FileHeader);
+  while (const size_t block = block_size({data_ + offset, size_ - offset})) {
+    BlockHeader header{};
+    std::memcpy(&header, data_ + offset, sizeof(header));
+    index_.push_back(IndexEntry{.offset = offset,
+                                .min_ts_us = header.min_ts_us,
+                                .max_ts_us = header.max_ts_us,
+                                .count = header.count,
+                                .reserved = 0});
+    offset += block;
+  }
+}
+
+TapeReader::~TapeReader() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<uint8_t*>(data_), size_);
+  }
+}
+
+std::span<const TapeTrade> TapeReader::read_block(const size_t i) {
+  const IndexEntry& entry = index_.at(i);
+  if (entry.offset >= size_) {
+    throw std::runtime_error(std::format("tape index out of the file. block [{}]", i));
+  }
+  decode_block({data_ + entry.offset, size_ - entry.offset}, block_);
+  return block_;
+}
+
+const std::vector<IndexEntry>& TapeReader::get_index() const {
+  return index_;
+}
+
+std::string_view TapeReader::get_symbol() const {
+  return header_.symbol.data();
+}
+
+uint64_t TapeReader::get_day_start_us() const {
+  return header_.day_start_us;
+}
+
+uint64_t TapeReader::size() const {
+  uint64_t count = 0;
+  for (const IndexEntry& entry : index_) {
+    count += entry.count;
+  }
+  return count;
+}
+
+bool TapeReader::is_recovered() const {
+  return recovered_;
+}
+
+}  // namespace tape
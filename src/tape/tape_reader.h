@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "tape_format.h"
+
+namespace tape {
+
+/// @brief Memory-maps a tape file (see `tape_format.h`) for research and backtesting:
+/// iterate every trade, or range-scan by time, skipping the blocks outside the range
+/// by their index entry. Blocks are decoded into a reused buffer, so a scan is a
+/// sequential pass over the mapping, without allocation.
+/// Files still being written are readable: without a footer, the index is rebuilt from
+/// the blocks on disk when the reader is opened.
+/// Not thread-safe, open one reader per thread.
+class TapeReader {
+ public:
+  /// @throws std::runtime_error when the file cannot be mapped or is not a tape file
+  explicit TapeReader(const std::filesystem::path& path);
+  ~TapeReader();
+
+  TapeReader(const TapeReader&) = delete;
+  TapeReader& operator=(const TapeReader&) = delete;
+
+  /// @brief call `fn(const TapeTrade&)` for every trade, in file order
+  template <typename Fn>
+  void for_each(Fn&& fn) {
+    for (size_t i = 0; i < index_.size(); ++i) {
+      for (const TapeTrade& trade : read_block(i)) {
+        fn(trade);
+      }
+    }
+  }
+
+  /// @brief call `fn(const TapeTrade&)` for the trades with `from_us <= ts_us < to_us`
+  template <typename Fn>
+  void scan(const uint64_t from_us, const uint64_t to_us, Fn&& fn) {
+    for (size_t i = 0; i < index_.size(); ++i) {
+      if (index_[i].max_ts_us < from_us || index_[i].min_ts_us >= to_us) {
+        continue;
+      }
+      for (const TapeTrade& trade : read_block(i)) {
+        if (trade.ts_us >= from_us && trade.ts_us < to_us) {
+          fn(trade);
+        }
+      }
+    }
+  }
+
+  /// @brief decode block `i`, valid until the next call
+  std::span<const TapeTrade> read_block(size_t i);
+
+  const std::vector<IndexEntry>& get_index() const;
+  std::string_view get_symbol() const;
+  /// @brief midnight UTC of the file's day, epoch microseconds
+  uint64_t get_day_start_us() const;
+  /// @brief trades in the file
+  uint64_t size() const;
+  /// @brief whether the footer was missing and the index rebuilt
+  bool is_recovered() const;
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  FileHeader header_{};
+  std::vector<IndexEntry> index_;
+  bool recovered_ = false;
+  std::vector<TapeTrade> block_;
+};
+
+}  // namespace tape
@@ -0,0 +1,284 @@
+#include "tape_writer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../utils/run_loop.h"
+#include "spdlog/spdlog.h"
+
+namespace tape {
+
+namespace {
+
+constexpr uint64_t DAY_US = 86'400'000'000;
+/// @brief how often the writer looks for trades when there were none
+constexpr std::chrono::milliseconds POLL_INTERVAL{1};
+
+/// @brief the blocks and index of an existing file, and where to resume appending
+struct Recovered {
+  std::vector<IndexEntry> index;
+  uint64_t size = 0;
+};
+
+/// @brief read the index from the trailer, or, if the writer died before writing it,
+/// rebuild it by walking the blocks, dropping a partially written last block
+Recovered recover(const std::filesystem::path& path, const binance::SymbolEnum symbol) {
+  std::ifstream in(path, std::ios::binary);
+  const uint64_t file_size = std::filesystem::file_size(path);
+  FileHeader header{};
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      header.magic != FILE_MAGIC || header.version != FORMAT_VERSION ||
+      binance::Symbol::to_str_view(symbol) !=
+          std::string_view(header.symbol.data(),
+                           ::strnlen(header.symbol.data(), header.symbol.size()))) {
+    throw std::runtime_error(std::format(
+        "not a tape file of this symbol or version. path [{}]", path.string()));
+  }
+
+  Recovered recovered;
+  Trailer trailer{};
+  if (file_size >= sizeof(FileHeader) + sizeof(Trailer)) {
+    in.seekg(static_cast<std::streamoff>(file_size - sizeof(Trailer)));
+    in.read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+  }
+  if (trailer.magic == TRAILER_MAGIC &&
+      trailer.index_offset + trailer.block_count * sizeof(IndexEntry) + sizeof(Trailer) ==
+          file_size) {
+    recovered.index.resize(trailer.block_count);
+    in.seekg(static_cast<std::streamoff>(trailer.index_offset));
+    in.read(reinterpret_cast<char*>(recovered.index.data()),
+            static_cast<std::streamsize>(trailer.block_count * sizeof(IndexEntry)));
+    recovered.size = trailer.index_offset;
+    return recovered;
+  }
+
+  uint64_t offset = sizeof(FileHeader);
+  std::vector<uint8_t> block;
+  for (;;) {
+    BlockHeader block_header{};
+    in.seekg(static_cast<std::streamoff>(offset));
+    if (!in.read(reinterpret_cast<char*>(&block_header), sizeof(block_header))) {
+      break;
+    }
+    block.resize(sizeof(BlockHeader) + block_header.payload_bytes);
+    std::memcpy(block.data(), &block_header, sizeof(block_header));
+    if (!in.read(reinterpret_cast<char*>(block.data() + sizeof(BlockHeader)),
+                 block_header.payload_bytes) ||
+        block_size(block) == 0) {
+      break;
+    }
+    recovered.index.push_back(IndexEntry{.offset = offset,
+                                         .min_ts_us = block_header.min_ts_us,
+                                         .max_ts_us = block_header.max_ts_us,
+                                         .count = block_header.count,
+                                         .reserved = 0});
+    offset += block.size();
+  }
+  recovered.size = offset;
+  spdlog::warn("tape file was not closed, index rebuilt. path [{}], blocks [{}]",
+               path.string(), recovered.index.size());
+  return recovered;
+}
+
+}  // namespace
+
+TapeWriter::TapeWriter(std::filesystem::path dir, const binance::SymbolEnum symbol)
+    : dir_(std::move(dir)),
+      symbol_(symbol),
+      queue_(std::make_unique<utils::SpscQueue<TapeTrade, QUEUE_CAPACITY>>()) {
+  std::filesystem::create_directories(dir_ / binance::Symbol::to_str_view(symbol_));
+  pending_.reserve(BLOCK_TRADES);
+  writer_ = utils::RunLoop::background().spawn(run(stop_.get_token()));
+}
+
+TapeWriter::~TapeWriter() {
+  stop();
+}
+
+// static function
+std::unique_ptr<TapeWriter> TapeWriter::from_env() {
+  const char* dir = std::getenv("TAPE_DIR");
+  if (dir == nullptr || *dir == '\0') {
+    return nullptr;
+  }
+  spdlog::info("persisting trades. dir [{}]", dir);
+  return std::make_unique<TapeWriter>(dir, binance::SymbolEnum::BTCUSDT);
+}
+
+bool TapeWriter::push(const core::Trade& trade) noexcept {
+  const TapeTrade t{.px = trade.px,
+                    .sz = trade.sz,
+                    .id = trade.id,
+                    .ts_us = trade.ts_us,
+                    .side = trade.side};
+  if (!queue_->try_push(t)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+void TapeWriter::stop() {
+  if (!stop_.request_stop()) {
+    return;
+  }
+  writer_.wait();
+  spdlog::info("tape writer stopped. written [{}], dropped [{}]", get_written(),
+               get_dropped());
+}
+
+uint64_t TapeWriter::get_written() const {
+  return written_.load(std::memory_order_relaxed);
+}
+
+uint64_t TapeWriter::get_dropped() const {
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+// static function
+std::filesystem::path TapeWriter::file_path(const std::filesystem::path& dir,
+                                            const binance::SymbolEnum symbol,
+                                            const uint64_t ts_us) {
+  using namespace std::chrono;
+  const sys_days day = floor<days>(sys_time<microseconds>(microseconds(ts_us)));
+  const year_month_day ymd{day};
+  return dir / binance::Symbol::to_str_view(symbol) /
+         std::format("{:04}-{:02}-{:02}.tape", static_cast<int>(ymd.year()),
+                     static_cast<unsigned>(ymd.month()),
+                     static_cast<unsigned>(ymd.day()));
+}
+
+// background loop
+utils::Task TapeWriter::run(const std::stop_token stoken) {
+  try {
+    TapeTrade trade;
+    for (;;) {
+      const bool is_running = co_await utils::RunLoop::sleep_for(POLL_INTERVAL, stoken);
+      if (!is_running) {
+        break;
+      }
+      while (queue_->try_pop(trade)) {
+        on_trade(trade);
+      }
+      if (!pending_.empty() &&
+          std::chrono::steady_clock::now() - pending_since_ >= FLUSH_INTERVAL) {
+        flush_block();
+      }
+    }
+    // the producer has stopped: write everything
+    while (queue_->try_pop(trade)) {
+      on_trade(trade);
+    }
+    flush_block();
+    close_file();
+  } catch (const std::exception& e) {
+    // trades are dropped from now on, the app carries on
+    spdlog::error("tape writer stopped. error [{}]", e.what());
+  }
+}
+
+void TapeWriter::on_trade(const TapeTrade& trade) {
+  const uint64_t day_start_us = trade.ts_us - trade.ts_us % DAY_US;
+  if (!file_.is_open() || day_start_us != day_start_us_) {
+    // blocks never span two days
+    flush_block();
+    close_file();
+    open_day(day_start_us);
+  }
+  if (pending_.empty()) {
+    pending_since_ = std::chrono::steady_clock::now();
+  }
+  pending_.push_back(trade);
+  if (pending_.size() >= BLOCK_TRADES) {
+    flush_block();
+  }
+}
+
+void TapeWriter::flush_block() {
+  if (pending_.empty()) {
+    return;
+  }
+  encoded_.clear();
+  IndexEntry entry = encode_block(pending_, encoded_);
+  entry.offset = file_size_;
+  file_.write(reinterpret_cast<const char*>(encoded_.data()),
+              static_cast<std::streamsize>(encoded_.size()));
+  // out per block: a crash loses at most the pending trades
+  file_.flush();
+  if (!file_) {
+    throw std::runtime_error(
+        std::format("cannot write tape file. path [{}]", file_path_.string()));
+  }
+  file_size_ += encoded_.size();
+  index_.push_back(entry);
+  written_.fetch_add(pending_.size(), std::memory_order_relaxed);
+  pending_.clear();
+}
+
+void TapeWriter::open_day(const uint64_t day_start_us) {
+  day_start_us_ = day_start_us;
+  file_path_ = file_path(dir_, symbol_, day_start_us);
+  index_.clear();
+  file_size_ = 0;
+  if (std::filesystem::exists(file_path_) && std::filesystem::file_size(file_path_) > 0) {
+    // resume: drop the footer (rewritten on close), append after the last block
+    Recovered recovered = recover(file_path_, symbol_);
+    std::filesystem::resize_file(file_path_, recovered.size);
+    index_ = std::move(recovered.index);
+    file_size_ = recovered.size;
+    file_.open(file_path_, std::ios::binary | std::ios::app);
+  } else {
+    file_.open(file_path_, std::ios::binary | std::ios::trunc);
+    FileHeader header{
+        .magic = FILE_MAGIC,
+        .version = FORMAT_VERSION,
+        .reserved = 0,
+        .symbol = {},
+        .day_start_us = day_start_us,
+    };
+    const std::string_view symbol = binance::Symbol::to_str_view(symbol_);
+    std::memcpy(header.symbol.data(), symbol.data(), symbol.size());
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_size_ = sizeof(header);
+  }
+  if (!file_) {
+    throw std::runtime_error(
+        std::format("cannot open tape file. path [{}]", file_path_.string()));
+  }
+  spdlog::info("tape file opened. path [{}], blocks [{}]", file_path_.string(),
+               index_.size());
+}
+
+void TapeWriter::close_file() {
+  if (!file_.is_open()) {
+    return;
+  }
+  const Trailer trailer{
+      .index_offset = file_size_,
+      .block_count = index_.size(),
+      .magic = TRAILER_MAGIC,
+  };
+  file_.write(reinterpret_cast<const char*>(index_.data()),
+              static_cast<std::streamsize>(index_.size() * sizeof(IndexEntry)));
+  file_.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+  file_.close();
+  if (!file_) {
+    throw std::runtime_error(
+        std::format("cannot close tape file. path [{}]", file_path_.string()));
+  }
+  index_.clear();
+}
+
+}  // namespace tape
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stop_token>
+#include <vector>
+
+#include "../binance/symbol.h"
+#include "../core/trade.h"
+#include "../utils/run_loop.h"
+#include "../utils/spsc_queue.h"
+#include "tape_format.h"
+
+namespace tape {
+
+/// @brief Persists one symbol's trades to daily columnar files (see `tape_format.h`),
+/// for research and backtesting with @ref tape::TapeReader.
+/// The trade thread only pushes into a lock-free SPSC buffer; a coroutine on the
+/// background loop ( @ref utils::RunLoop::background ) batches the trades into blocks,
+/// appends them to the day's file and, when the day rolls or the writer stops, writes
+/// the footer index. Restarting on the same day resumes the existing file.
+class TapeWriter {
+ public:
+  /// @brief trades buffered between the trade thread and the writer
+  static inline constexpr size_t QUEUE_CAPACITY = 65'536;
+  /// @brief trades per block, when they arrive fast enough
+  static inline constexpr size_t BLOCK_TRADES = 4'096;
+  /// @brief otherwise, a block is written once its first trade is this old
+  static inline constexpr std::chrono::seconds FLUSH_INTERVAL{1};
+
+  /// @brief create `dir/<symbol>/` and start the writer
+  /// @throws std::runtime_error when the directory cannot be created
+  TapeWriter(std::filesystem::path dir, binance::SymbolEnum symbol);
+  /// @brief @ref tape::TapeWriter::stop
+  ~TapeWriter();
+
+  TapeWriter(const TapeWriter&) = delete;
+  TapeWriter& operator=(const TapeWriter&) = delete;
+
+  /// @brief `TAPE_DIR` (optional): where to persist BTCUSDT trades. nullptr when not set
+  static std::unique_ptr<TapeWriter> from_env();
+
+  /// @brief queue a trade. single producer (the trade thread), never blocks
+  /// @return false if the buffer is full: the trade is dropped and counted
+  bool push(const core::Trade& trade) noexcept;
+  /// @brief write what is buffered, close the file with its footer and wait for the
+  /// writer. pushes must have stopped
+  void stop();
+
+  uint64_t get_written() const;
+  uint64_t get_dropped() const;
+  /// @brief `dir/<symbol>/<YYYY-MM-DD>.tape`, the UTC day of `ts_us`
+  static std::filesystem::path file_path(const std::filesystem::path& dir,
+                                         binance::SymbolEnum symbol,
+                                         uint64_t ts_us);
+
+ private:
+  const std::filesystem::path dir_;
+  const binance::SymbolEnum symbol_;
+  std::unique_ptr<utils::SpscQueue<TapeTrade, QUEUE_CAPACITY>> queue_;
+  alignas(utils::Env::CACHE_LINE_SIZE) std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> written_{0};
+
+  // writer state
+  std::vector<TapeTrade> pending_;
+  std::chrono::steady_clock::time_point pending_since_;
+  std::vector<uint8_t> encoded_;
+  std::ofstream file_;
+  std::filesystem::path file_path_;
+  uint64_t day_start_us_ = 0;
+  uint64_t file_size_ = 0;
+  std::vector<IndexEntry> index_;
+  std::stop_source stop_;
+  utils::TaskHandle writer_;
+
+  utils::Task run(std::stop_token stoken);
+  void on_trade(const TapeTrade& trade);
+  /// @brief append the pending trades as one block
+  void flush_block();
+  /// @brief open (or resume) the file of the day starting at `day_start_us`
+  void open_day(uint64_t day_start_us);
+  /// @brief write the footer index and close the file
+  void close_file();
+};
+
+}  // namespace tape
@@ -1,23 +1,23 @@
 #include "ui_app.h"
 
-#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
-#include <quickfix/fix44/Message.h>
-
-#include <algorithm>
 #include <ftxui/component/component.hpp>
+#include <ftxui/component/event.hpp>
 #include <ftxui/dom/elements.hpp>
 #include <memory>
+#include <stop_token>
 #include <thread>
 #include <utility>
-#include <vector>
 
 #include "../../binance/config.h"
-#include "../../binance/market_message_variant.h"
+#include "../../engine/engine.h"
+#include "../../utils/thread_placement.h"
+#include "../../utils/thread_telemetry.h"
+#include "../../utils/threading.h"
+#include "../candle_box.h"
 #include "../log_box/log_box.h"
 #include "../order_book_box.h"
 #include "../trade_box.h"
 #include "../traffic_box.h"
-#include "concurrentqueue.h"
 #include "ftxui_screen.h"
 #include "iscreen.h"
 #include "spdlog/spdlog.h"
@@ -35,39 +35,49 @@ namespace ui {
 ///////////////////////////////////////
 
 App::App(std::unique_ptr<IScreen> screen,
+         const engine::Engine& engine,
          std::unique_ptr<OrderBookBox> book_box,
          std::unique_ptr<LogBox> log_box,
-         std::unique_ptr<TradeBox> trade_box)
+         std::unique_ptr<TradeBox> trade_box,
+         binance::Config& binance_config,
+         const utils::ThreadTelemetry* telemetry)
     : screen_(std::move(screen)),
+      engine_(engine),
+      telemetry_(telemetry),
       book_box_(std::move(book_box)),
       log_box_(std::move(log_box)),
-      trade_box_(std::move(trade_box)) {};
+      trade_box_(std::move(trade_box)),
+      traffic_box_(telemetry),
+      candle_box_(engine.get_aggregator(), binance_config) {};
 
 // static function
-App App::from_env(
-    moodycamel::ConcurrentQueue<binance::MarketMessageVariant>& order_queue,
-    moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh>& trade_queue,
-    binance::Config& binance_config) {
+App App::from_env(const engine::Engine& engine,
+                  binance::Config& binance_config,
+                  const utils::ThreadTelemetry* telemetry) {
   //
   std::unique_ptr<IScreen> screen = std::make_unique<FtxuiScreen>();
 
-  auto book_box =
-      std::make_unique<OrderBookBox>(*screen, order_queue, binance_config.MAX_DEPTH);
+  auto book_box = std::make_unique<OrderBookBox>(engine);
 
   auto log_box = LogBox::from_env(*screen);
 
-  auto trade_box = std::make_unique<TradeBox>(*screen, binance_config, trade_queue);
+  auto trade_box = std::make_unique<TradeBox>(engine, binance_config);
 
-  return App(std::move(screen), std::move(book_box), std::move(log_box),
-             std::move(trade_box));
+  return App(std::move(screen), engine, std::move(book_box), std::move(log_box),
+             std::move(trade_box), binance_config, telemetry);
 }
 
 // main thread
 void App::start() {
   // start worker threads
-  book_box_->start();
   log_box_->start();
-  trade_box_->start();
+  refresh_worker_ = std::jthread{[this](const std::stop_token& stoken) {
+    utils::Threading::set_thread_name(THREAD_NAME_);
+    spdlog::info("starting ui refresh on thread, name [{}], id [{}]", THREAD_NAME_,
+                 utils::Threading::get_os_thread_id());
+    utils::ThreadPlacement::pin_current_thread(THREAD_NAME_);
+    refresh(stoken);
+  }};
 
   // start the main UI loop,
   // Arrange in 2×2 grid via containers
@@ -76,9 +86,35 @@ void App::start() {
                   Vertical({trade_box_->get_component() | flex}) | flex});
   const ftxui::Component row2 =
       Horizontal({Vertical({traffic_box_.get_component() | flex}) | flex,
+                  Vertical({candle_box_.get_component() | flex}) | flex,
                   Vertical({log_box_->get_component() | flex}) | flex});
-  const ftxui::Component root = Vertical({row1 | flex, row2 | size(HEIGHT, EQUAL, 6)});
+  const ftxui::Component root = Vertical({row1 | flex, row2 | size(HEIGHT, EQUAL, 12)});
   screen_->loop(root);
+
+  refresh_worker_.request_stop();
+  refresh_worker_.join();
+}
+
+// refresh thread
+void App::refresh(const std::stop_token& stoken) {
+  uint64_t book_version = 0;
+  uint64_t trades_version = 0;
+  uint64_t telemetry_version = 0;
+  while (!stoken.stop_requested()) {
+    std::this_thread::sleep_for(REFRESH_INTERVAL_);
+    // at most one redraw per interval, however fast the engine publishes
+    const uint64_t book_now = engine_.get_book_version();
+    const uint64_t trades_now = engine_.get_trades_version();
+    const uint64_t telemetry_now = telemetry_ ? telemetry_->get_version() : 0;
+    if (book_now != book_version || trades_now != trades_version ||
+        telemetry_now != telemetry_version) {
+      book_version = book_now;
+      trades_version = trades_now;
+      telemetry_version = telemetry_now;
+      screen_->post_event(ftxui::Event::Custom);
+    }
+  }
+  spdlog::info("closing worker thread, name [{}]", THREAD_NAME_);
 }
 
 }  // namespace ui
@@ -1,44 +1,63 @@
 #pragma once
 
-#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
-
+#include <chrono>
 #include <memory>
+#include <stop_token>
+#include <string>
 #include <thread>
 
 #include "../../binance/config.h"
-#include "../../binance/market_message_variant.h"
+#include "../../engine/engine.h"
+#include "../../utils/thread_telemetry.h"
+#include "../candle_box.h"
 #include "../log_box/log_box.h"
 #include "../order_book_box.h"
 #include "../trade_box.h"
 #include "../traffic_box.h"
-#include "concurrentqueue.h"
 #include "iscreen.h"
 
 namespace ui {
 
 // TODO(mils): login screen?
 
+/// @brief the terminal front-end: a reader of the engine's published snapshots.
+/// redraws are driven by a refresh thread at a capped frame rate, never by the
+/// engine's workers
 class App {
  public:
+  static inline constexpr std::string THREAD_NAME_ = "ui_refresh";
+  /// @brief ~30 FPS
+  static inline constexpr std::chrono::milliseconds REFRESH_INTERVAL_{33};
+
   explicit App(std::unique_ptr<IScreen> screen,
+               const engine::Engine& engine,
                std::unique_ptr<OrderBookBox> book_box,
                std::unique_ptr<LogBox> log_box,
-               std::unique_ptr<TradeBox> trade_box);
-  /// @brief start UI workers
+               std::unique_ptr<TradeBox> trade_box,
+               binance::Config& binance_config,
+               const utils::ThreadTelemetry* telemetry = nullptr);
+  /// @brief start UI workers, blocks until the UI exits
   void start();
   /// if any exceptions occurred
   std::exception_ptr thread_exception;
-  static App from_env(
-      moodycamel::ConcurrentQueue<binance::MarketMessageVariant>& order_queue,
-      moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh>& trade_queue,
-      binance::Config& binance_config);
+  /// @param telemetry optional, shown in the traffic box
+  static App from_env(const engine::Engine& engine,
+                      binance::Config& binance_config,
+                      const utils::ThreadTelemetry* telemetry = nullptr);
 
  private:
   std::unique_ptr<IScreen> screen_;
+  const engine::Engine& engine_;
+  const utils::ThreadTelemetry* telemetry_;
   std::unique_ptr<OrderBookBox> book_box_;
   std::unique_ptr<LogBox> log_box_;
   std::unique_ptr<TradeBox> trade_box_;
   TrafficBox traffic_box_;
+  CandleBox candle_box_;
+  // posts a redraw when a snapshot changed, declared last so it stops first
+  std::jthread refresh_worker_;
+  /// @brief runs on the refresh thread ( @ref ui::App::THREAD_NAME_ )
+  void refresh(const std::stop_token& stoken);
 };
 
 }  // namespace ui
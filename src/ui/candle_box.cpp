@@ -0,0 +1,101 @@
+#include "candle_box.h"
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <ftxui/component/component.hpp>
+#include <ftxui/dom/elements.hpp>
+#include <vector>
+
+#include "../binance/config.h"
+#include "../binance/symbol.h"
+#include "../core/bar.h"
+#include "../core/trade_aggregator.h"
+#include "../utils/double.h"
+#include "helpers.h"
+
+using ftxui::bold;
+using ftxui::border;
+using ftxui::color;
+using ftxui::Color;
+using ftxui::Component;
+using ftxui::dim;
+using ftxui::hbox;
+using ftxui::Renderer;
+using ftxui::text;
+using ftxui::vbox;
+
+namespace ui {
+
+CandleBox::CandleBox(const core::TradeAggregator& aggregator,
+                     binance::Config& binance_config,
+                     const core::TradeAggregator::Resolution resolution)
+    : aggregator_(aggregator), binance_config_(binance_config), resolution_(resolution) {
+  // initialize table header
+  for (const auto& column : columns_) {
+    header_.push_back(text(Helpers::Pad(column.first, column.second)) | bold);
+  }
+
+  component_ = Renderer([this](bool focused) {
+    return vbox({text(std::string("Bars ") +
+                      std::string(core::TradeAggregator::to_str_view(resolution_))) |
+                     bold,
+                 hbox(header_), to_table()}) |
+           border | (focused ? bold : dim);
+  });
+}
+
+Component CandleBox::get_component() {
+  return component_;
+}
+
+ftxui::Element CandleBox::to_table() const {
+  const std::vector<core::Bar> bars =
+      aggregator_.get_series(resolution_).latest(MAX_ROWS_);
+  const auto px_ticks = static_cast<double>(
+      binance_config_.get_price_ticks_per_unit(binance::SymbolEnum::BTCUSDT));
+  const auto sz_ticks = static_cast<double>(
+      binance_config_.get_size_ticks_per_unit(binance::SymbolEnum::BTCUSDT));
+
+  ftxui::Elements table;
+  // newest first, like the trade box
+  for (auto it = bars.rbegin(); it != bars.rend(); ++it) {
+    const core::Bar& bar = *it;
+
+    constexpr size_t TIME_STRLEN = 8;
+    std::array<char, TIME_STRLEN> tm_arr{};
+    const std::time_t start_s = static_cast<std::time_t>(bar.start_us / 1'000'000u);
+    std::tm tm{};
+    gmtime_r(&start_s, &tm);
+    std::snprintf(tm_arr.data(), tm_arr.size(), "%02d:%02d", tm.tm_hour, tm.tm_min);
+
+    const double buy_pct =
+        bar.volume == 0 ? 0.0
+                        : 100.0 * static_cast<double>(bar.buy_volume) /
+                              static_cast<double>(bar.volume);
+    auto px = [px_ticks](const uint64_t ticks) {
+      return utils::Double::pretty(static_cast<double>(ticks) / px_ticks);
+    };
+
+    ftxui::Elements ui_row;
+    ui_row.push_back(text(Helpers::Pad(std::string(tm_arr.data()), columns_[0].second)));
+    ui_row.push_back(text(Helpers::Pad(px(bar.open), columns_[1].second)));
+    ui_row.push_back(text(Helpers::Pad(px(bar.high), columns_[2].second)));
+    ui_row.push_back(text(Helpers::Pad(px(bar.low), columns_[3].second)));
+    ui_row.push_back(text(Helpers::Pad(px(bar.close), columns_[4].second)) |
+                     color(bar.close >= bar.open ? Color::Green : Color::Red));
+    ui_row.push_back(text(Helpers::Pad(
+        utils::Double::trim(static_cast<double>(bar.volume) / sz_ticks),
+        columns_[5].second)));
+    ui_row.push_back(text(Helpers::Pad(std::to_string(static_cast<int>(buy_pct + 0.5)),
+                                       columns_[6].second)));
+    ui_row.push_back(text(Helpers::Pad(
+        utils::Double::pretty(std::round(bar.vwap()) / px_ticks), columns_[7].second)));
+    table.push_back(hbox(std::move(ui_row)));
+  }
+
+  return vbox(table);
+}
+
+}  // namespace ui
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <ftxui/component/screen_interactive.hpp>
+#include <ftxui/dom/elements.hpp>
+
+#include <array>
+#include <string>
+#include <utility>
+
+#include "../binance/config.h"
+#include "../core/trade_aggregator.h"
+
+namespace ui {
+
+/// @brief compact OHLCV view of the most recent bars, newest first.
+/// renders on the UI thread straight from the aggregator's lock-free snapshots
+class CandleBox {
+ public:
+  CandleBox(const core::TradeAggregator& aggregator,
+            binance::Config& binance_config,
+            core::TradeAggregator::Resolution resolution =
+                core::TradeAggregator::Resolution::MINUTE_1);
+
+  // Return the FTXUI component to plug into layout
+  ftxui::Component get_component();
+  /// @brief one row per bar, newest first
+  ftxui::Element to_table() const;
+
+ private:
+  static inline constexpr size_t MAX_ROWS_ = 8;
+
+  const core::TradeAggregator& aggregator_;
+  binance::Config& binance_config_;
+  const core::TradeAggregator::Resolution resolution_;
+  ftxui::Component component_;
+  const std::array<std::pair<std::string, uint8_t>, 8> columns_ = {
+      {{"Time", 6},
+       {"Open", 10},
+       {"High", 10},
+       {"Low", 10},
+       {"Close", 10},
+       {"Volume", 9},
+       {"Buy%", 5},
+       {"VWAP", 10}}};
+  ftxui::Elements header_;
+};
+
+}  // namespace ui
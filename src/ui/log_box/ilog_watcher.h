@@ -1,12 +1,37 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+#include "log_line.h"
+
 namespace ui {
 
+/// @brief Follows the log file for the log box. Lines are held by the watcher and read
+/// in place, the box only ever touches the ones it shows. Lines are numbered from the
+/// first ever read, so a number stays valid as the oldest lines are dropped.
 class ILogWatcher {
  public:
+  /// @brief lines were appended. runs on the watcher's thread
+  using Callback = std::function<void()>;
+  /// @brief one line's number, index entry and text (without its newline). the text is
+  /// only valid during the call
+  using LineFn = std::function<void(uint64_t, const LogLineMeta&, std::string_view)>;
+
   virtual ~ILogWatcher() = default;
-  virtual void set_callback(std::function<void(std::vector<std::string>)> cb) = 0;
+  virtual void set_callback(Callback cb) = 0;
   virtual void start() = 0;
+  /// @brief stop calling back
+  virtual void stop() = 0;
+  /// @brief the number of the oldest line held. any thread
+  virtual uint64_t get_first_line() const = 0;
+  /// @brief complete lines held. any thread
+  virtual size_t get_line_count() const = 0;
+  /// @brief call `fn` for the held lines of `[first, first + count)`, oldest first. any
+  /// thread
+  virtual void read_lines(uint64_t first, size_t count, const LineFn& fn) const = 0;
 };
 
 }  // namespace ui
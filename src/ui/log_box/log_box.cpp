@@ -1,16 +1,24 @@
 #include "log_box.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
 #include <format>
 #include <ftxui/component/component.hpp>
 #include <ftxui/dom/elements.hpp>
-#include <iostream>
-#include <mutex>
+#include <ftxui/screen/terminal.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "../../utils/env.h"
 #include "../app/iscreen.h"
 #include "../helpers.h"
 #include "ilog_watcher.h"
-#include "spdlog/spdlog.h"
+#include "log_line.h"
+#include "log_search.h"
+#include "log_tailer.h"
 
 using ftxui::bold;
 using ftxui::border;
@@ -22,6 +30,7 @@ using ftxui::Elements;
 using ftxui::flex;
 using ftxui::focusPositionRelative;
 using ftxui::frame;
+using ftxui::hbox;
 using ftxui::Renderer;
 using ftxui::SliderOption;
 using ftxui::text;
@@ -29,14 +38,58 @@ using ftxui::vbox;
 
 namespace ui {
 
+namespace {
+
+/// @brief a line, coloured by its level
+ftxui::Element to_line(const LogLineMeta& meta, const std::string_view line) {
+  auto element = text(std::string(line));
+  switch (meta.level) {
+    case LogLevel::warning:
+      return element | ftxui::color(Color::Yellow);
+    case LogLevel::error:
+    case LogLevel::critical:
+      return element | ftxui::color(Color::Red);
+    default:
+      return element;
+  }
+}
+
+}  // namespace
+
 LogBox::LogBox(IScreen& screen, std::unique_ptr<ILogWatcher> watcher)
-    : screen_(screen), log_watcher_(std::move(watcher)) {
+    : screen_(screen),
+      log_watcher_(std::move(watcher)),
+      search_(std::make_unique<LogSearch>(*log_watcher_)) {
   // initialize table header
   for (const auto& column : columns_) {
     header_.push_back(ftxui::text(Helpers::Pad(column.first, column.second)) |
                       ftxui::bold);
   }
 
+  // new lines: search them, and render. runs on the background loop
+  log_watcher_->set_callback([this] {
+    search_->notify();
+    screen_.post_event(ftxui::Event::Custom);
+  });
+  // runs on the background loop ( @ref utils::RunLoop::background )
+  search_->set_callback([this] { screen_.post_event(ftxui::Event::Custom); });
+
+  // filter bar
+  for (const auto& level : LEVELS_) {
+    level_names_.push_back(level.first);
+  }
+  auto level_toggle = ftxui::Toggle(&level_names_, &level_selected_);
+  auto thread_input = ftxui::Input(&thread_text_, "any");
+  auto search_input = ftxui::Input(&search_text_, "search");
+  auto filter_bar =
+      ftxui::Container::Horizontal({level_toggle, thread_input, search_input});
+  auto filter_renderer = Renderer(filter_bar, [this, level_toggle, thread_input,
+                                               search_input] {
+    return hbox({level_toggle->Render(), text(" thread "),
+                 thread_input->Render() | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 8),
+                 text(" "), search_input->Render() | flex, search_status()});
+  });
+
   SliderOption<float> option_x;
   option_x.value = &scroll_x;
   option_x.min = 0.f;
@@ -61,17 +114,7 @@ LogBox::LogBox(IScreen& screen, std::unique_ptr<ILogWatcher> watcher)
   auto header_renderer = Renderer([this] { return vbox({hbox(header_)}); });
 
   auto content = Renderer([this](bool focused) {
-    std::deque<std::string> buffer_copy;
-    {
-      std::lock_guard<std::mutex> lock(log_ring_mutex_);
-      buffer_copy = log_ring_;  // safe copy
-    }
-    Elements lines;
-    for (const auto& line : buffer_copy) {
-      lines.push_back(text(line));
-    }
-
-    return vbox(std::move(lines)) | (focused ? bold : dim) |
+    return vbox(visible_lines()) | (focused ? bold : dim) |
            focusPositionRelative(scroll_x, scroll_y) | frame | flex;
   });
 
@@ -88,33 +131,22 @@ LogBox::LogBox(IScreen& screen, std::unique_ptr<ILogWatcher> watcher)
       }),
   });
 
-  // Full component: static header + scrollable content
-  component_ = ftxui::Container::Vertical({header_renderer, scroll_area}) | border;
+  // Full component: filter bar + static header + scrollable content
+  component_ = ftxui::Container::Vertical(
+                   {filter_renderer, header_renderer, scroll_area}) |
+               border;
+}
+
+LogBox::~LogBox() {
+  // the watcher calls into the search
+  log_watcher_->stop();
+  search_->stop();
 }
 
 // static function
 std::unique_ptr<LogBox> LogBox::from_env(IScreen& screen) {
-  // parse watch path
   const std::string log_path = utils::Env::get_env_or_throw("LOG_PATH");
-  size_t pos = log_path.find_last_of("/\\");  // handle both forward and backward slashes
-  std::string directory;
-  std::string filename;
-  if (pos != std::string::npos) {
-    directory = log_path.substr(0, pos + 1);  // include the slash
-    filename = log_path.substr(pos + 1);
-  } else {
-    // No slash found
-    throw std::runtime_error(std::format("invalid log file path, path [{}]", log_path));
-  }
-
-  auto watcher = std::make_unique<LogFileWatcher>(directory, filename);
-  auto log_box = std::make_unique<LogBox>(screen, std::move(watcher));
-  log_box->log_watcher_->set_callback(
-      [box_ptr = log_box.get()](std::vector<std::string> lines) {
-        box_ptr->on_log_lines(std::move(lines));
-      });
-
-  return log_box;
+  return std::make_unique<LogBox>(screen, std::make_unique<LogTailer>(log_path));
 }
 
 Component LogBox::get_component() {
@@ -122,19 +154,61 @@ Component LogBox::get_component() {
 }
 
 void LogBox::start() const {
+  search_->start();
   log_watcher_->start();
 }
 
-// runs on log watcher thread ( @ref ui::LogFileWatcher::THREAD_NAME_ )
-void LogBox::on_log_lines(std::vector<std::string> lines) {
-  std::lock_guard<std::mutex> lock(log_ring_mutex_);
-  for (std::string& line : lines) {
-    if (log_ring_.size() >= MAX_LINES_) {
-      log_ring_.pop_front();
+LogFilter LogBox::get_filter() const {
+  LogFilter filter;
+  filter.min_level = LEVELS_.at(static_cast<size_t>(level_selected_)).second;
+  // not a number: any thread
+  const char* const end = thread_text_.data() + thread_text_.size();
+  if (std::from_chars(thread_text_.data(), end, filter.thread_id).ptr != end) {
+    filter.thread_id = 0;
+  }
+  filter.text = search_text_;
+  return filter;
+}
+
+ftxui::Element LogBox::search_status() const {
+  if (!get_filter().is_active()) {
+    return text("");
+  }
+  const std::string status =
+      std::format(" {} matches{}", search_->get_match_count(),
+                  search_->is_searching() ? ", searching" : "");
+  return text(status) | dim;
+}
+
+Elements LogBox::visible_lines() const {
+  // a new filter restarts the search, an unchanged one is a no-op
+  const LogFilter filter = get_filter();
+  search_->set_filter(filter);
+
+  const bool is_filtered = filter.is_active();
+  const size_t count =
+      is_filtered ? search_->get_match_count() : log_watcher_->get_line_count();
+  const auto rows = static_cast<size_t>(std::max(ftxui::Terminal::Size().dimy, 1));
+  // scrolled to the bottom (1) shows the newest lines
+  const float scroll = std::clamp(scroll_y, 0.f, 1.f);
+  const size_t first =
+      count > rows
+          ? static_cast<size_t>(std::lround(scroll * static_cast<float>(count - rows)))
+          : 0;
+  Elements lines;
+  lines.reserve(std::min(count, rows));
+  const ILogWatcher::LineFn add_line = [&lines](uint64_t, const LogLineMeta& meta,
+                                                const std::string_view line) {
+    lines.push_back(to_line(meta, line));
+  };
+  if (is_filtered) {
+    for (const uint64_t line : search_->get_matches(first, rows)) {
+      log_watcher_->read_lines(line, 1, add_line);
     }
-    log_ring_.push_back(std::move(line));
+  } else {
+    log_watcher_->read_lines(log_watcher_->get_first_line() + first, rows, add_line);
   }
-  screen_.post_event(ftxui::Event::Custom);
-};
+  return lines;
+}
 
 }  // namespace ui
@@ -1,29 +1,36 @@
 #pragma once
 
-#include <deque>
-#include <fstream>
+#include <array>
 #include <ftxui/component/component.hpp>
 #include <ftxui/dom/elements.hpp>
-#include <mutex>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
-#include "../../utils/env.h"
 #include "../app/iscreen.h"
 #include "ilog_watcher.h"
-#include "log_file_watcher.h"
+#include "log_line.h"
+#include "log_search.h"
 
 namespace ui {
 
+/// @brief The tail of the log file, filtered by minimum level, thread id and a search
+/// string. Unfiltered lines are read straight from the watcher, filtered ones page
+/// through the matches streamed in by a `LogSearch`.
 class LogBox {
  public:
   LogBox(IScreen& screen, std::unique_ptr<ILogWatcher> watcher);
+  ~LogBox();
   static std::unique_ptr<LogBox> from_env(IScreen& screen);
   // Return the FTXUI component to plug into layout
   ftxui::Component get_component();
   /// if any exceptions occurred
   std::exception_ptr thread_exception;
-  // start log watcher
+  // start log watcher, and search
   void start() const;
+  /// @brief the filter set in the box's controls
+  LogFilter get_filter() const;
 
  private:
   // UI
@@ -36,14 +43,28 @@ class LogBox {
       {{"Time", 26}, {"Level", 7}, {"Thread", 7}, {"Message", 7}}};
   ftxui::Elements header_;
 
-  // log ring-buffer
-  std::deque<std::string> log_ring_;
-  static inline constexpr uint16_t MAX_LINES_ = 100;
-  alignas(utils::Env::CACHE_LINE_SIZE) std::mutex log_ring_mutex_;
+  // filter controls
+  /// @brief the minimum level toggle's entries
+  static inline const std::array<std::pair<std::string, LogLevel>, 5> LEVELS_ = {{
+      {"all", LogLevel::trace},
+      {"debug", LogLevel::debug},
+      {"info", LogLevel::info},
+      {"warning", LogLevel::warning},
+      {"error", LogLevel::error},
+  }};
+  std::vector<std::string> level_names_;
+  int level_selected_ = 0;
+  std::string thread_text_;
+  std::string search_text_;
 
-  // log-file watcher
+  // log-file watcher, holds the lines
   std::unique_ptr<ILogWatcher> log_watcher_;
-  void on_log_lines(std::vector<std::string> lines);
+  std::unique_ptr<LogSearch> search_;
+  /// @brief the lines that can be on screen: as many as the terminal is tall, around
+  /// the scroll position. the rest of the log is never touched
+  ftxui::Elements visible_lines() const;
+  /// @brief the filter bar's status: matches, and whether the search is still running
+  ftxui::Element search_status() const;
 };
 
 }  // namespace ui
@@ -0,0 +1,92 @@
+#include "log_line.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace ui {
+
+namespace {
+
+/// @brief `[2025-01-02 03:04:05.678] [`: the timestamp is fixed-width
+constexpr size_t TIME_LEN = 23;
+constexpr size_t LEVEL_POS = TIME_LEN + 4;
+
+constexpr std::array<std::pair<std::string_view, LogLevel>, 6> LEVELS = {{
+    {"trace", LogLevel::trace},
+    {"debug", LogLevel::debug},
+    {"info", LogLevel::info},
+    {"warning", LogLevel::warning},
+    {"error", LogLevel::error},
+    {"critical", LogLevel::critical},
+}};
+
+/// @brief the digits of `line[pos, pos + len)`
+/// @return false if not all digits
+template <typename T>
+bool read_number(const std::string_view line,
+                 const size_t pos,
+                 const size_t len,
+                 T& out) {
+  const char* const first = line.data() + pos;
+  const auto [ptr, ec] = std::from_chars(first, first + len, out);
+  return ec == std::errc{} && ptr == first + len;
+}
+
+}  // namespace
+
+// static function
+std::optional<LogLineMeta> LogLineMeta::parse(const std::string_view line) {
+  if (line.size() < LEVEL_POS || line[0] != '[' || line[TIME_LEN + 1] != ']' ||
+      line.substr(TIME_LEN + 2, 2) != " [") {
+    return std::nullopt;
+  }
+  // `2025-01-02 03:04:05.678`
+  int year = 0;
+  unsigned month = 0, day = 0, hours = 0, minutes = 0, seconds = 0, millis = 0;
+  if (line[5] != '-' || line[8] != '-' || line[11] != ' ' || line[14] != ':' ||
+      line[17] != ':' || line[20] != '.' || !read_number(line, 1, 4, year) ||
+      !read_number(line, 6, 2, month) || !read_number(line, 9, 2, day) ||
+      !read_number(line, 12, 2, hours) || !read_number(line, 15, 2, minutes) ||
+      !read_number(line, 18, 2, seconds) || !read_number(line, 21, 3, millis)) {
+    return std::nullopt;
+  }
+  const std::chrono::year_month_day date{
+      std::chrono::year(year), std::chrono::month(month), std::chrono::day(day)};
+  if (!date.ok()) {
+    return std::nullopt;
+  }
+
+  // `[level] [thread] `
+  const size_t level_end = line.find(']', LEVEL_POS);
+  if (level_end == std::string_view::npos || line.substr(level_end, 3) != "] [") {
+    return std::nullopt;
+  }
+  const std::string_view level_name = line.substr(LEVEL_POS, level_end - LEVEL_POS);
+  const auto* level = std::ranges::find_if(
+      LEVELS, [level_name](const auto& entry) { return entry.first == level_name; });
+  if (level == LEVELS.end()) {
+    return std::nullopt;
+  }
+  const size_t thread_pos = level_end + 3;
+  const size_t thread_end = line.find(']', thread_pos);
+  uint32_t thread_id = 0;
+  if (thread_end == std::string_view::npos ||
+      !read_number(line, thread_pos, thread_end - thread_pos, thread_id)) {
+    return std::nullopt;
+  }
+
+  const auto time = std::chrono::sys_days(date) + std::chrono::hours(hours) +
+                    std::chrono::minutes(minutes) + std::chrono::seconds(seconds) +
+                    std::chrono::milliseconds(millis);
+  return LogLineMeta{.time_ms = time.time_since_epoch().count(),
+                     .thread_id = thread_id,
+                     .level = level->second};
+}
+
+}  // namespace ui
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ui {
+
+/// @brief the severities spdlog writes, `%l`, least severe first
+enum class LogLevel : uint8_t { trace, debug, info, warning, error, critical };
+
+/// @brief A log line's index entry, parsed from the prefix of the pattern set in
+/// `utils::Logging`: `[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] %v`. Where the line is in the
+/// buffer is indexed by the tailer, alongside.
+struct LogLineMeta {
+  /// @brief milliseconds since the epoch, of the (local) wall-clock time written
+  int64_t time_ms = 0;
+  /// @brief the OS thread id
+  uint32_t thread_id = 0;
+  LogLevel level = LogLevel::info;
+
+  bool operator==(const LogLineMeta&) const = default;
+
+  /// @return nullopt if the line does not start with the pattern's prefix, e.g. the
+  /// continuation of a multi-line message. it belongs with the line above
+  static std::optional<LogLineMeta> parse(std::string_view line);
+};
+
+/// @brief What the log box shows. Level and thread are matched on the index alone, the
+/// text of a line is only searched when those match.
+struct LogFilter {
+  LogLevel min_level = LogLevel::trace;
+  /// @brief 0 for any
+  uint32_t thread_id = 0;
+  /// @brief case-sensitive substring, empty for any
+  std::string text{};
+
+  bool operator==(const LogFilter&) const = default;
+
+  /// @brief whether anything is filtered out
+  bool is_active() const {
+    return min_level != LogLevel::trace || thread_id != 0 || !text.empty();
+  }
+  bool matches(const LogLineMeta& meta, std::string_view line) const {
+    return meta.level >= min_level && (thread_id == 0 || meta.thread_id == thread_id) &&
+           (text.empty() || line.find(text) != std::string_view::npos);
+  }
+};
+
+}  // namespace ui
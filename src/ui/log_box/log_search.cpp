@@ -0,0 +1,147 @@
+#include "log_search.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../../utils/run_loop.h"
+#include "spdlog/spdlog.h"
+
+namespace ui {
+
+LogSearch::LogSearch(const ILogWatcher& watcher) : watcher_(watcher) {}
+
+LogSearch::~LogSearch() {
+  stop();
+}
+
+void LogSearch::set_callback(Callback cb) {
+  cb_ = std::move(cb);
+}
+
+void LogSearch::start() {
+  stop();
+  stop_ = std::stop_source{};
+  spdlog::info("starting searching the log on the background loop");
+  searcher_ = utils::RunLoop::background().spawn(run(stop_.get_token()));
+}
+
+void LogSearch::stop() {
+  stop_.request_stop();
+  searcher_.wait();
+}
+
+void LogSearch::set_filter(LogFilter filter) {
+  {
+    std::lock_guard lock(mutex_);
+    if (filter == filter_) {
+      return;
+    }
+    filter_ = std::move(filter);
+    ++generation_;
+    next_line_ = 0;
+    matches_.clear();
+  }
+  wakes_.push(Wake::FILTER);
+}
+
+void LogSearch::notify() {
+  wakes_.push(Wake::LINES);
+}
+
+size_t LogSearch::get_match_count() const {
+  std::lock_guard lock(mutex_);
+  return matches_.size();
+}
+
+std::vector<uint64_t> LogSearch::get_matches(const size_t first,
+                                             const size_t count) const {
+  std::lock_guard lock(mutex_);
+  const size_t begin = std::min(first, matches_.size());
+  const size_t end = std::min(first + count, matches_.size());
+  return {matches_.begin() + static_cast<ptrdiff_t>(begin),
+          matches_.begin() + static_cast<ptrdiff_t>(end)};
+}
+
+bool LogSearch::is_searching() const {
+  const uint64_t end = watcher_.get_first_line() + watcher_.get_line_count();
+  std::lock_guard lock(mutex_);
+  return filter_.is_active() && next_line_ < end;
+}
+
+// background loop
+utils::Task LogSearch::run(const std::stop_token stoken) {
+  try {
+    while (!stoken.stop_requested()) {
+      if (search_step()) {
+        co_await utils::RunLoop::yield();
+        continue;
+      }
+      // caught up: until a new filter or new lines
+      const std::optional<Wake> wake = co_await wakes_.pop(stoken);
+      if (!wake) {
+        break;
+      }
+      // the step reads the latest filter and line count: one wake stands for all
+      while (wakes_.try_pop()) {
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("log search stopped. error [{}]", e.what());
+  }
+}
+
+bool LogSearch::search_step() {
+  LogFilter filter;
+  uint64_t generation = 0;
+  uint64_t next = 0;
+  {
+    std::lock_guard lock(mutex_);
+    if (!filter_.is_active()) {
+      return false;
+    }
+    filter = filter_;
+    generation = generation_;
+    next = next_line_;
+  }
+  // lines dropped by the watcher are skipped
+  const uint64_t first_line = watcher_.get_first_line();
+  const uint64_t end_line = first_line + watcher_.get_line_count();
+  next = std::max(next, first_line);
+  if (next >= end_line) {
+    return false;
+  }
+  const size_t count = std::min<uint64_t>(STEP_LINES, end_line - next);
+  std::vector<uint64_t> found;
+  watcher_.read_lines(next, count,
+                      [&filter, &found](const uint64_t line, const LogLineMeta& meta,
+                                        const std::string_view text) {
+                        if (filter.matches(meta, text)) {
+                          found.push_back(line);
+                        }
+                      });
+  {
+    std::lock_guard lock(mutex_);
+    if (generation != generation_) {
+      // the filter changed meanwhile
+      return true;
+    }
+    if (!matches_.empty() && matches_.front() < first_line) {
+      matches_.erase(matches_.begin(), std::ranges::lower_bound(matches_, first_line));
+    }
+    matches_.insert(matches_.end(), found.begin(), found.end());
+    next_line_ = next + count;
+  }
+  if (cb_ && (!found.empty() || next + count == end_line)) {
+    cb_();
+  }
+  return true;
+}
+
+}  // namespace ui
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <vector>
+
+#include "../../utils/async_queue.h"
+#include "../../utils/run_loop.h"
+#include "ilog_watcher.h"
+#include "log_line.h"
+
+namespace ui {
+
+/// @brief Filters the log on the background loop ( @ref utils::RunLoop::background ),
+/// for the log box. The watcher's lines
+/// are searched a step at a time and the numbers of the matching ones are streamed into
+/// a list the box pages through; lines appended later are searched as they arrive.
+/// Level and thread are matched on the index, only those lines' text is searched.
+/// A new filter restarts the search, discarding the old one's results.
+class LogSearch {
+ public:
+  /// @brief lines searched per step, under the watcher's (shared) lock. the loop's
+  /// other coroutines run between two steps
+  static inline constexpr size_t STEP_LINES = 4096;
+  /// @brief matches were added, or the search caught up. runs on the background loop
+  using Callback = std::function<void()>;
+
+  explicit LogSearch(const ILogWatcher& watcher);
+  ~LogSearch();
+
+  LogSearch(const LogSearch&) = delete;
+  LogSearch& operator=(const LogSearch&) = delete;
+
+  void set_callback(Callback cb);
+  void start();
+  /// @brief stop and wait for the search
+  void stop();
+
+  /// @brief search with `filter` from the oldest line held, if it changed. any thread
+  void set_filter(LogFilter filter);
+  /// @brief lines were appended. any thread
+  void notify();
+
+  /// @brief search the next step of lines. the search's work, callable directly when
+  /// not started
+  /// @return false if there was nothing to search
+  bool search_step();
+
+  /// @brief matches so far
+  size_t get_match_count() const;
+  /// @brief the numbers of matches `[first, first + count)`, oldest first
+  std::vector<uint64_t> get_matches(size_t first, size_t count) const;
+  /// @brief whether the filter is active and lines are left to search
+  bool is_searching() const;
+
+ private:
+  /// @brief why the search was asked to look again
+  enum class Wake : uint8_t { FILTER, LINES };
+
+  const ILogWatcher& watcher_;
+  Callback cb_;
+  utils::AsyncQueue<Wake> wakes_;
+
+  mutable std::mutex mutex_;
+  LogFilter filter_;
+  /// @brief bumped on every new filter, so a step of the old one is discarded
+  uint64_t generation_ = 0;
+  /// @brief line number searched up to
+  uint64_t next_line_ = 0;
+  /// @brief line numbers, ascending
+  std::vector<uint64_t> matches_;
+
+  std::stop_source stop_;
+  utils::TaskHandle searcher_;
+
+  utils::Task run(std::stop_token stoken);
+};
+
+}  // namespace ui
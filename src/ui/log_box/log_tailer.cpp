@@ -0,0 +1,297 @@
+#include "log_tailer.h"
+
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <format>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../../utils/run_loop.h"
+#include "spdlog/spdlog.h"
+
+namespace ui {
+
+LogTailer::LogTailer(std::filesystem::path path, const size_t max_bytes)
+    : path_(std::move(path)), max_bytes_(std::max(max_bytes, READ_BYTES_)) {
+  inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd_ < 0) {
+    throw std::runtime_error(
+        std::format("cannot create inotify instance. error [{}]", std::strerror(errno)));
+  }
+  // the directory, not the file: rotation replaces the file
+  const std::filesystem::path dir =
+      path_.has_parent_path() ? path_.parent_path() : std::filesystem::path(".");
+  if (::inotify_add_watch(inotify_fd_, dir.c_str(),
+                          IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                              IN_MOVED_TO | IN_CLOSE_WRITE) < 0) {
+    const int err = errno;
+    ::close(inotify_fd_);
+    throw std::runtime_error(
+        std::format("cannot watch log directory. path [{}], error [{}]", dir.string(),
+                    std::strerror(err)));
+  }
+}
+
+LogTailer::~LogTailer() {
+  stop();
+  close_file();
+  ::close(inotify_fd_);
+}
+
+void LogTailer::set_callback(Callback cb) {
+  cb_ = std::move(cb);
+}
+
+void LogTailer::start() {
+  stop();
+  stop_ = std::stop_source{};
+  spdlog::info("starting tailing log file on the background loop. path [{}]",
+               path_.string());
+  watcher_ = utils::RunLoop::background().spawn(run(stop_.get_token()));
+}
+
+void LogTailer::stop() {
+  stop_.request_stop();
+  watcher_.wait();
+}
+
+uint64_t LogTailer::get_first_line() const {
+  std::shared_lock lock(mutex_);
+  return dropped_lines_;
+}
+
+size_t LogTailer::get_line_count() const {
+  std::shared_lock lock(mutex_);
+  return line_ends_.size();
+}
+
+void LogTailer::read_lines(const uint64_t first,
+                           const size_t count,
+                           const LineFn& fn) const {
+  std::shared_lock lock(mutex_);
+  // the held lines only, as indices
+  const uint64_t begin = std::max(first, dropped_lines_) - dropped_lines_;
+  const uint64_t end =
+      std::min<uint64_t>(std::max(first + count, dropped_lines_) - dropped_lines_,
+                         line_ends_.size());
+  for (size_t i = begin; i < end; ++i) {
+    const size_t start = i == 0 ? 0 : line_ends_[i - 1] + 1;
+    fn(dropped_lines_ + i, line_metas_[i],
+       std::string_view(data_.get() + start, line_ends_[i] - start));
+  }
+}
+
+// background loop
+utils::Task LogTailer::run(const std::stop_token stoken) {
+  try {
+    if (poll_file() && cb_) {
+      cb_();
+    }
+    while (!stoken.stop_requested()) {
+      const bool is_ready =
+          co_await utils::RunLoop::readable(inotify_fd_, POLL_INTERVAL, stoken);
+      if (stoken.stop_requested()) {
+        break;
+      }
+      // on a timeout, check anyway
+      if (is_ready && !read_events()) {
+        continue;
+      }
+      if (poll_file() && cb_) {
+        cb_();
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("log tailer stopped. error [{}]", e.what());
+  }
+}
+
+bool LogTailer::read_events() {
+  alignas(inotify_event) std::array<char, 4096> buffer;
+  const std::string filename = path_.filename().string();
+  bool is_relevant = false;
+  for (;;) {
+    const ssize_t n = ::read(inotify_fd_, buffer.data(), buffer.size());
+    if (n <= 0) {
+      break;
+    }
+    for (ssize_t offset = 0; offset < n;) {
+      const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+      if ((event->mask & IN_Q_OVERFLOW) != 0 ||
+          (event->len > 0 && filename == event->name)) {
+        is_relevant = true;
+      }
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+    }
+  }
+  return is_relevant;
+}
+
+bool LogTailer::poll_file() {
+  if (fd_ < 0) {
+    open_file();
+    if (fd_ < 0) {
+      return false;
+    }
+  }
+  bool is_added = false;
+  struct stat st{};
+  if (::fstat(fd_, &st) == 0 && st.st_size < read_offset_) {
+    // truncated in place (e.g. logrotate's copytruncate): start over from the top
+    is_added |= end_partial_line();
+    read_offset_ = 0;
+  }
+  is_added |= read_appended();
+
+  // rotated: the path now names another file, or none. the old one is read to the end
+  struct stat path_st{};
+  if (::stat(path_.c_str(), &path_st) != 0 || path_st.st_ino != ino_ ||
+      path_st.st_dev != dev_) {
+    is_added |= end_partial_line();
+    close_file();
+    open_file();
+    if (fd_ >= 0) {
+      is_added |= read_appended();
+    }
+  }
+  return is_added;
+}
+
+void LogTailer::open_file() {
+  fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd_ < 0) {
+    return;
+  }
+  struct stat st{};
+  ::fstat(fd_, &st);
+  dev_ = st.st_dev;
+  ino_ = st.st_ino;
+  read_offset_ = 0;
+}
+
+void LogTailer::close_file() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+bool LogTailer::read_appended() {
+  // counted, not compared with the line count: a trim may drop as many as came
+  size_t appended = 0;
+  for (;;) {
+    reserve(READ_BYTES_);
+    // beyond `size_`: no lock needed
+    const ssize_t n =
+        ::pread(fd_, data_.get() + size_, capacity_ - size_, read_offset_);
+    if (n <= 0) {
+      break;
+    }
+    read_offset_ += n;
+    std::vector<size_t> ends;
+    const char* const begin = data_.get();
+    const char* const end = begin + size_ + static_cast<size_t>(n);
+    for (const char* p = begin + scanned_; p < end; ++p) {
+      p = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+      if (p == nullptr) {
+        break;
+      }
+      ends.push_back(static_cast<size_t>(p - begin));
+    }
+    std::vector<LogLineMeta> metas;
+    parse_lines(line_ends_.empty() ? 0 : line_ends_.back() + 1, ends, metas);
+    {
+      std::unique_lock lock(mutex_);
+      size_ += static_cast<size_t>(n);
+      line_ends_.insert(line_ends_.end(), ends.begin(), ends.end());
+      line_metas_.insert(line_metas_.end(), metas.begin(), metas.end());
+    }
+    appended += ends.size();
+    scanned_ = size_;
+    if (size_ > max_bytes_) {
+      trim();
+    }
+  }
+  return appended != 0;
+}
+
+void LogTailer::parse_lines(size_t start,
+                            const std::vector<size_t>& ends,
+                            std::vector<LogLineMeta>& metas) {
+  metas.reserve(ends.size());
+  for (const size_t end : ends) {
+    const std::string_view line(data_.get() + start, end - start);
+    last_meta_ = LogLineMeta::parse(line).value_or(last_meta_);
+    metas.push_back(last_meta_);
+    start = end + 1;
+  }
+}
+
+bool LogTailer::end_partial_line() {
+  const size_t line_start = line_ends_.empty() ? 0 : line_ends_.back() + 1;
+  if (size_ == line_start) {
+    return false;
+  }
+  reserve(1);
+  data_[size_] = '\n';
+  std::vector<LogLineMeta> metas;
+  parse_lines(line_start, {size_}, metas);
+  std::unique_lock lock(mutex_);
+  line_ends_.push_back(size_);
+  line_metas_.push_back(metas.front());
+  ++size_;
+  scanned_ = size_;
+  return true;
+}
+
+void LogTailer::reserve(const size_t bytes) {
+  if (capacity_ - size_ >= bytes) {
+    return;
+  }
+  const size_t capacity = std::max(capacity_ * 2, size_ + bytes);
+  auto data = std::make_unique<char[]>(capacity);
+  if (size_ > 0) {
+    std::memcpy(data.get(), data_.get(), size_);
+  }
+  std::unique_lock lock(mutex_);
+  data_ = std::move(data);
+  capacity_ = capacity;
+}
+
+void LogTailer::trim() {
+  // keep the newest lines within half the budget, so that trims are rare
+  const size_t keep = max_bytes_ / 2;
+  // the first line ending within the newest `keep` bytes
+  const auto first_kept = std::ranges::lower_bound(line_ends_, size_ - keep);
+  if (first_kept == line_ends_.begin()) {
+    return;
+  }
+  const size_t cut = *(first_kept - 1) + 1;
+  std::unique_lock lock(mutex_);
+  const auto dropped = static_cast<size_t>(first_kept - line_ends_.begin());
+  std::memmove(data_.get(), data_.get() + cut, size_ - cut);
+  size_ -= cut;
+  scanned_ -= cut;
+  line_ends_.erase(line_ends_.begin(), first_kept);
+  line_metas_.erase(line_metas_.begin(),
+                    line_metas_.begin() + static_cast<ptrdiff_t>(dropped));
+  for (size_t& end : line_ends_) {
+    end -= cut;
+  }
+  dropped_lines_ += dropped;
+}
+
+}  // namespace ui
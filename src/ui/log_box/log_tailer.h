@@ -0,0 +1,115 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <stop_token>
+#include <vector>
+
+#include "../../utils/run_loop.h"
+#include "ilog_watcher.h"
+#include "log_line.h"
+
+namespace ui {
+
+/// @brief Follows a log file like `tail -F`. inotify wakes the watcher on writes (a
+/// coroutine on the background loop, @ref utils::RunLoop::background ), and the new
+/// bytes are `pread` straight into an append-only buffer. Lines are indexed as they
+/// arrive, the offset of their end and their parsed prefix
+/// (`LogLineMeta`), there is no string per line: readers slice the lines they show out
+/// of the buffer, so the cost of a render does not grow with the log.
+/// Keeps following when the file is rotated (renamed, or deleted and recreated) or
+/// truncated in place. Holds the most recent `max_bytes` of the log, dropping the
+/// oldest lines in bulk.
+class LogTailer : public ILogWatcher {
+ public:
+  static inline constexpr size_t DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+  /// @brief the file is also checked this often without an event: for a file created
+  /// after the tailer, or events lost to an inotify queue overflow
+  static inline constexpr std::chrono::milliseconds POLL_INTERVAL{250};
+
+  /// @brief the file need not exist yet, its directory must
+  /// @throws std::runtime_error if the directory cannot be watched
+  explicit LogTailer(std::filesystem::path path, size_t max_bytes = DEFAULT_MAX_BYTES);
+  ~LogTailer() override;
+
+  LogTailer(const LogTailer&) = delete;
+  LogTailer& operator=(const LogTailer&) = delete;
+
+  void set_callback(Callback cb) override;
+  /// @brief read the file so far, then follow it on the background loop
+  void start() override;
+  /// @brief stop and wait for the watcher
+  void stop() override;
+  uint64_t get_first_line() const override;
+  size_t get_line_count() const override;
+  void read_lines(uint64_t first, size_t count, const LineFn& fn) const override;
+
+  /// @brief read what was appended since the last call, following rotation and
+  /// truncation. the watcher's work, callable directly when not started
+  /// @return true if lines were added
+  bool poll_file();
+
+ private:
+  /// @brief bytes read per `pread`, at most
+  static inline constexpr size_t READ_BYTES_ = 64 * 1024;
+
+  const std::filesystem::path path_;
+  const size_t max_bytes_;
+  Callback cb_;
+  int inotify_fd_ = -1;
+
+  // watcher state
+  int fd_ = -1;
+  dev_t dev_ = 0;
+  ino_t ino_ = 0;
+  /// @brief file offset read up to
+  off_t read_offset_ = 0;
+  /// @brief buffer offset scanned for newlines up to
+  size_t scanned_ = 0;
+  /// @brief the last line's entry, for the continuation lines that follow it
+  LogLineMeta last_meta_;
+
+  // the buffer: written by the watcher only, beyond `size_` without the lock
+  // (readers never look there), everything else under an exclusive lock
+  mutable std::shared_mutex mutex_;
+  std::unique_ptr<char[]> data_;
+  size_t capacity_ = 0;
+  size_t size_ = 0;
+  /// @brief buffer offset of each complete line's newline
+  std::vector<size_t> line_ends_;
+  /// @brief each complete line's index entry
+  std::vector<LogLineMeta> line_metas_;
+  /// @brief lines dropped to stay within `max_bytes`
+  uint64_t dropped_lines_ = 0;
+
+  std::stop_source stop_;
+  utils::TaskHandle watcher_;
+
+  utils::Task run(std::stop_token stoken);
+  /// @brief whether the pending inotify events concern the file
+  bool read_events();
+  /// @brief open `path_` if it exists
+  void open_file();
+  void close_file();
+  /// @return true if lines were added
+  bool read_appended();
+  /// @brief the entries of the lines ending at `ends`, the first starting at `start`
+  void parse_lines(size_t start,
+                   const std::vector<size_t>& ends,
+                   std::vector<LogLineMeta>& metas);
+  /// @brief index a trailing line that has no newline, before the file changes under it
+  /// @return true if a line was added
+  bool end_partial_line();
+  /// @brief room for `bytes` more, growing the buffer
+  void reserve(size_t bytes);
+  /// @brief drop the oldest lines down to half of `max_bytes_`
+  void trim();
+};
+
+}  // namespace ui
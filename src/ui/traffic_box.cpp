@@ -1,22 +1,35 @@
 #include "traffic_box.h"
 
+#include <format>
 #include <ftxui/component/component.hpp>
 #include <ftxui/dom/elements.hpp>
+#include <string>
+#include <vector>
+
+#include "../utils/thread_telemetry.h"
+#include "helpers.h"
 
 using ftxui::bold;
 using ftxui::border;
+using ftxui::Color;
 using ftxui::Component;
 using ftxui::dim;
+using ftxui::frame;
+using ftxui::hbox;
 using ftxui::Renderer;
 using ftxui::text;
 using ftxui::vbox;
 
 namespace ui {
 
-TrafficBox::TrafficBox() {
-  component_ = Renderer([](bool focused) {
-    auto body = text(focused ? "Focused" : "Not Focused");
-    return vbox(body) | border | (focused ? bold : dim);
+TrafficBox::TrafficBox(const utils::ThreadTelemetry* telemetry) : telemetry_(telemetry) {
+  // initialize table header
+  for (const auto& column : columns_) {
+    header_.push_back(text(Helpers::Pad(column.first, column.second)) | bold);
+  }
+  component_ = Renderer([this](bool focused) {
+    return vbox({hbox(header_), to_table() | frame | ftxui::flex}) | border |
+           (focused ? bold : dim);
   });
 }
 
@@ -24,4 +37,34 @@ Component TrafficBox::get_component() {
   return component_;
 }
 
+ftxui::Element TrafficBox::to_table() const {
+  if (telemetry_ == nullptr) {
+    return text("thread telemetry off (THREAD_TELEMETRY_INTERVAL_MS=0)");
+  }
+  const auto cell = [this](const size_t column, const std::string& value) {
+    return text(Helpers::Pad(value, columns_[column].second));
+  };
+  const auto rate = [](const double value) { return std::format("{:.1f}", value); };
+
+  ftxui::Elements table;
+  for (const utils::ThreadUsage& usage : telemetry_->get_usage()) {
+    // preempted, or faulting to disk: what a hot thread should not be
+    const Color color = usage.major_faults_per_sec > 0   ? Color::Red
+                        : usage.involuntary_per_sec > 0 ? Color::Yellow
+                                                        : Color::Default;
+    table.push_back(hbox({
+                        cell(0, usage.name),
+                        cell(1, std::to_string(usage.total.last_cpu)),
+                        cell(2, rate(usage.cpu_pct)),
+                        cell(3, rate(usage.run_delay_pct)),
+                        cell(4, rate(usage.voluntary_per_sec)),
+                        cell(5, rate(usage.involuntary_per_sec)),
+                        cell(6, rate(usage.minor_faults_per_sec)),
+                        cell(7, rate(usage.major_faults_per_sec)),
+                    }) |
+                    ftxui::color(color));
+  }
+  return vbox(std::move(table));
+}
+
 }  // namespace ui
@@ -1,23 +1,42 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <ftxui/component/screen_interactive.hpp>
+#include <ftxui/dom/elements.hpp>
+#include <string>
+#include <utility>
 
-/*
-step 1: fetch balances of each instrument
-step 2: sortable/searchable collection
-*/
+#include "../utils/thread_telemetry.h"
 
 namespace ui {
 
+/// @brief each named thread's resource usage over the last sampling interval, from
+/// @ref utils::ThreadTelemetry : cpu, waiting for a cpu, context switches and faults
 class TrafficBox {
  public:
-  TrafficBox();
+  /// @param telemetry nullptr if off
+  explicit TrafficBox(const utils::ThreadTelemetry* telemetry);
 
   // Return the FTXUI component to plug into layout
   ftxui::Component get_component();
+  //
+  ftxui::Element to_table() const;
 
  private:
+  const utils::ThreadTelemetry* telemetry_;
   ftxui::Component component_;
+  /// @brief the columns in the thread table, and their widths
+  const std::array<std::pair<std::string, uint8_t>, 8> columns_ = {
+      {{"Thread", 16},
+       {"CPU", 4},
+       {"Use%", 6},
+       {"Wait%", 6},
+       {"Vol/s", 7},
+       {"Inv/s", 7},
+       {"MinF/s", 8},
+       {"MajF/s", 7}}};
+  ftxui::Elements header_;
 };
 
 }  // namespace ui
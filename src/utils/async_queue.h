@@ -0,0 +1,99 @@
+#pragma once
+
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <utility>
+
+#include "run_loop.h"
+
+namespace utils {
+
+/// @brief Unbounded multi-producer, single-consumer queue that a coroutine awaits on its
+/// @ref utils::RunLoop : any thread pushes, and a push to an empty queue posts the
+/// waiting coroutine back to its loop. Takes a lock: for the low-priority stages, not
+/// the hot path (see @ref utils::SpscQueue ).
+template <typename T>
+class AsyncQueue {
+ public:
+  /// @brief @ref utils::AsyncQueue::pop
+  class PopAwaiter : public RunLoop::WaitBase {
+   public:
+    PopAwaiter(AsyncQueue& queue, std::stop_token stoken)
+        : WaitBase(std::move(stoken)), queue_(queue) {}
+    ~PopAwaiter() {
+      std::lock_guard lock(queue_.mutex_);
+      if (queue_.waiter_ == &waiter_) {
+        queue_.waiter_ = nullptr;
+      }
+    }
+
+    bool await_ready() const {
+      std::lock_guard lock(queue_.mutex_);
+      return !queue_.items_.empty() || is_stop_requested();
+    }
+    /// @return false if a value was pushed meanwhile: no need to suspend
+    bool await_suspend(const std::coroutine_handle<Task::promise_type> handle) {
+      suspend(handle);
+      {
+        std::lock_guard lock(queue_.mutex_);
+        if (!queue_.items_.empty()) {
+          return false;
+        }
+        queue_.waiter_ = &waiter_;
+      }
+      arm_stop();
+      return true;
+    }
+    /// @return nullopt if stopped
+    std::optional<T> await_resume() {
+      if (is_stop_requested()) {
+        return std::nullopt;
+      }
+      return queue_.try_pop();
+    }
+
+   private:
+    AsyncQueue& queue_;
+  };
+
+  AsyncQueue() = default;
+
+  AsyncQueue(const AsyncQueue&) = delete;
+  AsyncQueue& operator=(const AsyncQueue&) = delete;
+
+  /// @brief queue `value`, waking the consumer. any thread
+  void push(T value) {
+    std::lock_guard lock(mutex_);
+    items_.push_back(std::move(value));
+    // under the lock: the consumer cannot resume, and free its waiter, meanwhile
+    if (waiter_ != nullptr) {
+      std::exchange(waiter_, nullptr)->wake_up(RunLoop::Wake::READY);
+    }
+  }
+
+  /// @return nullopt if empty
+  std::optional<T> try_pop() {
+    std::lock_guard lock(mutex_);
+    if (items_.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> value(std::move(items_.front()));
+    items_.pop_front();
+    return value;
+  }
+
+  /// @brief the next value, once there is one. a single consumer, on a loop
+  /// @return (awaited) nullopt on a stop request
+  PopAwaiter pop(std::stop_token stoken) { return PopAwaiter{*this, std::move(stoken)}; }
+
+ private:
+  mutable std::mutex mutex_;
+  std::deque<T> items_;
+  /// @brief the suspended consumer, if any
+  RunLoop::Waiter* waiter_ = nullptr;
+};
+
+}  // namespace utils
@@ -0,0 +1,169 @@
+#include "cpu_topology.h"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+namespace {
+
+/// @return nullopt if the file cannot be read
+std::optional<std::string> read_line(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  std::string line;
+  if (!file || !std::getline(file, line)) {
+    return std::nullopt;
+  }
+  return line;
+}
+
+/// @return `fallback` if the file cannot be read, or does not hold a number
+unsigned read_unsigned(const std::filesystem::path& path, const unsigned fallback) {
+  const std::optional<std::string> line = read_line(path);
+  unsigned value = 0;
+  if (!line || std::from_chars(line->data(), line->data() + line->size(), value).ec !=
+                   std::errc{}) {
+    return fallback;
+  }
+  return value;
+}
+
+/// @brief the lowest CPU of the list in the file
+/// @return `fallback` if the file cannot be read
+unsigned read_lowest_cpu(const std::filesystem::path& path, const unsigned fallback) {
+  const std::optional<std::string> line = read_line(path);
+  if (!line) {
+    return fallback;
+  }
+  const std::vector<unsigned> cpus = CpuTopology::parse_cpu_list(*line);
+  return cpus.empty() ? fallback : cpus.front();
+}
+
+/// @brief the CPU's L3 domain: the lowest CPU sharing its level 3 cache
+/// @return `fallback` if it has none
+unsigned read_l3(const std::filesystem::path& cpu_dir, const unsigned fallback) {
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(cpu_dir / "cache", ec)) {
+    if (entry.path().filename().string().starts_with("index") &&
+        read_unsigned(entry.path() / "level", 0) == 3) {
+      return read_lowest_cpu(entry.path() / "shared_cpu_list", fallback);
+    }
+  }
+  return fallback;
+}
+
+/// @brief the CPU's NUMA node, from its `nodeN` link. 0 without NUMA
+unsigned read_numa_node(const std::filesystem::path& cpu_dir) {
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(cpu_dir, ec)) {
+    const std::string name = entry.path().filename().string();
+    unsigned node = 0;
+    if (name.starts_with("node") &&
+        std::from_chars(name.data() + 4, name.data() + name.size(), node).ec ==
+            std::errc{}) {
+      return node;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+CpuTopology::CpuTopology(std::vector<LogicalCpu> cpus, std::vector<unsigned> isolated)
+    : cpus_(std::move(cpus)), isolated_(std::move(isolated)) {
+  std::ranges::sort(cpus_, {}, &LogicalCpu::id);
+  std::ranges::sort(isolated_);
+}
+
+// static function
+CpuTopology CpuTopology::from_sysfs(const std::filesystem::path& root) {
+  const std::optional<std::string> online = read_line(root / "online");
+  if (!online) {
+    throw std::runtime_error(
+        std::format("cannot read online cpus. path [{}]", (root / "online").string()));
+  }
+  std::vector<LogicalCpu> cpus;
+  for (const unsigned id : parse_cpu_list(*online)) {
+    const std::filesystem::path dir = root / std::format("cpu{}", id);
+    const std::filesystem::path topology = dir / "topology";
+    const unsigned package = read_unsigned(topology / "physical_package_id", 0);
+    cpus.push_back(LogicalCpu{
+        .id = id,
+        .core = read_lowest_cpu(topology / "thread_siblings_list", id),
+        .package = package,
+        .l3 = read_l3(dir, package),
+        .numa_node = read_numa_node(dir),
+    });
+  }
+  const std::optional<std::string> isolated = read_line(root / "isolated");
+  return {std::move(cpus),
+          isolated ? parse_cpu_list(*isolated) : std::vector<unsigned>{}};
+}
+
+// static function
+std::vector<unsigned> CpuTopology::parse_cpu_list(const std::string_view list) {
+  std::vector<unsigned> cpus;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string_view::npos) {
+      end = list.size();
+    }
+    const std::string_view part = list.substr(pos, end - pos);
+    pos = end + 1;
+    if (part.empty() || part == "\n") {
+      continue;
+    }
+    unsigned first = 0;
+    unsigned last = 0;
+    const char* const part_end = part.data() + part.size();
+    std::from_chars_result result = std::from_chars(part.data(), part_end, first);
+    last = first;
+    if (result.ec == std::errc{} && result.ptr != part_end && *result.ptr == '-') {
+      result = std::from_chars(result.ptr + 1, part_end, last);
+    }
+    if (result.ec != std::errc{} || result.ptr != part_end || last < first) {
+      throw std::runtime_error(std::format("invalid cpu list. value [{}]", list));
+    }
+    for (unsigned cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  std::ranges::sort(cpus);
+  const auto [first, last] = std::ranges::unique(cpus);
+  cpus.erase(first, last);
+  return cpus;
+}
+
+// static function
+std::string CpuTopology::to_cpu_list(const std::span<const unsigned> cpus) {
+  std::string out;
+  for (size_t i = 0; i < cpus.size();) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+      ++j;
+    }
+    out += out.empty() ? "" : ",";
+    out += j == i ? std::format("{}", cpus[i]) : std::format("{}-{}", cpus[i], cpus[j]);
+    i = j + 1;
+  }
+  return out;
+}
+
+const LogicalCpu* CpuTopology::find(const unsigned id) const {
+  const auto it = std::ranges::lower_bound(cpus_, id, {}, &LogicalCpu::id);
+  return it != cpus_.end() && it->id == id ? &*it : nullptr;
+}
+
+}  // namespace utils
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utils {
+
+/// @brief one logical CPU, and what it shares with others. Each id is that of a CPU:
+/// the lowest one of the group, so that ids compare across the topology
+struct LogicalCpu {
+  unsigned id = 0;
+  /// @brief the physical core: its SMT siblings share it
+  unsigned core = 0;
+  unsigned package = 0;
+  /// @brief the last-level (L3) cache domain, the package if there is none
+  unsigned l3 = 0;
+  unsigned numa_node = 0;
+
+  bool operator==(const LogicalCpu&) const = default;
+};
+
+/// @brief The machine's CPUs as Linux describes them under `/sys/devices/system/cpu`:
+/// the online CPUs, their physical cores (SMT siblings), L3 domains and NUMA nodes,
+/// and the CPUs isolated from the scheduler (`isolcpus`).
+class CpuTopology {
+ public:
+  static inline constexpr std::string_view SYSFS_ROOT = "/sys/devices/system/cpu";
+
+  CpuTopology(std::vector<LogicalCpu> cpus, std::vector<unsigned> isolated);
+
+  /// @brief read the topology. a root other than sysfs is for tests
+  /// @throws std::runtime_error if the online CPUs cannot be read
+  static CpuTopology from_sysfs(const std::filesystem::path& root = SYSFS_ROOT);
+
+  /// @brief parse the kernel's CPU list format, e.g. `0-3,8,10-11`
+  /// @throws std::runtime_error if malformed
+  static std::vector<unsigned> parse_cpu_list(std::string_view list);
+  /// @brief the kernel's CPU list format, ranges collapsed. `cpus` sorted
+  static std::string to_cpu_list(std::span<const unsigned> cpus);
+
+  /// @brief online CPUs, by id
+  const std::vector<LogicalCpu>& get_cpus() const { return cpus_; }
+  /// @brief isolated CPUs, sorted. empty if none
+  const std::vector<unsigned>& get_isolated() const { return isolated_; }
+  /// @return nullptr if not online
+  const LogicalCpu* find(unsigned id) const;
+
+ private:
+  std::vector<LogicalCpu> cpus_;
+  std::vector<unsigned> isolated_;
+};
+
+}  // namespace utils
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <csignal>
+#include <cstdlib>
 #include <exception>
 #include <new>
 
+#include "flight_recorder.h"
 #include "spdlog/spdlog.h"
 
 #ifdef _WIN32
@@ -30,28 +32,29 @@ class Crash {
     std::terminate();  // invokes terminate handler
   }
 
-  /// @brief Signal handler (async-signal-safe)
+  /// @brief Signal handler (async-signal-safe), dumps the flight recorder before exiting
   static void handle_signal(int sig) {
     constexpr char prefix[] = "CRITICAL: Fatal signal caught: ";
     constexpr char suffix[] = "\n";
     char buf[64];
     size_t len = 0;
 
-    // copy prefix
-    for (char c : prefix) {
-      buf[len++] = c;
+    // copy prefix (without its NUL terminator)
+    for (size_t i = 0; i + 1 < sizeof(prefix); ++i) {
+      buf[len++] = prefix[i];
     }
 
     // convert signal number
     int_to_str(sig, buf, len);
 
-    // copy suffix
-    for (char c : suffix) {
-      buf[len++] = c;
+    // copy suffix (without its NUL terminator)
+    for (size_t i = 0; i + 1 < sizeof(suffix); ++i) {
+      buf[len++] = suffix[i];
     }
 
-    // write to stderr and exit
+    // write to stderr, keep the recent hot-path events (see `flight_decode`) and exit
     [[maybe_unused]] ssize_t n = write(2, buf, len);
+    FlightRecorder::dump_global(sig);
     _exit(1);
   }
 
@@ -62,8 +65,16 @@ class Crash {
   /// - Memory allocation failures (`std::bad_alloc`)
   /// - Fatal signals (SIGSEGV, SIGABRT, SIGFPE, SIGILL, and SIGBUS on POSIX)
   ///
+  /// And creates the flight recorder dumped by the signal handler, to
+  /// `FLIGHT_RECORDER_PATH` (optional, default `flight_recorder.bin`).
+  ///
   /// @note Signals like SIGKILL and SIGSTOP cannot be caught.
   static void configure_handlers() {
+    // preallocate the flight recorder, the signal handler only writes it out
+    FlightRecorder::global();
+    if (const char* path = std::getenv("FLIGHT_RECORDER_PATH")) {
+      FlightRecorder::set_dump_path(path);
+    }
     // Catch unhandled exceptions
     std::set_terminate(handle_terminate);
     // Catch std::bad_alloc (new OOM)
@@ -0,0 +1,276 @@
+#include "flight_recorder.h"
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "threading.h"
+
+namespace utils {
+
+namespace {
+
+std::atomic<uint64_t> next_recorder_id{1};
+/// @brief set once the global recorder exists, read by the signal handler
+std::atomic<FlightRecorder*> global_recorder{nullptr};
+/// @brief NUL-terminated, preallocated: the signal handler cannot build strings
+std::array<char, 256> dump_path{};
+
+/// @brief `write(2)` until done, retrying on EINTR. async-signal-safe
+bool write_all(const int fd, const void* data, size_t size) noexcept {
+  const auto* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    const ssize_t n = ::write(fd, bytes, size);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += n;
+    size -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+template <typename T>
+void read_exact(std::istream& in, T& out, const std::string_view what) {
+  if (!in.read(reinterpret_cast<char*>(&out), sizeof(T))) {
+    throw std::runtime_error(
+        std::format("truncated flight recorder dump. at [{}]", what));
+  }
+}
+
+}  // namespace
+
+std::string_view to_str_view(const FlightEvent event) {
+  switch (event) {
+    case FlightEvent::NONE:
+      return "NONE";
+    case FlightEvent::FIX_SNAPSHOT:
+      return "FIX_SNAPSHOT";
+    case FlightEvent::FIX_INCREMENT:
+      return "FIX_INCREMENT";
+    case FlightEvent::BOOK_APPLY:
+      return "BOOK_APPLY";
+    case FlightEvent::BOOK_PUBLISH:
+      return "BOOK_PUBLISH";
+    case FlightEvent::TRADES:
+      return "TRADES";
+    case FlightEvent::BOOK_CONFLATE:
+      return "BOOK_CONFLATE";
+  }
+  return "UNKNOWN";
+}
+
+FlightRecorder::FlightRecorder(const uint32_t max_threads, const uint32_t capacity)
+    : id_(next_recorder_id.fetch_add(1, std::memory_order_relaxed)),
+      max_threads_(max_threads),
+      capacity_(std::bit_ceil(std::max(capacity, 1u))),
+      mask_(capacity_ - 1),
+      rings_(std::make_unique<Ring[]>(max_threads)),
+      // zeroed, and so touched up front: no page faults on the hot path
+      records_(std::make_unique<Record[]>(static_cast<size_t>(max_threads) * capacity_)),
+      ticks_per_ns_(get_ticks_per_ns()) {
+  for (uint32_t i = 0; i < max_threads_; ++i) {
+    rings_[i].records = &records_[static_cast<size_t>(i) * capacity_];
+  }
+}
+
+// static function
+FlightRecorder& FlightRecorder::global() {
+  static FlightRecorder recorder;
+  global_recorder.store(&recorder, std::memory_order_release);
+  return recorder;
+}
+
+// static function
+void FlightRecorder::set_dump_path(const std::string_view path) {
+  const size_t len = std::min(path.size(), dump_path.size() - 1);
+  std::memcpy(dump_path.data(), path.data(), len);
+  dump_path[len] = '\0';
+}
+
+// static function
+void FlightRecorder::dump_global(const int signal) noexcept {
+  const FlightRecorder* recorder = global_recorder.load(std::memory_order_acquire);
+  if (recorder == nullptr) {
+    return;
+  }
+  const char* path = dump_path[0] != '\0' ? dump_path.data() : DEFAULT_DUMP_PATH.data();
+  const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return;
+  }
+  recorder->dump(fd, signal);
+  ::close(fd);
+}
+
+FlightRecorder::Ring* FlightRecorder::claim_ring() noexcept {
+  const uint32_t index = claimed_.fetch_add(1, std::memory_order_relaxed);
+  Ring* ring = nullptr;
+  if (index < max_threads_) {
+    ring = &rings_[index];
+    try {
+      const std::string name = Threading::get_thread_name();
+      std::memcpy(ring->name.data(), name.data(),
+                  std::min(name.size(), ring->name.size() - 1));
+      ring->tid = Threading::get_os_thread_id();
+    } catch (const std::exception&) {
+      // unnamed: the records still count
+    }
+  } else {
+    claimed_.store(max_threads_, std::memory_order_relaxed);
+  }
+  tls_ring_ = ThreadRing{.recorder_id = id_, .ring = ring};
+  return ring;
+}
+
+bool FlightRecorder::dump(const int fd, const int signal) const noexcept {
+  const uint32_t thread_count = std::min(claimed_.load(std::memory_order_acquire),
+                                         max_threads_);
+  timespec epoch{};
+  ::clock_gettime(CLOCK_REALTIME, &epoch);
+  const DumpHeader header{
+      .magic = DUMP_MAGIC,
+      .version = DUMP_VERSION,
+      .thread_count = thread_count,
+      .capacity = capacity_,
+      .signal = signal,
+      .ticks_per_ns = ticks_per_ns_,
+      .dump_ticks = now(),
+      .dump_epoch_ns = static_cast<uint64_t>(epoch.tv_sec) * 1'000'000'000u +
+                       static_cast<uint64_t>(epoch.tv_nsec),
+  };
+  bool ok = write_all(fd, &header, sizeof(header));
+  for (uint32_t i = 0; i < thread_count && ok; ++i) {
+    const Ring& ring = rings_[i];
+    const ThreadHeader thread{
+        .name = ring.name,
+        .tid = ring.tid,
+        .recorded = ring.recorded.load(std::memory_order_acquire),
+    };
+    ok = write_all(fd, &thread, sizeof(thread)) &&
+         write_all(fd, ring.records, sizeof(Record) * capacity_);
+  }
+  return ok;
+}
+
+// static function
+FlightRecorder::Dump FlightRecorder::read_dump(std::istream& in) {
+  Dump dump;
+  read_exact(in, dump.header, "header");
+  if (dump.header.magic != DUMP_MAGIC || dump.header.version != DUMP_VERSION) {
+    throw std::runtime_error(
+        std::format("not a flight recorder dump, or of another version. version [{}]",
+                    dump.header.version));
+  }
+  const uint32_t capacity = dump.header.capacity;
+  if (!std::has_single_bit(capacity)) {
+    throw std::runtime_error(std::format("invalid capacity. capacity [{}]", capacity));
+  }
+  std::vector<Record> ring(capacity);
+  for (uint32_t i = 0; i < dump.header.thread_count; ++i) {
+    ThreadHeader header{};
+    read_exact(in, header, "thread");
+    if (!in.read(reinterpret_cast<char*>(ring.data()),
+                 static_cast<std::streamsize>(sizeof(Record) * capacity))) {
+      throw std::runtime_error(
+          std::format("truncated flight recorder dump. at [records of thread {}]", i));
+    }
+    ThreadDump& thread = dump.threads.emplace_back();
+    thread.name = std::string(header.name.data(),
+                              ::strnlen(header.name.data(), header.name.size()));
+    thread.tid = header.tid;
+    thread.recorded = header.recorded;
+    // unroll the ring, oldest first
+    const uint64_t count = std::min<uint64_t>(header.recorded, capacity);
+    thread.records.reserve(count);
+    for (uint64_t n = header.recorded - count; n < header.recorded; ++n) {
+      thread.records.push_back(ring[n & (capacity - 1)]);
+    }
+  }
+  return dump;
+}
+
+// static function
+void FlightRecorder::print_dump(const Dump& dump, std::ostream& out) {
+  const DumpHeader& header = dump.header;
+  out << std::format(
+      "flight recorder dump. signal [{}], epoch_ns [{}], threads [{}], "
+      "ticks_per_ns [{:.3f}]\n",
+      header.signal, header.dump_epoch_ns, header.thread_count, header.ticks_per_ns);
+  struct Entry {
+    const Record* record;
+    const ThreadDump* thread;
+  };
+  std::vector<Entry> timeline;
+  for (const ThreadDump& thread : dump.threads) {
+    out << std::format("thread [{}], tid [{}], recorded [{}], kept [{}]\n", thread.name,
+                       thread.tid, thread.recorded, thread.records.size());
+    for (const Record& record : thread.records) {
+      timeline.push_back(Entry{.record = &record, .thread = &thread});
+    }
+  }
+  std::ranges::stable_sort(timeline, {}, [](const Entry& e) { return e.record->ticks; });
+
+  out << std::format("{:>14} {:<15} {:<13} {}\n", "age_us", "thread", "event", "data");
+  const double ticks_per_us = std::max(header.ticks_per_ns, 1e-9) * 1'000.0;
+  for (const Entry& e : timeline) {
+    const double age_us =
+        (static_cast<double>(header.dump_ticks) - static_cast<double>(e.record->ticks)) /
+        ticks_per_us;
+    out << std::format("{:>14.3f} {:<15} {:<13} a [{}] b [{}] c [{}]\n", -age_us,
+                       e.thread->name, to_str_view(e.record->event), e.record->a,
+                       e.record->b, e.record->c);
+  }
+}
+
+// static function
+double FlightRecorder::get_ticks_per_ns() {
+#if defined(__aarch64__)
+  // the virtual counter's frequency is architectural
+  uint64_t hz;
+  asm volatile("mrs %0, cntfrq_el0" : "=r"(hz));
+  return static_cast<double>(hz) / 1e9;
+#elif defined(__x86_64__) || defined(_M_X64)
+  // invariant TSC: measure it against the steady clock, once
+  static const double ticks_per_ns = [] {
+    const uint64_t start_ns = steady_now_ns();
+    const uint64_t start = now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    const uint64_t ticks = now() - start;
+    const uint64_t ns = steady_now_ns() - start_ns;
+    return ns > 0 ? static_cast<double>(ticks) / static_cast<double>(ns) : 1.0;
+  }();
+  return ticks_per_ns;
+#else
+  return 1.0;
+#endif
+}
+
+// static function
+uint64_t FlightRecorder::steady_now_ns() noexcept {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+}
+
+}  // namespace utils
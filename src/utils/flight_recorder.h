@@ -0,0 +1,198 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "env.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+
+namespace utils {
+
+/// @brief hot-path events kept by the flight recorder. `a`, `b` and `c` per event:
+enum class FlightEvent : uint16_t {
+  NONE = 0,
+  /// a: session (0 px, 1 px standby, 2 tx, 3 other), b: MsgSeqNum
+  FIX_SNAPSHOT = 1,
+  /// a: session (0 px, 1 px standby, 2 tx, 3 other), b: MsgSeqNum
+  FIX_INCREMENT = 2,
+  /// a: the message's `binance::MarketMessageVariant` index (0 snapshot, 1 increment,
+  /// 2 top of book), b: book message number, c: ticks spent applying
+  BOOK_APPLY = 3,
+  /// a: rows, b: book message number, c: order queue depth
+  BOOK_PUBLISH = 4,
+  /// a: trades in the message, b: trade message number, c: trade queue depth
+  TRADES = 5,
+  /// a: conflated levels applied, b: book message number, c: ticks spent applying
+  BOOK_CONFLATE = 6,
+};
+
+std::string_view to_str_view(FlightEvent event);
+
+/// @brief Crash-safe flight recorder: one fixed-size ring of binary event records per
+/// thread, preallocated, written lock-free by its own thread only. On a fatal signal
+/// @ref utils::Crash dumps every ring to a file with `write(2)` (async-signal-safe),
+/// and `flight_decode` prints the dump as one timeline.
+/// Recording is a timestamp counter read and a 32-byte store, cheap enough to stay on
+/// in production. Threads claim a ring on their first event; once all rings are
+/// claimed, further threads record nothing. A thread records into one recorder at a
+/// time (in practice, the global one).
+class FlightRecorder {
+ public:
+  static inline constexpr uint64_t DUMP_MAGIC = 0x31544C4652445254;  // "TRDRFLT1"
+  static inline constexpr uint32_t DUMP_VERSION = 1;
+  static inline constexpr uint32_t DEFAULT_MAX_THREADS = 16;
+  static inline constexpr uint32_t DEFAULT_CAPACITY = 4096;
+  static inline constexpr std::string_view DEFAULT_DUMP_PATH = "flight_recorder.bin";
+
+  struct Record {
+    /// @brief timestamp counter ticks, see @ref utils::FlightRecorder::now
+    uint64_t ticks;
+    FlightEvent event;
+    uint16_t reserved;
+    uint32_t a;
+    uint64_t b;
+    uint64_t c;
+  };
+  static_assert(sizeof(Record) == 32);
+
+  struct DumpHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t thread_count;
+    uint32_t capacity;
+    int32_t signal;
+    /// @brief to convert record ticks to time
+    double ticks_per_ns;
+    uint64_t dump_ticks;
+    /// @brief `CLOCK_REALTIME` at the dump, epoch nanoseconds
+    uint64_t dump_epoch_ns;
+  };
+
+  /// @brief follows the dump header, once per thread, then `capacity` records
+  struct ThreadHeader {
+    std::array<char, 16> name;
+    uint64_t tid;
+    /// @brief records ever written: the newest is at `(recorded - 1) % capacity`
+    uint64_t recorded;
+  };
+
+  /// @brief one thread's records from a dump, oldest first
+  struct ThreadDump {
+    std::string name;
+    uint64_t tid = 0;
+    uint64_t recorded = 0;
+    std::vector<Record> records;
+  };
+
+  struct Dump {
+    DumpHeader header{};
+    std::vector<ThreadDump> threads;
+  };
+
+  /// @param capacity records per thread, rounded up to a power of two
+  explicit FlightRecorder(uint32_t max_threads = DEFAULT_MAX_THREADS,
+                          uint32_t capacity = DEFAULT_CAPACITY);
+
+  FlightRecorder(const FlightRecorder&) = delete;
+  FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+  /// @brief the process-wide recorder, used by the hot path and the crash handler.
+  /// created by @ref utils::Crash::configure_handlers, before any signal can need it
+  static FlightRecorder& global();
+  /// @brief where @ref utils::FlightRecorder::dump_global writes. copied, as the
+  /// signal handler must not allocate
+  static void set_dump_path(std::string_view path);
+  /// @brief dump the global recorder, if created, to the dump path. async-signal-safe
+  static void dump_global(int signal) noexcept;
+
+  /// @brief append an event to the calling thread's ring. any thread, never blocks
+  void record(const FlightEvent event,
+              const uint32_t a = 0,
+              const uint64_t b = 0,
+              const uint64_t c = 0) noexcept {
+    Ring* ring = tls_ring_.ring;
+    if (tls_ring_.recorder_id != id_) [[unlikely]] {
+      ring = claim_ring();
+    }
+    if (ring == nullptr) [[unlikely]] {
+      return;
+    }
+    const uint64_t head = ring->recorded.load(std::memory_order_relaxed);
+    ring->records[head & mask_] = Record{
+        .ticks = now(), .event = event, .reserved = 0, .a = a, .b = b, .c = c};
+    // the dump may run on another thread: publish the record before the count
+    ring->recorded.store(head + 1, std::memory_order_release);
+  }
+
+  /// @brief write every claimed ring to `fd`. async-signal-safe, but not atomic with
+  /// respect to threads still recording: their newest record may be torn
+  /// @return false if a write failed
+  bool dump(int fd, int signal) const noexcept;
+
+  /// @brief parse a dump
+  /// @throws std::runtime_error if it is truncated or of another version
+  static Dump read_dump(std::istream& in);
+  /// @brief print a dump as one timeline, all threads merged, oldest first, with each
+  /// event's age relative to the dump
+  static void print_dump(const Dump& dump, std::ostream& out);
+
+  /// @brief the timestamp counter: TSC on x86, the virtual counter on ARM64, else the
+  /// steady clock in nanoseconds
+  static uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return steady_now_ns();
+#endif
+  }
+
+  /// @brief timestamp counter frequency, measured once per process
+  static double get_ticks_per_ns();
+
+ private:
+  struct alignas(utils::Env::CACHE_LINE_SIZE) Ring {
+    std::atomic<uint64_t> recorded{0};
+    Record* records = nullptr;
+    std::array<char, 16> name{};
+    uint64_t tid = 0;
+  };
+
+  /// @brief the calling thread's ring, in the recorder it last recorded into.
+  /// zero-initialised (recorder ids start at 1)
+  struct ThreadRing {
+    uint64_t recorder_id;
+    Ring* ring;
+  };
+
+  /// @brief unique per recorder, never reused (unlike addresses)
+  const uint64_t id_;
+  const uint32_t max_threads_;
+  const uint32_t capacity_;
+  const uint64_t mask_;
+  std::unique_ptr<Ring[]> rings_;
+  std::unique_ptr<Record[]> records_;
+  std::atomic<uint32_t> claimed_{0};
+  const double ticks_per_ns_;
+
+  static inline thread_local ThreadRing tls_ring_{};
+
+  /// @brief name the calling thread's ring, or nullptr once all are claimed
+  Ring* claim_ring() noexcept;
+  static uint64_t steady_now_ns() noexcept;
+};
+
+}  // namespace utils
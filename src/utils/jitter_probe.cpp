@@ -0,0 +1,195 @@
+#include "jitter_probe.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "cpu_topology.h"
+#include "flight_recorder.h"
+#include "spdlog/spdlog.h"
+#include "thread_placement.h"
+#include "threading.h"
+
+namespace utils {
+
+namespace {
+
+/// @return `fallback` if unset
+std::chrono::nanoseconds read_env_ns(const char* key,
+                                     const std::chrono::nanoseconds fallback,
+                                     const int64_t ns_per_unit) {
+  const char* val = std::getenv(key);
+  if (val == nullptr || *val == '\0') {
+    return fallback;
+  }
+  const std::string_view str{val};
+  int64_t value = 0;
+  const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+  if (ec != std::errc() || ptr != str.data() + str.size() || value < 0) {
+    throw std::runtime_error(std::format("could not parse envar. key [{}], value [{}]",
+                                         key, str));
+  }
+  return std::chrono::nanoseconds(value * ns_per_unit);
+}
+
+}  // namespace
+
+void JitterReport::add(const uint64_t gap_ns) {
+  ++interruptions;
+  total_gap_ns += gap_ns;
+  max_gap_ns = std::max(max_gap_ns, gap_ns);
+  ++histogram[to_bucket(gap_ns)];
+}
+
+// static function
+size_t JitterReport::to_bucket(const uint64_t gap_ns) {
+  return std::min<size_t>(std::bit_width(gap_ns / 1'000), BUCKETS - 1);
+}
+
+std::string JitterReport::format_metrics() const {
+  std::string line = std::format(
+      "jitter_cpu={} seconds={:.3f} samples={} interruptions={} total_gap_ns={} "
+      "max_gap_ns={}",
+      cpu, std::chrono::duration<double>(duration).count(), samples, interruptions,
+      total_gap_ns, max_gap_ns);
+  for (size_t i = 0; i + 1 < BUCKETS; ++i) {
+    line += std::format(" gaps_lt{}us={}", uint64_t{1} << i, histogram[i]);
+  }
+  line += std::format(" gaps_ge{}us={}", uint64_t{1} << (BUCKETS - 2),
+                      histogram[BUCKETS - 1]);
+  return line;
+}
+
+JitterProbe::JitterProbe(const std::chrono::nanoseconds duration,
+                         const std::chrono::nanoseconds threshold,
+                         const std::chrono::nanoseconds warn_gap)
+    : duration_(duration), threshold_(threshold), warn_gap_(warn_gap) {
+  if (duration_.count() <= 0 || threshold_.count() <= 0) {
+    throw std::runtime_error(
+        std::format("jitter probe duration and threshold must be positive. duration "
+                    "[{}ns], threshold [{}ns]",
+                    duration_.count(), threshold_.count()));
+  }
+}
+
+// static function
+std::unique_ptr<JitterProbe> JitterProbe::from_env() {
+  const std::chrono::nanoseconds duration =
+      read_env_ns("JITTER_PROBE_MS", std::chrono::nanoseconds{0}, 1'000'000);
+  if (duration.count() == 0) {
+    spdlog::info("envar not set, not probing cpus for jitter. key [JITTER_PROBE_MS]");
+    return nullptr;
+  }
+  const std::chrono::nanoseconds threshold =
+      read_env_ns("JITTER_THRESHOLD_NS", DEFAULT_THRESHOLD, 1);
+  const std::chrono::nanoseconds warn_gap =
+      read_env_ns("JITTER_WARN_NS", DEFAULT_WARN_GAP, 1);
+  spdlog::info("probing cpus for jitter. duration [{}ms], threshold [{}ns], warn [{}ns]",
+               duration.count() / 1'000'000, threshold.count(), warn_gap.count());
+  return std::make_unique<JitterProbe>(duration, threshold, warn_gap);
+}
+
+// static function
+std::vector<unsigned> JitterProbe::get_default_cpus() {
+  std::vector<unsigned> cpus;
+  if (const ThreadPlacement* placement = ThreadPlacement::get_installed()) {
+    for (const ThreadPlan& plan : placement->get_plans()) {
+      // a cpu of its own
+      if (plan.role != ThreadRole::BACKGROUND && plan.cpus.size() == 1) {
+        cpus.push_back(plan.cpus.front());
+      }
+    }
+  }
+#if defined(__linux__)
+  if (cpus.empty()) {
+    cpus = CpuTopology::from_sysfs().get_isolated();
+  }
+#endif
+  std::ranges::sort(cpus);
+  const auto [first, last] = std::ranges::unique(cpus);
+  cpus.erase(first, last);
+  return cpus;
+}
+
+std::vector<JitterReport> JitterProbe::run(const std::span<const unsigned> cpus) const {
+  std::vector<JitterReport> reports(cpus.size());
+  std::vector<std::exception_ptr> errors(cpus.size());
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(cpus.size());
+    for (size_t i = 0; i < cpus.size(); ++i) {
+      threads.emplace_back([this, &reports, &errors, i, cpu = cpus[i]] {
+        try {
+          Threading::set_thread_name(THREAD_NAME_);
+          Threading::set_thread_cpu(cpu);
+          reports[i] = probe_current_thread(cpu);
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      });
+    }
+  }
+  for (const std::exception_ptr& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  return reports;
+}
+
+JitterReport JitterProbe::probe_current_thread(const unsigned cpu) const {
+  const double ticks_per_ns = FlightRecorder::get_ticks_per_ns();
+  const auto threshold_ticks =
+      static_cast<uint64_t>(static_cast<double>(threshold_.count()) * ticks_per_ns);
+  const auto duration_ticks =
+      static_cast<uint64_t>(static_cast<double>(duration_.count()) * ticks_per_ns);
+
+  JitterReport report{.cpu = cpu, .duration = duration_};
+  uint64_t last = FlightRecorder::now();
+  const uint64_t end = last + duration_ticks;
+  while (last < end) {
+    const uint64_t now = FlightRecorder::now();
+    ++report.samples;
+    if (now - last > threshold_ticks) [[unlikely]] {
+      report.add(static_cast<uint64_t>(static_cast<double>(now - last) / ticks_per_ns));
+    }
+    last = now;
+  }
+  return report;
+}
+
+bool JitterProbe::log(const std::span<const JitterReport> reports) const {
+  if (reports.empty()) {
+    spdlog::info("no dedicated or isolated cpus to probe for jitter");
+  }
+  bool is_all_quiet = true;
+  for (const JitterReport& report : reports) {
+    if (is_quiet(report)) {
+      spdlog::info("cpu jitter. {}", report.format_metrics());
+      continue;
+    }
+    is_all_quiet = false;
+    spdlog::warn("cpu is not quiet, check its isolation and irqs. max gap [{}ns], "
+                 "limit [{}ns], {}",
+                 report.max_gap_ns, warn_gap_.count(), report.format_metrics());
+  }
+  return is_all_quiet;
+}
+
+bool JitterProbe::is_quiet(const JitterReport& report) const {
+  return report.max_gap_ns < static_cast<uint64_t>(warn_gap_.count());
+}
+
+}  // namespace utils
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace utils {
+
+/// @brief one CPU's interruptions, as seen by @ref utils::JitterProbe
+struct JitterReport {
+  /// @brief gaps by duration: under 1us, then [1, 2)us, [2, 4)us ... [512, 1024)us,
+  /// and 1024us or more
+  static inline constexpr size_t BUCKETS = 12;
+
+  unsigned cpu = 0;
+  std::chrono::nanoseconds duration{};
+  /// @brief timestamp counter reads
+  uint64_t samples = 0;
+  /// @brief gaps between two reads above the threshold
+  uint64_t interruptions = 0;
+  /// @brief time lost to them
+  uint64_t total_gap_ns = 0;
+  uint64_t max_gap_ns = 0;
+  std::array<uint64_t, BUCKETS> histogram{};
+
+  /// @brief count an interruption
+  void add(uint64_t gap_ns);
+  static size_t to_bucket(uint64_t gap_ns);
+
+  /// @brief a logfmt line, e.g. for `engine::Headless`'s output
+  std::string format_metrics() const;
+};
+
+/// @brief Checks that a CPU is quiet: spins reading the timestamp counter on it for a
+/// while, and records every gap between two reads above a threshold. A gap is time the
+/// thread was not running: an interrupt, a timer tick, another task, an SMI. On a well
+/// isolated core (`isolcpus`, `nohz_full`, IRQs moved by `scripts/pin_irqs.sh`) there
+/// are few, and short. Run at startup, before the hot threads start, or on demand with
+/// the `jitter_probe` tool.
+class JitterProbe {
+ public:
+  static inline constexpr std::string THREAD_NAME_ = "jitter_probe";
+  static inline constexpr std::chrono::nanoseconds DEFAULT_THRESHOLD{1'000};
+  static inline constexpr std::chrono::nanoseconds DEFAULT_WARN_GAP{20'000};
+
+  /// @param duration how long to spin on each CPU
+  /// @param threshold shorter gaps are not interruptions
+  /// @param warn_gap a CPU with a longer gap is reported as not quiet
+  JitterProbe(std::chrono::nanoseconds duration,
+              std::chrono::nanoseconds threshold = DEFAULT_THRESHOLD,
+              std::chrono::nanoseconds warn_gap = DEFAULT_WARN_GAP);
+
+  /// @brief read `JITTER_PROBE_MS` (optional, off if unset or 0), `JITTER_THRESHOLD_NS`
+  /// and `JITTER_WARN_NS` (optional)
+  /// @return nullptr if off
+  static std::unique_ptr<JitterProbe> from_env();
+
+  /// @brief the CPUs worth probing: those of the hot and warm threads in the installed
+  /// @ref utils::ThreadPlacement , else the isolated ones. empty if neither
+  static std::vector<unsigned> get_default_cpus();
+
+  /// @brief probe the CPUs at once, a pinned thread on each. blocks for the duration
+  /// @return a report per CPU, in order
+  std::vector<JitterReport> run(std::span<const unsigned> cpus) const;
+  /// @brief probe the CPU the calling thread runs on, without pinning it
+  JitterReport probe_current_thread(unsigned cpu) const;
+
+  /// @brief log a line per CPU, a warning for those that are not quiet
+  /// @return whether all were quiet
+  bool log(std::span<const JitterReport> reports) const;
+  bool is_quiet(const JitterReport& report) const;
+
+ private:
+  const std::chrono::nanoseconds duration_;
+  const std::chrono::nanoseconds threshold_;
+  const std::chrono::nanoseconds warn_gap_;
+};
+
+}  // namespace utils
@@ -0,0 +1,195 @@
+#include "perf_counters.h"
+
+#include <cstdint>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace utils {
+
+namespace {
+
+struct EventSpec {
+  std::string_view name;
+  uint32_t type;
+  uint64_t config;
+};
+
+#if defined(__linux__)
+
+constexpr uint64_t cache_miss(const uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+std::vector<EventSpec> events_of(const PerfCounters::Set set) {
+  switch (set) {
+    case PerfCounters::Set::CORE:
+      return {{"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+              {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+              {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}};
+    case PerfCounters::Set::CACHE:
+      // the generic cache-misses event is the last level cache on x86 and arm64,
+      // and more widely supported than the LL cache event
+      return {{"L1D-misses", PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+              {"LLC-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}};
+    case PerfCounters::Set::TLB:
+      return {{"dTLB-misses", PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB)}};
+  }
+  return {};
+}
+
+int perf_event_open(const EventSpec& event, const int group_fd) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  // the leader starts disabled and enables the whole group
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // this thread, any cpu
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+#endif
+
+}  // namespace
+
+// static
+std::vector<PerfCounters::Set> PerfCounters::parse_sets(const std::string_view spec) {
+  std::vector<Set> sets;
+  if (spec == "none" || spec.empty()) {
+    return sets;
+  }
+  if (spec == "all") {
+    return {Set::CORE, Set::CACHE, Set::TLB};
+  }
+  size_t begin = 0;
+  while (begin <= spec.size()) {
+    const size_t end = std::min(spec.find(',', begin), spec.size());
+    const std::string_view name = spec.substr(begin, end - begin);
+    bool is_found = false;
+    for (const Set set : {Set::CORE, Set::CACHE, Set::TLB}) {
+      if (name == to_str_view(set)) {
+        sets.push_back(set);
+        is_found = true;
+      }
+    }
+    if (!is_found) {
+      throw std::runtime_error(std::format(
+          "unknown perf counter set. set [{}], expected any of [core,cache,tlb,all,none]",
+          name));
+    }
+    begin = end + 1;
+  }
+  return sets;
+}
+
+// static
+std::string_view PerfCounters::to_str_view(const Set set) {
+  switch (set) {
+    case Set::CORE:
+      return "core";
+    case Set::CACHE:
+      return "cache";
+    case Set::TLB:
+      return "tlb";
+  }
+  return "?";
+}
+
+PerfCounters::PerfCounters(const std::span<const Set> sets) {
+  for (const Set set : sets) {
+    open_group(set);
+  }
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+  for (const Group& group : groups_) {
+    for (const int fd : group.fds) {
+      close(fd);
+    }
+  }
+#endif
+}
+
+void PerfCounters::open_group([[maybe_unused]] const Set set) {
+#if defined(__linux__)
+  Group group;
+  for (const EventSpec& event : events_of(set)) {
+    const int fd = perf_event_open(event, group.leader_fd);
+    if (fd == -1) {
+      spdlog::warn("perf event unavailable. event [{}], error [{}]", event.name,
+                   std::strerror(errno));
+      continue;
+    }
+    if (group.leader_fd == -1) {
+      group.leader_fd = fd;
+    }
+    group.fds.push_back(fd);
+    group.names.push_back(event.name);
+  }
+  if (group.leader_fd != -1) {
+    groups_.push_back(std::move(group));
+  }
+#else
+  spdlog::warn("perf counters are only supported on linux. set [{}]", to_str_view(set));
+#endif
+}
+
+void PerfCounters::start() {
+#if defined(__linux__)
+  for (const Group& group : groups_) {
+    ioctl(group.leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group.leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif
+}
+
+void PerfCounters::stop() {
+#if defined(__linux__)
+  for (const Group& group : groups_) {
+    ioctl(group.leader_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif
+}
+
+std::vector<PerfCounters::Reading> PerfCounters::read() const {
+  std::vector<Reading> readings;
+#if defined(__linux__)
+  for (const Group& group : groups_) {
+    // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, value[nr]
+    std::vector<uint64_t> buf(3 + group.fds.size());
+    const ssize_t n = ::read(group.leader_fd, buf.data(), buf.size() * sizeof(uint64_t));
+    if (n < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buf[2] == 0) {
+      // never scheduled on the PMU, no meaningful counts
+      continue;
+    }
+    const double scale = static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+    for (size_t i = 0; i < buf[0] && i < group.names.size(); ++i) {
+      readings.push_back({group.names[i], static_cast<double>(buf[3 + i]) * scale});
+    }
+  }
+#endif
+  return readings;
+}
+
+}  // namespace utils
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utils {
+
+/// @brief Hardware performance counters of the calling thread, user space only,
+/// through `perf_event_open` (Linux). Each set of events is opened as one perf group,
+/// so that its events are scheduled, and comparable, together; counts are scaled up
+/// when the kernel multiplexes groups.
+/// Events the CPU, the kernel or `perf_event_paranoid` refuse are skipped: on other
+/// platforms, or in most containers, nothing is counted and `read` returns nothing.
+/// Not thread-safe: open, start, stop and read from the same thread.
+class PerfCounters {
+ public:
+  enum class Set : uint8_t {
+    /// @brief cycles, instructions, branch misses
+    CORE = 0,
+    /// @brief L1 data and last level cache misses
+    CACHE = 1,
+    /// @brief data TLB misses
+    TLB = 2,
+  };
+
+  struct Reading {
+    std::string_view name;
+    double value;
+  };
+
+  /// @brief comma separated set names, "all" or "none". e.g. "core,tlb"
+  /// @throws std::runtime_error on an unknown set name
+  static std::vector<Set> parse_sets(std::string_view spec);
+  static std::string_view to_str_view(Set set);
+
+  explicit PerfCounters(std::span<const Set> sets);
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  /// @brief at least one event could be opened
+  bool is_available() const { return !groups_.empty(); }
+
+  /// @brief reset the counts and start counting
+  void start();
+  void stop();
+  /// @brief counts between the last `start` and `stop`
+  std::vector<Reading> read() const;
+
+ private:
+  struct Group {
+    int leader_fd = -1;
+    std::vector<int> fds;
+    std::vector<std::string_view> names;
+  };
+  std::vector<Group> groups_;
+
+  void open_group(Set set);
+};
+
+}  // namespace utils
@@ -0,0 +1,359 @@
+#include "run_loop.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+#include "spdlog/spdlog.h"
+#include "thread_placement.h"
+#include "threading.h"
+
+namespace utils {
+
+Task::promise_type::~promise_type() {
+  if (loop != nullptr) {
+    loop->forget(std::coroutine_handle<promise_type>::from_promise(*this).address());
+  }
+  state->is_done.store(true, std::memory_order_release);
+  state->is_done.notify_all();
+}
+
+Task::Task(const std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+Task::Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+Task::~Task() {
+  if (handle_) {
+    handle_.destroy();
+  }
+}
+
+TaskHandle::TaskHandle(std::shared_ptr<const Task::State> state)
+    : state_(std::move(state)) {}
+
+bool TaskHandle::is_done() const {
+  return !state_ || state_->is_done.load(std::memory_order_acquire);
+}
+
+void TaskHandle::wait() const {
+  if (!state_) {
+    return;
+  }
+  while (!state_->is_done.load(std::memory_order_acquire)) {
+    state_->is_done.wait(false, std::memory_order_acquire);
+  }
+}
+
+std::exception_ptr TaskHandle::get_exception() const {
+  return state_ ? state_->exception : nullptr;
+}
+
+bool RunLoop::Waiter::wake_up(const Wake reason) {
+  if (is_claimed.exchange(true, std::memory_order_acq_rel)) {
+    return false;
+  }
+  wake = reason;
+  // resumed, and possibly destroyed, from here on
+  loop->post(handle);
+  return true;
+}
+
+RunLoop::WaitBase::WaitBase(std::stop_token stoken) : stoken_(std::move(stoken)) {}
+
+RunLoop::WaitBase::~WaitBase() {
+  // waits for a stop callback running on another thread
+  on_stop_.reset();
+  if (waiter_.timer) {
+    waiter_.loop->timers_.erase(*waiter_.timer);
+  }
+}
+
+void RunLoop::WaitBase::suspend(const std::coroutine_handle<Task::promise_type> handle) {
+  waiter_.loop = handle.promise().loop;
+  waiter_.handle = handle;
+}
+
+void RunLoop::WaitBase::arm_timer(const Clock::duration timeout) {
+  waiter_.timer = waiter_.loop->timers_.emplace(Clock::now() + timeout, &waiter_);
+}
+
+void RunLoop::WaitBase::arm_stop() {
+  on_stop_.emplace(stoken_, OnStop{&waiter_});
+}
+
+void RunLoop::YieldAwaiter::await_suspend(
+    const std::coroutine_handle<Task::promise_type> handle) const {
+  handle.promise().loop->post(handle);
+}
+
+RunLoop::SleepAwaiter::SleepAwaiter(const Clock::duration timeout, std::stop_token stoken)
+    : WaitBase(std::move(stoken)), timeout_(timeout) {}
+
+void RunLoop::SleepAwaiter::await_suspend(
+    const std::coroutine_handle<Task::promise_type> handle) {
+  suspend(handle);
+  arm_timer(timeout_);
+  arm_stop();
+}
+
+bool RunLoop::SleepAwaiter::await_resume() const {
+  return waiter_.wake != Wake::STOPPED && !is_stop_requested();
+}
+
+RunLoop::ReadableAwaiter::ReadableAwaiter(const int fd,
+                                          const Clock::duration timeout,
+                                          std::stop_token stoken)
+    : WaitBase(std::move(stoken)), fd_(fd), timeout_(timeout) {}
+
+RunLoop::ReadableAwaiter::~ReadableAwaiter() {
+  if (epoll_fd_ >= 0) {
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd_, nullptr);
+  }
+}
+
+void RunLoop::ReadableAwaiter::await_suspend(
+    const std::coroutine_handle<Task::promise_type> handle) {
+  suspend(handle);
+  epoll_event event{};
+  // once: the descriptor is removed as the coroutine resumes
+  event.events = EPOLLIN | EPOLLONESHOT;
+  event.data.ptr = &waiter_;
+  if (::epoll_ctl(waiter_.loop->epoll_fd_, EPOLL_CTL_ADD, fd_, &event) != 0) {
+    throw std::runtime_error(std::format("cannot watch descriptor. fd [{}], error [{}]",
+                                         fd_, std::strerror(errno)));
+  }
+  epoll_fd_ = waiter_.loop->epoll_fd_;
+  if (timeout_ > Clock::duration::zero()) {
+    arm_timer(timeout_);
+  }
+  arm_stop();
+}
+
+bool RunLoop::ReadableAwaiter::await_resume() const {
+  return waiter_.wake == Wake::READY;
+}
+
+RunLoop::RunLoop(std::string name) : name_(std::move(name)) {
+  epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    throw std::runtime_error(
+        std::format("cannot create epoll instance. error [{}]", std::strerror(errno)));
+  }
+  wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  epoll_event event{};
+  event.events = EPOLLIN;
+  // no waiter: the loop's own wake-up
+  event.data.ptr = nullptr;
+  if (wake_fd_ < 0 || ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event) != 0) {
+    const int err = errno;
+    if (wake_fd_ >= 0) {
+      ::close(wake_fd_);
+    }
+    ::close(epoll_fd_);
+    throw std::runtime_error(
+        std::format("cannot create run loop eventfd. error [{}]", std::strerror(err)));
+  }
+}
+
+RunLoop::~RunLoop() {
+  stop();
+  ::close(wake_fd_);
+  ::close(epoll_fd_);
+}
+
+// static function
+RunLoop& RunLoop::background() {
+  // spdlog's registry first: statics are destroyed in reverse, and the loop thread
+  // logs as it closes
+  spdlog::default_logger();
+  static RunLoop loop;
+  static std::once_flag is_started;
+  std::call_once(is_started, [] { loop.start(); });
+  return loop;
+}
+
+void RunLoop::start() {
+  {
+    std::lock_guard lock(mutex_);
+    is_closed_ = false;
+  }
+  worker_ = std::jthread{[this](const std::stop_token& stoken) {
+    Threading::set_thread_name(name_);
+    thread_id_.store(std::this_thread::get_id(), std::memory_order_release);
+    spdlog::info("starting run loop thread, name [{}], id [{}]", name_,
+                 Threading::get_os_thread_id());
+    try {
+      ThreadPlacement::pin_current_thread(name_);
+      run(stoken);
+      spdlog::info("closing worker thread, name [{}]", name_);
+    } catch (const std::exception& e) {
+      spdlog::error("run loop stopped. name [{}], error [{}]", name_, e.what());
+      // nothing will resume them: their waiters must not block
+      destroy_tasks();
+    }
+  }};
+}
+
+void RunLoop::stop() {
+  if (worker_.joinable()) {
+    worker_.request_stop();
+    const uint64_t one = 1;
+    [[maybe_unused]] const ssize_t n = ::write(wake_fd_, &one, sizeof(one));
+    worker_.join();
+  }
+  destroy_tasks();
+}
+
+TaskHandle RunLoop::spawn(Task task) {
+  const std::coroutine_handle<Task::promise_type> handle =
+      std::exchange(task.handle_, {});
+  handle.promise().loop = this;
+  TaskHandle out(handle.promise().state);
+  bool is_closed = false;
+  {
+    std::lock_guard lock(mutex_);
+    is_closed = is_closed_;
+    if (!is_closed) {
+      live_.insert(handle.address());
+    }
+  }
+  // never to run: done at once
+  if (is_closed) {
+    handle.destroy();
+    return out;
+  }
+  post(handle);
+  return out;
+}
+
+void RunLoop::post(const std::coroutine_handle<> handle) {
+  bool is_first = false;
+  {
+    std::lock_guard lock(mutex_);
+    is_first = posted_.empty();
+    posted_.push_back(handle);
+  }
+  // the loop thread looks at the posted handles before it waits
+  if (is_first && !is_loop_thread()) {
+    const uint64_t one = 1;
+    [[maybe_unused]] const ssize_t n = ::write(wake_fd_, &one, sizeof(one));
+  }
+}
+
+bool RunLoop::is_loop_thread() const {
+  return thread_id_.load(std::memory_order_acquire) == std::this_thread::get_id();
+}
+
+// loop thread
+void RunLoop::run(const std::stop_token& stoken) {
+  std::array<epoll_event, MAX_EVENTS_> events{};
+  while (!stoken.stop_requested()) {
+    {
+      std::lock_guard lock(mutex_);
+      resuming_.swap(posted_);
+    }
+    for (const std::coroutine_handle<> handle : resuming_) {
+      handle.resume();
+    }
+    resuming_.clear();
+
+    const Clock::time_point now = Clock::now();
+    while (!timers_.empty() && timers_.begin()->first <= now) {
+      Waiter* waiter = timers_.begin()->second;
+      waiter->timer.reset();
+      timers_.erase(timers_.begin());
+      waiter->wake_up(Wake::TIMEOUT);
+    }
+
+    const int count = ::epoll_wait(epoll_fd_, events.data(), MAX_EVENTS_, get_wait_ms());
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(
+          std::format("cannot wait on epoll. error [{}]", std::strerror(errno)));
+    }
+    // only posted: nothing resumes before the next turn
+    for (int i = 0; i < count; ++i) {
+      if (events[i].data.ptr == nullptr) {
+        uint64_t wakes = 0;
+        [[maybe_unused]] const ssize_t n = ::read(wake_fd_, &wakes, sizeof(wakes));
+      } else {
+        static_cast<Waiter*>(events[i].data.ptr)->wake_up(Wake::READY);
+      }
+    }
+  }
+}
+
+void RunLoop::destroy_tasks() {
+  // the coroutines left are suspended: destroyed, their handles are done
+  std::unordered_set<void*> live;
+  {
+    std::lock_guard lock(mutex_);
+    is_closed_ = true;
+    live.swap(live_);
+    posted_.clear();
+  }
+  resuming_.clear();
+  for (void* frame : live) {
+    std::coroutine_handle<>::from_address(frame).destroy();
+  }
+}
+
+void RunLoop::forget(void* frame) {
+  std::lock_guard lock(mutex_);
+  live_.erase(frame);
+}
+
+int RunLoop::get_wait_ms() {
+  {
+    std::lock_guard lock(mutex_);
+    if (!posted_.empty()) {
+      return 0;
+    }
+  }
+  if (timers_.empty()) {
+    return -1;
+  }
+  const Clock::duration wait = timers_.begin()->first - Clock::now();
+  if (wait <= Clock::duration::zero()) {
+    return 0;
+  }
+  // rounded up: a timer never fires early
+  const auto ms = std::chrono::ceil<std::chrono::milliseconds>(wait).count();
+  return static_cast<int>(std::min<int64_t>(ms, std::numeric_limits<int>::max()));
+}
+
+// static function
+RunLoop::SleepAwaiter RunLoop::sleep_for(const Clock::duration timeout,
+                                         std::stop_token stoken) {
+  return SleepAwaiter{timeout, std::move(stoken)};
+}
+
+// static function
+RunLoop::ReadableAwaiter RunLoop::readable(const int fd,
+                                           const Clock::duration timeout,
+                                           std::stop_token stoken) {
+  return ReadableAwaiter{fd, timeout, std::move(stoken)};
+}
+
+}  // namespace utils
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace utils {
+
+class RunLoop;
+
+/// @brief a coroutine run by a @ref utils::RunLoop : lazy, it starts once spawned, and
+/// its frame is freed as it returns. an exception it lets out is kept for its
+/// @ref utils::TaskHandle
+class Task {
+ public:
+  /// @brief shared by the frame and the handles
+  struct State {
+    std::atomic<bool> is_done{false};
+    std::exception_ptr exception;
+  };
+
+  struct promise_type {
+    std::shared_ptr<State> state = std::make_shared<State>();
+    /// @brief set when spawned
+    RunLoop* loop = nullptr;
+
+    /// @brief the task is done: returned, threw, or was destroyed with its loop
+    ~promise_type();
+    Task get_return_object() noexcept {
+      return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { state->exception = std::current_exception(); }
+  };
+
+  Task(Task&& other) noexcept;
+  Task& operator=(Task&& other) = delete;
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+  /// @brief destroys the coroutine if it was never spawned
+  ~Task();
+
+ private:
+  friend class RunLoop;
+  std::coroutine_handle<promise_type> handle_;
+
+  explicit Task(std::coroutine_handle<promise_type> handle) noexcept;
+};
+
+/// @brief a spawned @ref utils::Task , to wait for it from another thread
+class TaskHandle {
+ public:
+  /// @brief of no task: done
+  TaskHandle() = default;
+
+  bool is_done() const;
+  /// @brief block until the task is done. never on its loop's thread
+  void wait() const;
+  /// @brief what the task threw, once done. nullptr if it returned
+  std::exception_ptr get_exception() const;
+
+ private:
+  friend class RunLoop;
+  std::shared_ptr<const Task::State> state_;
+
+  explicit TaskHandle(std::shared_ptr<const Task::State> state);
+};
+
+/// @brief A single-threaded run loop for coroutines ( @ref utils::Task ): the
+/// low-priority stages share its one pinned thread instead of a thread each, and sleep
+/// in `epoll_wait` together rather than each on its own timer. A coroutine suspends on
+/// a timer, a file descriptor or a queue ( @ref utils::AsyncQueue ) and is resumed on
+/// the loop's thread by whichever comes first, including a stop request. Another
+/// thread wakes the loop through an `eventfd`.
+/// A coroutine must not block: the others wait while it runs. It awaits in a statement
+/// of its own (`const bool is_running = co_await ...;`), never within a condition such
+/// as `while (co_await ...)`: GCC 12 loses track of the awaiter's frame. Linux only.
+class RunLoop {
+ public:
+  /// @brief the process's background loop ( @ref utils::RunLoop::background )
+  static inline constexpr std::string THREAD_NAME_ = "utils_runloop";
+
+  /// @brief what resumed a suspended coroutine
+  enum class Wake : uint8_t { NONE, READY, TIMEOUT, STOPPED };
+
+  struct Waiter;
+  using Clock = std::chrono::steady_clock;
+  using Timers = std::multimap<Clock::time_point, Waiter*>;
+
+  /// @brief a suspended coroutine. the first to wake it claims it and posts it back to
+  /// its loop, those after do nothing
+  struct Waiter {
+    RunLoop* loop = nullptr;
+    std::coroutine_handle<> handle;
+    std::atomic<bool> is_claimed{false};
+    Wake wake = Wake::NONE;
+    /// @brief its deadline, if any. loop thread only
+    std::optional<Timers::iterator> timer;
+
+    /// @brief claim it for `wake` and post it. any thread
+    /// @return false if it was already woken
+    bool wake_up(Wake reason);
+  };
+
+  /// @brief the base of the awaitables: suspends the coroutine on its loop, wakes it on
+  /// a stop request, and disarms it once resumed, whatever woke it
+  class WaitBase {
+   public:
+    WaitBase(const WaitBase&) = delete;
+    WaitBase& operator=(const WaitBase&) = delete;
+
+   protected:
+    explicit WaitBase(std::stop_token stoken);
+    ~WaitBase();
+
+    bool is_stop_requested() const { return stoken_.stop_requested(); }
+    /// @brief take the coroutine. from `await_suspend`, before arming any waker
+    void suspend(std::coroutine_handle<Task::promise_type> handle);
+    /// @brief wake with `Wake::TIMEOUT` after `timeout`
+    void arm_timer(Clock::duration timeout);
+    /// @brief wake with `Wake::STOPPED` on a stop request. last, it may wake at once
+    void arm_stop();
+
+    Waiter waiter_;
+
+   private:
+    struct OnStop {
+      Waiter* waiter;
+      void operator()() const { waiter->wake_up(Wake::STOPPED); }
+    };
+
+    std::stop_token stoken_;
+    std::optional<std::stop_callback<OnStop>> on_stop_;
+  };
+
+  /// @brief @ref utils::RunLoop::yield
+  struct YieldAwaiter {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<Task::promise_type> handle) const;
+    void await_resume() const noexcept {}
+  };
+
+  /// @brief @ref utils::RunLoop::sleep_for
+  class SleepAwaiter : public WaitBase {
+   public:
+    SleepAwaiter(Clock::duration timeout, std::stop_token stoken);
+
+    bool await_ready() const { return is_stop_requested(); }
+    void await_suspend(std::coroutine_handle<Task::promise_type> handle);
+    /// @return false if stopped
+    bool await_resume() const;
+
+   private:
+    const Clock::duration timeout_;
+  };
+
+  /// @brief @ref utils::RunLoop::readable
+  class ReadableAwaiter : public WaitBase {
+   public:
+    ReadableAwaiter(int fd, Clock::duration timeout, std::stop_token stoken);
+    ~ReadableAwaiter();
+
+    bool await_ready() const { return is_stop_requested(); }
+    /// @throws std::runtime_error if the descriptor cannot be watched
+    void await_suspend(std::coroutine_handle<Task::promise_type> handle);
+    /// @return false on a timeout, or if stopped
+    bool await_resume() const;
+
+   private:
+    const int fd_;
+    const Clock::duration timeout_;
+    int epoll_fd_ = -1;
+  };
+
+  /// @param name the loop thread's, as placed by @ref utils::ThreadPlacement
+  /// @throws std::runtime_error if the epoll instance cannot be created
+  explicit RunLoop(std::string name = THREAD_NAME_);
+  /// @brief @ref utils::RunLoop::stop
+  ~RunLoop();
+
+  RunLoop(const RunLoop&) = delete;
+  RunLoop& operator=(const RunLoop&) = delete;
+
+  /// @brief the low-priority stages' loop, started on first use and stopped at exit,
+  /// or earlier by `stop`
+  static RunLoop& background();
+
+  /// @brief start the loop thread, pinned by its name
+  void start();
+  /// @brief stop and join the loop thread, then destroy the coroutines still suspended:
+  /// their handles are done. as the loop thread fails, too
+  void stop();
+
+  /// @brief run `task` on the loop, or destroy it at once if the loop is stopped or
+  /// failed. any thread
+  TaskHandle spawn(Task task);
+  /// @brief resume `handle` on the loop. any thread
+  void post(std::coroutine_handle<> handle);
+  bool is_loop_thread() const;
+
+  /// @brief let the loop's other coroutines run, then carry on
+  static YieldAwaiter yield() { return {}; }
+  /// @brief resume after `timeout`, or earlier on a stop request
+  /// @return (awaited) false if stopped
+  static SleepAwaiter sleep_for(Clock::duration timeout, std::stop_token stoken);
+  /// @brief resume once `fd` is readable, after `timeout` (if positive) or on a stop
+  /// request. one coroutine at a time per descriptor
+  /// @return (awaited) true if readable
+  static ReadableAwaiter readable(int fd,
+                                  Clock::duration timeout,
+                                  std::stop_token stoken);
+
+ private:
+  /// @brief events handled per `epoll_wait`
+  static inline constexpr int MAX_EVENTS_ = 64;
+
+  const std::string name_;
+  int epoll_fd_ = -1;
+  /// @brief wakes `epoll_wait` for what another thread posted
+  int wake_fd_ = -1;
+
+  std::mutex mutex_;
+  /// @brief to resume on the next turn
+  std::vector<std::coroutine_handle<>> posted_;
+  /// @brief the frames of the spawned coroutines not yet done, owned by the loop
+  std::unordered_set<void*> live_;
+  /// @brief stopped or failed: a task spawned now is destroyed at once
+  bool is_closed_ = false;
+
+  // loop thread state
+  Timers timers_;
+  /// @brief the posted handles being resumed, reused
+  std::vector<std::coroutine_handle<>> resuming_;
+  std::atomic<std::thread::id> thread_id_;
+
+  std::jthread worker_;
+
+  friend struct Task::promise_type;
+
+  void run(const std::stop_token& stoken);
+  /// @brief destroy the coroutines left, as the loop stops or fails: their handles
+  /// are done. not while the loop thread runs them
+  void destroy_tasks();
+  /// @brief a frame is being destroyed
+  void forget(void* frame);
+  /// @return the `epoll_wait` timeout in ms: 0 with coroutines to resume, -1 without
+  /// them or timers
+  int get_wait_ms();
+};
+
+}  // namespace utils
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "env.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace utils {
+
+/// @brief Single-writer, multi-reader sequence lock.
+/// The writer never blocks or waits for readers. Readers copy the value and retry if
+/// the writer was mid-update. Suited to small, frequently-written, occasionally-read
+/// state (e.g. market data published to the UI or to other threads).
+/// @tparam T must be trivially copyable, readers `memcpy` it while it may be written.
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>, "SeqLock requires trivial copies");
+
+ public:
+  SeqLock() = default;
+  explicit SeqLock(const T& value) : value_(value) {}
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  /// @brief update the value in place. writer thread only.
+  /// @param fn callable taking a `T&`, should be short and must not throw
+  template <typename Fn>
+  void write(Fn&& fn) noexcept {
+    const uint64_t seq = seq_.load(std::memory_order_relaxed);
+    // odd == write in progress
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    fn(value_);
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  /// @brief replace the value. writer thread only.
+  void store(const T& value) noexcept {
+    write([&value](T& v) { v = value; });
+  }
+
+  /// @brief take a consistent copy of the value. any thread, never blocks the writer.
+  T load() const noexcept {
+    T copy;
+    for (;;) {
+      const uint64_t before = seq_.load(std::memory_order_acquire);
+      if ((before & 1u) == 0) {
+        std::memcpy(static_cast<void*>(&copy), &value_, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) == before) {
+          return copy;
+        }
+      }
+      cpu_relax();
+    }
+  }
+
+  /// @brief number of completed writes, useful for cheap change detection
+  uint64_t version() const noexcept {
+    return seq_.load(std::memory_order_acquire) / 2;
+  }
+
+ private:
+  // readers spin on the sequence, keep it off the value's cache lines
+  alignas(Env::CACHE_LINE_SIZE) std::atomic<uint64_t> seq_{0};
+  alignas(Env::CACHE_LINE_SIZE) T value_{};
+
+  static inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+  }
+};
+
+}  // namespace utils
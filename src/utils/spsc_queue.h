@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+#include "env.h"
+
+namespace utils {
+
+/// @brief Bounded single-producer, single-consumer queue: a ring of `Capacity` slots.
+/// Neither side ever blocks or allocates: a full queue rejects the push, so a hot
+/// producer can hand work to a background consumer at the cost of two index reads.
+/// Each side caches the other's index, touching the shared cache line only when its
+/// cached view says the ring is full (producer) or empty (consumer).
+/// Large: allocate it on the heap.
+/// @tparam Capacity a power of two
+template <typename T, size_t Capacity>
+class SpscQueue {
+  static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+
+ public:
+  SpscQueue() = default;
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /// @brief producer thread only
+  /// @return false when full, the value is not queued
+  bool try_push(const T& value) noexcept {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ == Capacity) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ == Capacity) {
+        return false;
+      }
+    }
+    buffer_[tail & MASK] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief consumer thread only
+  /// @return false when empty
+  bool try_pop(T& out) noexcept {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == cached_tail_) {
+        return false;
+      }
+    }
+    out = buffer_[head & MASK];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief approximate when either side is active. any thread
+  size_t size_approx() const noexcept {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+  static constexpr size_t capacity() noexcept { return Capacity; }
+
+ private:
+  static inline constexpr size_t MASK = Capacity - 1;
+
+  // consumer
+  alignas(utils::Env::CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+  size_t cached_tail_ = 0;
+  // producer
+  alignas(utils::Env::CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+  size_t cached_head_ = 0;
+  alignas(utils::Env::CACHE_LINE_SIZE) std::array<T, Capacity> buffer_{};
+};
+
+}  // namespace utils
@@ -0,0 +1,507 @@
+#include "thread_placement.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "cpu_topology.h"
+#include "spdlog/spdlog.h"
+#include "threading.h"
+
+namespace utils {
+
+namespace {
+
+/// @brief the process's plan, installed before the planned threads start
+std::unique_ptr<const ThreadPlacement> installed;
+
+/// @brief where to look for CPUs: an L3 domain, a NUMA node, or anywhere
+struct Scope {
+  std::optional<unsigned> l3 = std::nullopt;
+  std::optional<unsigned> numa_node = std::nullopt;
+
+  bool contains(const LogicalCpu& cpu) const {
+    return (!l3 || cpu.l3 == *l3) && (!numa_node || cpu.numa_node == *numa_node);
+  }
+};
+
+/// @brief The CPUs left to plan on, in the order to hand them out. Tracks what is taken
+/// by physical core, so that a hot thread's core is taken whole.
+class CpuPool {
+ public:
+  CpuPool(const CpuTopology& topology, std::vector<const LogicalCpu*> candidates)
+      : topology_(topology), candidates_(std::move(candidates)) {}
+
+  /// @brief the L3 domains of the candidates, in order
+  std::vector<unsigned> get_domains() const {
+    std::vector<unsigned> domains;
+    for (const LogicalCpu* cpu : candidates_) {
+      if (std::ranges::find(domains, cpu->l3) == domains.end()) {
+        domains.push_back(cpu->l3);
+      }
+    }
+    return domains;
+  }
+
+  /// @brief the NUMA nodes of the candidates, in order
+  std::vector<unsigned> get_nodes() const {
+    std::vector<unsigned> nodes;
+    for (const LogicalCpu* cpu : candidates_) {
+      if (std::ranges::find(nodes, cpu->numa_node) == nodes.end()) {
+        nodes.push_back(cpu->numa_node);
+      }
+    }
+    return nodes;
+  }
+
+  /// @brief the NUMA node of an L3 domain
+  unsigned get_node(const unsigned l3) const {
+    const auto it = std::ranges::find_if(
+        candidates_, [l3](const LogicalCpu* cpu) { return cpu->l3 == l3; });
+    return it == candidates_.end() ? 0 : (*it)->numa_node;
+  }
+
+  /// @brief free physical cores, all of whose SMT siblings are candidates
+  std::vector<unsigned> free_cores(const Scope& scope) const {
+    std::vector<unsigned> cores;
+    for (const LogicalCpu* cpu : candidates_) {
+      if (scope.contains(*cpu) && std::ranges::find(cores, cpu->core) == cores.end() &&
+          is_free_core(cpu->core)) {
+        cores.push_back(cpu->core);
+      }
+    }
+    return cores;
+  }
+
+  /// @brief free candidates, those on cores already in use first: whole cores are kept
+  /// for hot threads
+  std::vector<unsigned> free_cpus(const Scope& scope) const {
+    std::vector<unsigned> shared;
+    std::vector<unsigned> whole;
+    for (const LogicalCpu* cpu : candidates_) {
+      if (scope.contains(*cpu) && !taken_.contains(cpu->id)) {
+        (is_free_core(cpu->core) ? whole : shared).push_back(cpu->id);
+      }
+    }
+    shared.insert(shared.end(), whole.begin(), whole.end());
+    return shared;
+  }
+
+  /// @brief take a core and its siblings
+  /// @return the CPU to run on: its first candidate
+  unsigned take_core(const unsigned core) {
+    std::optional<unsigned> first;
+    for (const LogicalCpu& cpu : topology_.get_cpus()) {
+      if (cpu.core == core) {
+        taken_.insert(cpu.id);
+        if (!first && is_candidate(cpu.id)) {
+          first = cpu.id;
+        }
+      }
+    }
+    return first.value_or(core);
+  }
+
+  /// @brief whether `scope` has a core per hot thread and a CPU per warm one
+  bool fits(const Scope& scope, const size_t hot, const size_t warm) const {
+    const std::vector<unsigned> cores = free_cores(scope);
+    return cores.size() >= hot &&
+           free_cpus(scope).size() - count_cpus(std::span(cores).first(hot)) >= warm;
+  }
+
+  /// @brief the candidates on `cores`
+  size_t count_cpus(const std::span<const unsigned> cores) const {
+    return static_cast<size_t>(
+        std::ranges::count_if(candidates_, [cores](const LogicalCpu* cpu) {
+          return std::ranges::find(cores, cpu->core) != cores.end();
+        }));
+  }
+
+  void take_cpu(const unsigned id) { taken_.insert(id); }
+  bool is_taken(const unsigned id) const { return taken_.contains(id); }
+
+ private:
+  const CpuTopology& topology_;
+  std::vector<const LogicalCpu*> candidates_;
+  std::set<unsigned> taken_;
+
+  bool is_candidate(const unsigned id) const {
+    return std::ranges::any_of(candidates_,
+                               [id](const LogicalCpu* cpu) { return cpu->id == id; });
+  }
+  bool is_free_core(const unsigned core) const {
+    return std::ranges::all_of(topology_.get_cpus(), [this, core](const LogicalCpu& cpu) {
+      return cpu.core != core || (is_candidate(cpu.id) && !taken_.contains(cpu.id));
+    });
+  }
+};
+
+ThreadRole parse_role(const std::string_view role) {
+  if (role == "hot") {
+    return ThreadRole::HOT;
+  }
+  if (role == "warm") {
+    return ThreadRole::WARM;
+  }
+  if (role == "background") {
+    return ThreadRole::BACKGROUND;
+  }
+  throw std::runtime_error(std::format("invalid thread role. value [{}]", role));
+}
+
+}  // namespace
+
+// static function
+const std::vector<ThreadPolicy>& ThreadPlacement::default_policy() {
+  // NB: the names the threads set, e.g. `binance::FixApp::THREAD_NAME_` and its session
+  static const std::vector<ThreadPolicy> policy = {
+      // prices: the FIX session parses, the engine applies
+      {.thread = "fix_session_PX", .role = ThreadRole::HOT, .group = "book"},
+      {.thread = "engine_book", .role = ThreadRole::HOT, .group = "book"},
+      {.thread = "fix_session_PXB", .role = ThreadRole::WARM, .group = "book"},
+      // trades
+      {.thread = "fix_session_TX", .role = ThreadRole::WARM, .group = "trades"},
+      {.thread = "engine_trade", .role = ThreadRole::WARM, .group = "trades"},
+      // housekeeping
+      {.thread = "main", .role = ThreadRole::BACKGROUND},
+      {.thread = "ui_refresh", .role = ThreadRole::BACKGROUND},
+      // checkpoints, tape, log tailing and search, telemetry: coroutines on one loop
+      {.thread = "utils_runloop", .role = ThreadRole::BACKGROUND},
+  };
+  return policy;
+}
+
+// static function
+std::vector<ThreadPolicy> ThreadPlacement::parse_policy(const std::string_view text) {
+  std::vector<ThreadPolicy> policy;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t end = text.find(',', pos);
+    if (end == std::string_view::npos) {
+      end = text.size();
+    }
+    const std::string_view entry = text.substr(pos, end - pos);
+    pos = end + 1;
+    if (entry.empty()) {
+      continue;
+    }
+    // <thread>=<role>[@<group>]
+    const size_t equals = entry.find('=');
+    if (equals == std::string_view::npos || equals == 0) {
+      throw std::runtime_error(std::format("invalid thread policy. entry [{}]", entry));
+    }
+    const std::string_view rest = entry.substr(equals + 1);
+    const size_t at = rest.find('@');
+    policy.push_back(ThreadPolicy{
+        .thread = std::string(entry.substr(0, equals)),
+        .role = parse_role(rest.substr(0, at)),
+        .group = at == std::string_view::npos ? "" : std::string(rest.substr(at + 1)),
+    });
+  }
+  return policy;
+}
+
+// static function
+ThreadPlacement ThreadPlacement::plan(const CpuTopology& topology,
+                                      const std::span<const unsigned> allowed,
+                                      const std::span<const ThreadPolicy> policy) {
+  std::vector<const LogicalCpu*> usable;
+  std::vector<const LogicalCpu*> isolated;
+  for (const LogicalCpu& cpu : topology.get_cpus()) {
+    if (std::ranges::binary_search(allowed, cpu.id)) {
+      usable.push_back(&cpu);
+      if (std::ranges::binary_search(topology.get_isolated(), cpu.id)) {
+        isolated.push_back(&cpu);
+      }
+    }
+  }
+  // hot and warm threads on the isolated CPUs. without any, away from the first core,
+  // which takes the interrupts and housekeeping
+  std::vector<const LogicalCpu*> candidates = isolated.empty() ? usable : isolated;
+  if (isolated.empty() && !usable.empty()) {
+    const unsigned first_core = usable.front()->core;
+    std::ranges::stable_partition(candidates, [first_core](const LogicalCpu* cpu) {
+      return cpu->core != first_core;
+    });
+  }
+  CpuPool pool(topology, candidates);
+
+  ThreadPlacement placement;
+  for (const ThreadPolicy& entry : policy) {
+    placement.plans_.push_back(
+        ThreadPlan{.thread = entry.thread, .role = entry.role, .group = entry.group});
+  }
+
+  // the hot and warm threads, a group at a time: in the L3 domain that fits it
+  std::vector<std::string> groups;
+  for (const ThreadPlan& plan : placement.plans_) {
+    const std::string key = plan.group.empty() ? plan.thread : plan.group;
+    if (plan.role != ThreadRole::BACKGROUND &&
+        std::ranges::find(groups, key) == groups.end()) {
+      groups.push_back(key);
+    }
+  }
+  std::vector<ThreadPlan*> unplaced;
+  for (const std::string& group : groups) {
+    std::vector<ThreadPlan*> members;
+    size_t hot = 0;
+    for (ThreadPlan& plan : placement.plans_) {
+      if (plan.role != ThreadRole::BACKGROUND &&
+          (plan.group.empty() ? plan.thread : plan.group) == group) {
+        members.push_back(&plan);
+        hot += plan.role == ThreadRole::HOT ? 1 : 0;
+      }
+    }
+    const size_t warm = members.size() - hot;
+    // the first domain with a core per hot thread and a CPU per warm one. failing that,
+    // the roomiest domain of the first NUMA node the group fits, or of any: what
+    // overflows the domain stays on its node if it can
+    std::optional<unsigned> domain;
+    for (const unsigned l3 : pool.get_domains()) {
+      if (pool.fits(Scope{.l3 = l3}, hot, warm)) {
+        domain = l3;
+        break;
+      }
+    }
+    if (!domain) {
+      std::optional<unsigned> node;
+      for (const unsigned numa_node : pool.get_nodes()) {
+        if (pool.fits(Scope{.numa_node = numa_node}, hot, warm)) {
+          node = numa_node;
+          break;
+        }
+      }
+      size_t most_free = 0;
+      for (const unsigned l3 : pool.get_domains()) {
+        const size_t free_cpus = pool.free_cpus(Scope{.l3 = l3}).size();
+        if ((!node || pool.get_node(l3) == *node) && free_cpus > most_free) {
+          most_free = free_cpus;
+          domain = l3;
+        }
+      }
+    }
+    // nearest first: the domain, its node, anywhere
+    std::vector<Scope> scopes;
+    if (domain) {
+      scopes = {Scope{.l3 = domain}, Scope{.numa_node = pool.get_node(*domain)}};
+    }
+    scopes.emplace_back();
+
+    for (ThreadPlan* plan : members) {
+      if (plan->role == ThreadRole::HOT) {
+        std::vector<unsigned> cores;
+        for (auto it = scopes.begin(); cores.empty() && it != scopes.end(); ++it) {
+          cores = pool.free_cores(*it);
+        }
+        if (!cores.empty()) {
+          plan->cpus = {pool.take_core(cores.front())};
+          continue;
+        }
+      }
+      std::vector<unsigned> cpus;
+      for (auto it = scopes.begin(); cpus.empty() && it != scopes.end(); ++it) {
+        cpus = pool.free_cpus(*it);
+      }
+      if (cpus.empty()) {
+        unplaced.push_back(plan);
+        continue;
+      }
+      pool.take_cpu(cpus.front());
+      plan->cpus = {cpus.front()};
+    }
+  }
+
+  // the background threads share what is left: off the isolated CPUs if there are any
+  std::vector<unsigned> background;
+  for (const LogicalCpu* cpu : usable) {
+    const bool is_isolated = std::ranges::binary_search(topology.get_isolated(), cpu->id);
+    if (!pool.is_taken(cpu->id) && !is_isolated) {
+      background.push_back(cpu->id);
+    }
+  }
+  if (background.empty()) {
+    for (const LogicalCpu* cpu : usable) {
+      if (!pool.is_taken(cpu->id)) {
+        background.push_back(cpu->id);
+      }
+    }
+  }
+  // none left: share all of them, rather than leave the threads unpinned
+  if (background.empty()) {
+    for (const LogicalCpu* cpu : usable) {
+      background.push_back(cpu->id);
+    }
+  }
+  for (ThreadPlan& plan : placement.plans_) {
+    if (plan.role == ThreadRole::BACKGROUND) {
+      plan.cpus = background;
+    }
+  }
+  // out of CPUs of their own
+  for (ThreadPlan* plan : unplaced) {
+    plan->cpus = background;
+  }
+  return placement;
+}
+
+// static function
+std::unique_ptr<ThreadPlacement> ThreadPlacement::from_env() {
+  const char* mode = std::getenv("THREAD_PLACEMENT");
+  const std::string_view mode_str = mode == nullptr || *mode == '\0' ? "auto" : mode;
+  spdlog::info("fetched envar. key [THREAD_PLACEMENT], value [{}]", mode_str);
+  if (mode_str == "off") {
+    return nullptr;
+  }
+  if (mode_str != "auto") {
+    throw std::runtime_error(
+        std::format("invalid thread placement. key [THREAD_PLACEMENT], value [{}]",
+                    mode_str));
+  }
+#if !defined(__linux__)
+  spdlog::warn("thread placement needs linux's cpu topology, threads are not pinned");
+  return nullptr;
+#else
+  std::vector<ThreadPolicy> policy = default_policy();
+  if (const char* text = std::getenv("THREAD_POLICY"); text != nullptr && *text != '\0') {
+    spdlog::info("fetched envar. key [THREAD_POLICY], value [{}]", text);
+    policy = parse_policy(text);
+  }
+  const CpuTopology topology = CpuTopology::from_sysfs();
+  const std::vector<unsigned> allowed = Threading::get_allowed_cpus();
+  std::set<unsigned> nodes;
+  for (const LogicalCpu& cpu : topology.get_cpus()) {
+    nodes.insert(cpu.numa_node);
+  }
+  spdlog::info("planning thread placement. cpus [{}], numa nodes [{}], isolated [{}], "
+               "allowed [{}]",
+               topology.get_cpus().size(), nodes.size(),
+               CpuTopology::to_cpu_list(topology.get_isolated()),
+               CpuTopology::to_cpu_list(allowed));
+  auto placement = std::make_unique<ThreadPlacement>(plan(topology, allowed, policy));
+  for (const std::string& shortfall : placement->validate(topology, allowed)) {
+    spdlog::warn("thread placement falls short of its policy. reason [{}]", shortfall);
+  }
+  placement->log();
+  return placement;
+#endif
+}
+
+std::vector<std::string> ThreadPlacement::validate(
+    const CpuTopology& topology,
+    const std::span<const unsigned> allowed) const {
+  std::vector<std::string> shortfalls;
+  for (const ThreadPlan& plan : plans_) {
+    for (const unsigned cpu : plan.cpus) {
+      if (topology.find(cpu) == nullptr || !std::ranges::binary_search(allowed, cpu)) {
+        throw std::runtime_error(
+            std::format("thread planned on a cpu it cannot run on. thread [{}], cpu [{}]",
+                        plan.thread, cpu));
+      }
+    }
+  }
+  // hot: a core to itself
+  for (const ThreadPlan& plan : plans_) {
+    if (plan.role == ThreadRole::BACKGROUND) {
+      continue;
+    }
+    if (plan.cpus.size() != 1) {
+      shortfalls.push_back(
+          std::format("no cpu of its own, thread [{}] shares the background cpus",
+                      plan.thread));
+      continue;
+    }
+    if (plan.role != ThreadRole::HOT) {
+      continue;
+    }
+    const unsigned core = topology.find(plan.cpus.front())->core;
+    for (const ThreadPlan& other : plans_) {
+      if (&other != &plan && std::ranges::any_of(other.cpus, [&](const unsigned cpu) {
+            return topology.find(cpu)->core == core;
+          })) {
+        shortfalls.push_back(std::format("hot thread [{}] shares core [{}] with [{}]",
+                                         plan.thread, core, other.thread));
+      }
+    }
+  }
+  // a group: one L3, and so one NUMA node
+  std::map<std::string, std::set<unsigned>> group_domains;
+  std::map<std::string, std::set<unsigned>> group_nodes;
+  for (const ThreadPlan& plan : plans_) {
+    if (plan.role != ThreadRole::BACKGROUND && !plan.group.empty() &&
+        plan.cpus.size() == 1) {
+      const LogicalCpu* cpu = topology.find(plan.cpus.front());
+      group_domains[plan.group].insert(cpu->l3);
+      group_nodes[plan.group].insert(cpu->numa_node);
+    }
+  }
+  for (const auto& [group, domains] : group_domains) {
+    if (domains.size() > 1) {
+      shortfalls.push_back(
+          std::format("group [{}] spans [{}] L3 domains", group, domains.size()));
+    }
+    // its threads' memory on another node than some of them
+    if (const size_t nodes = group_nodes[group].size(); nodes > 1) {
+      shortfalls.push_back(
+          std::format("group [{}] spans [{}] NUMA nodes", group, nodes));
+    }
+  }
+  return shortfalls;
+}
+
+void ThreadPlacement::log() const {
+  for (const ThreadPlan& plan : plans_) {
+    spdlog::info("thread placement. thread [{}], role [{}], group [{}], cpus [{}]",
+                 plan.thread, to_str(plan.role), plan.group,
+                 plan.cpus.empty() ? "any" : CpuTopology::to_cpu_list(plan.cpus));
+  }
+}
+
+const ThreadPlan* ThreadPlacement::find(const std::string_view thread) const {
+  const auto it = std::ranges::find(plans_, thread, &ThreadPlan::thread);
+  return it == plans_.end() ? nullptr : &*it;
+}
+
+// static function
+void ThreadPlacement::install(std::unique_ptr<ThreadPlacement> placement) {
+  installed = std::move(placement);
+}
+
+// static function
+const ThreadPlacement* ThreadPlacement::get_installed() {
+  return installed.get();
+}
+
+// static function
+bool ThreadPlacement::pin_current_thread(const std::string_view thread) {
+  const ThreadPlan* plan = installed ? installed->find(thread) : nullptr;
+  if (plan == nullptr || plan->cpus.empty()) {
+    return false;
+  }
+  Threading::set_thread_cpus(plan->cpus);
+  return true;
+}
+
+// static function
+std::string_view ThreadPlacement::to_str(const ThreadRole role) {
+  switch (role) {
+    case ThreadRole::HOT:
+      return "hot";
+    case ThreadRole::WARM:
+      return "warm";
+    case ThreadRole::BACKGROUND:
+      return "background";
+  }
+  return "unknown";
+}
+
+}  // namespace utils
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cpu_topology.h"
+
+namespace utils {
+
+/// @brief how much of the machine a thread gets
+enum class ThreadRole : uint8_t {
+  /// @brief latency critical: a physical core of its own, its SMT siblings left idle
+  HOT,
+  /// @brief on the data path: a logical CPU of its own
+  WARM,
+  /// @brief everything else: shares the housekeeping CPUs
+  BACKGROUND,
+};
+
+/// @brief one named thread's role
+struct ThreadPolicy {
+  /// @brief the name it sets, `utils::Threading::set_thread_name`
+  std::string thread;
+  ThreadRole role = ThreadRole::BACKGROUND;
+  /// @brief threads that hand data to each other, placed under one L3 cache, else on
+  /// one NUMA node. empty for none
+  std::string group{};
+
+  bool operator==(const ThreadPolicy&) const = default;
+};
+
+/// @brief where one thread runs
+struct ThreadPlan {
+  std::string thread;
+  ThreadRole role = ThreadRole::BACKGROUND;
+  std::string group{};
+  /// @brief empty: not pinned
+  std::vector<unsigned> cpus{};
+};
+
+/// @brief Plans where each named thread runs, from the CPU topology and a declarative
+/// role policy, instead of raw CPU ids per thread. Hot and warm threads go to the
+/// isolated CPUs if there are any (`isolcpus`), the background threads to the rest.
+/// Hot threads get a physical core each, and the threads of a group share an L3; if
+/// they do not fit one, they stay on one NUMA node where they can.
+/// Planned once at startup and installed process-wide, each thread then pins itself by
+/// name as it starts ( @ref pin_current_thread ).
+class ThreadPlacement {
+ public:
+  /// @brief the market data path is hot, the trades are warm, the rest background
+  static const std::vector<ThreadPolicy>& default_policy();
+  /// @brief parse a policy, `<thread>=<hot|warm|background>[@<group>],...`
+  /// @throws std::runtime_error if malformed
+  static std::vector<ThreadPolicy> parse_policy(std::string_view text);
+
+  /// @brief best effort: a thread that does not get what its role asks for is placed as
+  /// well as the CPUs left allow, see @ref validate
+  /// @param allowed the CPUs the process may run on, sorted
+  static ThreadPlacement plan(const CpuTopology& topology,
+                              std::span<const unsigned> allowed,
+                              std::span<const ThreadPolicy> policy);
+
+  /// @brief `THREAD_PLACEMENT`: `auto` (default) plans over sysfs and the process's
+  /// CPUs, `off` leaves the threads to the scheduler. `THREAD_POLICY` replaces the
+  /// default policy. validates and logs the plan
+  /// @return nullptr if off
+  static std::unique_ptr<ThreadPlacement> from_env();
+
+  /// @brief check the plan against the topology
+  /// @return what falls short of the policy: hot threads sharing a core, groups split
+  /// across L3 domains or NUMA nodes, threads left unpinned
+  /// @throws std::runtime_error if a thread is planned on a CPU it cannot run on
+  std::vector<std::string> validate(const CpuTopology& topology,
+                                    std::span<const unsigned> allowed) const;
+  /// @brief log a line per thread
+  void log() const;
+
+  const std::vector<ThreadPlan>& get_plans() const { return plans_; }
+  /// @return nullptr if not planned
+  const ThreadPlan* find(std::string_view thread) const;
+
+  /// @brief make `placement` the process's plan. before the planned threads start
+  static void install(std::unique_ptr<ThreadPlacement> placement);
+  /// @return nullptr if none installed
+  static const ThreadPlacement* get_installed();
+  /// @brief pin the calling thread as the installed plan has it
+  /// @return false if there is no plan, or it does not place the thread
+  static bool pin_current_thread(std::string_view thread);
+
+  static std::string_view to_str(ThreadRole role);
+
+ private:
+  std::vector<ThreadPlan> plans_;
+};
+
+}  // namespace utils
@@ -0,0 +1,312 @@
+#include "thread_telemetry.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "run_loop.h"
+#include "spdlog/spdlog.h"
+#include "threading.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace utils {
+
+namespace {
+
+/// @return nullopt if the file cannot be read
+std::optional<std::string> read_file(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  if (!file) {
+    return std::nullopt;
+  }
+  std::ostringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+/// @return false if `text` is not a number
+template <typename T>
+bool parse_number(const std::string_view text, T& out) {
+  const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+  return ec == std::errc() && ptr == text.data() + text.size();
+}
+
+/// @brief the whitespace-separated fields of `text`
+std::vector<std::string_view> split(const std::string_view text) {
+  std::vector<std::string_view> fields;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    const size_t start = text.find_first_not_of(" \t\n", pos);
+    if (start == std::string_view::npos) {
+      break;
+    }
+    const size_t end = std::min(text.find_first_of(" \t\n", start), text.size());
+    fields.push_back(text.substr(start, end - start));
+    pos = end;
+  }
+  return fields;
+}
+
+/// @brief `now - before` per second, 0 if the counter went back (a reused tid)
+double rate(const uint64_t now, const uint64_t before, const double seconds) {
+  return now >= before ? static_cast<double>(now - before) / seconds : 0.0;
+}
+
+uint64_t get_ns_per_tick() {
+#if defined(__linux__)
+  const long hz = ::sysconf(_SC_CLK_TCK);
+  if (hz > 0) {
+    return 1'000'000'000 / static_cast<uint64_t>(hz);
+  }
+#endif
+  return 10'000'000;
+}
+
+}  // namespace
+
+// static function
+bool ThreadSample::parse_stat(const std::string_view stat,
+                              const uint64_t ns_per_tick,
+                              ThreadSample& out) {
+  // `<tid> (<comm>) <state> ...`, comm may hold spaces and parentheses
+  const size_t comm_end = stat.rfind(')');
+  if (comm_end == std::string_view::npos) {
+    return false;
+  }
+  // from field 3, state
+  const std::vector<std::string_view> fields = split(stat.substr(comm_end + 1));
+  const auto field = [&fields](const size_t number) { return fields[number - 3]; };
+  constexpr size_t PROCESSOR = 39;
+  if (fields.size() < PROCESSOR - 2) {
+    return false;
+  }
+  uint64_t utime = 0;
+  uint64_t stime = 0;
+  if (!parse_number(field(10), out.minor_faults) ||
+      !parse_number(field(12), out.major_faults) || !parse_number(field(14), utime) ||
+      !parse_number(field(15), stime) || !parse_number(field(PROCESSOR), out.last_cpu)) {
+    return false;
+  }
+  out.cpu_time_ns = (utime + stime) * ns_per_tick;
+  return true;
+}
+
+// static function
+void ThreadSample::parse_status(const std::string_view status, ThreadSample& out) {
+  size_t pos = 0;
+  while (pos < status.size()) {
+    size_t end = status.find('\n', pos);
+    if (end == std::string_view::npos) {
+      end = status.size();
+    }
+    const std::string_view line = status.substr(pos, end - pos);
+    pos = end + 1;
+    const size_t colon = line.find(':');
+    if (colon == std::string_view::npos) {
+      continue;
+    }
+    const std::string_view key = line.substr(0, colon);
+    const std::vector<std::string_view> value = split(line.substr(colon + 1));
+    if (value.size() != 1) {
+      continue;
+    }
+    if (key == "voluntary_ctxt_switches") {
+      parse_number(value.front(), out.voluntary_switches);
+    } else if (key == "nonvoluntary_ctxt_switches") {
+      parse_number(value.front(), out.involuntary_switches);
+    }
+  }
+}
+
+// static function
+bool ThreadSample::parse_schedstat(const std::string_view schedstat, ThreadSample& out) {
+  // `<on cpu ns> <waiting ns> <timeslices>`
+  const std::vector<std::string_view> fields = split(schedstat);
+  uint64_t cpu_time_ns = 0;
+  uint64_t run_delay_ns = 0;
+  if (fields.size() < 2 || !parse_number(fields[0], cpu_time_ns) ||
+      !parse_number(fields[1], run_delay_ns)) {
+    return false;
+  }
+  out.cpu_time_ns = cpu_time_ns;
+  out.run_delay_ns = run_delay_ns;
+  return true;
+}
+
+// static function
+ThreadUsage ThreadUsage::from_samples(const NamedThread& thread,
+                                      const ThreadSample& now,
+                                      const std::optional<ThreadSample>& before,
+                                      const double seconds) {
+  ThreadUsage usage{.name = thread.name, .tid = thread.tid, .total = now};
+  if (!before || seconds <= 0) {
+    return usage;
+  }
+  usage.cpu_pct = rate(now.cpu_time_ns, before->cpu_time_ns, seconds) / 1e7;
+  usage.run_delay_pct = rate(now.run_delay_ns, before->run_delay_ns, seconds) / 1e7;
+  usage.voluntary_per_sec =
+      rate(now.voluntary_switches, before->voluntary_switches, seconds);
+  usage.involuntary_per_sec =
+      rate(now.involuntary_switches, before->involuntary_switches, seconds);
+  usage.minor_faults_per_sec = rate(now.minor_faults, before->minor_faults, seconds);
+  usage.major_faults_per_sec = rate(now.major_faults, before->major_faults, seconds);
+  return usage;
+}
+
+std::string ThreadUsage::format_metrics() const {
+  return std::format(
+      "thread={} tid={} last_cpu={} cpu_pct={:.1f} run_delay_pct={:.1f} cpu_time_ms={} "
+      "voluntary_switches={} involuntary_switches={} involuntary_per_sec={:.1f} "
+      "minor_faults={} major_faults={} major_faults_per_sec={:.1f}",
+      name, tid, total.last_cpu, cpu_pct, run_delay_pct, total.cpu_time_ns / 1'000'000,
+      total.voluntary_switches, total.involuntary_switches, involuntary_per_sec,
+      total.minor_faults, total.major_faults, major_faults_per_sec);
+}
+
+ThreadTelemetry::ThreadTelemetry(const std::chrono::milliseconds interval,
+                                 std::filesystem::path tasks)
+    : interval_(interval), tasks_(std::move(tasks)), ns_per_tick_(get_ns_per_tick()) {
+  if (interval_.count() <= 0) {
+    throw std::runtime_error(std::format(
+        "thread telemetry interval must be positive. value [{}]", interval_.count()));
+  }
+}
+
+ThreadTelemetry::~ThreadTelemetry() {
+  stop();
+}
+
+// static function
+std::unique_ptr<ThreadTelemetry> ThreadTelemetry::from_env() {
+  std::chrono::milliseconds interval = DEFAULT_INTERVAL;
+  if (const char* val = std::getenv("THREAD_TELEMETRY_INTERVAL_MS")) {
+    const std::string_view str{val};
+    int64_t ms = 0;
+    if (!parse_number(str, ms) || ms < 0) {
+      throw std::runtime_error(
+          std::format("could not parse thread telemetry interval, value [{}]", str));
+    }
+    interval = std::chrono::milliseconds(ms);
+  }
+  spdlog::info("fetched envar. key [THREAD_TELEMETRY_INTERVAL_MS], value [{}]",
+               interval.count());
+  if (interval.count() == 0) {
+    return nullptr;
+  }
+#if !defined(__linux__)
+  spdlog::warn("thread telemetry reads linux's /proc, threads are not sampled");
+  return nullptr;
+#else
+  return std::make_unique<ThreadTelemetry>(interval);
+#endif
+}
+
+void ThreadTelemetry::start() {
+  stop();
+  stop_ = std::stop_source{};
+  spdlog::info("starting thread telemetry on the background loop, interval [{}ms]",
+               interval_.count());
+  sampler_ = RunLoop::background().spawn(run(stop_.get_token()));
+}
+
+void ThreadTelemetry::stop() {
+  stop_.request_stop();
+  sampler_.wait();
+}
+
+// background loop
+Task ThreadTelemetry::run(const std::stop_token stoken) {
+  try {
+    for (;;) {
+      for (const uint64_t tid :
+           sample(Threading::get_named_threads(), std::chrono::steady_clock::now())) {
+        Threading::forget_thread(tid);
+      }
+      const bool is_running = co_await RunLoop::sleep_for(interval_, stoken);
+      if (!is_running) {
+        break;
+      }
+    }
+    spdlog::info("closing thread telemetry");
+  } catch (const std::exception& e) {
+    spdlog::error("thread telemetry stopped. error [{}]", e.what());
+  }
+}
+
+std::vector<uint64_t> ThreadTelemetry::sample(
+    const std::span<const NamedThread> threads,
+    const std::chrono::steady_clock::time_point now) {
+  const double seconds =
+      last_time_ == std::chrono::steady_clock::time_point{}
+          ? 0.0
+          : std::chrono::duration<double>(now - last_time_).count();
+  std::vector<ThreadUsage> usage;
+  std::vector<uint64_t> gone;
+  std::map<uint64_t, ThreadSample> samples;
+  for (const NamedThread& thread : threads) {
+    const std::optional<ThreadSample> sample = read_sample(thread.tid);
+    if (!sample) {
+      gone.push_back(thread.tid);
+      continue;
+    }
+    const auto before = last_samples_.find(thread.tid);
+    usage.push_back(ThreadUsage::from_samples(
+        thread, *sample,
+        before == last_samples_.end() ? std::nullopt : std::optional(before->second),
+        seconds));
+    samples.emplace(thread.tid, *sample);
+  }
+  last_samples_ = std::move(samples);
+  last_time_ = now;
+  {
+    std::lock_guard lock(mutex_);
+    usage_ = std::move(usage);
+  }
+  version_.fetch_add(1, std::memory_order_release);
+  return gone;
+}
+
+std::optional<ThreadSample> ThreadTelemetry::read_sample(const uint64_t tid) const {
+  const std::filesystem::path dir = tasks_ / std::to_string(tid);
+  const std::optional<std::string> stat = read_file(dir / "stat");
+  ThreadSample sample;
+  if (!stat || !ThreadSample::parse_stat(*stat, ns_per_tick_, sample)) {
+    return std::nullopt;
+  }
+  if (const std::optional<std::string> status = read_file(dir / "status")) {
+    ThreadSample::parse_status(*status, sample);
+  }
+  // finer cpu time than the clock ticks of `stat`, if the kernel keeps it
+  if (const std::optional<std::string> schedstat = read_file(dir / "schedstat")) {
+    ThreadSample::parse_schedstat(*schedstat, sample);
+  }
+  return sample;
+}
+
+std::vector<ThreadUsage> ThreadTelemetry::get_usage() const {
+  std::lock_guard lock(mutex_);
+  return usage_;
+}
+
+}  // namespace utils
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "run_loop.h"
+#include "threading.h"
+
+namespace utils {
+
+/// @brief a thread's counters since it started, as the kernel keeps them
+struct ThreadSample {
+  /// @brief time on a cpu, user and system
+  uint64_t cpu_time_ns = 0;
+  /// @brief time runnable but waiting for a cpu. 0 without `schedstat`
+  uint64_t run_delay_ns = 0;
+  /// @brief gave up the cpu: blocked, slept
+  uint64_t voluntary_switches = 0;
+  /// @brief had the cpu taken away: preempted
+  uint64_t involuntary_switches = 0;
+  uint64_t minor_faults = 0;
+  /// @brief faults that needed I/O
+  uint64_t major_faults = 0;
+  /// @brief the cpu it last ran on
+  int last_cpu = -1;
+
+  bool operator==(const ThreadSample&) const = default;
+
+  /// @brief parse `/proc/<pid>/task/<tid>/stat`: faults, cpu time in clock ticks, and
+  /// the last cpu
+  /// @return false if malformed
+  static bool parse_stat(std::string_view stat, uint64_t ns_per_tick, ThreadSample& out);
+  /// @brief parse `/proc/<pid>/task/<tid>/status`: the context switches
+  static void parse_status(std::string_view status, ThreadSample& out);
+  /// @brief parse `/proc/<pid>/task/<tid>/schedstat`: cpu time and run delay, in ns
+  /// @return false if malformed
+  static bool parse_schedstat(std::string_view schedstat, ThreadSample& out);
+};
+
+/// @brief a named thread's usage: totals, and rates over the last sampling interval
+struct ThreadUsage {
+  std::string name;
+  uint64_t tid = 0;
+  ThreadSample total;
+  /// @brief of one cpu, e.g. 100 for a spinning thread
+  double cpu_pct = 0;
+  double run_delay_pct = 0;
+  double voluntary_per_sec = 0;
+  double involuntary_per_sec = 0;
+  double minor_faults_per_sec = 0;
+  double major_faults_per_sec = 0;
+
+  /// @param before the previous sample, nullopt for the first
+  static ThreadUsage from_samples(const NamedThread& thread,
+                                  const ThreadSample& now,
+                                  const std::optional<ThreadSample>& before,
+                                  double seconds);
+  /// @brief a logfmt line, e.g. for `engine::Headless`'s output
+  std::string format_metrics() const;
+};
+
+/// @brief Samples each named thread's resource usage at a low frequency, from
+/// `/proc/self/task/<tid>/{stat,status,schedstat}`: cpu time, context switches,
+/// faults and the last cpu, so that a hot thread being preempted or faulting shows at
+/// runtime, in the UI and the metrics. The threads are those of the registry
+/// ( @ref utils::Threading::get_named_threads ), those that exited are dropped from it.
+/// Samples on the background loop ( @ref utils::RunLoop::background ). Linux only.
+class ThreadTelemetry {
+ public:
+  static inline constexpr std::chrono::milliseconds DEFAULT_INTERVAL{1'000};
+  static inline constexpr std::string_view PROC_TASKS = "/proc/self/task";
+
+  /// @param tasks a root other than `/proc/self/task` is for tests
+  explicit ThreadTelemetry(std::chrono::milliseconds interval,
+                           std::filesystem::path tasks = PROC_TASKS);
+  ~ThreadTelemetry();
+
+  ThreadTelemetry(const ThreadTelemetry&) = delete;
+  ThreadTelemetry& operator=(const ThreadTelemetry&) = delete;
+
+  /// @brief read `THREAD_TELEMETRY_INTERVAL_MS` (optional, 0 for off)
+  /// @return nullptr if off, or not on Linux
+  static std::unique_ptr<ThreadTelemetry> from_env();
+
+  void start();
+  /// @brief stop and wait for the sampler
+  void stop();
+
+  /// @brief read every thread's counters and publish their usage. the sampler's work,
+  /// callable directly when not started
+  /// @return the threads that could not be read, e.g. as they exited
+  std::vector<uint64_t> sample(std::span<const NamedThread> threads,
+                               std::chrono::steady_clock::time_point now);
+  /// @return nullopt if the thread cannot be read
+  std::optional<ThreadSample> read_sample(uint64_t tid) const;
+
+  /// @brief the last sample's usage, in the order the threads were named. any thread
+  std::vector<ThreadUsage> get_usage() const;
+  /// @brief bumped on every sample. any thread
+  uint64_t get_version() const { return version_.load(std::memory_order_acquire); }
+
+ private:
+  const std::chrono::milliseconds interval_;
+  const std::filesystem::path tasks_;
+  const uint64_t ns_per_tick_;
+
+  // sampler state
+  std::map<uint64_t, ThreadSample> last_samples_;
+  std::chrono::steady_clock::time_point last_time_{};
+
+  mutable std::mutex mutex_;
+  std::vector<ThreadUsage> usage_;
+  std::atomic<uint64_t> version_{0};
+
+  std::stop_source stop_;
+  TaskHandle sampler_;
+
+  Task run(std::stop_token stoken);
+};
+
+}  // namespace utils
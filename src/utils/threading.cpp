@@ -2,13 +2,18 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include <format>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <system_error>
 #include <thread>
+#include <vector>
 
 #include "spdlog/spdlog.h"
 
@@ -35,15 +40,35 @@
 
 namespace utils {
 
+namespace {
+
+/// @brief the registry of named threads
+std::mutex named_threads_mutex;
+std::vector<NamedThread> named_threads;
+
+void register_thread(std::string name, const uint64_t tid) {
+  std::lock_guard lock(named_threads_mutex);
+  const auto it = std::ranges::find(named_threads, tid, &NamedThread::tid);
+  if (it != named_threads.end()) {
+    it->name = std::move(name);
+    return;
+  }
+  named_threads.push_back(NamedThread{.name = std::move(name), .tid = tid});
+}
+
+}  // namespace
+
 // static function
 void Threading::set_thread_name(const std::string& name) {
 #if defined(__linux__)
   // linux: limit is 16 bytes including null terminator
   pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+  register_thread(name.substr(0, 15), get_os_thread_id());
 
 #elif defined(__APPLE__)
   // macos: only supports setting name from within the thread
   pthread_setname_np(name.substr(0, 63).c_str());  // 64 bytes max including null
+  register_thread(name.substr(0, 63), get_os_thread_id());
 
 #elif defined(_WIN32)
   // windows 10 (1607 and later)
@@ -59,9 +84,23 @@ void Threading::set_thread_name(const std::string& name) {
       // optional: handle error (e.g., log or assert)
     }
   }
+  register_thread(name, get_os_thread_id());
 #endif
 }
 
+// static function
+std::vector<NamedThread> Threading::get_named_threads() {
+  std::lock_guard lock(named_threads_mutex);
+  return named_threads;
+}
+
+// static function
+void Threading::forget_thread(const uint64_t tid) {
+  std::lock_guard lock(named_threads_mutex);
+  std::erase_if(named_threads,
+                [tid](const NamedThread& thread) { return thread.tid == tid; });
+}
+
 // static function
 std::string Threading::get_thread_name() {
 #if defined(__linux__)
@@ -154,6 +193,59 @@ void Threading::set_thread_cpu(unsigned int cpu_id) {
 #endif
 }
 
+// static function
+void Threading::set_thread_cpus(const std::span<const unsigned int> cpu_ids) {
+  if (cpu_ids.empty()) {
+    throw std::runtime_error("cannot set thread affinity to no cpus");
+  }
+#if defined(__linux__)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  std::string cpus;
+  for (const unsigned int cpu_id : cpu_ids) {
+    if (cpu_id >= CPU_SETSIZE) {
+      throw std::runtime_error(
+          std::format("cpu_id exceeds cpu_set_t, cpu_id [{}]", cpu_id));
+    }
+    CPU_SET(cpu_id, &cpuset);
+    cpus += std::format("{}{}", cpus.empty() ? "" : ",", cpu_id);
+  }
+  int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+  if (rc != 0) {
+    throw std::runtime_error(
+        std::format("linux: failed to set thread affinity. error [{}]",
+                    std::system_category().message(rc)));
+  }
+  spdlog::info("linux: successfully set thread affinity. thread_name [{}] cpus [{}]",
+               get_thread_name(), cpus);
+#else
+  set_thread_cpu(cpu_ids.front());
+#endif
+}
+
+// static function
+std::vector<unsigned int> Threading::get_allowed_cpus() {
+  std::vector<unsigned int> cpus;
+#if defined(__linux__)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0) {
+    for (unsigned int cpu_id = 0; cpu_id < CPU_SETSIZE; ++cpu_id) {
+      if (CPU_ISSET(cpu_id, &cpuset)) {
+        cpus.push_back(cpu_id);
+      }
+    }
+    return cpus;
+  }
+  spdlog::error("linux: failed to get process affinity, assuming every cpu. error [{}]",
+                std::strerror(errno));
+#endif
+  for (unsigned int cpu_id = 0; cpu_id < get_cpu_count(); ++cpu_id) {
+    cpus.push_back(cpu_id);
+  }
+  return cpus;
+}
+
 // static function
 void Threading::set_native_thread_affinity(std::thread::native_handle_type handle,
                                            unsigned int cpu_id) {
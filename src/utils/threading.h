@@ -1,10 +1,22 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace utils {
 
+/// @brief a thread named with @ref utils::Threading::set_thread_name
+struct NamedThread {
+  std::string name;
+  /// @brief @ref utils::Threading::get_os_thread_id
+  uint64_t tid = 0;
+
+  bool operator==(const NamedThread&) const = default;
+};
+
 /// @brief thread helper functions
 class Threading {
  public:
@@ -17,9 +29,18 @@ class Threading {
   /// - Linux: 15 characters + null terminator
   /// - macOS: 63 characters + null terminator
   /// - Windows: UTF-16 string, shown in debuggers that support `SetThreadDescription`.
+  /// The thread is also recorded in the process's registry of named threads, for
+  /// @ref utils::ThreadTelemetry .
   /// @param name Name to assign to the current thread.
   static void set_thread_name(const std::string& name);
 
+  /// @brief the threads named so far, in the order they were named. a thread named
+  /// twice is listed once, under its last name. threads that exited are listed until
+  /// forgotten
+  static std::vector<NamedThread> get_named_threads();
+  /// @brief drop a thread from the registry, e.g. once it has exited
+  static void forget_thread(uint64_t tid);
+
   /// @brief Returns the operating system thread ID for the current thread.
   /// This ID matches what is shown in system tools like `htop` (Linux),
   /// Activity Monitor (macOS), or Task Manager (Windows), and what `spdlog` uses
@@ -52,6 +73,18 @@ class Threading {
   ///               Valid range is `[0, get_cpu_count() - 1]`.
   static void set_thread_cpu(unsigned int cpu_id);
 
+  /// @brief Sets the CPU affinity of the calling thread to a set of logical CPUs, any of
+  /// which the scheduler may run it on. Linux only, elsewhere the thread is pinned to
+  /// the first CPU of the set ( @ref set_thread_cpu ).
+  /// @param cpu_ids zero-based logical CPUs, at least one
+  static void set_thread_cpus(std::span<const unsigned int> cpu_ids);
+
+  /// @brief The logical CPUs the process may run on: its affinity mask, as narrowed by
+  /// a cpuset (e.g. `scripts/pin_cpus.sh`) or `taskset`. Linux only, elsewhere every
+  /// CPU ( @ref get_cpu_count ).
+  /// @return sorted CPU ids
+  static std::vector<unsigned int> get_allowed_cpus();
+
   /// @brief Elevates the current thread to real-time priority.
   /// Attempts to set the calling thread to the highest real-time priority:
   /// - On Windows: uses `SetThreadPriority()` with `THREAD_PRIORITY_TIME_CRITICAL`.
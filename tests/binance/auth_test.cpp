@@ -60,3 +60,48 @@ TEST(AuthTest, GetSeedFromPem_InvalidKey_Throws) {
 
   EXPECT_THROW(auth.get_seed_from_pem(), std::runtime_error);
 }
+
+TEST(AuthTest, SignPayload_CachedKey_MatchesSeedSignature) {
+  std::string api_key = "dummy";
+  std::filesystem::path pem_path =
+      path_.parent_path() / "test_resources" / "valid_key.pem";
+  std::string pem_path_str = pem_path.string();
+  const std::string payload =
+      "A\x01SENDER\x01SPOT\x01"
+      "1\x01"
+      "20250915-03:27:02.028992";
+
+  binance::Auth auth(api_key, pem_path_str);
+  const std::string expected =
+      binance::Auth::sign_payload(payload, auth.get_seed_from_pem());
+
+  // first call loads the key, second call signs from the cache
+  EXPECT_EQ(auth.sign_payload(payload), expected);
+  EXPECT_EQ(auth.sign_payload(payload), expected);
+}
+
+TEST(AuthTest, LoadKeys_InvalidKey_Throws) {
+  std::string api_key = "dummy";
+  std::filesystem::path pem_path =
+      path_.parent_path() / "test_resources" / "invalid_key.pem";
+  std::string pem_path_str = pem_path.string();
+
+  binance::Auth auth(api_key, pem_path_str);
+
+  EXPECT_THROW(auth.load_keys(), std::runtime_error);
+}
+
+TEST(AuthTest, SignPayload_AfterClearKeys_Throws) {
+  std::string api_key = "dummy";
+  std::filesystem::path pem_path =
+      path_.parent_path() / "test_resources" / "valid_key.pem";
+  std::string pem_path_str = pem_path.string();
+
+  binance::Auth auth(api_key, pem_path_str);
+  auth.load_keys();
+  auth.clear_keys();
+
+  // the cached key is gone, and so is the path to reload it from
+  EXPECT_TRUE(api_key.empty());
+  EXPECT_THROW(auth.sign_payload("payload"), std::runtime_error);
+}
@@ -24,6 +24,8 @@ TEST(ConfigTest, FromEnv) {
   EXPECT_EQ(cfg.symbols, expectedSymbols);
   EXPECT_EQ(cfg.px_cpu, 0);
   EXPECT_EQ(cfg.tx_cpu, 1);
+  EXPECT_FALSE(cfg.is_dual_depth);
+  EXPECT_EQ(cfg.book_max_levels, Config::MAX_DEPTH);
 }
 
 TEST(ConfigTest, ThrowsOnMissingEnv) {
@@ -60,3 +62,31 @@ TEST(ConfigTest, HandlesTrailingComma) {
   std::vector<std::string> expected = {"BTCUSDT"};
   EXPECT_EQ(cfg.symbols, expected);
 }
+
+TEST(ConfigTest, DualDepth) {
+  setenv("API_KEY", "key", 1);
+  setenv("PRIVATE_KEY_PATH", "keypath", 1);
+  setenv("FIX_CONFIG_PATH", "fix", 1);
+  setenv("SYMBOLS", "BTCUSDT", 1);
+  setenv("PX_SESSION_CPU", "0", 1);
+  setenv("TX_SESSION_CPU", "1", 1);
+  setenv("PX_DUAL_DEPTH", "true", 1);
+
+  EXPECT_EQ(Config::from_env().is_dual_depth, Config::MAX_DEPTH > 1);
+  unsetenv("PX_DUAL_DEPTH");
+}
+
+TEST(ConfigTest, BookMaxLevels) {
+  setenv("API_KEY", "key", 1);
+  setenv("PRIVATE_KEY_PATH", "keypath", 1);
+  setenv("FIX_CONFIG_PATH", "fix", 1);
+  setenv("SYMBOLS", "BTCUSDT", 1);
+  setenv("PX_SESSION_CPU", "0", 1);
+  setenv("TX_SESSION_CPU", "1", 1);
+
+  setenv("BOOK_MAX_LEVELS", "0", 1);
+  EXPECT_EQ(Config::from_env().book_max_levels, 0u);
+  setenv("BOOK_MAX_LEVELS", "50x", 1);
+  EXPECT_THROW(Config::from_env(), std::runtime_error);
+  unsetenv("BOOK_MAX_LEVELS");
+}
@@ -0,0 +1,271 @@
+#include "binance/feed_arbiter.h"
+
+#include <gtest/gtest.h>
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "binance/market_message_variant.h"
+#include "concurrentqueue.h"
+
+using binance::FeedArbiter;
+using binance::FeedSource;
+
+namespace {
+
+FIX44::MarketDataIncrementalRefresh make_increment(const uint64_t first,
+                                                   const uint64_t last) {
+  FIX44::MarketDataIncrementalRefresh msg;
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries group;
+  group.set(FIX::Symbol("BTCUSDT"));
+  group.set(FIX::MDUpdateAction(FIX::MDUpdateAction_NEW));
+  group.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+  group.set(FIX::MDEntryPx(95));
+  group.set(FIX::MDEntrySize(10));
+  group.setField(FeedArbiter::FIRST_BOOK_UPDATE_ID_TAG, std::to_string(first));
+  group.setField(FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, std::to_string(last));
+  msg.addGroup(group);
+  return msg;
+}
+
+FIX44::MarketDataSnapshotFullRefresh make_snapshot(const uint64_t last) {
+  FIX44::MarketDataSnapshotFullRefresh msg;
+  msg.set(FIX::Symbol("BTCUSDT"));
+  msg.setField(FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, std::to_string(last));
+  return msg;
+}
+
+/// @brief a depth-1 subscription's increment: the best bid and offer
+FIX44::MarketDataIncrementalRefresh make_top(const uint64_t last,
+                                             const double bid_px,
+                                             const double ask_px) {
+  FIX44::MarketDataIncrementalRefresh msg;
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries bid;
+  bid.set(FIX::Symbol("BTCUSDT"));
+  bid.set(FIX::MDUpdateAction(FIX::MDUpdateAction_NEW));
+  bid.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+  bid.set(FIX::MDEntryPx(bid_px));
+  bid.set(FIX::MDEntrySize(1));
+  bid.setField(FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, std::to_string(last));
+  msg.addGroup(bid);
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries ask;
+  ask.set(FIX::MDUpdateAction(FIX::MDUpdateAction_NEW));
+  ask.set(FIX::MDEntryType(FIX::MDEntryType_OFFER));
+  ask.set(FIX::MDEntryPx(ask_px));
+  ask.set(FIX::MDEntrySize(2));
+  msg.addGroup(ask);
+  return msg;
+}
+
+/// @brief drain the queue, returning the last update id of each message
+std::vector<uint64_t> drain(
+    moodycamel::ConcurrentQueue<binance::MarketMessageVariant>& queue) {
+  std::vector<uint64_t> ids;
+  binance::MarketMessageVariant msg;
+  while (queue.try_dequeue(msg)) {
+    std::visit(
+        [&ids](const auto& m) {
+          const auto update_ids = FeedArbiter::get_update_ids(m);
+          ids.push_back(update_ids ? update_ids->last : 0);
+        },
+        msg);
+  }
+  return ids;
+}
+
+}  // namespace
+
+class FeedArbiterTest : public ::testing::Test {
+ protected:
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> queue_;
+  FeedArbiter arbiter_{queue_};
+
+  void SetUp() override {
+    arbiter_.on_session_created(FeedSource::PRIMARY);
+    arbiter_.on_session_created(FeedSource::STANDBY);
+    arbiter_.on_session_up(FeedSource::PRIMARY);
+    arbiter_.on_session_up(FeedSource::STANDBY);
+  }
+};
+
+TEST_F(FeedArbiterTest, get_update_ids) {
+  const auto inc =
+      FeedArbiter::get_update_ids(make_increment(7'000'000'001, 7'000'000'005));
+  ASSERT_TRUE(inc.has_value());
+  EXPECT_EQ(inc->symbol, binance::SymbolEnum::BTCUSDT);
+  EXPECT_EQ(inc->first, 7'000'000'001u);
+  EXPECT_EQ(inc->last, 7'000'000'005u);
+
+  const auto snap = FeedArbiter::get_update_ids(make_snapshot(42));
+  ASSERT_TRUE(snap.has_value());
+  EXPECT_EQ(snap->last, 42u);
+
+  EXPECT_FALSE(FeedArbiter::get_update_ids(FIX44::MarketDataIncrementalRefresh{}));
+}
+
+TEST_F(FeedArbiterTest, SuppressesDuplicatesFromStandby) {
+  for (uint64_t id = 1; id <= 10; ++id) {
+    EXPECT_TRUE(arbiter_.on_increment(make_increment(id, id), FeedSource::PRIMARY));
+    EXPECT_FALSE(arbiter_.on_increment(make_increment(id, id), FeedSource::STANDBY));
+  }
+
+  const std::vector<uint64_t> expected = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  EXPECT_EQ(drain(queue_), expected);
+  EXPECT_EQ(arbiter_.get_stats().forwarded, 10u);
+  EXPECT_EQ(arbiter_.get_stats().duplicates, 10u);
+}
+
+TEST_F(FeedArbiterTest, ForwardsWhicheverSessionIsFirst) {
+  EXPECT_TRUE(arbiter_.on_increment(make_increment(1, 1), FeedSource::PRIMARY));
+  // standby is ahead for a while
+  EXPECT_TRUE(arbiter_.on_increment(make_increment(2, 2), FeedSource::STANDBY));
+  EXPECT_TRUE(arbiter_.on_increment(make_increment(3, 3), FeedSource::STANDBY));
+  EXPECT_FALSE(arbiter_.on_increment(make_increment(2, 2), FeedSource::PRIMARY));
+  // primary batched differently, partially overlapping - still advances the book
+  EXPECT_TRUE(arbiter_.on_increment(make_increment(3, 5), FeedSource::PRIMARY));
+
+  const std::vector<uint64_t> expected = {1, 2, 3, 5};
+  EXPECT_EQ(drain(queue_), expected);
+  EXPECT_EQ(arbiter_.get_stats().gaps, 0u);
+}
+
+TEST_F(FeedArbiterTest, FailsOverWithoutSnapshotGap) {
+  ASSERT_TRUE(arbiter_.on_snapshot(make_snapshot(100), FeedSource::PRIMARY));
+  ASSERT_FALSE(arbiter_.on_snapshot(make_snapshot(100), FeedSource::STANDBY));
+  for (uint64_t id = 101; id <= 105; ++id) {
+    arbiter_.on_increment(make_increment(id, id), FeedSource::PRIMARY);
+    arbiter_.on_increment(make_increment(id, id), FeedSource::STANDBY);
+  }
+
+  // primary drops, standby carries on without a new snapshot
+  arbiter_.on_session_down(FeedSource::PRIMARY);
+  for (uint64_t id = 106; id <= 110; ++id) {
+    EXPECT_TRUE(arbiter_.on_increment(make_increment(id, id), FeedSource::STANDBY));
+  }
+  // primary reconnects, its fresh snapshot is older than the book - dropped
+  arbiter_.on_session_up(FeedSource::PRIMARY);
+  EXPECT_FALSE(arbiter_.on_snapshot(make_snapshot(108), FeedSource::PRIMARY));
+
+  std::vector<uint64_t> expected = {100};
+  for (uint64_t id = 101; id <= 110; ++id) {
+    expected.push_back(id);
+  }
+  EXPECT_EQ(drain(queue_), expected);
+
+  const FeedArbiter::Stats stats = arbiter_.get_stats();
+  EXPECT_EQ(stats.failovers, 1u);
+  EXPECT_EQ(stats.gaps, 0u);
+  EXPECT_GT(stats.last_failover_time.count(), 0);
+}
+
+TEST(FeedArbiter, PrimaryAloneIsQueuedAsItComes) {
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> queue;
+  FeedArbiter arbiter(queue);
+  arbiter.on_session_created(FeedSource::PRIMARY);
+  arbiter.on_session_up(FeedSource::PRIMARY);
+  // nothing read, nothing dropped
+  EXPECT_TRUE(arbiter.on_snapshot(make_snapshot(5), FeedSource::PRIMARY));
+  EXPECT_TRUE(arbiter.on_increment(make_increment(2, 2), FeedSource::PRIMARY));
+  EXPECT_TRUE(arbiter.on_increment(make_increment(2, 2), FeedSource::PRIMARY));
+  EXPECT_EQ(drain(queue), (std::vector<uint64_t>{5, 2, 2}));
+  EXPECT_EQ(arbiter.get_stats().forwarded, 0u);
+
+  // a depth-1 stream alongside: arbitrated, the top is placed against the deep ids
+  FeedArbiter dual(queue, true);
+  EXPECT_TRUE(dual.on_increment(make_increment(1, 5), FeedSource::PRIMARY));
+  EXPECT_FALSE(dual.on_increment(make_increment(1, 5), FeedSource::PRIMARY));
+  EXPECT_FALSE(dual.on_top(make_top(5, 95, 96), FeedSource::PRIMARY));
+  EXPECT_EQ(dual.get_stats().duplicates, 1u);
+}
+
+TEST_F(FeedArbiterTest, StandbyDownIsNoFailover) {
+  ASSERT_TRUE(arbiter_.on_increment(make_increment(1, 1), FeedSource::PRIMARY));
+  arbiter_.on_session_down(FeedSource::STANDBY);
+  for (uint64_t id = 2; id <= 5; ++id) {
+    EXPECT_TRUE(arbiter_.on_increment(make_increment(id, id), FeedSource::PRIMARY));
+  }
+  // the standby comes back and drops again, the primary never stops feeding
+  arbiter_.on_session_up(FeedSource::STANDBY);
+  arbiter_.on_session_down(FeedSource::STANDBY);
+  EXPECT_TRUE(arbiter_.on_increment(make_increment(6, 6), FeedSource::PRIMARY));
+
+  const FeedArbiter::Stats stats = arbiter_.get_stats();
+  EXPECT_EQ(stats.failovers, 0u);
+  EXPECT_EQ(stats.last_failover_time.count(), 0);
+  EXPECT_EQ(stats.forwarded, 6u);
+}
+
+TEST_F(FeedArbiterTest, NewerSnapshotReplacesBook) {
+  ASSERT_TRUE(arbiter_.on_increment(make_increment(1, 1), FeedSource::PRIMARY));
+  EXPECT_TRUE(arbiter_.on_snapshot(make_snapshot(50), FeedSource::STANDBY));
+  EXPECT_FALSE(arbiter_.on_increment(make_increment(2, 2), FeedSource::PRIMARY));
+  EXPECT_TRUE(arbiter_.on_increment(make_increment(51, 51), FeedSource::PRIMARY));
+  EXPECT_EQ(arbiter_.get_stats().gaps, 0u);
+}
+
+TEST_F(FeedArbiterTest, CountsGaps) {
+  arbiter_.on_increment(make_increment(1, 1), FeedSource::PRIMARY);
+  EXPECT_TRUE(arbiter_.on_increment(make_increment(5, 6), FeedSource::PRIMARY));
+  EXPECT_EQ(arbiter_.get_stats().gaps, 1u);
+}
+
+TEST_F(FeedArbiterTest, MessagesWithoutIdsOnlyFromPrimaryWhileUp) {
+  FIX44::MarketDataIncrementalRefresh no_ids;
+  EXPECT_TRUE(arbiter_.on_increment(no_ids, FeedSource::PRIMARY));
+  EXPECT_FALSE(arbiter_.on_increment(no_ids, FeedSource::STANDBY));
+  arbiter_.on_session_down(FeedSource::PRIMARY);
+  EXPECT_TRUE(arbiter_.on_increment(no_ids, FeedSource::STANDBY));
+}
+
+TEST_F(FeedArbiterTest, get_top) {
+  // production tick sizes
+  const std::optional<binance::TopOfBook> top =
+      FeedArbiter::get_top(make_top(42, 95, 96));
+  ASSERT_TRUE(top.has_value());
+  const binance::TopOfBook expected{.last_update_id = 42,
+                                    .bid = binance::TopOfBook::Level{9'500, 100'000},
+                                    .ask = binance::TopOfBook::Level{9'600, 200'000}};
+  EXPECT_EQ(*top, expected);
+  EXPECT_FALSE(FeedArbiter::get_top(FIX44::MarketDataIncrementalRefresh{}));
+}
+
+TEST_F(FeedArbiterTest, get_top_DeleteOnly) {
+  // the side's one entry: the delete stands
+  FIX44::MarketDataIncrementalRefresh msg;
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries bid;
+  bid.set(FIX::Symbol("BTCUSDT"));
+  bid.set(FIX::MDUpdateAction(FIX::MDUpdateAction_DELETE));
+  bid.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+  bid.set(FIX::MDEntryPx(95));
+  bid.setField(FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, "42");
+  msg.addGroup(bid);
+  const std::optional<binance::TopOfBook> top = FeedArbiter::get_top(msg);
+  ASSERT_TRUE(top.has_value());
+  EXPECT_EQ(top->bid, (binance::TopOfBook::Level{9'500, 0}));
+  EXPECT_FALSE(top->ask);
+}
+
+TEST_F(FeedArbiterTest, ForwardsTheTopAheadOfTheDeepStream) {
+  ASSERT_TRUE(arbiter_.on_increment(make_increment(1, 5), FeedSource::PRIMARY));
+  // the depth-1 stream is ahead
+  EXPECT_TRUE(arbiter_.on_top(make_top(7, 95, 96), FeedSource::PRIMARY));
+  EXPECT_FALSE(arbiter_.on_top(make_top(7, 95, 96), FeedSource::STANDBY));
+  EXPECT_FALSE(arbiter_.on_top(make_top(6, 95, 96), FeedSource::PRIMARY));
+  // the deep stream is not held back by it, and then gets there first
+  EXPECT_TRUE(arbiter_.on_increment(make_increment(6, 8), FeedSource::PRIMARY));
+  EXPECT_FALSE(arbiter_.on_top(make_top(8, 95, 96), FeedSource::PRIMARY));
+  EXPECT_TRUE(arbiter_.on_top(make_top(9, 95, 96), FeedSource::PRIMARY));
+
+  const std::vector<uint64_t> expected = {5, 7, 8, 9};
+  EXPECT_EQ(drain(queue_), expected);
+  const FeedArbiter::Stats stats = arbiter_.get_stats();
+  EXPECT_EQ(stats.top_forwarded, 2u);
+  EXPECT_EQ(stats.top_behind, 1u);
+  EXPECT_EQ(stats.duplicates, 2u);
+  EXPECT_EQ(stats.gaps, 0u);
+}
@@ -0,0 +1,192 @@
+#include "core/bbo_book.h"
+
+#include <gtest/gtest.h>
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "binance/feed_arbiter.h"
+#include "binance/testing.h"
+#include "binance/top_of_book.h"
+#include "core/bid_ask.h"
+#include "core/order_book.h"
+
+using binance::Testing;
+using core::BidAsk;
+
+namespace {
+
+/// @brief a depth-1 increment moving the best bid from 95 to 95.5: the new best and
+/// the delete of the old one, in either order
+FIX44::MarketDataIncrementalRefresh make_new_best_bid(const bool is_delete_first,
+                                                      const uint64_t last) {
+  std::array entries = {
+      Testing::make_increment(FIX::MDUpdateAction_NEW, FIX::MDEntryType_BID, 95.5, 1),
+      Testing::make_increment(FIX::MDUpdateAction_DELETE, FIX::MDEntryType_BID, 95, 0)};
+  if (is_delete_first) {
+    std::swap(entries[0], entries[1]);
+  }
+  FIX44::MarketDataIncrementalRefresh msg;
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries group;
+  for (const FIX44::MarketDataIncrementalRefresh& entry : entries) {
+    entry.getGroup(1, group);
+    group.setField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, std::to_string(last));
+    msg.addGroup(group);
+  }
+  return msg;
+}
+
+}  // namespace
+
+TEST(BboBook, BookFor) {
+  static_assert(std::is_same_v<core::BookFor<1>, core::BboBook>);
+  static_assert(std::is_same_v<core::BookFor<100>, core::OrderBook>);
+}
+
+TEST(BboBook, apply_snapshot) {
+  // production tick sizes (thus lots of zeroes below)
+  FIX44::MarketDataSnapshotFullRefresh msg;
+  for (const auto& [type, px, sz] : {std::tuple{FIX::MDEntryType_BID, 94.0, 9.0},
+                                     std::tuple{FIX::MDEntryType_BID, 95.0, 10.0},
+                                     std::tuple{FIX::MDEntryType_OFFER, 97.0, 12.0},
+                                     std::tuple{FIX::MDEntryType_OFFER, 96.0, 11.0}}) {
+    FIX44::MarketDataSnapshotFullRefresh::NoMDEntries level;
+    level.set(FIX::MDEntryType(type));
+    level.set(FIX::MDEntryPx(px));
+    level.set(FIX::MDEntrySize(sz));
+    msg.addGroup(level);
+  }
+  msg.set(FIX::Symbol("BTCUSDT"));
+  msg.setField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, "50");
+
+  core::BboBook book = core::BboBook::from_levels({}, {}, 0);
+  EXPECT_TRUE(book.is_provisional());
+  book.apply_snapshot(msg);
+
+  // the best of each side, whatever the order
+  const std::vector check = {BidAsk(1'000'000, 9'500, 9'600, 1'100'000)};
+  EXPECT_EQ(book.to_vector(), check);
+  EXPECT_EQ(book.get_last_update_id(), 50u);
+  EXPECT_FALSE(book.is_provisional());
+}
+
+TEST(BboBook, apply_increment) {
+  // the same depth-1 stream through the full book, clearing on changes: the same touch
+  core::BboBook bbo;
+  core::OrderBook book;
+  const std::array stream = {
+      Testing::make_increment(FIX::MDUpdateAction_NEW, FIX::MDEntryType_BID, 95, 1),
+      Testing::make_increment(FIX::MDUpdateAction_NEW, FIX::MDEntryType_OFFER, 97, 2),
+      Testing::make_increment(FIX::MDUpdateAction_CHANGE, FIX::MDEntryType_BID, 96, 3),
+      // a better level, then the old one goes
+      Testing::make_increment(FIX::MDUpdateAction_NEW, FIX::MDEntryType_OFFER, 96.5, 4),
+      Testing::make_increment(FIX::MDUpdateAction_DELETE, FIX::MDEntryType_OFFER, 97, 0),
+      Testing::make_increment(FIX::MDUpdateAction_CHANGE, FIX::MDEntryType_BID, 96, 5),
+  };
+  for (const FIX44::MarketDataIncrementalRefresh& msg : stream) {
+    bbo.apply_increment(msg);
+    book.apply_increment(msg, true);
+    ASSERT_EQ(bbo.to_vector().size(), 1u);
+    EXPECT_EQ(bbo.to_vector().front(), book.to_vector().front());
+  }
+  EXPECT_EQ(bbo.get_bbo().sequence, stream.size());
+
+  // the top goes, the side is empty
+  bbo.apply_increment(
+      Testing::make_increment(FIX::MDUpdateAction_DELETE, FIX::MDEntryType_BID, 96, 0));
+  const std::vector check = {
+      BidAsk(BidAsk::SENTINEL_, BidAsk::SENTINEL_, 9'650, 400'000)};
+  EXPECT_EQ(bbo.to_vector(), check);
+  bbo.apply_increment(
+      Testing::make_increment(FIX::MDUpdateAction_DELETE, FIX::MDEntryType_OFFER, 96.5,
+                              0));
+  EXPECT_TRUE(bbo.to_vector().empty());
+}
+
+TEST(BboBook, apply_top) {
+  using binance::TopOfBook;
+  core::BboBook bbo = core::BboBook::from_levels(
+      std::array{core::PriceLevel{9'500, 10}}, std::array{core::PriceLevel{9'600, 11}},
+      10);
+  // the sides it carries, if newer
+  bbo.apply_top(TopOfBook{.last_update_id = 11, .bid = TopOfBook::Level{9'550, 3}});
+  bbo.apply_top(TopOfBook{.last_update_id = 11, .ask = TopOfBook::Level{9'560, 1}});
+  const std::vector check = {BidAsk(3, 9'550, 9'600, 11)};
+  EXPECT_EQ(bbo.to_vector(), check);
+  EXPECT_EQ(bbo.get_last_update_id(), 11u);
+}
+
+TEST(BboBook, apply_top_NewBestAndDelete) {
+  // the same through both books: the new best stays, whichever entry comes first
+  for (const bool is_delete_first : {false, true}) {
+    const std::optional<binance::TopOfBook> top =
+        binance::FeedArbiter::get_top(make_new_best_bid(is_delete_first, 11));
+    ASSERT_TRUE(top.has_value());
+    EXPECT_EQ(top->bid, (binance::TopOfBook::Level{9'550, 100'000}));
+
+    core::BboBook bbo = core::BboBook::from_levels(
+        std::array{core::PriceLevel{9'500, 10}}, std::array{core::PriceLevel{9'600, 11}},
+        10);
+    core::OrderBook book = core::OrderBook::from_levels(
+        std::array{core::PriceLevel{9'500, 10}, core::PriceLevel{9'400, 9}},
+        std::array{core::PriceLevel{9'600, 11}}, 10);
+    bbo.apply_top(*top);
+    book.apply_top(*top);
+    const std::vector check = {BidAsk(100'000, 9'550, 9'600, 11)};
+    EXPECT_EQ(bbo.to_vector(), check);
+    EXPECT_EQ(book.to_vector().front(), check.front());
+  }
+}
+
+TEST(BboBook, apply_top_DeleteOnly) {
+  using binance::TopOfBook;
+  core::BboBook bbo = core::BboBook::from_levels(
+      std::array{core::PriceLevel{9'500, 10}}, std::array{core::PriceLevel{9'600, 11}},
+      10);
+  // of a level already replaced: kept
+  bbo.apply_top(TopOfBook{.last_update_id = 11, .bid = TopOfBook::Level{9'400, 0}});
+  EXPECT_EQ(bbo.to_vector(), std::vector{BidAsk(10, 9'500, 9'600, 11)});
+  // of the side's: emptied
+  bbo.apply_top(TopOfBook{.last_update_id = 12, .bid = TopOfBook::Level{9'500, 0}});
+  const std::vector check = {
+      BidAsk(BidAsk::SENTINEL_, BidAsk::SENTINEL_, 9'600, 11)};
+  EXPECT_EQ(bbo.to_vector(), check);
+}
+
+TEST(BboBook, checkpoint_levels) {
+  const std::array bids = {core::PriceLevel{95, 10}, core::PriceLevel{94, 9}};
+  const std::array<core::PriceLevel, 0> asks{};
+  const core::BboBook book = core::BboBook::from_levels(bids, asks, 41);
+  EXPECT_TRUE(book.is_provisional());
+
+  std::array<core::PriceLevel, 4> top_bids{};
+  std::array<core::PriceLevel, 4> top_asks{};
+  const core::OrderBook::LevelCounts counts = book.copy_levels(top_bids, top_asks);
+  EXPECT_EQ(counts.bids, 1u);
+  EXPECT_EQ(counts.asks, 0u);
+  EXPECT_EQ(counts.last_update_id, 41u);
+  EXPECT_EQ(top_bids[0], (core::PriceLevel{95, 10}));
+}
+
+TEST(BboBook, get_analytics) {
+  const core::BboBook bbo = core::BboBook::from_levels(
+      std::array{core::PriceLevel{9'500, 300'000}},
+      std::array{core::PriceLevel{9'600, 100'000}}, 0);
+  const core::BookAnalytics analytics = bbo.get_analytics();
+
+  // as the full book's from the same touch
+  core::BookAnalytics check = core::BookAnalytics::compute(
+      {BidAsk(300'000, 9'500, 9'600, 100'000)}, core::BookAnalyticsConfig{});
+  check.sequence = analytics.sequence;
+  EXPECT_EQ(analytics, check);
+  EXPECT_TRUE(analytics.is_two_sided);
+  EXPECT_EQ(analytics.spread, 100u);
+}
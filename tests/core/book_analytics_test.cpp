@@ -0,0 +1,126 @@
+#include "core/book_analytics.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "core/bid_ask.h"
+
+using core::BidAsk;
+using core::BookAnalytics;
+using core::BookAnalyticsConfig;
+using core::BookAnalyzer;
+
+namespace {
+
+using BidMap = absl::btree_map<uint64_t, uint64_t, std::greater<>>;
+using AskMap = absl::btree_map<uint64_t, uint64_t>;
+
+/// @brief same layout as `core::OrderBook::to_vector`
+std::vector<BidAsk> to_vector(const BidMap& bids, const AskMap& asks) {
+  std::vector<BidAsk> v;
+  auto bid_it = bids.begin();
+  auto ask_it = asks.begin();
+  for (; bid_it != bids.end() || ask_it != asks.end();) {
+    BidAsk ba{};
+    if (bid_it != bids.end()) {
+      ba.bid_px = bid_it->first;
+      ba.bid_sz = bid_it->second;
+      ++bid_it;
+    }
+    if (ask_it != asks.end()) {
+      ba.ask_px = ask_it->first;
+      ba.ask_sz = ask_it->second;
+      ++ask_it;
+    }
+    v.push_back(ba);
+  }
+  return v;
+}
+
+}  // namespace
+
+TEST(BookAnalytics, compute) {
+  const BidMap bids = {{100, 3}, {99, 1}, {90, 10}};
+  const AskMap asks = {{101, 1}, {103, 2}};
+  BookAnalyticsConfig config;
+  config.top_k = 2;
+  config.depth_offsets = {0, 1, 5, 10};
+  config.sweep_sizes = {1, 4, 100};
+
+  const BookAnalytics a = BookAnalytics::compute(to_vector(bids, asks), config);
+  ASSERT_TRUE(a.is_two_sided);
+  EXPECT_EQ(a.spread, 1u);
+  // (100 * 1 + 101 * 3) / 4
+  EXPECT_DOUBLE_EQ(a.microprice, 100.75);
+  // top 2: bids 4, asks 3
+  EXPECT_DOUBLE_EQ(a.imbalance, 1.0 / 7.0);
+
+  const std::array<uint64_t, 4> bid_depth = {3, 4, 4, 14};
+  EXPECT_EQ(a.bid.depth_sz, bid_depth);
+  const std::array<uint64_t, 4> ask_depth = {1, 1, 3, 3};
+  EXPECT_EQ(a.ask.depth_sz, ask_depth);
+
+  EXPECT_EQ(a.bid.sweep_notional[0], 100u);
+  EXPECT_EQ(a.bid.sweep_notional[1], 300u + 99u);
+  EXPECT_TRUE(a.bid.sweep_filled[1]);
+  EXPECT_EQ(a.ask.sweep_notional[2], 101u + 206u);
+  EXPECT_FALSE(a.ask.sweep_filled[2]);
+}
+
+TEST(BookAnalytics, OneSidedBook) {
+  const BookAnalytics a =
+      BookAnalytics::compute(to_vector(BidMap{{100, 1}}, AskMap{}), {});
+  EXPECT_FALSE(a.is_two_sided);
+  EXPECT_EQ(a.spread, 0u);
+  EXPECT_DOUBLE_EQ(a.imbalance, 1.0);
+}
+
+TEST(BookAnalyzer, IncrementalMatchesFullRecompute) {
+  BookAnalyticsConfig config;
+  config.top_k = 3;
+  config.depth_offsets = {2, 5, 10, 20};
+  config.sweep_sizes = {5, 20, 60};
+
+  BidMap bids;
+  AskMap asks;
+  BookAnalyzer analyzer{config};
+
+  constexpr uint64_t MID = 10'000;
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<uint64_t> level_dist(1, 60);
+  std::uniform_int_distribution<uint64_t> size_dist(0, 10);
+  for (int msg = 0; msg < 5'000; ++msg) {
+    // a few level changes per message, some deep in the book
+    const int changes = 1 + static_cast<int>(rng() % 3);
+    for (int c = 0; c < changes; ++c) {
+      const uint64_t offset = level_dist(rng);
+      const uint64_t sz = size_dist(rng);
+      auto apply = [&](auto& levels, const uint64_t px, auto&& on_change) {
+        const auto it = levels.find(px);
+        on_change(px, it == levels.end() ? 0 : it->second, sz);
+        sz == 0 ? static_cast<void>(levels.erase(px)) : static_cast<void>(levels[px] = sz);
+      };
+      if (rng() % 2 == 0) {
+        apply(bids, MID - offset, [&](auto... args) { analyzer.on_bid_change(args...); });
+      } else {
+        apply(asks, MID + offset, [&](auto... args) { analyzer.on_ask_change(args...); });
+      }
+    }
+    if (msg % 1'000 == 999) {
+      // e.g. a new snapshot
+      analyzer.on_reset();
+    }
+    analyzer.publish(bids, asks);
+
+    BookAnalytics expected = BookAnalytics::compute(to_vector(bids, asks), config);
+    const BookAnalytics actual = analyzer.get();
+    expected.sequence = actual.sequence;
+    ASSERT_EQ(actual, expected) << "message " << msg;
+  }
+  EXPECT_EQ(analyzer.get().sequence, 5'000u);
+}
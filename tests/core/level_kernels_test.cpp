@@ -0,0 +1,80 @@
+#include "core/level_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using core::LevelKernels;
+using core::SimdLevel;
+
+namespace {
+
+/// @brief every kernel table this machine can run, scalar first
+std::vector<const LevelKernels*> available_kernels() {
+  std::vector<const LevelKernels*> out;
+  for (const SimdLevel level : {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::NEON}) {
+    if (const LevelKernels* k = LevelKernels::get(level)) {
+      out.push_back(k);
+    }
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST(LevelKernels, get) {
+  const LevelKernels& best = LevelKernels::get();
+  ASSERT_NE(LevelKernels::get(best.level), nullptr);
+  ASSERT_NE(LevelKernels::get(SimdLevel::SCALAR), nullptr);
+  EXPECT_EQ(LevelKernels::to_str_view(SimdLevel::SCALAR), "scalar");
+}
+
+TEST(LevelKernels, MatchScalar) {
+  const LevelKernels& scalar = *LevelKernels::get(SimdLevel::SCALAR);
+  std::mt19937_64 rng{7};
+  std::uniform_int_distribution<uint64_t> px_dist(1, 20'000'000);
+  std::uniform_int_distribution<uint64_t> sz_dist(0, 5'000'000);
+
+  // odd lengths exercise the scalar tails
+  for (const size_t n : {0, 1, 3, 4, 7, 8, 9, 31, 100, 1'001}) {
+    std::vector<uint64_t> px(n);
+    std::vector<uint64_t> sz(n);
+    for (size_t i = 0; i < n; ++i) {
+      px[i] = px_dist(rng);
+      sz[i] = sz_dist(rng);
+    }
+    const uint64_t total = scalar.sum(sz.data(), n);
+
+    for (const LevelKernels* k : available_kernels()) {
+      SCOPED_TRACE(std::string(LevelKernels::to_str_view(k->level)) + " n=" +
+                   std::to_string(n));
+      EXPECT_EQ(k->sum(sz.data(), n), total);
+      EXPECT_EQ(k->dot(px.data(), sz.data(), n), scalar.dot(px.data(), sz.data(), n));
+
+      std::vector<uint64_t> expected(n);
+      std::vector<uint64_t> actual(n);
+      scalar.prefix_sum(sz.data(), n, expected.data());
+      k->prefix_sum(sz.data(), n, actual.data());
+      EXPECT_EQ(actual, expected);
+
+      for (const uint64_t target : {uint64_t{0}, uint64_t{1}, total / 3, total, total + 1}) {
+        uint64_t expected_before = 0;
+        uint64_t actual_before = 0;
+        EXPECT_EQ(k->find_cumulative(sz.data(), n, target, actual_before),
+                  scalar.find_cumulative(sz.data(), n, target, expected_before));
+        EXPECT_EQ(actual_before, expected_before);
+      }
+    }
+  }
+}
+
+TEST(LevelKernels, DotFallsBackOnWideValues) {
+  const std::vector<uint64_t> px = {1, 2, 3, uint64_t{1} << 33, 5};
+  const std::vector<uint64_t> sz = {1, 1, 1, 1, 1};
+  for (const LevelKernels* k : available_kernels()) {
+    EXPECT_EQ(k->dot(px.data(), sz.data(), px.size()), 11 + (uint64_t{1} << 33));
+  }
+}
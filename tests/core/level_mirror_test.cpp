@@ -0,0 +1,95 @@
+#include "core/level_mirror.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "core/level_kernels.h"
+
+using core::LevelKernels;
+using core::LevelMirror;
+
+namespace {
+
+using BidMap = absl::btree_map<uint64_t, uint64_t, std::greater<>>;
+
+/// @brief the first `count` levels of a side, worst first like the mirror
+std::vector<uint64_t> top_prices(const BidMap& levels, const size_t count) {
+  std::vector<uint64_t> out;
+  for (auto it = levels.begin(); it != levels.end() && out.size() < count; ++it) {
+    out.insert(out.begin(), it->first);
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST(LevelMirror, Queries) {
+  // asks, best first: 100 x 2, 101 x 3, 103 x 5
+  const absl::btree_map<uint64_t, uint64_t> asks = {{100, 2}, {101, 3}, {103, 5}};
+  LevelMirror mirror{false, 16};
+  mirror.assign(asks);
+  ASSERT_EQ(mirror.size(), 3u);
+  EXPECT_FALSE(mirror.is_truncated());
+
+  EXPECT_EQ(mirror.size_to_price(101), 5u);
+  EXPECT_EQ(mirror.size_to_price(99), 0u);
+  EXPECT_EQ(mirror.price_to_fill(2), 100u);
+  EXPECT_EQ(mirror.price_to_fill(3), 101u);
+  EXPECT_EQ(mirror.price_to_fill(10), 103u);
+  EXPECT_EQ(mirror.price_to_fill(11), std::nullopt);
+  EXPECT_EQ(mirror.notional_to_fill(6), 2u * 100 + 3u * 101 + 1u * 103);
+
+  std::array<uint64_t, 4> cumulative{};
+  ASSERT_EQ(mirror.cumulative_sizes(cumulative), 3u);
+  EXPECT_EQ(cumulative[0], 2u);
+  EXPECT_EQ(cumulative[1], 5u);
+  EXPECT_EQ(cumulative[2], 10u);
+}
+
+TEST(LevelMirror, TruncatedAnswersAreUnknown) {
+  const BidMap bids = {{100, 1}, {99, 1}, {98, 1}, {97, 1}};
+  LevelMirror mirror{true, 2};
+  mirror.assign(bids);
+  ASSERT_TRUE(mirror.is_truncated());
+  EXPECT_EQ(mirror.size_to_price(99), 2u);
+  EXPECT_EQ(mirror.size_to_price(98), std::nullopt);
+  EXPECT_EQ(mirror.price_to_fill(2), 99u);
+  EXPECT_EQ(mirror.price_to_fill(3), std::nullopt);
+}
+
+TEST(LevelMirror, TracksBook) {
+  constexpr size_t CAPACITY = 64;
+  BidMap book;
+  LevelMirror mirror{true, CAPACITY};
+
+  std::mt19937_64 rng{3};
+  std::geometric_distribution<uint64_t> offset_dist(0.02);
+  std::uniform_int_distribution<uint64_t> sz_dist(0, 4);
+  for (int i = 0; i < 50'000; ++i) {
+    const uint64_t px = 10'000 - std::min<uint64_t>(offset_dist(rng), 500);
+    const uint64_t sz = sz_dist(rng);
+    sz == 0 ? static_cast<void>(book.erase(px)) : static_cast<void>(book[px] = sz);
+    mirror.set(px, sz);
+    if (mirror.needs_refill()) {
+      mirror.assign(book);
+    }
+
+    // the mirror is always a prefix of the book
+    const auto prices = mirror.prices();
+    ASSERT_EQ(std::vector<uint64_t>(prices.begin(), prices.end()),
+              top_prices(book, prices.size()))
+        << "step " << i;
+    ASSERT_LE(prices.size(), CAPACITY);
+    if (!mirror.is_truncated()) {
+      ASSERT_EQ(prices.size(), book.size());
+    }
+  }
+}
@@ -1,13 +1,22 @@
 #include "core/order_book.h"
 
 #include <gtest/gtest.h>
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
 #include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
 
+#include <array>
 #include <cmath>
+#include <optional>
+#include <random>
 #include <string>
+#include <vector>
 
 #include "absl/container/btree_map.h"
+#include "binance/feed_arbiter.h"
+#include "binance/top_of_book.h"
 #include "core/bid_ask.h"
+#include "core/book_analytics.h"
+#include "core/level_mirror.h"
 
 using core::BidAsk;
 
@@ -32,6 +41,25 @@ TEST(OrderBook, to_vector) {
   ASSERT_NE(ob_vec, bad_check);
 }
 
+TEST(OrderBook, top_levels) {
+  const absl::btree_map<uint64_t, uint64_t, std::greater<>> bids = {{95, 10}, {94, 9}};
+  const absl::btree_map<uint64_t, uint64_t> asks = {{96, 11}, {97, 12}, {98, 13}};
+  const core::OrderBook x{bids, asks};
+
+  // fewer rows than the book has
+  std::array<BidAsk, 2> top{};
+  ASSERT_EQ(x.top_levels(top), 2u);
+  EXPECT_EQ(top[0], (BidAsk{10, 95, 96, 11}));
+  EXPECT_EQ(top[1], (BidAsk{9, 94, 97, 12}));
+
+  // more rows than the book has: the rest is left untouched
+  std::array<BidAsk, 4> all{};
+  all[3] = BidAsk{1, 2, 3, 4};
+  ASSERT_EQ(x.top_levels(all), 3u);
+  EXPECT_EQ(all[2], (BidAsk{BidAsk::SENTINEL_, BidAsk::SENTINEL_, 98, 13}));
+  EXPECT_EQ(all[3], (BidAsk{1, 2, 3, 4}));
+}
+
 TEST(OrderBook, constructors) {
   const absl::btree_map<uint64_t, uint64_t, std::greater<>> bids = {
       {95, 10},
@@ -110,3 +138,350 @@ TEST(OrderBook, apply_increment) {
   std::vector check = {BidAsk(10'000'000, 9'500, 9'600, 11'000'000)};
   ASSERT_EQ(vec, check);
 }
+
+TEST(OrderBook, provisional) {
+  const std::array bids = {core::PriceLevel{95, 10}, core::PriceLevel{94, 9}};
+  const std::array asks = {core::PriceLevel{96, 11}};
+  core::OrderBook book = core::OrderBook::from_levels(bids, asks, 41);
+  EXPECT_TRUE(book.is_provisional());
+  EXPECT_EQ(book.get_last_update_id(), 41u);
+
+  std::array<core::PriceLevel, 1> top_bids{};
+  std::array<core::PriceLevel, 4> top_asks{};
+  const core::OrderBook::LevelCounts counts = book.copy_levels(top_bids, top_asks);
+  EXPECT_EQ(counts.bids, 1u);
+  EXPECT_EQ(counts.asks, 1u);
+  EXPECT_EQ(counts.last_update_id, 41u);
+  EXPECT_EQ(top_bids[0], (core::PriceLevel{95, 10}));
+  EXPECT_EQ(top_asks[0], (core::PriceLevel{96, 11}));
+
+  // increments keep the book provisional, and advance the update id
+  FIX44::MarketDataIncrementalRefresh increment;
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries level;
+  level.set(FIX::Symbol("BTCUSDT"));
+  level.set(FIX::MDUpdateAction(FIX::MDUpdateAction_DELETE));
+  level.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+  level.set(FIX::MDEntryPx(0.94));
+  level.setField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, "42");
+  increment.addGroup(level);
+  book.apply_increment(increment, false);
+  EXPECT_TRUE(book.is_provisional());
+  EXPECT_EQ(book.get_last_update_id(), 42u);
+
+  // a snapshot replaces it
+  FIX44::MarketDataSnapshotFullRefresh snapshot;
+  FIX44::MarketDataSnapshotFullRefresh::NoMDEntries bid;
+  bid.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+  bid.set(FIX::MDEntryPx(95));
+  bid.set(FIX::MDEntrySize(10));
+  snapshot.addGroup(bid);
+  snapshot.set(FIX::Symbol("BTCUSDT"));
+  snapshot.setField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, "50");
+  book.apply_snapshot(snapshot);
+  EXPECT_FALSE(book.is_provisional());
+  EXPECT_EQ(book.get_last_update_id(), 50u);
+  const std::vector check = {
+      BidAsk(1'000'000, 9500, BidAsk::SENTINEL_, BidAsk::SENTINEL_)};
+  EXPECT_EQ(book.to_vector(), check);
+}
+
+TEST(OrderBook, to_level_updates) {
+  FIX44::MarketDataIncrementalRefresh msg;
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries bid;
+  bid.set(FIX::Symbol("BTCUSDT"));
+  bid.set(FIX::MDUpdateAction(FIX::MDUpdateAction_CHANGE));
+  bid.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+  bid.set(FIX::MDEntryPx(95));
+  bid.set(FIX::MDEntrySize(1));
+  bid.setField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, "42");
+  msg.addGroup(bid);
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries ask_delete;
+  ask_delete.set(FIX::MDUpdateAction(FIX::MDUpdateAction_DELETE));
+  ask_delete.set(FIX::MDEntryType(FIX::MDEntryType_OFFER));
+  ask_delete.set(FIX::MDEntryPx(96));
+  msg.addGroup(ask_delete);
+
+  // production tick sizes
+  std::vector<core::LevelUpdate> updates;
+  EXPECT_EQ(core::OrderBook::to_level_updates(msg, updates), 42u);
+  const std::vector<core::LevelUpdate> check_updates = {
+      {.side = core::BookSide::BID, .px = 9'500, .sz = 100'000},
+      {.side = core::BookSide::ASK, .px = 9'600, .sz = 0},
+  };
+  ASSERT_EQ(updates, check_updates);
+
+  // applied as levels, the book is the same as applied as a message
+  const absl::btree_map<uint64_t, uint64_t, std::greater<>> bids = {{9'500, 300'000}};
+  const absl::btree_map<uint64_t, uint64_t> asks = {{9'600, 100'000}, {9'700, 200'000}};
+  core::OrderBook book{bids, asks};
+  core::OrderBook by_levels{bids, asks};
+  book.apply_increment(msg, false);
+  by_levels.apply_levels(updates, 42);
+  EXPECT_EQ(by_levels.to_vector(), book.to_vector());
+  EXPECT_EQ(by_levels.get_last_update_id(), 42u);
+  EXPECT_EQ(by_levels.get_analytics(), book.get_analytics());
+}
+
+TEST(OrderBook, apply_top) {
+  using binance::TopOfBook;
+  using core::BookSide;
+  // the deep book as of update 10
+  const std::array bids = {core::PriceLevel{9'500, 10}, core::PriceLevel{9'400, 9}};
+  const std::array asks = {core::PriceLevel{9'600, 11}, core::PriceLevel{9'700, 12}};
+  core::OrderBook book = core::OrderBook::from_levels(bids, asks, 10);
+
+  // the depth-1 stream is ahead: the best bid went, the next one is the best
+  book.apply_top(TopOfBook{.last_update_id = 12,
+                           .bid = TopOfBook::Level{9'400, 5},
+                           .ask = TopOfBook::Level{9'600, 11}});
+  std::vector check = {BidAsk(5, 9'400, 9'600, 11),
+                       BidAsk(BidAsk::SENTINEL_, BidAsk::SENTINEL_, 9'700, 12)};
+  EXPECT_EQ(book.to_vector(), check);
+  EXPECT_EQ(book.get_last_update_id(), 10u);
+
+  // a deep message behind the top: its entries at or better than the top are older
+  const std::vector<core::LevelUpdate> behind = {
+      {.side = BookSide::BID, .px = 9'500, .sz = 3},
+      {.side = BookSide::BID, .px = 9'400, .sz = 7},
+      {.side = BookSide::BID, .px = 9'300, .sz = 2},
+  };
+  book.apply_levels(behind, 11);
+  check = {BidAsk(5, 9'400, 9'600, 11), BidAsk(2, 9'300, 9'700, 12)};
+  EXPECT_EQ(book.to_vector(), check);
+  // as is a top no newer than the book
+  book.apply_top(TopOfBook{.last_update_id = 12, .bid = TopOfBook::Level{9'900, 1}});
+  EXPECT_EQ(book.to_vector(), check);
+
+  // the deep stream catches up, the book is whole again: it can better the top
+  FIX44::MarketDataIncrementalRefresh caught_up;
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries level;
+  level.set(FIX::Symbol("BTCUSDT"));
+  level.set(FIX::MDUpdateAction(FIX::MDUpdateAction_NEW));
+  level.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+  level.set(FIX::MDEntryPx(95.5));
+  level.set(FIX::MDEntrySize(1));
+  level.setField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, "13");
+  caught_up.addGroup(level);
+  book.apply_increment(caught_up, false);
+  EXPECT_EQ(book.to_vector().front(), BidAsk(100'000, 9'550, 9'600, 11));
+  EXPECT_EQ(book.get_last_update_id(), 13u);
+
+  // a snapshot older than the top keeps it
+  book.apply_top(TopOfBook{.last_update_id = 20, .bid = TopOfBook::Level{9'560, 4}});
+  FIX44::MarketDataSnapshotFullRefresh snapshot;
+  FIX44::MarketDataSnapshotFullRefresh::NoMDEntries bid;
+  bid.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+  bid.set(FIX::MDEntryPx(95.7));
+  bid.set(FIX::MDEntrySize(1));
+  snapshot.addGroup(bid);
+  bid.set(FIX::MDEntryPx(95.5));
+  snapshot.addGroup(bid);
+  snapshot.set(FIX::Symbol("BTCUSDT"));
+  snapshot.setField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG, "15");
+  book.apply_snapshot(snapshot);
+  check = {BidAsk(4, 9'560, BidAsk::SENTINEL_, BidAsk::SENTINEL_),
+           BidAsk(100'000, 9'550, BidAsk::SENTINEL_, BidAsk::SENTINEL_)};
+  EXPECT_EQ(book.to_vector(), check);
+}
+
+TEST(OrderBook, apply_top_DeletedBest) {
+  using binance::TopOfBook;
+  using core::BookSide;
+  const std::array bids = {core::PriceLevel{9'500, 10}, core::PriceLevel{9'400, 9}};
+  const std::array asks = {core::PriceLevel{9'600, 11}};
+  core::OrderBook book = core::OrderBook::from_levels(bids, asks, 10);
+
+  // a deleted level goes alone, the better ones stay
+  book.apply_top(TopOfBook{.last_update_id = 12, .bid = TopOfBook::Level{9'400, 0}});
+  std::vector check = {BidAsk(10, 9'500, 9'600, 11)};
+  EXPECT_EQ(book.to_vector(), check);
+
+  // only the deleted price is shadowed for a deep message behind the top
+  const std::vector<core::LevelUpdate> behind = {
+      {.side = BookSide::BID, .px = 9'400, .sz = 7},
+      {.side = BookSide::BID, .px = 9'550, .sz = 2},
+  };
+  book.apply_levels(behind, 11);
+  check = {BidAsk(2, 9'550, 9'600, 11),
+           BidAsk(10, 9'500, BidAsk::SENTINEL_, BidAsk::SENTINEL_)};
+  EXPECT_EQ(book.to_vector(), check);
+}
+
+TEST(OrderBook, get_analytics) {
+  absl::btree_map<uint64_t, uint64_t, std::greater<>> bids = {
+      {9'500, 300'000},
+  };
+  absl::btree_map<uint64_t, uint64_t> asks = {
+      {9'600, 100'000},
+      {9'700, 200'000},
+  };
+  core::OrderBook book{bids, asks};
+  ASSERT_EQ(book.get_analytics().sequence, 1u);
+
+  FIX44::MarketDataIncrementalRefresh msg;
+  // shrink the touch to 1 BTC on the bid
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries bid;
+  bid.set(FIX::Symbol("BTCUSDT"));
+  bid.set(FIX::MDUpdateAction(FIX::MDUpdateAction_CHANGE));
+  bid.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+  bid.set(FIX::MDEntryPx(95));
+  bid.set(FIX::MDEntrySize(1));
+  msg.addGroup(bid);
+  // remove the best ask
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries ask_delete;
+  ask_delete.set(FIX::Symbol("BTCUSDT"));
+  ask_delete.set(FIX::MDUpdateAction(FIX::MDUpdateAction_DELETE));
+  ask_delete.set(FIX::MDEntryType(FIX::MDEntryType_OFFER));
+  ask_delete.set(FIX::MDEntryPx(96));
+  msg.addGroup(ask_delete);
+  book.apply_increment(msg, false);
+
+  const core::BookAnalytics a = book.get_analytics();
+  EXPECT_EQ(a.sequence, 2u);
+  EXPECT_EQ(a.bid.best_px, 9'500u);
+  EXPECT_EQ(a.ask.best_px, 9'700u);
+  EXPECT_EQ(a.spread, 200u);
+  // (9500 * 2 + 9700 * 1) / 3
+  EXPECT_NEAR(a.microprice, 9'566.67, 0.01);
+  EXPECT_NEAR(a.imbalance, -1.0 / 3.0, 1e-9);
+
+  core::BookAnalytics expected =
+      core::BookAnalytics::compute(book.to_vector(), core::BookAnalyticsConfig{});
+  expected.sequence = a.sequence;
+  EXPECT_EQ(a, expected);
+}
+
+TEST(OrderBook, depth_queries) {
+  absl::btree_map<uint64_t, uint64_t, std::greater<>> bids = {
+      {9'990, 100'000},
+      {9'980, 200'000},
+      {9'900, 300'000},
+  };
+  absl::btree_map<uint64_t, uint64_t> asks = {
+      {10'010, 50'000},
+      {10'020, 150'000},
+  };
+  core::OrderBook book{bids, asks};
+
+  EXPECT_EQ(book.size_within(core::BookSide::BID, 10), 300'000u);
+  EXPECT_EQ(book.size_within(core::BookSide::ASK, 0), 50'000u);
+  // mid 10'000, 10 bps = 10 ticks
+  EXPECT_EQ(book.size_within_bps_of_mid(core::BookSide::BID, 10.0), 100'000u);
+  EXPECT_EQ(book.size_within_bps_of_mid(core::BookSide::ASK, 20.0), 200'000u);
+  EXPECT_EQ(book.price_to_fill(core::BookSide::BID, 150'000), 9'980u);
+  EXPECT_EQ(book.notional_to_fill(core::BookSide::ASK, 100'000),
+            50'000u * 10'010 + 50'000u * 10'020);
+  EXPECT_EQ(book.price_to_fill(core::BookSide::ASK, 1'000'000), std::nullopt);
+
+  // the mirror follows increments
+  FIX44::MarketDataIncrementalRefresh msg;
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries ask_delete;
+  ask_delete.set(FIX::Symbol("BTCUSDT"));
+  ask_delete.set(FIX::MDUpdateAction(FIX::MDUpdateAction_DELETE));
+  ask_delete.set(FIX::MDEntryType(FIX::MDEntryType_OFFER));
+  ask_delete.set(FIX::MDEntryPx(100.10));
+  msg.addGroup(ask_delete);
+  book.apply_increment(msg, false);
+
+  std::array<uint64_t, 4> cumulative{};
+  ASSERT_EQ(book.cumulative_sizes(core::BookSide::ASK, cumulative), 1u);
+  EXPECT_EQ(cumulative[0], 150'000u);
+}
+
+TEST(OrderBook, set_max_levels) {
+  absl::btree_map<uint64_t, uint64_t, std::greater<>> bids = {
+      {9'990, 1}, {9'980, 2}, {9'970, 3}};
+  absl::btree_map<uint64_t, uint64_t> asks = {{10'010, 4}, {10'020, 5}};
+  core::OrderBook book{bids, asks};
+
+  // the worst go straight away
+  book.set_max_levels(2);
+  std::vector check = {BidAsk(1, 9'990, 10'010, 4), BidAsk(2, 9'980, 10'020, 5)};
+  EXPECT_EQ(book.to_vector(), check);
+  core::OrderBook::Footprint footprint = book.get_footprint();
+  EXPECT_EQ(footprint.bid_levels, 2u);
+  EXPECT_EQ(footprint.ask_levels, 2u);
+  EXPECT_EQ(footprint.trimmed_levels, 1u);
+
+  // then after each message: a better bid pushes the worst out, a worse ask never stays
+  const std::array updates = {
+      core::LevelUpdate{.side = core::BookSide::BID, .px = 9'995, .sz = 6},
+      core::LevelUpdate{.side = core::BookSide::ASK, .px = 10'030, .sz = 7}};
+  book.apply_levels(updates, std::nullopt);
+  check = {BidAsk(6, 9'995, 10'010, 4), BidAsk(1, 9'990, 10'020, 5)};
+  EXPECT_EQ(book.to_vector(), check);
+  EXPECT_EQ(book.get_footprint().trimmed_levels, 3u);
+  // the analytics and the mirrors dropped them too
+  core::BookAnalytics expected =
+      core::BookAnalytics::compute(book.to_vector(), core::BookAnalyticsConfig{});
+  expected.sequence = book.get_analytics().sequence;
+  EXPECT_EQ(book.get_analytics(), expected);
+  EXPECT_EQ(book.size_within(core::BookSide::BID, 100), 7u);
+  EXPECT_EQ(book.price_to_fill(core::BookSide::ASK, 10), std::nullopt);
+
+  // unbounded
+  book.set_max_levels(0);
+  book.apply_levels(updates, std::nullopt);
+  footprint = book.get_footprint();
+  EXPECT_EQ(footprint.ask_levels, 3u);
+  EXPECT_EQ(footprint.trimmed_levels, 3u);
+}
+
+TEST(OrderBook, max_levels_over_a_long_replay) {
+  // an hour of a depth-100 stream at 100 updates a second. the touch drifts, levels
+  // crossed by it are deleted, those left behind far from it never are
+  constexpr size_t WINDOW = 100;
+  constexpr size_t MESSAGES = 36'000;
+  constexpr size_t UPDATES_PER_MESSAGE = 10;
+  constexpr size_t SAMPLES = 10;
+  core::OrderBook bounded;
+  bounded.set_max_levels(WINDOW);
+  core::OrderBook unbounded;
+
+  std::mt19937_64 rng{42};
+  uint64_t mid = 10'000'000;
+  std::vector<core::LevelUpdate> updates;
+  std::vector<core::OrderBook::Footprint> samples;
+  for (size_t i = 0; i < MESSAGES; ++i) {
+    updates.clear();
+    const uint64_t next_mid = mid + rng() % 7 - 3;
+    for (uint64_t px = std::min(mid, next_mid); px <= std::max(mid, next_mid); ++px) {
+      const core::BookSide crossed =
+          next_mid > mid ? core::BookSide::ASK : core::BookSide::BID;
+      updates.push_back({.side = crossed, .px = px, .sz = 0});
+    }
+    mid = next_mid;
+    for (size_t j = 0; j < UPDATES_PER_MESSAGE; ++j) {
+      const bool is_bid = rng() % 2 == 0;
+      const uint64_t offset = 1 + rng() % WINDOW;
+      updates.push_back({.side = is_bid ? core::BookSide::BID : core::BookSide::ASK,
+                         .px = is_bid ? mid - offset : mid + offset,
+                         .sz = rng() % 4 == 0 ? 0 : 1 + rng() % 1'000});
+    }
+    bounded.apply_levels(updates, std::nullopt);
+    unbounded.apply_levels(updates, std::nullopt);
+    if ((i + 1) % (MESSAGES / SAMPLES) == 0) {
+      samples.push_back(bounded.get_footprint());
+      EXPECT_LE(bounded.to_vector().size(), WINDOW);
+    }
+  }
+
+  // flat: never more than the window, whatever the time
+  const size_t bound =
+      core::OrderBook{}.get_footprint().bytes + 2 * WINDOW * core::OrderBook::LEVEL_BYTES;
+  for (const core::OrderBook::Footprint& sample : samples) {
+    EXPECT_LE(sample.bid_levels, WINDOW);
+    EXPECT_LE(sample.ask_levels, WINDOW);
+    EXPECT_LE(sample.bytes, bound);
+  }
+  EXPECT_GT(samples.back().trimmed_levels, samples.front().trimmed_levels);
+  // where the unbounded book kept everything the touch ever drifted past
+  const core::OrderBook::Footprint kept = unbounded.get_footprint();
+  EXPECT_GT(kept.bid_levels + kept.ask_levels, 4 * WINDOW);
+  EXPECT_GT(kept.bytes, bound);
+
+  core::BookAnalytics expected =
+      core::BookAnalytics::compute(bounded.to_vector(), core::BookAnalyticsConfig{});
+  expected.sequence = bounded.get_analytics().sequence;
+  EXPECT_EQ(bounded.get_analytics(), expected);
+}
@@ -0,0 +1,117 @@
+#include "core/trade_aggregator.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "binance/side.h"
+#include "core/bar.h"
+#include "core/trade.h"
+
+using core::Bar;
+using core::Trade;
+using core::TradeAggregator;
+
+namespace {
+
+constexpr uint64_t SECOND_US = 1'000'000;
+constexpr uint64_t MINUTE_US = 60 * SECOND_US;
+// 2023-10-20 12:34:00 UTC
+constexpr uint64_t T0_US = 1'697'805'240 * SECOND_US;
+
+Trade make_trade(const uint64_t px,
+                 const uint64_t sz,
+                 const binance::SideEnum side,
+                 const uint64_t ts_us) {
+  return Trade(px, sz, 0, side, std::array<char, 16>{}, ts_us);
+}
+
+}  // namespace
+
+TEST(TradeAggregator, BuildsOhlcvWithinBucket) {
+  TradeAggregator agg;
+  agg.on_trade(make_trade(100, 1, binance::SideEnum::BUY, T0_US + 1));
+  agg.on_trade(make_trade(110, 1, binance::SideEnum::BUY, T0_US + 2));
+  agg.on_trade(make_trade(90, 2, binance::SideEnum::SELL, T0_US + 3));
+  agg.on_trade(make_trade(105, 2, binance::SideEnum::BUY, T0_US + 4));
+
+  const auto bars = agg.get_series(TradeAggregator::Resolution::MINUTE_1).latest(10);
+  ASSERT_EQ(bars.size(), 1u);
+  const Bar& bar = bars[0];
+  EXPECT_EQ(bar.start_us, T0_US);
+  EXPECT_EQ(bar.open, 100u);
+  EXPECT_EQ(bar.high, 110u);
+  EXPECT_EQ(bar.low, 90u);
+  EXPECT_EQ(bar.close, 105u);
+  EXPECT_EQ(bar.volume, 6u);
+  EXPECT_EQ(bar.buy_volume, 4u);
+  EXPECT_EQ(bar.sell_volume, 2u);
+  EXPECT_EQ(bar.trade_count, 4u);
+  // (100 + 110 + 180 + 210) / 6
+  EXPECT_DOUBLE_EQ(bar.vwap(), 100.0);
+}
+
+TEST(TradeAggregator, RollsBucketsPerResolution) {
+  TradeAggregator agg;
+  agg.on_trade(make_trade(100, 1, binance::SideEnum::BUY, T0_US));
+  agg.on_trade(make_trade(101, 1, binance::SideEnum::BUY, T0_US + SECOND_US));
+  // skip a minute, empty buckets are not reported
+  agg.on_trade(make_trade(102, 1, binance::SideEnum::SELL, T0_US + 2 * MINUTE_US));
+
+  const auto secs = agg.get_series(TradeAggregator::Resolution::SECOND_1).latest(3);
+  ASSERT_EQ(secs.size(), 1u);
+  EXPECT_EQ(secs[0].close, 102u);
+
+  const auto mins = agg.get_series(TradeAggregator::Resolution::MINUTE_1).latest(3);
+  ASSERT_EQ(mins.size(), 2u);
+  EXPECT_EQ(mins[0].start_us, T0_US);
+  EXPECT_EQ(mins[0].close, 101u);
+  EXPECT_EQ(mins[1].start_us, T0_US + 2 * MINUTE_US);
+
+  const Bar totals = agg.get_totals();
+  EXPECT_EQ(totals.open, 100u);
+  EXPECT_EQ(totals.close, 102u);
+  EXPECT_EQ(totals.trade_count, 3u);
+  EXPECT_EQ(agg.version(), 3u);
+}
+
+TEST(TradeAggregator, LateTradesStillLandInOpenBuckets) {
+  TradeAggregator agg;
+  agg.on_trade(make_trade(100, 1, binance::SideEnum::BUY, T0_US + MINUTE_US));
+  agg.on_trade(make_trade(90, 1, binance::SideEnum::SELL, T0_US));
+
+  const auto mins = agg.get_series(TradeAggregator::Resolution::MINUTE_1).latest(2);
+  ASSERT_EQ(mins.size(), 2u);
+  EXPECT_EQ(mins[0].close, 90u);
+  EXPECT_EQ(mins[1].close, 100u);
+}
+
+TEST(TradeAggregator, DropsTradesOlderThanTheRing) {
+  TradeAggregator agg;
+  const uint64_t late_us = T0_US + TradeAggregator::BAR_COUNT * SECOND_US;
+  agg.on_trade(make_trade(100, 1, binance::SideEnum::BUY, late_us));
+  agg.on_trade(make_trade(90, 1, binance::SideEnum::SELL, T0_US));
+
+  const auto secs = agg.get_series(TradeAggregator::Resolution::SECOND_1)
+                        .latest(TradeAggregator::BAR_COUNT);
+  ASSERT_EQ(secs.size(), 1u);
+  EXPECT_EQ(secs[0].start_us, late_us);
+  EXPECT_EQ(secs[0].trade_count, 1u);
+}
+
+TEST(TradeAggregator, RecyclesSlots) {
+  TradeAggregator agg;
+  for (uint64_t i = 0; i < 2 * TradeAggregator::BAR_COUNT; ++i) {
+    agg.on_trade(make_trade(100 + i, 1, binance::SideEnum::BUY, T0_US + i * SECOND_US));
+  }
+  const auto secs = agg.get_series(TradeAggregator::Resolution::SECOND_1)
+                        .latest(TradeAggregator::BAR_COUNT);
+  ASSERT_EQ(secs.size(), TradeAggregator::BAR_COUNT);
+  EXPECT_EQ(secs.front().open, 100 + TradeAggregator::BAR_COUNT);
+  EXPECT_EQ(secs.back().close, 100 + 2 * TradeAggregator::BAR_COUNT - 1);
+  for (const Bar& bar : secs) {
+    EXPECT_EQ(bar.trade_count, 1u);
+  }
+}
@@ -0,0 +1,73 @@
+#include "core/trade_parser.h"
+
+#include <gtest/gtest.h>
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+
+#include <string>
+#include <vector>
+
+#include "binance/side.h"
+#include "core/trade.h"
+
+namespace {
+
+FIX44::MarketDataIncrementalRefresh::NoMDEntries make_trade(const char* symbol,
+                                                            const double px,
+                                                            const double sz,
+                                                            const char* id,
+                                                            const char* side) {
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries group;
+  group.set(FIX::MDEntryType(FIX::MDEntryType_TRADE));
+  if (symbol) {
+    group.set(FIX::Symbol(symbol));
+  }
+  group.set(FIX::MDEntryPx(px));
+  group.set(FIX::MDEntrySize(sz));
+  group.setField(FIX::TradeID(id));
+  if (side) {
+    group.setField(2446, side);
+  }
+  group.setField(60, "20231020-12:34:56.789012");
+  return group;
+}
+
+}  // namespace
+
+TEST(TradeParser, ParsesEveryTradeOfAMessage) {
+  FIX44::MarketDataIncrementalRefresh msg;
+  msg.set(FIX::NoMDEntries(2));
+  msg.addGroup(make_trade("BTCUSDT", 27481.12, 0.014, "5100000000", "1"));
+  // the symbol is only on the first entry
+  msg.addGroup(make_trade(nullptr, 27480.5, 1.5, "5100000001", "2"));
+
+  std::vector<core::Trade> trades;
+  ASSERT_EQ(core::TradeParser::parse(msg, trades), 2u);
+  ASSERT_EQ(trades.size(), 2u);
+
+  EXPECT_EQ(trades[0].px, 2'748'112u);
+  EXPECT_EQ(trades[0].sz, 1'400u);
+  EXPECT_EQ(trades[0].id, 5'100'000'000u);
+  EXPECT_EQ(trades[0].side, binance::SideEnum::BUY);
+  EXPECT_EQ(std::string(trades[0].time.data()), "12:34:56.789012");
+  // 2023-10-20 12:34:56.789012 UTC
+  EXPECT_EQ(trades[0].ts_us, 1'697'805'296'789'012u);
+
+  EXPECT_EQ(trades[1].px, 2'748'050u);
+  EXPECT_EQ(trades[1].sz, 150'000u);
+  EXPECT_EQ(trades[1].side, binance::SideEnum::SELL);
+}
+
+TEST(TradeParser, SkipsOtherSymbolsAndSidelessTrades) {
+  FIX44::MarketDataIncrementalRefresh msg;
+  msg.set(FIX::NoMDEntries(3));
+  msg.addGroup(make_trade("ETHUSDT", 1600.0, 1.0, "1", "1"));
+  msg.addGroup(make_trade("BTCUSDT", 27481.12, 0.014, "2", nullptr));
+  msg.addGroup(make_trade(nullptr, 27481.12, 0.014, "3", "2"));
+
+  // appends, keeping what is already there
+  std::vector<core::Trade> trades;
+  trades.emplace_back(1, 1, 1, binance::SideEnum::BUY, std::array<char, 16>{});
+  ASSERT_EQ(core::TradeParser::parse(msg, trades), 1u);
+  ASSERT_EQ(trades.size(), 2u);
+  EXPECT_EQ(trades[1].id, 3u);
+}
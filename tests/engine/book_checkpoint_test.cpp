@@ -0,0 +1,171 @@
+#include "engine/book_checkpoint.h"
+
+#include <gtest/gtest.h>
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "binance/market_message_variant.h"
+#include "binance/symbol.h"
+#include "concurrentqueue.h"
+#include "core/bbo_book.h"
+#include "core/bid_ask.h"
+#include "core/order_book.h"
+#include "engine/engine.h"
+#include "utils/testing.h"
+
+using core::BidAsk;
+using core::PriceLevel;
+
+namespace {
+
+constexpr size_t MAX_LEVELS = 4;
+
+class BookCheckpointTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = std::filesystem::temp_directory_path() /
+            std::format("tradercpp_ckpt_{}_{}", ::getpid(),
+                        ::testing::UnitTest::GetInstance()->current_test_info()->name()) /
+            "book.ckpt";
+    std::filesystem::remove_all(path_.parent_path());
+  }
+  void TearDown() override { std::filesystem::remove_all(path_.parent_path()); }
+
+  std::unique_ptr<engine::BookCheckpoint> open(const size_t max_levels = MAX_LEVELS) {
+    return std::make_unique<engine::BookCheckpoint>(
+        path_, binance::SymbolEnum::BTCUSDT, std::chrono::seconds(1), max_levels);
+  }
+
+  /// @brief the book's rows, best first
+  static std::vector<BidAsk> rows(const core::OrderBook& book) {
+    std::array<BidAsk, 8> out{};
+    return {out.begin(), out.begin() + static_cast<ptrdiff_t>(book.top_levels(out))};
+  }
+
+  std::filesystem::path path_;
+};
+
+core::OrderBook make_book(const uint64_t best_bid, const uint64_t last_update_id) {
+  const std::array bids = {PriceLevel{best_bid, 10}, PriceLevel{best_bid - 1, 9}};
+  const std::array asks = {PriceLevel{best_bid + 1, 11}};
+  return core::OrderBook::from_levels(bids, asks, last_update_id);
+}
+
+}  // namespace
+
+TEST_F(BookCheckpointTest, RestoresAProvisionalBook) {
+  open()->save(make_book(95, 42));
+
+  // a new process: the file is reopened
+  const core::OrderBook book = open()->restore();
+  EXPECT_TRUE(book.is_provisional());
+  EXPECT_EQ(book.get_last_update_id(), 42u);
+  const std::vector<BidAsk> expected = {
+      BidAsk(10, 95, 96, 11), BidAsk(9, 94, BidAsk::SENTINEL_, BidAsk::SENTINEL_)};
+  EXPECT_EQ(rows(book), expected);
+}
+
+TEST_F(BookCheckpointTest, RestoresTheTopOfBook) {
+  // a depth-1 book restores from a full book's checkpoint, and the other way round
+  open()->save(make_book(95, 42));
+  const core::BboBook bbo = open()->restore<core::BboBook>();
+  EXPECT_TRUE(bbo.is_provisional());
+  EXPECT_EQ(bbo.get_last_update_id(), 42u);
+  const std::vector<BidAsk> expected = {BidAsk(10, 95, 96, 11)};
+  EXPECT_EQ(bbo.to_vector(), expected);
+
+  open()->save(bbo);
+  EXPECT_EQ(rows(open()->restore()), expected);
+}
+
+TEST_F(BookCheckpointTest, KeepsTheBestLevels) {
+  const std::array bids = {PriceLevel{95, 1}, PriceLevel{94, 2}, PriceLevel{93, 3},
+                           PriceLevel{92, 4}, PriceLevel{91, 5}, PriceLevel{90, 6}};
+  open(2)->save(core::OrderBook::from_levels(bids, {}, 1));
+
+  const core::OrderBook book = open(2)->restore();
+  const std::vector<BidAsk> expected = {
+      BidAsk(1, 95, BidAsk::SENTINEL_, BidAsk::SENTINEL_),
+      BidAsk(2, 94, BidAsk::SENTINEL_, BidAsk::SENTINEL_)};
+  EXPECT_EQ(rows(book), expected);
+}
+
+TEST_F(BookCheckpointTest, EmptyWithoutACheckpoint) {
+  const auto checkpoint = open();
+  const core::OrderBook book = checkpoint->restore();
+  EXPECT_FALSE(book.is_provisional());
+  EXPECT_TRUE(rows(book).empty());
+  EXPECT_EQ(std::filesystem::file_size(path_),
+            engine::BookCheckpoint::file_size(MAX_LEVELS));
+
+  // another layout: started afresh
+  open()->save(make_book(95, 1));
+  EXPECT_TRUE(rows(open(MAX_LEVELS + 1)->restore()).empty());
+}
+
+TEST_F(BookCheckpointTest, FallsBackOnATornCheckpoint) {
+  {
+    const auto checkpoint = open();
+    checkpoint->save(make_book(95, 1));
+    checkpoint->save(make_book(105, 2));
+    EXPECT_EQ(checkpoint->get_saved(), 2u);
+    EXPECT_EQ(checkpoint->restore().get_last_update_id(), 2u);
+  }
+  // corrupt the best bid of the latest checkpoint, in slot 0 (sequence 2)
+  {
+    std::fstream file(path_, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(sizeof(engine::CheckpointHeader) + sizeof(engine::CheckpointSlotHeader));
+    const uint64_t px = 999;
+    file.write(reinterpret_cast<const char*>(&px), sizeof(px));
+  }
+  const auto checkpoint = open();
+  const core::OrderBook book = checkpoint->restore();
+  EXPECT_EQ(book.get_last_update_id(), 1u);
+  EXPECT_EQ(rows(book).front(), BidAsk(10, 95, 96, 11));
+
+  // the next save overwrites the torn slot, not the good one
+  checkpoint->save(make_book(115, 3));
+  EXPECT_EQ(open()->restore().get_last_update_id(), 3u);
+}
+
+TEST_F(BookCheckpointTest, EngineCheckpointsOnStop) {
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> order_queue;
+  moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> trade_queue;
+  {
+    engine::Engine engine(order_queue, trade_queue, 100, make_book(95, 1), nullptr,
+                          nullptr, open());
+    EXPECT_TRUE(engine.get_book().provisional);
+    engine.start();
+    // a live snapshot replaces the provisional book
+    FIX44::MarketDataSnapshotFullRefresh snapshot;
+    FIX44::MarketDataSnapshotFullRefresh::NoMDEntries bid;
+    bid.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+    bid.set(FIX::MDEntryPx(95));
+    bid.set(FIX::MDEntrySize(10));
+    snapshot.addGroup(bid);
+    snapshot.set(FIX::Symbol("BTCUSDT"));
+    snapshot.setField(25044, "77");  // LastBookUpdateID
+    order_queue.enqueue(binance::MarketMessageVariant{snapshot});
+    ASSERT_TRUE(utils::Testing::wait_for([&] { return !engine.get_book().provisional; },
+                                         1000));
+    EXPECT_TRUE(engine.get_stats().first_live_book_time.has_value());
+    engine.stop();
+  }
+
+  const core::OrderBook book = open()->restore();
+  EXPECT_TRUE(book.is_provisional());
+  EXPECT_EQ(book.get_last_update_id(), 77u);
+  EXPECT_EQ(rows(book).front(), BidAsk(1'000'000, 9500, BidAsk::SENTINEL_,
+                                       BidAsk::SENTINEL_));
+}
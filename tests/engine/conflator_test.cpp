@@ -0,0 +1,78 @@
+#include "engine/conflator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "binance/symbol.h"
+#include "core/level_mirror.h"
+#include "core/order_book.h"
+
+using core::BookSide;
+using core::LevelUpdate;
+
+namespace {
+
+LevelUpdate bid(const uint64_t px, const uint64_t sz) {
+  return LevelUpdate{.side = BookSide::BID, .px = px, .sz = sz};
+}
+
+LevelUpdate ask(const uint64_t px, const uint64_t sz) {
+  return LevelUpdate{.side = BookSide::ASK, .px = px, .sz = sz};
+}
+
+}  // namespace
+
+TEST(Conflator, KeepsTheLatestSizePerLevel) {
+  engine::Conflator conflator(1, 16);
+  EXPECT_TRUE(conflator.add(bid(95, 1)));
+  EXPECT_TRUE(conflator.add(ask(95, 2)));
+  EXPECT_TRUE(conflator.add(bid(94, 3)));
+  EXPECT_TRUE(conflator.add(bid(95, 4)));
+  // a delete is a size like any other
+  EXPECT_TRUE(conflator.add(bid(94, 0)));
+
+  // first-seen order, latest size
+  const std::vector<LevelUpdate> expected = {bid(95, 4), ask(95, 2), bid(94, 0)};
+  EXPECT_EQ(std::vector<LevelUpdate>(conflator.get_updates().begin(),
+                                     conflator.get_updates().end()),
+            expected);
+}
+
+TEST(Conflator, IsFullAtCapacity) {
+  engine::Conflator conflator(1, 4);
+  for (uint64_t px = 1; px <= 4; ++px) {
+    EXPECT_TRUE(conflator.add(bid(px, px)));
+  }
+  EXPECT_FALSE(conflator.add(bid(5, 5)));
+  // a pending level still updates
+  EXPECT_TRUE(conflator.add(bid(4, 40)));
+  ASSERT_EQ(conflator.size(), 4u);
+  EXPECT_EQ(conflator.get_updates().back(), bid(4, 40));
+}
+
+TEST(Conflator, ClearsForTheNextBatch) {
+  engine::Conflator conflator(1, 1'024);
+  for (uint64_t px = 0; px < 1'024; ++px) {
+    ASSERT_TRUE(conflator.add(ask(10'000 + px, 1)));
+  }
+  conflator.clear();
+  EXPECT_TRUE(conflator.empty());
+
+  // no trace of the previous batch
+  EXPECT_TRUE(conflator.add(ask(10'000, 2)));
+  EXPECT_TRUE(conflator.add(ask(10'001, 3)));
+  const std::vector<LevelUpdate> expected = {ask(10'000, 2), ask(10'001, 3)};
+  EXPECT_EQ(std::vector<LevelUpdate>(conflator.get_updates().begin(),
+                                     conflator.get_updates().end()),
+            expected);
+}
+
+TEST(Conflator, KeysBySymbol) {
+  engine::Conflator conflator(1, 16);
+  conflator.add(bid(95, 1));
+  conflator.add(LevelUpdate{
+      .symbol = binance::SymbolEnum::ETHUSDT, .side = BookSide::BID, .px = 95, .sz = 2});
+  EXPECT_EQ(conflator.size(), 2u);
+}
@@ -0,0 +1,236 @@
+#include "engine/engine.h"
+
+#include <gtest/gtest.h>
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "binance/market_message_variant.h"
+#include "binance/testing.h"
+#include "concurrentqueue.h"
+#include "core/bbo_book.h"
+#include "core/bid_ask.h"
+#include "core/order_book.h"
+#include "core/trade_aggregator.h"
+#include "engine/conflator.h"
+#include "engine/headless.h"
+#include "utils/testing.h"
+
+using binance::Testing;
+using core::BidAsk;
+
+namespace {
+
+FIX44::MarketDataSnapshotFullRefresh make_snapshot() {
+  FIX44::MarketDataSnapshotFullRefresh msg;
+  FIX44::MarketDataSnapshotFullRefresh::NoMDEntries bid;
+  bid.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+  bid.set(FIX::MDEntryPx(95));
+  bid.set(FIX::MDEntrySize(10));
+  msg.addGroup(bid);
+  FIX44::MarketDataSnapshotFullRefresh::NoMDEntries ask;
+  ask.set(FIX::MDEntryType(FIX::MDEntryType_OFFER));
+  ask.set(FIX::MDEntryPx(96));
+  ask.set(FIX::MDEntrySize(11));
+  msg.addGroup(ask);
+  msg.set(FIX::Symbol("BTCUSDT"));
+  return msg;
+}
+
+FIX44::MarketDataIncrementalRefresh make_trade() {
+  FIX44::MarketDataIncrementalRefresh msg;
+  FIX44::MarketDataIncrementalRefresh::NoMDEntries group;
+  group.set(FIX::MDEntryType(FIX::MDEntryType_TRADE));
+  group.set(FIX::Symbol("BTCUSDT"));
+  group.set(FIX::MDEntryPx(27481.12));
+  group.set(FIX::MDEntrySize(0.014));
+  group.setField(FIX::TradeID("123456789"));
+  group.setField(2446, "1");  // AggressorSide; 1 = Buy (Binance custom field, tag 2446)
+  group.setField(60, "20231020-12:34:56.789");
+  msg.set(FIX::NoMDEntries(1));
+  msg.addGroup(group);
+  return msg;
+}
+
+}  // namespace
+
+class EngineTest : public ::testing::Test {
+ protected:
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> order_queue_;
+  moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> trade_queue_;
+  engine::Engine engine_{order_queue_, trade_queue_};
+
+  void SetUp() override { engine_.start(); }
+  void TearDown() override { engine_.stop(); }
+};
+
+TEST_F(EngineTest, PublishesTheBook) {
+  const uint64_t version = engine_.get_book_version();
+  order_queue_.enqueue(binance::MarketMessageVariant{make_snapshot()});
+
+  ASSERT_TRUE(utils::Testing::wait_for(
+      [&] { return engine_.get_book_version() > version; }, 1000));
+  const engine::BookSnapshot book = engine_.get_book();
+  ASSERT_EQ(book.row_count, 1u);
+  EXPECT_EQ(book.message_count, 1u);
+  EXPECT_EQ(book.levels[0], BidAsk(1'000'000, 9500, 9600, 1'100'000));
+  EXPECT_EQ(engine_.get_stats().book_messages, 1u);
+  EXPECT_FALSE(engine_.get_exception());
+}
+
+TEST_F(EngineTest, FeedsTheTapeAndTheBars) {
+  trade_queue_.enqueue(make_trade());
+
+  ASSERT_TRUE(utils::Testing::wait_for(
+      [&] { return engine_.get_aggregator().get_totals().trade_count == 1; }, 1000));
+  const auto bars = engine_.get_aggregator()
+                        .get_series(core::TradeAggregator::Resolution::MINUTE_1)
+                        .latest(1);
+  ASSERT_EQ(bars.size(), 1u);
+  // 2023-10-20 12:34:00 UTC
+  EXPECT_EQ(bars[0].start_us, 1'697'805'240'000'000u);
+  EXPECT_EQ(bars[0].buy_volume, bars[0].volume);
+
+  ASSERT_TRUE(utils::Testing::wait_for(
+      [&] { return engine_.get_stats().trade_messages == 1; }, 1000));
+  const std::vector<core::Trade> trades = engine_.get_trades().to_vector();
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].px, 2'748'112u);
+  EXPECT_EQ(trades[0].id, 123'456'789u);
+  EXPECT_EQ(engine_.get_trades_version(), 1u);
+}
+
+TEST(Engine, PublishesTheInitialBook) {
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> order_queue;
+  moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> trade_queue;
+  const absl::btree_map<uint64_t, uint64_t, std::greater<>> bids = {{95, 10}, {94, 9}};
+  const absl::btree_map<uint64_t, uint64_t> asks = {{96, 11}};
+  // not started: readers still see the book it was given
+  const engine::Engine engine(order_queue, trade_queue, 100, core::OrderBook{bids, asks});
+
+  const engine::BookSnapshot book = engine.get_book();
+  ASSERT_EQ(book.row_count, 2u);
+  EXPECT_EQ(book.levels[0], BidAsk(10, 95, 96, 11));
+  EXPECT_EQ(book.levels[1], BidAsk(9, 94, BidAsk::SENTINEL_, BidAsk::SENTINEL_));
+}
+
+TEST(Engine, ConflatesABacklogToTheSameBook) {
+  // a backlog queued before the book worker starts: snapshot, churn on a few levels,
+  // snapshot (a barrier), more churn
+  std::vector<binance::MarketMessageVariant> backlog;
+  backlog.emplace_back(make_snapshot());
+  for (int i = 1; i <= 200; ++i) {
+    backlog.emplace_back(Testing::make_increment(FIX::MDUpdateAction_CHANGE,
+                                                 FIX::MDEntryType_BID, 95 - i % 3, i));
+    backlog.emplace_back(Testing::make_increment(FIX::MDUpdateAction_NEW,
+                                                 FIX::MDEntryType_OFFER, 97 + i % 2, i));
+  }
+  backlog.emplace_back(make_snapshot());
+  backlog.emplace_back(
+      Testing::make_increment(FIX::MDUpdateAction_NEW, FIX::MDEntryType_BID, 94, 7));
+  backlog.emplace_back(
+      Testing::make_increment(FIX::MDUpdateAction_DELETE, FIX::MDEntryType_BID, 95, 0));
+  backlog.emplace_back(
+      Testing::make_increment(FIX::MDUpdateAction_CHANGE, FIX::MDEntryType_OFFER, 96,
+                              3));
+
+  const auto run = [&backlog](std::unique_ptr<engine::Conflator> conflator) {
+    moodycamel::ConcurrentQueue<binance::MarketMessageVariant> order_queue;
+    moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> trade_queue;
+    for (const binance::MarketMessageVariant& msg : backlog) {
+      order_queue.enqueue(msg);
+    }
+    engine::Engine engine(order_queue, trade_queue, 100, core::OrderBook{}, nullptr,
+                          nullptr, nullptr, std::move(conflator));
+    engine.start();
+    EXPECT_TRUE(utils::Testing::wait_for(
+        [&] { return engine.get_book().message_count == backlog.size(); }, 1000));
+    engine.stop();
+    EXPECT_FALSE(engine.get_exception());
+    return std::pair{engine.get_book(), engine.get_stats()};
+  };
+  const auto [book, stats] = run(nullptr);
+  const auto [conflated_book, conflated_stats] =
+      run(std::make_unique<engine::Conflator>(1));
+
+  ASSERT_EQ(conflated_book.row_count, book.row_count);
+  for (size_t i = 0; i < book.row_count; ++i) {
+    EXPECT_EQ(conflated_book.levels[i], book.levels[i]);
+  }
+  EXPECT_EQ(stats.conflated_messages, 0u);
+  EXPECT_EQ(conflated_stats.book_messages, backlog.size());
+  EXPECT_GT(conflated_stats.conflated_messages, 0u);
+  // many updates, few levels
+  EXPECT_LT(conflated_stats.conflated_levels * 10, conflated_stats.conflated_updates);
+  EXPECT_LT(conflated_stats.book_publishes, stats.book_publishes);
+}
+
+TEST(Engine, PublishesTheTopOfBookAtDepthOne) {
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> order_queue;
+  moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> trade_queue;
+  // a conflator is not used at depth 1
+  engine::BasicEngine<core::BboBook> engine(order_queue, trade_queue, 1, core::BboBook{},
+                                            nullptr, nullptr, nullptr,
+                                            std::make_unique<engine::Conflator>(1));
+  order_queue.enqueue(binance::MarketMessageVariant{make_snapshot()});
+  order_queue.enqueue(binance::MarketMessageVariant{
+      Testing::make_increment(FIX::MDUpdateAction_CHANGE, FIX::MDEntryType_BID, 95.5,
+                              2)});
+  engine.start();
+
+  ASSERT_TRUE(utils::Testing::wait_for(
+      [&] { return engine.get_book().message_count == 2; }, 1000));
+  engine.stop();
+  const engine::BookSnapshot book = engine.get_book();
+  ASSERT_EQ(book.row_count, 1u);
+  EXPECT_EQ(book.levels[0], BidAsk(200'000, 9550, 9600, 1'100'000));
+  EXPECT_EQ(engine.get_stats().conflated_messages, 0u);
+  EXPECT_EQ(engine.get_analytics().bid.best_px, 9550u);
+  EXPECT_FALSE(engine.get_exception());
+}
+
+TEST(TradeTape, to_vector) {
+  engine::TradeTape tape;
+  EXPECT_TRUE(tape.to_vector().empty());
+
+  // wrap around: only the most recent `MAX_TRADES` are kept, oldest first
+  constexpr uint64_t WRITTEN = engine::TradeTape::MAX_TRADES + 5;
+  for (uint64_t id = 0; id < WRITTEN; ++id) {
+    tape.trades[tape.total % engine::TradeTape::MAX_TRADES].id = id;
+    ++tape.total;
+  }
+  const std::vector<core::Trade> trades = tape.to_vector();
+  ASSERT_EQ(trades.size(), engine::TradeTape::MAX_TRADES);
+  EXPECT_EQ(trades.front().id, 5u);
+  EXPECT_EQ(trades.back().id, WRITTEN - 1);
+}
+
+TEST(Headless, format_metrics) {
+  const engine::Stats before{.book_messages = 100, .trades = 10};
+  const engine::Stats now{.book_messages = 300,
+                          .book_publishes = 20,
+                          .trade_messages = 15,
+                          .trades = 30,
+                          .book_levels = 7,
+                          .book_bytes = 4'096,
+                          .trimmed_levels = 3,
+                          .order_queue_depth = 2,
+                          .trade_queue_depth = 0,
+                          .first_book_time = std::chrono::microseconds(1'500)};
+  engine::BookSnapshot book;
+  book.row_count = 1;
+  book.provisional = true;
+  book.levels[0] = BidAsk(1'000'000, 2'748'112, BidAsk::SENTINEL_, BidAsk::SENTINEL_);
+
+  EXPECT_EQ(engine::Headless::format_metrics(now, before, 2.0, book),
+            "book_msgs=300 book_msgs_per_sec=100 book_publishes=20 conflated_msgs=0 "
+            "conflation_ratio=- trade_msgs=15 trades=30 trades_per_sec=10 order_queue=2 "
+            "trade_queue=0 levels=1 book_levels=7 book_kb=4 trimmed_levels=3 "
+            "best_bid=27481.12 best_ask=- provisional=1 first_book_ms=1.5 "
+            "first_live_book_ms=-");
+}
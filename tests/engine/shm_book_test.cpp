@@ -0,0 +1,101 @@
+#include "engine/shm_book.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <array>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "absl/container/btree_map.h"
+#include "binance/market_message_variant.h"
+#include "binance/symbol.h"
+#include "concurrentqueue.h"
+#include "core/bid_ask.h"
+#include "core/order_book.h"
+#include "core/trade.h"
+#include "engine/engine.h"
+#include "engine/shm_publisher.h"
+
+namespace {
+
+/// @brief unique per test process, so that parallel test runs do not collide
+std::string shm_name(const std::string& test) {
+  return std::format("/tradercpp_test_{}_{}", test, ::getpid());
+}
+
+}  // namespace
+
+TEST(ShmBook, PublishAndRead) {
+  const std::string name = shm_name("publish");
+  engine::ShmPublisher publisher(name);
+  const engine::ShmBookReader reader(name);
+
+  const auto slot = reader.find("BTCUSDT");
+  ASSERT_TRUE(slot.has_value());
+  EXPECT_FALSE(reader.find("DOGEUSDT").has_value());
+  EXPECT_EQ(reader.get_slot(*slot).price_ticks_per_unit, 100u);
+  EXPECT_EQ(reader.get_header().writer_pid, ::getpid());
+
+  engine::ShmBook book{};
+  EXPECT_EQ(reader.read_book(*slot, book), 0u);
+
+  engine::BookSnapshot snapshot;
+  snapshot.row_count = 2;
+  snapshot.message_count = 42;
+  snapshot.provisional = true;
+  snapshot.levels[0] = core::BidAsk(10, 95, 96, 11);
+  snapshot.levels[1] =
+      core::BidAsk(9, 94, core::BidAsk::SENTINEL_, core::BidAsk::SENTINEL_);
+  publisher.publish_book(binance::SymbolEnum::BTCUSDT, snapshot);
+
+  ASSERT_EQ(reader.read_book(*slot, book), 1u);
+  EXPECT_EQ(reader.book_version(*slot), 1u);
+  EXPECT_EQ(book.message_count, 42u);
+  EXPECT_EQ(book.flags, engine::SHM_BOOK_PROVISIONAL);
+  ASSERT_EQ(book.row_count, 2u);
+  EXPECT_EQ(book.levels[0].bid_px, 95u);
+  EXPECT_EQ(book.levels[0].ask_sz, 11u);
+  EXPECT_EQ(book.levels[1].ask_px, core::BidAsk::SENTINEL_);
+  EXPECT_GT(book.publish_ns, 0u);
+
+  publisher.publish_trade(binance::SymbolEnum::BTCUSDT,
+                          core::Trade(2'748'112, 1'400, 7, binance::SideEnum::SELL,
+                                      std::array<char, 16>{}, 1'697'805'296'789'012));
+  engine::ShmTrades trades{};
+  ASSERT_EQ(reader.read_trades(*slot, trades), 1u);
+  ASSERT_EQ(trades.total, 1u);
+  EXPECT_EQ(trades.trades[0].id, 7u);
+  EXPECT_EQ(trades.trades[0].side, '2');
+  EXPECT_EQ(trades.trades[0].ts_us, 1'697'805'296'789'012u);
+}
+
+TEST(ShmBook, ReaderNeedsAPublisher) {
+  const std::string name = shm_name("missing");
+  EXPECT_THROW(engine::ShmBookReader{name}, std::runtime_error);
+  {
+    const engine::ShmPublisher publisher(name);
+  }
+  // unlinked when the publisher goes away
+  EXPECT_THROW(engine::ShmBookReader{name}, std::runtime_error);
+}
+
+TEST(ShmBook, EnginePublishesToSharedMemory) {
+  const std::string name = shm_name("engine");
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> order_queue;
+  moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> trade_queue;
+  const absl::btree_map<uint64_t, uint64_t, std::greater<>> bids = {{95, 10}};
+  const absl::btree_map<uint64_t, uint64_t> asks = {{96, 11}};
+  // the initial book is published on construction
+  const engine::Engine engine(order_queue, trade_queue, 100, core::OrderBook{bids, asks},
+                              std::make_unique<engine::ShmPublisher>(name));
+
+  const engine::ShmBookReader reader(name);
+  engine::ShmBook book{};
+  ASSERT_EQ(reader.read_book(0, book), 1u);
+  ASSERT_EQ(book.row_count, 1u);
+  EXPECT_EQ(book.levels[0].bid_px, 95u);
+  EXPECT_EQ(book.levels[0].ask_px, 96u);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "binance/side.h"
+#include "binance/symbol.h"
+#include "core/trade.h"
+#include "tape/tape_format.h"
+#include "tape/tape_reader.h"
+#include "tape/tape_writer.h"
+
+namespace {
+
+/// @brief 2023-10-20 12:34:56 UTC
+constexpr uint64_t TS_US = 1'697'805'296'000'000;
+constexpr uint64_t DAY_US = 86'400'000'000;
+
+core::Trade make_trade(const uint64_t i, const uint64_t ts_us) {
+  return core::Trade(2'748'100 + (i * 7) % 50, 100 + (i * 13) % 1'000, 3'000'000'000 + i,
+                     i % 3 == 0 ? binance::SideEnum::SELL : binance::SideEnum::BUY,
+                     std::array<char, 16>{}, ts_us);
+}
+
+class TapeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() /
+           std::format("tradercpp_tape_{}_{}", ::getpid(),
+                       ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    std::filesystem::remove_all(dir_);
+  }
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::filesystem::path file_path(const uint64_t ts_us) const {
+    return tape::TapeWriter::file_path(dir_, binance::SymbolEnum::BTCUSDT, ts_us);
+  }
+
+  std::filesystem::path dir_;
+};
+
+}  // namespace
+
+TEST(TapeFormat, BlockRoundTrip) {
+  const std::vector<tape::TapeTrade> trades = {
+      {.px = 100, .sz = 5, .id = 10, .ts_us = 1'000, .side = binance::SideEnum::BUY},
+      // prices and ids going down, out-of-order timestamps
+      {.px = 90, .sz = 7, .id = 9, .ts_us = 999, .side = binance::SideEnum::SELL},
+      {.px = UINT64_MAX, .sz = UINT64_MAX, .id = UINT64_MAX, .ts_us = 1'001,
+       .side = binance::SideEnum::SELL},
+      {.px = 0, .sz = 0, .id = 0, .ts_us = 1'002, .side = binance::SideEnum::BUY},
+  };
+  std::vector<uint8_t> encoded = {0xAA};
+  const tape::IndexEntry entry = tape::encode_block(trades, encoded);
+  EXPECT_EQ(entry.offset, 1u);
+  EXPECT_EQ(entry.count, 4u);
+  EXPECT_EQ(entry.min_ts_us, 999u);
+  EXPECT_EQ(entry.max_ts_us, 1'002u);
+
+  const std::span<const uint8_t> block(encoded.data() + 1, encoded.size() - 1);
+  EXPECT_EQ(tape::block_size(block), block.size());
+  std::vector<tape::TapeTrade> decoded;
+  tape::decode_block(block, decoded);
+  EXPECT_EQ(decoded, trades);
+
+  // truncated: not a complete block
+  EXPECT_EQ(tape::block_size(block.first(block.size() - 1)), 0u);
+  EXPECT_THROW(tape::decode_block(block.first(block.size() - 1), decoded),
+               std::runtime_error);
+}
+
+TEST(TapeFormat, CompressesATypicalTape) {
+  std::vector<tape::TapeTrade> trades;
+  for (uint64_t i = 0; i < 4'096; ++i) {
+    const core::Trade t = make_trade(i, TS_US + i * 250);
+    trades.push_back(
+        {.px = t.px, .sz = t.sz, .id = t.id, .ts_us = t.ts_us, .side = t.side});
+  }
+  std::vector<uint8_t> encoded;
+  tape::encode_block(trades, encoded);
+  // 33 bytes of fields per trade, raw
+  EXPECT_LT(encoded.size(), trades.size() * 8);
+}
+
+TEST_F(TapeTest, WriteThenReadAndScan) {
+  constexpr uint64_t COUNT = 10'000;
+  {
+    tape::TapeWriter writer(dir_, binance::SymbolEnum::BTCUSDT);
+    for (uint64_t i = 0; i < COUNT; ++i) {
+      ASSERT_TRUE(writer.push(make_trade(i, TS_US + i * 1'000)));
+    }
+    writer.stop();
+    EXPECT_EQ(writer.get_written(), COUNT);
+    EXPECT_EQ(writer.get_dropped(), 0u);
+  }
+
+  const auto path = file_path(TS_US);
+  EXPECT_EQ(path.filename(), "2023-10-20.tape");
+  tape::TapeReader reader(path);
+  EXPECT_FALSE(reader.is_recovered());
+  EXPECT_EQ(reader.get_symbol(), "BTCUSDT");
+  EXPECT_EQ(reader.get_day_start_us(), TS_US - TS_US % DAY_US);
+  EXPECT_EQ(reader.size(), COUNT);
+  EXPECT_GT(reader.get_index().size(), 1u);
+
+  uint64_t i = 0;
+  reader.for_each([&i](const tape::TapeTrade& trade) {
+    const core::Trade expected = make_trade(i, TS_US + i * 1'000);
+    EXPECT_EQ(trade.id, expected.id);
+    EXPECT_EQ(trade.px, expected.px);
+    EXPECT_EQ(trade.sz, expected.sz);
+    EXPECT_EQ(trade.side, expected.side);
+    ++i;
+  });
+  EXPECT_EQ(i, COUNT);
+
+  // [5000, 5100)
+  std::vector<uint64_t> ids;
+  reader.scan(TS_US + 5'000'000, TS_US + 5'100'000,
+              [&ids](const tape::TapeTrade& trade) { ids.push_back(trade.id); });
+  ASSERT_EQ(ids.size(), 100u);
+  EXPECT_EQ(ids.front(), 3'000'005'000u);
+  EXPECT_EQ(ids.back(), 3'000'005'099u);
+}
+
+TEST_F(TapeTest, OneFilePerDay) {
+  {
+    tape::TapeWriter writer(dir_, binance::SymbolEnum::BTCUSDT);
+    writer.push(make_trade(0, TS_US));
+    writer.push(make_trade(1, TS_US + DAY_US));
+  }
+  const auto day_2 = file_path(TS_US + DAY_US);
+  EXPECT_EQ(day_2.filename(), "2023-10-21.tape");
+  const auto day_1 = file_path(TS_US);
+  EXPECT_EQ(tape::TapeReader(day_1).size(), 1u);
+  EXPECT_EQ(tape::TapeReader(day_2).size(), 1u);
+}
+
+TEST_F(TapeTest, ResumesAFileThatWasNotClosed) {
+  const auto path = file_path(TS_US);
+  {
+    tape::TapeWriter writer(dir_, binance::SymbolEnum::BTCUSDT);
+    writer.push(make_trade(0, TS_US));
+    writer.push(make_trade(1, TS_US + 1));
+  }
+  // as if the writer died before the footer, mid-way through a block
+  const uint64_t blocks_end = std::filesystem::file_size(path) - sizeof(tape::Trailer) -
+                              sizeof(tape::IndexEntry);
+  std::filesystem::resize_file(path, blocks_end + 10);
+  {
+    tape::TapeReader reader(path);
+    EXPECT_TRUE(reader.is_recovered());
+    EXPECT_EQ(reader.size(), 2u);
+  }
+
+  {
+    tape::TapeWriter writer(dir_, binance::SymbolEnum::BTCUSDT);
+    writer.push(make_trade(2, TS_US + 2));
+  }
+  tape::TapeReader reader(path);
+  EXPECT_FALSE(reader.is_recovered());
+  EXPECT_EQ(reader.get_index().size(), 2u);
+  std::vector<uint64_t> ids;
+  reader.for_each([&ids](const tape::TapeTrade& trade) { ids.push_back(trade.id); });
+  EXPECT_EQ(ids, (std::vector<uint64_t>{3'000'000'000, 3'000'000'001, 3'000'000'002}));
+}
+
+TEST_F(TapeTest, ReaderRejectsOtherFiles) {
+  EXPECT_THROW(tape::TapeReader{dir_ / "missing.tape"}, std::runtime_error);
+}
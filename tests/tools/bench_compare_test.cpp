@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "compare.h"
+#include "statistics.h"
+
+TEST(BenchCompare_MannWhitney, SeparatedSamples) {
+  const std::vector<double> a{1, 2, 3, 4, 5};
+  const std::vector<double> b{6, 7, 8, 9, 10};
+  const auto r = tools::MannWhitney::test(a, b);
+  EXPECT_DOUBLE_EQ(r.u, 0);
+  // normal approximation with continuity correction: z = 12 / sqrt(275 / 12)
+  EXPECT_NEAR(r.p_value, 0.0122, 1e-4);
+  EXPECT_NEAR(tools::MannWhitney::test(b, a).p_value, r.p_value, 1e-12);
+}
+
+TEST(BenchCompare_MannWhitney, IdenticalSamples) {
+  const std::vector<double> a{3, 1, 2, 5, 4};
+  EXPECT_DOUBLE_EQ(tools::MannWhitney::test(a, a).p_value, 1);
+  // every value tied: no information at all
+  const std::vector<double> flat{7, 7, 7};
+  EXPECT_DOUBLE_EQ(tools::MannWhitney::test(flat, flat).p_value, 1);
+  EXPECT_DOUBLE_EQ(tools::MannWhitney::test({}, a).p_value, 1);
+}
+
+TEST(BenchCompare_Shift, EstimateAndInterval) {
+  const std::vector<double> a{10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+  std::vector<double> b;
+  for (const double v : a) {
+    b.push_back(v + 5);
+  }
+  const auto shift = tools::Shift::estimate_of(a, b, 0.95);
+  EXPECT_DOUBLE_EQ(shift.estimate, 5);
+  ASSERT_TRUE(shift.low && shift.high);
+  EXPECT_LT(*shift.low, 5);
+  EXPECT_GT(*shift.high, 5);
+
+  // a single repetition per side cannot give an interval
+  const std::vector<double> one{1};
+  EXPECT_FALSE(tools::Shift::estimate_of(one, one, 0.95).low);
+}
+
+TEST(BenchCompare_Statistics, MedianAndQuantile) {
+  EXPECT_DOUBLE_EQ(tools::median(std::vector<double>{3, 1, 2}), 2);
+  EXPECT_DOUBLE_EQ(tools::median(std::vector<double>{4, 1, 3, 2}), 2.5);
+  EXPECT_NEAR(tools::normal_quantile(0.975), 1.95996, 1e-4);
+  EXPECT_NEAR(tools::normal_quantile(0.5), 0, 1e-9);
+}
+
+TEST(BenchCompare_Compare, Verdicts) {
+  const std::vector<double> base{100, 101, 99, 100, 102, 98, 100, 101, 99, 100};
+  std::vector<double> slow;
+  std::vector<double> fast;
+  for (const double v : base) {
+    slow.push_back(v * 1.2);
+    fast.push_back(v * 0.8);
+  }
+  const tools::Results baseline{{"BENCH_Hot", base},
+                                {"BENCH_Cold", base},
+                                {"BENCH_Fast", base},
+                                {"BENCH_Noise", base},
+                                {"BENCH_Gone", base}};
+  const tools::Results contender{{"BENCH_Hot", slow},
+                                 {"BENCH_Cold", slow},
+                                 {"BENCH_Fast", fast},
+                                 {"BENCH_Noise", base},
+                                 {"BENCH_New", base}};
+  const tools::CompareConfig config{.threshold = 0.05, .alpha = 0.05, .hot_path = "Hot"};
+  const auto comparisons = tools::compare(baseline, contender, config);
+
+  ASSERT_EQ(comparisons.size(), 6u);
+  // sorted by name
+  EXPECT_EQ(comparisons[0].name, "BENCH_Cold");
+  EXPECT_EQ(comparisons[0].verdict, tools::Verdict::SLOWER);
+  EXPECT_EQ(comparisons[1].name, "BENCH_Fast");
+  EXPECT_EQ(comparisons[1].verdict, tools::Verdict::FASTER);
+  EXPECT_EQ(comparisons[2].name, "BENCH_Gone");
+  EXPECT_EQ(comparisons[2].verdict, tools::Verdict::UNMATCHED);
+  EXPECT_EQ(comparisons[3].name, "BENCH_Hot");
+  EXPECT_EQ(comparisons[3].verdict, tools::Verdict::REGRESSION);
+  EXPECT_NEAR(comparisons[3].delta, 0.2, 1e-9);
+  ASSERT_TRUE(comparisons[3].delta_low && comparisons[3].delta_high);
+  EXPECT_LT(*comparisons[3].delta_low, 0.2);
+  EXPECT_GT(*comparisons[3].delta_high, 0.2);
+  EXPECT_EQ(comparisons[4].name, "BENCH_New");
+  EXPECT_EQ(comparisons[4].verdict, tools::Verdict::UNMATCHED);
+  EXPECT_EQ(comparisons[5].name, "BENCH_Noise");
+  EXPECT_EQ(comparisons[5].verdict, tools::Verdict::SAME);
+
+  // a slowdown under the threshold is not a regression, however significant
+  const tools::CompareConfig lenient{.threshold = 0.25, .alpha = 0.05, .hot_path = ""};
+  for (const auto& c : tools::compare(baseline, contender, lenient)) {
+    EXPECT_NE(c.verdict, tools::Verdict::REGRESSION) << c.name;
+  }
+}
+
+TEST(BenchCompare_Compare, SingleRepetitionNeverGates) {
+  const tools::Results baseline{{"BENCH_Hot", {100}}};
+  const tools::Results contender{{"BENCH_Hot", {200}}};
+  const auto comparisons = tools::compare(baseline, contender, {});
+  ASSERT_EQ(comparisons.size(), 1u);
+  EXPECT_EQ(comparisons[0].verdict, tools::Verdict::SAME);
+  EXPECT_NE(tools::format_report(comparisons, {}).find("too few repetitions"),
+            std::string::npos);
+}
+
+TEST(BenchCompare_LoadResults, RepetitionsOnly) {
+  const auto results = tools::load_results(R"({
+    "context": {},
+    "benchmarks": [
+      {"name": "BENCH_A", "run_name": "BENCH_A", "run_type": "iteration",
+       "repetition_index": 0, "real_time": 1.5, "cpu_time": 1.4, "time_unit": "us"},
+      {"name": "BENCH_A", "run_name": "BENCH_A", "run_type": "iteration",
+       "repetition_index": 1, "real_time": 2, "cpu_time": 1.9, "time_unit": "us"},
+      {"name": "BENCH_A_mean", "run_name": "BENCH_A", "run_type": "aggregate",
+       "aggregate_name": "mean", "real_time": 1.75, "cpu_time": 1.65, "time_unit": "us"},
+      {"name": "BENCH_B", "run_name": "BENCH_B", "run_type": "iteration",
+       "error_occurred": true, "real_time": 0, "cpu_time": 0, "time_unit": "ns"}
+    ]
+  })",
+                                           "real_time");
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results.at("BENCH_A"), (std::vector<double>{1'500, 2'000}));
+
+  EXPECT_THROW(tools::load_results("{}", "real_time"), std::runtime_error);
+  EXPECT_THROW(tools::load_results("not json", "real_time"), std::runtime_error);
+}
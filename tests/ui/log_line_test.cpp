@@ -0,0 +1,52 @@
+#include "ui/log_box/log_line.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <optional>
+
+using ui::LogFilter;
+using ui::LogLevel;
+using ui::LogLineMeta;
+
+TEST(LogLineMeta, ParsesThePattern) {
+  const std::optional<LogLineMeta> meta =
+      LogLineMeta::parse("[2025-01-02 03:04:05.678] [error] [4242] feed stalled [x]");
+  ASSERT_TRUE(meta.has_value());
+  EXPECT_EQ(meta->level, LogLevel::error);
+  EXPECT_EQ(meta->thread_id, 4242u);
+  using std::chrono::sys_days;
+  const auto time = sys_days(std::chrono::year(2025) / 1 / 2) + std::chrono::hours(3) +
+                    std::chrono::minutes(4) + std::chrono::seconds(5) +
+                    std::chrono::milliseconds(678);
+  EXPECT_EQ(meta->time_ms, time.time_since_epoch().count());
+
+  EXPECT_EQ(LogLineMeta::parse("[2025-01-02 03:04:05.678] [critical] [1] x")->level,
+            LogLevel::critical);
+}
+
+TEST(LogLineMeta, RejectsOtherLines) {
+  EXPECT_FALSE(LogLineMeta::parse("").has_value());
+  EXPECT_FALSE(LogLineMeta::parse("  at the gateway").has_value());
+  // not a date
+  EXPECT_FALSE(LogLineMeta::parse("[2025-13-02 03:04:05.678] [info] [1] x").has_value());
+  EXPECT_FALSE(LogLineMeta::parse("[2025-01-02 03:04:05] [info] [1] x").has_value());
+  // not a level, not a thread id
+  EXPECT_FALSE(LogLineMeta::parse("[2025-01-02 03:04:05.678] [loud] [1] x").has_value());
+  EXPECT_FALSE(
+      LogLineMeta::parse("[2025-01-02 03:04:05.678] [info] [main] x").has_value());
+  EXPECT_FALSE(LogLineMeta::parse("[2025-01-02 03:04:05.678] [info").has_value());
+}
+
+TEST(LogFilter, Matches) {
+  const LogLineMeta meta{.time_ms = 0, .thread_id = 7, .level = LogLevel::warning};
+  EXPECT_FALSE(LogFilter{}.is_active());
+  EXPECT_TRUE(LogFilter{}.matches(meta, "feed stalled"));
+
+  EXPECT_TRUE(LogFilter{.min_level = LogLevel::warning}.matches(meta, ""));
+  EXPECT_FALSE(LogFilter{.min_level = LogLevel::error}.matches(meta, ""));
+  EXPECT_TRUE(LogFilter{.thread_id = 7}.matches(meta, ""));
+  EXPECT_FALSE(LogFilter{.thread_id = 8}.matches(meta, ""));
+  EXPECT_TRUE(LogFilter{.text = "stall"}.matches(meta, "feed stalled"));
+  EXPECT_FALSE(LogFilter{.text = "Stall"}.matches(meta, "feed stalled"));
+}
@@ -0,0 +1,126 @@
+#include "ui/log_box/log_search.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ui/log_box/log_line.h"
+#include "ui/log_box/log_tailer.h"
+#include "utils/testing.h"
+
+using ui::LogFilter;
+using ui::LogLevel;
+
+namespace {
+
+class LogSearchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() /
+           std::format("tradercpp_search_{}_{}", ::getpid(),
+                       ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    std::filesystem::remove_all(dir_);
+    std::filesystem::create_directories(dir_);
+    path_ = dir_ / "trader.log";
+  }
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  /// @brief `count` lines, cycling through levels and threads 1 and 2
+  void append(const int count) const {
+    std::ofstream file(path_, std::ios::app);
+    constexpr std::array levels = {"debug", "info", "warning", "error"};
+    for (int i = 0; i < count; ++i) {
+      file << std::format("[2025-01-02 03:04:05.678] [{}] [{}] message {}\n",
+                          levels[static_cast<size_t>(i) % levels.size()], 1 + i % 2, i);
+    }
+  }
+
+  /// @brief search to the end
+  static void run_to_end(ui::LogSearch& search) {
+    while (search.search_step()) {
+    }
+  }
+
+  std::filesystem::path dir_;
+  std::filesystem::path path_;
+};
+
+}  // namespace
+
+TEST_F(LogSearchTest, FiltersByLevelThreadAndText) {
+  append(10'000);
+  ui::LogTailer tailer(path_);
+  tailer.poll_file();
+  ui::LogSearch search(tailer);
+
+  // unfiltered: nothing to search, the box reads the tailer
+  EXPECT_FALSE(search.search_step());
+  EXPECT_EQ(search.get_match_count(), 0u);
+
+  search.set_filter(LogFilter{.min_level = LogLevel::error});
+  EXPECT_TRUE(search.is_searching());
+  run_to_end(search);
+  EXPECT_FALSE(search.is_searching());
+  EXPECT_EQ(search.get_match_count(), 2'500u);
+  EXPECT_EQ(search.get_matches(0, 2), (std::vector<uint64_t>{3, 7}));
+
+  // a new filter restarts
+  search.set_filter(LogFilter{.min_level = LogLevel::warning, .thread_id = 2});
+  run_to_end(search);
+  EXPECT_EQ(search.get_match_count(), 2'500u);
+  EXPECT_EQ(search.get_matches(0, 1), (std::vector<uint64_t>{3}));
+
+  search.set_filter(LogFilter{.text = "message 999"});
+  run_to_end(search);
+  EXPECT_EQ(search.get_matches(0, 20),
+            (std::vector<uint64_t>{999, 9990, 9991, 9992, 9993, 9994, 9995, 9996, 9997,
+                                   9998, 9999}));
+  // past the end
+  EXPECT_TRUE(search.get_matches(20, 5).empty());
+}
+
+TEST_F(LogSearchTest, SearchesAppendedLines) {
+  append(4);
+  ui::LogTailer tailer(path_);
+  tailer.poll_file();
+  ui::LogSearch search(tailer);
+  search.set_filter(LogFilter{.min_level = LogLevel::error});
+  run_to_end(search);
+  EXPECT_EQ(search.get_match_count(), 1u);
+
+  append(4);
+  tailer.poll_file();
+  EXPECT_TRUE(search.is_searching());
+  run_to_end(search);
+  EXPECT_EQ(search.get_matches(0, 10), (std::vector<uint64_t>{3, 7}));
+}
+
+TEST_F(LogSearchTest, StreamsResultsOnItsThread) {
+  append(4);
+  ui::LogTailer tailer(path_);
+  ui::LogSearch search(tailer);
+  std::atomic<int> calls = 0;
+  search.set_callback([&calls] { ++calls; });
+  tailer.set_callback([&search] { search.notify(); });
+  search.start();
+  tailer.start();
+  search.set_filter(LogFilter{.text = "message 3"});
+  ASSERT_TRUE(
+      utils::Testing::wait_for([&] { return search.get_match_count() == 1; }, 1000));
+
+  append(8);
+  ASSERT_TRUE(
+      utils::Testing::wait_for([&] { return search.get_match_count() == 2; }, 1000));
+  EXPECT_EQ(search.get_matches(0, 2), (std::vector<uint64_t>{3, 7}));
+  EXPECT_GT(calls, 0);
+  tailer.stop();
+  search.stop();
+}
@@ -0,0 +1,173 @@
+#include "ui/log_box/log_tailer.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ui/log_box/log_line.h"
+#include "utils/testing.h"
+
+namespace {
+
+class LogTailerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() /
+           std::format("tradercpp_log_{}_{}", ::getpid(),
+                       ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    std::filesystem::remove_all(dir_);
+    std::filesystem::create_directories(dir_);
+    path_ = dir_ / "trader.log";
+  }
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  void append(const std::string_view text) const {
+    std::ofstream(path_, std::ios::app) << text;
+  }
+
+  static std::vector<std::string> lines(const ui::LogTailer& tailer) {
+    std::vector<std::string> out;
+    tailer.read_lines(tailer.get_first_line(), tailer.get_line_count(),
+                      [&out](uint64_t, const ui::LogLineMeta&,
+                             const std::string_view line) { out.emplace_back(line); });
+    return out;
+  }
+
+  std::filesystem::path dir_;
+  std::filesystem::path path_;
+};
+
+}  // namespace
+
+TEST_F(LogTailerTest, IndexesCompleteLines) {
+  append("one\ntwo\nthr");
+  ui::LogTailer tailer(path_);
+  EXPECT_TRUE(tailer.poll_file());
+  EXPECT_EQ(lines(tailer), (std::vector<std::string>{"one", "two"}));
+
+  // the partial line completes
+  append("ee\n\nfour\n");
+  EXPECT_TRUE(tailer.poll_file());
+  EXPECT_FALSE(tailer.poll_file());
+  EXPECT_EQ(lines(tailer), (std::vector<std::string>{"one", "two", "three", "", "four"}));
+
+  std::vector<std::string> window;
+  tailer.read_lines(
+      3, 10, [&window](uint64_t, const ui::LogLineMeta&, const std::string_view line) {
+        window.emplace_back(line);
+      });
+  EXPECT_EQ(window, (std::vector<std::string>{"", "four"}));
+}
+
+TEST_F(LogTailerTest, WaitsForTheFile) {
+  ui::LogTailer tailer(path_);
+  EXPECT_FALSE(tailer.poll_file());
+  append("one\n");
+  EXPECT_TRUE(tailer.poll_file());
+  EXPECT_EQ(lines(tailer), (std::vector<std::string>{"one"}));
+}
+
+TEST_F(LogTailerTest, FollowsTruncation) {
+  append("one\ntwo\nthr");
+  ui::LogTailer tailer(path_);
+  tailer.poll_file();
+
+  std::ofstream(path_, std::ios::trunc) << "four\n";
+  EXPECT_TRUE(tailer.poll_file());
+  EXPECT_EQ(lines(tailer), (std::vector<std::string>{"one", "two", "thr", "four"}));
+}
+
+TEST_F(LogTailerTest, FollowsRotation) {
+  append("one\ntwo\n");
+  ui::LogTailer tailer(path_);
+  tailer.poll_file();
+
+  // written to the old file before it was rotated, and the new one
+  append("three\n");
+  std::filesystem::rename(path_, dir_ / "trader.log.1");
+  append("four\n");
+  EXPECT_TRUE(tailer.poll_file());
+  EXPECT_EQ(lines(tailer), (std::vector<std::string>{"one", "two", "three", "four"}));
+
+  // deleted, then recreated
+  std::filesystem::remove(path_);
+  EXPECT_FALSE(tailer.poll_file());
+  append("five\n");
+  EXPECT_TRUE(tailer.poll_file());
+  EXPECT_EQ(lines(tailer).back(), "five");
+}
+
+TEST_F(LogTailerTest, DropsTheOldestLines) {
+  // the smallest budget: one read's worth
+  ui::LogTailer tailer(path_, 0);
+  const std::string line(99, 'x');
+  for (int i = 0; i < 2'000; ++i) {
+    append(std::format("{}\n", i) + line + "\n");
+  }
+  tailer.poll_file();
+
+  const std::vector<std::string> held = lines(tailer);
+  EXPECT_GT(tailer.get_first_line(), 0u);
+  EXPECT_EQ(tailer.get_first_line() + held.size(), 4'000u);
+  EXPECT_EQ(held[held.size() - 2], "1999");
+  EXPECT_EQ(held.back(), line);
+}
+
+TEST_F(LogTailerTest, ReportsAppendsATrimOffsets) {
+  // the smallest budget, 64 KiB. 1 KiB lines: half of it holds 32 of them
+  ui::LogTailer tailer(path_, 0);
+  const auto append_lines = [this](const int first, const int count) {
+    for (int i = first; i < first + count; ++i) {
+      append(std::format("{:05}", i) + std::string(1'018, 'x') + "\n");
+    }
+  };
+  append_lines(0, 32);
+  ASSERT_TRUE(tailer.poll_file());
+  ASSERT_EQ(tailer.get_line_count(), 32u);
+
+  // 40 more overflow the budget, and the trim drops 40: the same line count
+  append_lines(32, 40);
+  EXPECT_TRUE(tailer.poll_file());
+  EXPECT_EQ(tailer.get_line_count(), 32u);
+  EXPECT_EQ(tailer.get_first_line(), 40u);
+  EXPECT_TRUE(lines(tailer).back().starts_with("00071"));
+}
+
+TEST_F(LogTailerTest, NotifiesOnAppend) {
+  append("one\n");
+  ui::LogTailer tailer(path_);
+  std::atomic<int> calls = 0;
+  tailer.set_callback([&calls] { ++calls; });
+  tailer.start();
+  ASSERT_TRUE(utils::Testing::wait_for([&] { return calls == 1; }, 1000));
+
+  append("two\n");
+  ASSERT_TRUE(utils::Testing::wait_for([&] { return calls == 2; }, 1000));
+  EXPECT_EQ(lines(tailer), (std::vector<std::string>{"one", "two"}));
+  tailer.stop();
+}
+
+TEST_F(LogTailerTest, IndexesTheLogPattern) {
+  append("[2025-01-02 03:04:05.678] [warning] [4242] feed stalled\n  at the gateway\n");
+  ui::LogTailer tailer(path_);
+  tailer.poll_file();
+
+  std::vector<ui::LogLineMeta> metas;
+  tailer.read_lines(0, 2,
+                    [&metas](uint64_t, const ui::LogLineMeta& meta, std::string_view) {
+                      metas.push_back(meta);
+                    });
+  ASSERT_EQ(metas.size(), 2u);
+  EXPECT_EQ(metas[0].level, ui::LogLevel::warning);
+  EXPECT_EQ(metas[0].thread_id, 4242u);
+  // a continuation line belongs with the line above
+  EXPECT_EQ(metas[1], metas[0]);
+}
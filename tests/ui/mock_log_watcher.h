@@ -1,22 +1,29 @@
 #pragma once
 
-#include <functional>
-#include <string>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 #include "ui/log_box/ilog_watcher.h"
 
 namespace ui {
 
 class MockLogWatcher : public ILogWatcher {
-  using Callback = std::function<void(std::vector<std::string>)>;
-
  public:
   explicit MockLogWatcher() = default;
 
   void set_callback([[maybe_unused]] Callback cb) override {}
 
   void start() override {};
+
+  void stop() override {};
+
+  uint64_t get_first_line() const override { return 0; }
+
+  size_t get_line_count() const override { return 0; }
+
+  void read_lines([[maybe_unused]] uint64_t first,
+                  [[maybe_unused]] size_t count,
+                  [[maybe_unused]] const LineFn& fn) const override {}
 };
 
 }  // namespace ui
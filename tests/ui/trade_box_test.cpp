@@ -3,36 +3,32 @@
 #include <gtest/gtest.h>
 #include <quickfix/fix44/MarketDataIncrementalRefresh.h>
 
-#include <chrono>
 #include <ftxui/dom/elements.hpp>
 #include <ftxui/dom/node.hpp>
 #include <ftxui/screen/screen.hpp>
-#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "binance/config.h"
-#include "binance/side.h"
-#include "binance/symbol.h"
-#include "ui/app/iscreen.h"
-#include "utils/double.h"
+#include "binance/market_message_variant.h"
+#include "concurrentqueue.h"
+#include "engine/engine.h"
 #include "utils/testing.h"
 
-class DummyScreen : public ui::IScreen {
- public:
-  void post_event(const ftxui::Event&) override {}
-  void loop([[maybe_unused]] ftxui::Component renderer) override {}
-};
-
 class TradeBoxTest : public ::testing::Test {
  protected:
-  DummyScreen screen_;
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> order_queue_;
   moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> queue_;
+  engine::Engine engine_{order_queue_, queue_};
   std::unique_ptr<ui::TradeBox> trade_box_;
   binance::Config config_{"", "", "", std::vector<std::string>{}, 0, 0};
 
   void SetUp() override {
-    trade_box_ = std::make_unique<ui::TradeBox>(screen_, config_, queue_);
-    trade_box_->start();
+    trade_box_ = std::make_unique<ui::TradeBox>(engine_, config_);
+    engine_.start();
   }
+  void TearDown() override { engine_.stop(); }
 };
 
 FIX44::MarketDataIncrementalRefresh create_valid_trade_message() {
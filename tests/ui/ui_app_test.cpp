@@ -11,16 +11,19 @@
 #include "binance/market_message_variant.h"
 #include "concurrentqueue.h"
 #include "core/order_book.h"
+#include "engine/engine.h"
 #include "fake_screen.h"
 #include "mock_log_watcher.h"
 #include "spdlog/spdlog.h"
 #include "ui/app/iscreen.h"
 #include "ui/log_box/ilog_watcher.h"
 #include "ui/log_box/log_box.h"
+#include "utils/testing.h"
 
 TEST(App, start) {
   // create app
   std::unique_ptr<ui::IScreen> screen = std::make_unique<FakeScreen>();
+  auto* fake_screen = static_cast<FakeScreen*>(screen.get());
 
   std::unique_ptr<ui::ILogWatcher> log_reader = std::make_unique<ui::MockLogWatcher>();
   auto log_box = std::make_unique<ui::LogBox>(*screen.get(), std::move(log_reader));
@@ -29,15 +32,16 @@ TEST(App, start) {
   moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> trade_queue{};
 
   constexpr int MAX_DEPTH = 50;
-  auto book_box = std::make_unique<ui::OrderBookBox>(*screen, order_queue, MAX_DEPTH);
+  engine::Engine engine(order_queue, trade_queue, MAX_DEPTH);
+  auto book_box = std::make_unique<ui::OrderBookBox>(engine);
   binance::Config bconf{"", "", "", std::vector<std::string>{}, 0, 0};
-  auto trade_box = std::make_unique<ui::TradeBox>(
-      *screen, bconf, trade_queue,
-      []([[maybe_unused]] const std::stop_token& stoken) { spdlog::info("mock task"); });
+  auto trade_box = std::make_unique<ui::TradeBox>(engine, bconf);
 
-  auto app = ui::App(std::move(screen), std::move(book_box), std::move(log_box),
-                     std::move(trade_box));
+  auto app = ui::App(std::move(screen), engine, std::move(book_box), std::move(log_box),
+                     std::move(trade_box), bconf);
+  // FakeScreen::loop returns straight away
   app.start();
+  EXPECT_TRUE(fake_screen->loop_called);
 
   // publish update
   FIX44::MarketDataSnapshotFullRefresh message;
@@ -56,6 +60,10 @@ TEST(App, start) {
   message.addGroup(ask);
   // push
   order_queue.enqueue(binance::MarketMessageVariant{message});
+  engine.start();
 
-  // TODO: how to assert this? how to evaluate the UI change based on the input message?
+  // the UI reads what the engine published
+  ASSERT_TRUE(
+      utils::Testing::wait_for([&] { return engine.get_book().row_count == 1; }, 1000));
+  engine.stop();
 }
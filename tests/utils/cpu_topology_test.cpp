@@ -0,0 +1,101 @@
+#include "utils/cpu_topology.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using utils::CpuTopology;
+using utils::LogicalCpu;
+
+namespace {
+
+class CpuTopologyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    root_ = std::filesystem::temp_directory_path() /
+            std::format("tradercpp_cpu_{}_{}", ::getpid(),
+                        ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    std::filesystem::remove_all(root_);
+    std::filesystem::create_directories(root_);
+  }
+  void TearDown() override { std::filesystem::remove_all(root_); }
+
+  void write(const std::filesystem::path& relative, const std::string& text) const {
+    std::filesystem::create_directories((root_ / relative).parent_path());
+    std::ofstream(root_ / relative) << text << "\n";
+  }
+
+  /// @brief a cpu as sysfs has it
+  void write_cpu(const unsigned id,
+                 const std::string& siblings,
+                 const unsigned package,
+                 const std::string& l3_shared,
+                 const unsigned node) const {
+    const std::string cpu = std::format("cpu{}", id);
+    write(cpu + "/topology/thread_siblings_list", siblings);
+    write(cpu + "/topology/physical_package_id", std::to_string(package));
+    write(cpu + "/cache/index0/level", "1");
+    write(cpu + "/cache/index0/shared_cpu_list", std::to_string(id));
+    write(cpu + "/cache/index3/level", "3");
+    write(cpu + "/cache/index3/shared_cpu_list", l3_shared);
+    std::filesystem::create_directories(root_ / cpu / std::format("node{}", node));
+  }
+
+  std::filesystem::path root_;
+};
+
+}  // namespace
+
+TEST(CpuList, ParsesAndFormats) {
+  EXPECT_EQ(CpuTopology::parse_cpu_list("0-3,8,10-11"),
+            (std::vector<unsigned>{0, 1, 2, 3, 8, 10, 11}));
+  EXPECT_EQ(CpuTopology::parse_cpu_list("5,1,1-2"), (std::vector<unsigned>{1, 2, 5}));
+  EXPECT_TRUE(CpuTopology::parse_cpu_list("").empty());
+  EXPECT_THROW(CpuTopology::parse_cpu_list("0-"), std::runtime_error);
+  EXPECT_THROW(CpuTopology::parse_cpu_list("3-1"), std::runtime_error);
+  EXPECT_THROW(CpuTopology::parse_cpu_list("a"), std::runtime_error);
+
+  const std::vector<unsigned> cpus = {0, 1, 2, 3, 8, 10, 11};
+  EXPECT_EQ(CpuTopology::to_cpu_list(cpus), "0-3,8,10-11");
+  EXPECT_EQ(CpuTopology::to_cpu_list({}), "");
+}
+
+TEST_F(CpuTopologyTest, ReadsSysfs) {
+  // two packages of two SMT cores, one L3 each. cpu 5 is offline
+  write("online", "0-4,6-7");
+  write("isolated", "2-3,6-7");
+  write_cpu(0, "0,4", 0, "0-1,4-5", 0);
+  write_cpu(1, "1,5", 0, "0-1,4-5", 0);
+  write_cpu(2, "2,6", 1, "2-3,6-7", 1);
+  write_cpu(3, "3,7", 1, "2-3,6-7", 1);
+  write_cpu(4, "0,4", 0, "0-1,4-5", 0);
+  write_cpu(6, "2,6", 1, "2-3,6-7", 1);
+  write_cpu(7, "3,7", 1, "2-3,6-7", 1);
+
+  const CpuTopology topology = CpuTopology::from_sysfs(root_);
+  ASSERT_EQ(topology.get_cpus().size(), 7u);
+  EXPECT_EQ(*topology.find(0),
+            (LogicalCpu{.id = 0, .core = 0, .package = 0, .l3 = 0, .numa_node = 0}));
+  EXPECT_EQ(*topology.find(7),
+            (LogicalCpu{.id = 7, .core = 3, .package = 1, .l3 = 2, .numa_node = 1}));
+  EXPECT_EQ(topology.find(5), nullptr);
+  EXPECT_EQ(topology.get_isolated(), (std::vector<unsigned>{2, 3, 6, 7}));
+}
+
+TEST_F(CpuTopologyTest, FallsBackWithoutDetail) {
+  // e.g. a VM: no topology, no caches, no isolation
+  write("online", "0-1");
+  const CpuTopology topology = CpuTopology::from_sysfs(root_);
+  ASSERT_EQ(topology.get_cpus().size(), 2u);
+  EXPECT_EQ(*topology.find(1),
+            (LogicalCpu{.id = 1, .core = 1, .package = 0, .l3 = 0, .numa_node = 0}));
+  EXPECT_TRUE(topology.get_isolated().empty());
+
+  EXPECT_THROW(CpuTopology::from_sysfs(root_ / "missing"), std::runtime_error);
+}
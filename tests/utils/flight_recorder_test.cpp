@@ -0,0 +1,121 @@
+#include "utils/flight_recorder.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <csignal>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "utils/crash.h"
+#include "utils/threading.h"
+
+namespace {
+
+std::filesystem::path dump_path(const std::string& test) {
+  return std::filesystem::temp_directory_path() /
+         std::format("tradercpp_flight_{}_{}.bin", test, ::getpid());
+}
+
+utils::FlightRecorder::Dump dump_and_read(const utils::FlightRecorder& recorder,
+                                          const std::filesystem::path& path) {
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  EXPECT_NE(file, nullptr);
+  EXPECT_TRUE(recorder.dump(::fileno(file), SIGSEGV));
+  std::fclose(file);
+  std::ifstream in(path, std::ios::binary);
+  auto dump = utils::FlightRecorder::read_dump(in);
+  std::filesystem::remove(path);
+  return dump;
+}
+
+}  // namespace
+
+TEST(FlightRecorder, DumpsEachThreadsRingOldestFirst) {
+  utils::FlightRecorder recorder(4, 8);
+  recorder.record(utils::FlightEvent::FIX_SNAPSHOT, 0, 1);
+  std::jthread([&recorder] {
+    utils::Threading::set_thread_name("flight_test");
+    // wraps: only the last 8 are kept
+    for (uint64_t i = 0; i < 10; ++i) {
+      recorder.record(utils::FlightEvent::BOOK_APPLY, 1, i, 0);
+    }
+  }).join();
+
+  const auto dump = dump_and_read(recorder, dump_path("rings"));
+  EXPECT_EQ(dump.header.signal, SIGSEGV);
+  EXPECT_EQ(dump.header.capacity, 8u);
+  ASSERT_EQ(dump.threads.size(), 2u);
+
+  ASSERT_EQ(dump.threads[0].records.size(), 1u);
+  EXPECT_EQ(dump.threads[0].records[0].event, utils::FlightEvent::FIX_SNAPSHOT);
+
+  const auto& worker = dump.threads[1];
+  EXPECT_EQ(worker.name, "flight_test");
+  EXPECT_EQ(worker.recorded, 10u);
+  ASSERT_EQ(worker.records.size(), 8u);
+  for (uint64_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(worker.records[i].b, i + 2);
+  }
+  EXPECT_LE(worker.records.front().ticks, worker.records.back().ticks);
+  EXPECT_LE(worker.records.back().ticks, dump.header.dump_ticks);
+}
+
+TEST(FlightRecorder, ThreadsBeyondTheRingsRecordNothing) {
+  utils::FlightRecorder recorder(1, 4);
+  recorder.record(utils::FlightEvent::TRADES, 1, 1, 0);
+  std::jthread([&recorder] { recorder.record(utils::FlightEvent::TRADES, 1, 2, 0); })
+      .join();
+
+  const auto dump = dump_and_read(recorder, dump_path("full"));
+  ASSERT_EQ(dump.threads.size(), 1u);
+  ASSERT_EQ(dump.threads[0].records.size(), 1u);
+  EXPECT_EQ(dump.threads[0].records[0].b, 1u);
+}
+
+TEST(FlightRecorder, PrintsOneTimeline) {
+  utils::FlightRecorder recorder(2, 4);
+  recorder.record(utils::FlightEvent::BOOK_PUBLISH, 5, 42, 3);
+
+  std::ostringstream out;
+  utils::FlightRecorder::print_dump(dump_and_read(recorder, dump_path("print")), out);
+  EXPECT_NE(out.str().find("signal [11]"), std::string::npos);
+  EXPECT_NE(out.str().find("BOOK_PUBLISH  a [5] b [42] c [3]"), std::string::npos);
+}
+
+TEST(FlightRecorder, RejectsOtherFiles) {
+  std::istringstream garbage("not a dump, long enough to fill a dump header");
+  EXPECT_THROW(utils::FlightRecorder::read_dump(garbage), std::runtime_error);
+  std::istringstream empty;
+  EXPECT_THROW(utils::FlightRecorder::read_dump(empty), std::runtime_error);
+}
+
+TEST(FlightRecorder, CrashHandlerDumpsTheGlobalRecorder) {
+  const auto path = dump_path("crash");
+  EXPECT_EXIT(
+      {
+        utils::FlightRecorder::global().record(utils::FlightEvent::FIX_INCREMENT, 2, 77);
+        utils::FlightRecorder::set_dump_path(path.string());
+        utils::Crash::handle_signal(SIGSEGV);
+      },
+      ::testing::ExitedWithCode(1), "Fatal signal caught: 11");
+
+  std::ifstream in(path, std::ios::binary);
+  ASSERT_TRUE(in);
+  const auto dump = utils::FlightRecorder::read_dump(in);
+  std::filesystem::remove(path);
+  // other tests' threads may have recorded into the global recorder too
+  bool found = false;
+  for (const auto& thread : dump.threads) {
+    for (const auto& record : thread.records) {
+      found |= record.event == utils::FlightEvent::FIX_INCREMENT && record.b == 77;
+    }
+  }
+  EXPECT_TRUE(found);
+}
@@ -0,0 +1,79 @@
+#include "utils/jitter_probe.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utils/threading.h"
+
+using utils::JitterProbe;
+using utils::JitterReport;
+
+TEST(JitterReport, BucketsGapsByPowersOfTwo) {
+  EXPECT_EQ(JitterReport::to_bucket(0), 0u);
+  EXPECT_EQ(JitterReport::to_bucket(999), 0u);
+  EXPECT_EQ(JitterReport::to_bucket(1'000), 1u);
+  EXPECT_EQ(JitterReport::to_bucket(1'999), 1u);
+  EXPECT_EQ(JitterReport::to_bucket(2'000), 2u);
+  EXPECT_EQ(JitterReport::to_bucket(1'023'999), 10u);
+  EXPECT_EQ(JitterReport::to_bucket(1'024'000), 11u);
+  EXPECT_EQ(JitterReport::to_bucket(60'000'000'000), JitterReport::BUCKETS - 1);
+}
+
+TEST(JitterReport, CountsAndFormats) {
+  JitterReport report{.cpu = 3, .duration = std::chrono::milliseconds(500)};
+  report.samples = 100;
+  report.add(1'500);
+  report.add(3'000);
+  report.add(2'000'000);
+  EXPECT_EQ(report.interruptions, 3u);
+  EXPECT_EQ(report.total_gap_ns, 2'004'500u);
+  EXPECT_EQ(report.max_gap_ns, 2'000'000u);
+  EXPECT_EQ(report.histogram[1], 1u);
+  EXPECT_EQ(report.histogram[2], 1u);
+  EXPECT_EQ(report.histogram[11], 1u);
+
+  const std::string line = report.format_metrics();
+  EXPECT_TRUE(line.starts_with("jitter_cpu=3 seconds=0.500 samples=100 interruptions=3 "
+                               "total_gap_ns=2004500 max_gap_ns=2000000 gaps_lt1us=0 "
+                               "gaps_lt2us=1 gaps_lt4us=1 "))
+      << line;
+  EXPECT_TRUE(line.ends_with(" gaps_lt1024us=0 gaps_ge1024us=1")) << line;
+}
+
+TEST(JitterProbe, ProbesForTheDuration) {
+  const JitterProbe probe(std::chrono::milliseconds(20), std::chrono::nanoseconds(1'000),
+                          std::chrono::seconds(10));
+  const auto start = std::chrono::steady_clock::now();
+  const JitterReport report = probe.probe_current_thread(0);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  EXPECT_GE(elapsed, std::chrono::milliseconds(15));
+  EXPECT_GT(report.samples, 1'000u);
+  EXPECT_LE(report.interruptions, report.samples);
+  EXPECT_LE(report.total_gap_ns, static_cast<uint64_t>(elapsed.count()));
+  EXPECT_TRUE(probe.is_quiet(report));
+}
+
+TEST(JitterProbe, ProbesEachCpu) {
+  const std::vector<unsigned> allowed = utils::Threading::get_allowed_cpus();
+  const std::vector<unsigned> cpus(allowed.begin(),
+                                   allowed.begin() + std::min<size_t>(allowed.size(), 2));
+  const JitterProbe probe(std::chrono::milliseconds(5));
+  const std::vector<JitterReport> reports = probe.run(cpus);
+  ASSERT_EQ(reports.size(), cpus.size());
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    EXPECT_EQ(reports[i].cpu, cpus[i]);
+    EXPECT_GT(reports[i].samples, 0u);
+  }
+}
+
+TEST(JitterProbe, RejectsANonPositiveDuration) {
+  EXPECT_THROW(JitterProbe(std::chrono::nanoseconds(0)), std::runtime_error);
+  EXPECT_THROW(JitterProbe(std::chrono::milliseconds(1), std::chrono::nanoseconds(0)),
+               std::runtime_error);
+}
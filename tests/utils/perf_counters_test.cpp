@@ -0,0 +1,45 @@
+#include "utils/perf_counters.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+using Set = utils::PerfCounters::Set;
+
+TEST(PerfCounters, ParseSets) {
+  EXPECT_TRUE(utils::PerfCounters::parse_sets("none").empty());
+  EXPECT_TRUE(utils::PerfCounters::parse_sets("").empty());
+  EXPECT_EQ(utils::PerfCounters::parse_sets("all"),
+            (std::vector{Set::CORE, Set::CACHE, Set::TLB}));
+  EXPECT_EQ(utils::PerfCounters::parse_sets("tlb,core"),
+            (std::vector{Set::TLB, Set::CORE}));
+  EXPECT_THROW(utils::PerfCounters::parse_sets("core,bogus"), std::runtime_error);
+  EXPECT_THROW(utils::PerfCounters::parse_sets("core,"), std::runtime_error);
+}
+
+TEST(PerfCounters, CountsInstructions) {
+  const std::vector sets{Set::CORE};
+  utils::PerfCounters counters(sets);
+  if (!counters.is_available()) {
+    GTEST_SKIP() << "perf_event_open not permitted here";
+  }
+
+  counters.start();
+  volatile uint64_t sum = 0;
+  for (uint64_t i = 0; i < 1'000'000; ++i) {
+    sum = sum + i;
+  }
+  counters.stop();
+
+  double instructions = 0;
+  for (const auto& reading : counters.read()) {
+    if (reading.name == "instructions") {
+      instructions = reading.value;
+    }
+  }
+  // at least a load, an add and a store per iteration
+  EXPECT_GT(instructions, 1'000'000.0);
+}
@@ -0,0 +1,216 @@
+#include "utils/run_loop.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/async_queue.h"
+
+using namespace std::chrono_literals;
+using utils::RunLoop;
+using utils::Task;
+
+namespace {
+
+/// @brief what the coroutines saw, in the order they saw it
+struct Trace {
+  std::mutex mutex;
+  std::vector<std::string> events;
+
+  void add(const std::string& event) {
+    std::lock_guard lock(mutex);
+    events.push_back(event);
+  }
+  std::vector<std::string> get() {
+    std::lock_guard lock(mutex);
+    return events;
+  }
+};
+
+Task sleep_then(Trace& trace,
+                const std::string name,
+                const std::chrono::milliseconds timeout,
+                const std::stop_token stoken) {
+  const bool is_slept = co_await RunLoop::sleep_for(timeout, stoken);
+  trace.add(name + (is_slept ? " slept" : " stopped"));
+}
+
+Task read_pipe(Trace& trace,
+               const int fd,
+               const std::chrono::milliseconds timeout,
+               const std::stop_token stoken) {
+  while (!stoken.stop_requested()) {
+    const bool is_ready = co_await RunLoop::readable(fd, timeout, stoken);
+    if (!is_ready) {
+      trace.add("timeout");
+      continue;
+    }
+    char c = 0;
+    if (::read(fd, &c, 1) != 1) {
+      co_return;
+    }
+    trace.add(std::string(1, c));
+  }
+}
+
+Task consume(Trace& trace, utils::AsyncQueue<int>& queue, const std::stop_token stoken) {
+  for (;;) {
+    const std::optional<int> value = co_await queue.pop(stoken);
+    if (!value) {
+      break;
+    }
+    trace.add(std::to_string(*value));
+    co_await RunLoop::yield();
+  }
+  trace.add("stopped");
+}
+
+Task throw_after(const std::chrono::milliseconds timeout) {
+  co_await RunLoop::sleep_for(timeout, {});
+  throw std::runtime_error("boom");
+}
+
+}  // namespace
+
+TEST(RunLoop, SleepsWakeInDeadlineOrder) {
+  RunLoop loop("test_loop");
+  loop.start();
+  Trace trace;
+  const auto start = std::chrono::steady_clock::now();
+  const utils::TaskHandle slow = loop.spawn(sleep_then(trace, "slow", 30ms, {}));
+  const utils::TaskHandle fast = loop.spawn(sleep_then(trace, "fast", 10ms, {}));
+  slow.wait();
+  fast.wait();
+  EXPECT_GE(std::chrono::steady_clock::now() - start, 30ms);
+  const std::vector<std::string> check = {"fast slept", "slow slept"};
+  EXPECT_EQ(trace.get(), check);
+}
+
+TEST(RunLoop, StopRequestWakesASleep) {
+  RunLoop loop("test_loop");
+  loop.start();
+  Trace trace;
+  std::stop_source stop;
+  const utils::TaskHandle task =
+      loop.spawn(sleep_then(trace, "sleeper", 1h, stop.get_token()));
+  std::this_thread::sleep_for(5ms);
+  EXPECT_FALSE(task.is_done());
+  stop.request_stop();
+  task.wait();
+  const std::vector<std::string> check = {"sleeper stopped"};
+  EXPECT_EQ(trace.get(), check);
+}
+
+TEST(RunLoop, ResumesOnReadableOrTimeout) {
+  std::array<int, 2> fds{};
+  ASSERT_EQ(::pipe(fds.data()), 0);
+  RunLoop loop("test_loop");
+  loop.start();
+  Trace trace;
+  std::stop_source stop;
+  const utils::TaskHandle task =
+      loop.spawn(read_pipe(trace, fds[0], 20ms, stop.get_token()));
+  // nothing to read: times out
+  std::this_thread::sleep_for(50ms);
+  ASSERT_EQ(::write(fds[1], "ab", 2), 2);
+  std::this_thread::sleep_for(10ms);
+  stop.request_stop();
+  task.wait();
+  ::close(fds[0]);
+  ::close(fds[1]);
+
+  const std::vector<std::string> events = trace.get();
+  ASSERT_FALSE(events.empty());
+  EXPECT_EQ(events.front(), "timeout");
+  // one byte per wake: the descriptor is still readable after the first
+  std::vector<std::string> bytes;
+  std::ranges::copy_if(events, std::back_inserter(bytes),
+                       [](const std::string& event) { return event != "timeout"; });
+  EXPECT_EQ(bytes, (std::vector<std::string>{"a", "b"}));
+}
+
+TEST(RunLoop, QueuePushedFromAnotherThread) {
+  RunLoop loop("test_loop");
+  loop.start();
+  Trace trace;
+  utils::AsyncQueue<int> queue;
+  std::stop_source stop;
+  const utils::TaskHandle task = loop.spawn(consume(trace, queue, stop.get_token()));
+  std::jthread producer([&queue] {
+    for (int i = 0; i < 100; ++i) {
+      queue.push(i);
+    }
+  });
+  producer.join();
+  while (trace.get().size() < 100) {
+    std::this_thread::sleep_for(1ms);
+  }
+  stop.request_stop();
+  task.wait();
+
+  std::vector<std::string> check;
+  for (int i = 0; i < 100; ++i) {
+    check.push_back(std::to_string(i));
+  }
+  check.emplace_back("stopped");
+  EXPECT_EQ(trace.get(), check);
+}
+
+TEST(RunLoop, KeepsTheTaskException) {
+  RunLoop loop("test_loop");
+  loop.start();
+  const utils::TaskHandle task = loop.spawn(throw_after(1ms));
+  task.wait();
+  ASSERT_TRUE(task.get_exception());
+  EXPECT_THROW(std::rethrow_exception(task.get_exception()), std::runtime_error);
+
+  // the loop carries on
+  Trace trace;
+  loop.spawn(sleep_then(trace, "after", 1ms, {})).wait();
+  EXPECT_EQ(trace.get().size(), 1u);
+}
+
+TEST(RunLoop, StopDestroysSuspendedTasks) {
+  Trace trace;
+  utils::AsyncQueue<int> queue;
+  utils::TaskHandle sleeper;
+  utils::TaskHandle consumer;
+  {
+    RunLoop loop("test_loop");
+    loop.start();
+    sleeper = loop.spawn(sleep_then(trace, "sleeper", 1h, {}));
+    consumer = loop.spawn(consume(trace, queue, {}));
+    std::this_thread::sleep_for(5ms);
+    EXPECT_FALSE(sleeper.is_done());
+  }
+  EXPECT_TRUE(sleeper.is_done());
+  EXPECT_TRUE(consumer.is_done());
+  EXPECT_FALSE(sleeper.get_exception());
+  // unregistered: pushes wake no one
+  queue.push(1);
+  EXPECT_TRUE(trace.get().empty());
+}
+
+TEST(RunLoop, SpawnAfterStopIsDone) {
+  RunLoop loop("test_loop");
+  loop.start();
+  loop.stop();
+  Trace trace;
+  // never to run: its waiter must not block
+  const utils::TaskHandle task = loop.spawn(sleep_then(trace, "late", 1ms, {}));
+  EXPECT_TRUE(task.is_done());
+  task.wait();
+  EXPECT_TRUE(trace.get().empty());
+}
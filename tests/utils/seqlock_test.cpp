@@ -0,0 +1,71 @@
+#include "utils/seqlock.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+/// @brief every element holds the same value, a torn read would mix two writes
+struct Payload {
+  std::array<uint64_t, 32> values{};
+};
+
+}  // namespace
+
+TEST(SeqLock, StoreLoad) {
+  utils::SeqLock<uint64_t> lock{7};
+  EXPECT_EQ(lock.load(), 7u);
+  EXPECT_EQ(lock.version(), 0u);
+
+  lock.store(8);
+  lock.write([](uint64_t& v) { ++v; });
+  EXPECT_EQ(lock.load(), 9u);
+  EXPECT_EQ(lock.version(), 2u);
+}
+
+TEST(SeqLock, ConcurrentReadersNeverSeeTornWrites) {
+  utils::SeqLock<Payload> lock;
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> torn{0};
+  std::atomic<uint64_t> reads{0};
+
+  std::array<std::jthread, 3> readers;
+  for (auto& reader : readers) {
+    reader = std::jthread([&] {
+      uint64_t last = 0;
+      do {
+        const Payload p = lock.load();
+        for (const uint64_t v : p.values) {
+          if (v != p.values[0]) {
+            torn.fetch_add(1, std::memory_order_relaxed);
+            break;
+          }
+        }
+        // a single writer only ever moves forward
+        if (p.values[0] < last) {
+          torn.fetch_add(1, std::memory_order_relaxed);
+        }
+        last = p.values[0];
+        reads.fetch_add(1, std::memory_order_relaxed);
+      } while (!done.load(std::memory_order_relaxed));
+    });
+  }
+
+  constexpr uint64_t WRITES = 200'000;
+  for (uint64_t i = 1; i <= WRITES; ++i) {
+    lock.write([i](Payload& p) { p.values.fill(i); });
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(torn.load(), 0u);
+  EXPECT_GT(reads.load(), 0u);
+  EXPECT_EQ(lock.load().values[0], WRITES);
+  EXPECT_EQ(lock.version(), WRITES);
+}
@@ -0,0 +1,51 @@
+#include "utils/spsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+TEST(SpscQueue, RejectsPushesWhenFull) {
+  utils::SpscQueue<int, 4> queue;
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.try_push(i));
+  }
+  EXPECT_FALSE(queue.try_push(4));
+  EXPECT_EQ(queue.size_approx(), 4u);
+
+  int out = -1;
+  EXPECT_TRUE(queue.try_pop(out));
+  EXPECT_EQ(out, 0);
+  EXPECT_TRUE(queue.try_push(4));
+  for (int i = 1; i <= 4; ++i) {
+    EXPECT_TRUE(queue.try_pop(out));
+    EXPECT_EQ(out, i);
+  }
+  EXPECT_FALSE(queue.try_pop(out));
+}
+
+TEST(SpscQueue, KeepsOrderAcrossThreads) {
+  constexpr uint64_t COUNT = 100'000;
+  auto queue = std::make_unique<utils::SpscQueue<uint64_t, 1024>>();
+  std::jthread producer([&queue] {
+    for (uint64_t i = 0; i < COUNT;) {
+      if (queue->try_push(i)) {
+        ++i;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint64_t expected = 0;
+  uint64_t out = 0;
+  while (expected < COUNT) {
+    if (queue->try_pop(out)) {
+      ASSERT_EQ(out, expected);
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
@@ -0,0 +1,165 @@
+#include "utils/thread_placement.h"
+
+#include <gtest/gtest.h>
+
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utils/cpu_topology.h"
+
+using utils::CpuTopology;
+using utils::LogicalCpu;
+using utils::ThreadPlacement;
+using utils::ThreadPolicy;
+using utils::ThreadRole;
+
+namespace {
+
+/// @brief `packages` x `cores` x 2 SMT siblings, one L3 per package. sibling of cpu `c`
+/// is `c + packages * cores`, as Linux numbers them
+CpuTopology make_topology(const unsigned packages,
+                          const unsigned cores,
+                          std::vector<unsigned> isolated = {}) {
+  std::vector<LogicalCpu> cpus;
+  const unsigned physical = packages * cores;
+  for (unsigned id = 0; id < 2 * physical; ++id) {
+    const unsigned core = id % physical;
+    const unsigned package = core / cores;
+    cpus.push_back(LogicalCpu{.id = id,
+                              .core = core,
+                              .package = package,
+                              .l3 = package * cores,
+                              .numa_node = package});
+  }
+  return {std::move(cpus), std::move(isolated)};
+}
+
+std::vector<unsigned> all_cpus(const CpuTopology& topology) {
+  std::vector<unsigned> cpus;
+  for (const LogicalCpu& cpu : topology.get_cpus()) {
+    cpus.push_back(cpu.id);
+  }
+  return cpus;
+}
+
+const std::vector<ThreadPolicy> POLICY = {
+    {.thread = "px", .role = ThreadRole::HOT, .group = "book"},
+    {.thread = "book", .role = ThreadRole::HOT, .group = "book"},
+    {.thread = "tx", .role = ThreadRole::WARM, .group = "trades"},
+    {.thread = "trades", .role = ThreadRole::WARM, .group = "trades"},
+    {.thread = "ui", .role = ThreadRole::BACKGROUND},
+};
+
+std::vector<unsigned> cpus_of(const ThreadPlacement& placement,
+                              const std::string& thread) {
+  return placement.find(thread)->cpus;
+}
+
+}  // namespace
+
+TEST(ThreadPlacement, HotThreadsGetWholeCoresInOneL3) {
+  // 2 packages x 4 cores, cpus 0-7 and their siblings 8-15. cpus 4-7 and 12-15 isolated
+  const CpuTopology topology =
+      make_topology(2, 4, CpuTopology::parse_cpu_list("4-7,12-15"));
+  const std::vector<unsigned> allowed = all_cpus(topology);
+  const ThreadPlacement placement = ThreadPlacement::plan(topology, allowed, POLICY);
+
+  // the book group: a core each, on the isolated package, siblings left idle
+  EXPECT_EQ(cpus_of(placement, "px"), (std::vector<unsigned>{4}));
+  EXPECT_EQ(cpus_of(placement, "book"), (std::vector<unsigned>{5}));
+  // the trades group: packed onto one core's siblings, whole cores kept
+  EXPECT_EQ(cpus_of(placement, "tx"), (std::vector<unsigned>{6}));
+  EXPECT_EQ(cpus_of(placement, "trades"), (std::vector<unsigned>{14}));
+  // background: the housekeeping cpus
+  EXPECT_EQ(cpus_of(placement, "ui"), CpuTopology::parse_cpu_list("0-3,8-11"));
+  EXPECT_TRUE(placement.validate(topology, allowed).empty());
+}
+
+TEST(ThreadPlacement, AvoidsTheFirstCoreWithoutIsolation) {
+  const CpuTopology topology = make_topology(1, 4);
+  const std::vector<unsigned> allowed = all_cpus(topology);
+  const ThreadPlacement placement = ThreadPlacement::plan(topology, allowed, POLICY);
+
+  EXPECT_EQ(cpus_of(placement, "px"), (std::vector<unsigned>{1}));
+  EXPECT_EQ(cpus_of(placement, "book"), (std::vector<unsigned>{2}));
+  EXPECT_EQ(cpus_of(placement, "tx"), (std::vector<unsigned>{3}));
+  EXPECT_EQ(cpus_of(placement, "trades"), (std::vector<unsigned>{7}));
+  EXPECT_EQ(cpus_of(placement, "ui"), (std::vector<unsigned>{0, 4}));
+  EXPECT_TRUE(placement.validate(topology, allowed).empty());
+}
+
+TEST(ThreadPlacement, ReportsShortfalls) {
+  // 2 cores, a cpuset of 3 of the 4 cpus: one whole core only
+  const CpuTopology topology = make_topology(1, 2);
+  const std::vector<unsigned> allowed = {0, 1, 3};
+  const ThreadPlacement placement = ThreadPlacement::plan(topology, allowed, POLICY);
+
+  EXPECT_EQ(cpus_of(placement, "px"), (std::vector<unsigned>{1}));
+  // no whole core left: a cpu, then none
+  EXPECT_EQ(cpus_of(placement, "book"), (std::vector<unsigned>{0}));
+  EXPECT_FALSE(placement.validate(topology, allowed).empty());
+  // left over threads share what there is
+  EXPECT_EQ(cpus_of(placement, "tx"), allowed);
+  EXPECT_EQ(cpus_of(placement, "ui"), allowed);
+
+  // a plan on a cpu the process cannot use
+  const std::vector<unsigned> narrower = {0, 1};
+  EXPECT_THROW(placement.validate(topology, narrower), std::runtime_error);
+}
+
+TEST(ThreadPlacement, KeepsAGroupOnItsNumaNode) {
+  // no SMT, all isolated. node 0: L3s {0,1} and {2,3}. node 1: L3s {4,5,6} and {7}
+  std::vector<LogicalCpu> cpus;
+  for (unsigned id = 0; id < 8; ++id) {
+    cpus.push_back(LogicalCpu{.id = id,
+                              .core = id,
+                              .l3 = id < 2 ? 0u : id < 4 ? 2u : id < 7 ? 4u : 7u,
+                              .numa_node = id / 4});
+  }
+  const CpuTopology topology(cpus, CpuTopology::parse_cpu_list("0-7"));
+  const std::vector<unsigned> allowed = all_cpus(topology);
+  const auto hot_group = [](const unsigned count) {
+    std::vector<ThreadPolicy> policy;
+    for (unsigned i = 0; i < count; ++i) {
+      policy.push_back(ThreadPolicy{
+          .thread = std::format("hot{}", i), .role = ThreadRole::HOT, .group = "book"});
+    }
+    return policy;
+  };
+
+  // 4 fit no L3 but fit node 0, rather than the roomiest L3 and a core of node 0
+  const ThreadPlacement four = ThreadPlacement::plan(topology, allowed, hot_group(4));
+  for (unsigned i = 0; i < 4; ++i) {
+    EXPECT_EQ(cpus_of(four, std::format("hot{}", i)), (std::vector<unsigned>{i}));
+  }
+  EXPECT_EQ(four.validate(topology, allowed),
+            (std::vector<std::string>{"group [book] spans [2] L3 domains"}));
+
+  // 5 fit no node: the roomiest L3, its node, then the other node's, reported
+  const ThreadPlacement five = ThreadPlacement::plan(topology, allowed, hot_group(5));
+  EXPECT_EQ(cpus_of(five, "hot3"), (std::vector<unsigned>{7}));
+  EXPECT_EQ(cpus_of(five, "hot4"), (std::vector<unsigned>{0}));
+  EXPECT_EQ(five.validate(topology, allowed),
+            (std::vector<std::string>{"group [book] spans [3] L3 domains",
+                                      "group [book] spans [2] NUMA nodes"}));
+}
+
+TEST(ThreadPlacement, ParsesAPolicy) {
+  EXPECT_EQ(ThreadPlacement::parse_policy("px=hot@book,ui=background,"),
+            (std::vector<ThreadPolicy>{
+                {.thread = "px", .role = ThreadRole::HOT, .group = "book"},
+                {.thread = "ui", .role = ThreadRole::BACKGROUND, .group = ""}}));
+  EXPECT_THROW(ThreadPlacement::parse_policy("px=lukewarm"), std::runtime_error);
+  EXPECT_THROW(ThreadPlacement::parse_policy("=hot"), std::runtime_error);
+  EXPECT_THROW(ThreadPlacement::parse_policy("px"), std::runtime_error);
+
+  // the default policy names the threads this app starts
+  EXPECT_NE(ThreadPlacement::parse_policy("a=warm").front().role, ThreadRole::HOT);
+  EXPECT_FALSE(ThreadPlacement::default_policy().empty());
+}
+
+TEST(ThreadPlacement, PinsOnlyWhenInstalled) {
+  EXPECT_FALSE(ThreadPlacement::pin_current_thread("px"));
+}
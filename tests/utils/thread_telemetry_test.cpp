@@ -0,0 +1,168 @@
+#include "utils/thread_telemetry.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/threading.h"
+
+using utils::NamedThread;
+using utils::ThreadSample;
+using utils::ThreadTelemetry;
+using utils::ThreadUsage;
+
+namespace {
+
+/// @brief a `stat` line: minflt (10), majflt (12), utime (14), stime (15), processor (39)
+std::string make_stat(const std::string& comm,
+                      const uint64_t minflt,
+                      const uint64_t majflt,
+                      const uint64_t utime,
+                      const uint64_t stime,
+                      const int processor) {
+  std::string stat = std::format("4242 ({}) S", comm);
+  for (int field = 4; field <= 52; ++field) {
+    uint64_t value = 0;
+    switch (field) {
+      case 10:
+        value = minflt;
+        break;
+      case 12:
+        value = majflt;
+        break;
+      case 14:
+        value = utime;
+        break;
+      case 15:
+        value = stime;
+        break;
+      case 39:
+        value = static_cast<uint64_t>(processor);
+        break;
+      default:
+        value = 1;
+    }
+    stat += std::format(" {}", value);
+  }
+  return stat + "\n";
+}
+
+class ThreadTelemetryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    root_ = std::filesystem::temp_directory_path() /
+            std::format("tradercpp_tasks_{}_{}", ::getpid(),
+                        ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    std::filesystem::remove_all(root_);
+  }
+  void TearDown() override { std::filesystem::remove_all(root_); }
+
+  void write_task(const uint64_t tid,
+                  const std::string& stat,
+                  const std::string& status,
+                  const std::string& schedstat) const {
+    const std::filesystem::path dir = root_ / std::to_string(tid);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "stat") << stat;
+    std::ofstream(dir / "status") << status;
+    std::ofstream(dir / "schedstat") << schedstat;
+  }
+
+  std::filesystem::path root_;
+};
+
+}  // namespace
+
+TEST(ThreadSample, ParsesStat) {
+  ThreadSample sample;
+  ASSERT_TRUE(ThreadSample::parse_stat(make_stat("odd) (name", 120, 3, 50, 25, 7),
+                                       10'000'000, sample));
+  EXPECT_EQ(sample.minor_faults, 120u);
+  EXPECT_EQ(sample.major_faults, 3u);
+  EXPECT_EQ(sample.cpu_time_ns, 750'000'000u);
+  EXPECT_EQ(sample.last_cpu, 7);
+
+  EXPECT_FALSE(ThreadSample::parse_stat("4242 (short) S 1 2 3", 10'000'000, sample));
+  EXPECT_FALSE(ThreadSample::parse_stat("garbage", 10'000'000, sample));
+}
+
+TEST(ThreadSample, ParsesStatusAndSchedstat) {
+  ThreadSample sample;
+  ThreadSample::parse_status(
+      "Name:\tfix_session_PX\nState:\tS (sleeping)\nvoluntary_ctxt_switches:\t150\n"
+      "nonvoluntary_ctxt_switches:\t9\n",
+      sample);
+  EXPECT_EQ(sample.voluntary_switches, 150u);
+  EXPECT_EQ(sample.involuntary_switches, 9u);
+
+  ASSERT_TRUE(ThreadSample::parse_schedstat("123456789 2000 17\n", sample));
+  EXPECT_EQ(sample.cpu_time_ns, 123'456'789u);
+  EXPECT_EQ(sample.run_delay_ns, 2'000u);
+  EXPECT_FALSE(ThreadSample::parse_schedstat("", sample));
+}
+
+TEST_F(ThreadTelemetryTest, SamplesRatesOverTheInterval) {
+  const std::vector<NamedThread> threads = {{.name = "fix_session_PX", .tid = 11},
+                                            {.name = "gone", .tid = 12}};
+  ThreadTelemetry telemetry(std::chrono::seconds(1), root_);
+  const auto start = std::chrono::steady_clock::time_point{} + std::chrono::hours(1);
+
+  write_task(11, make_stat("fix_session_PX", 100, 0, 10, 10, 2),
+             "voluntary_ctxt_switches:\t10\nnonvoluntary_ctxt_switches:\t1\n",
+             "1000000000 0 5\n");
+  EXPECT_EQ(telemetry.sample(threads, start), (std::vector<uint64_t>{12}));
+  ASSERT_EQ(telemetry.get_usage().size(), 1u);
+  EXPECT_EQ(telemetry.get_usage().front().cpu_pct, 0);  // no interval yet
+
+  // 2s later: half a cpu, 10 preemptions a second
+  write_task(11, make_stat("fix_session_PX", 300, 2, 10, 10, 3),
+             "voluntary_ctxt_switches:\t10\nnonvoluntary_ctxt_switches:\t21\n",
+             "2000000000 100000000 9\n");
+  telemetry.sample(threads, start + std::chrono::seconds(2));
+  const std::vector<ThreadUsage> usage = telemetry.get_usage();
+  ASSERT_EQ(usage.size(), 1u);
+  EXPECT_EQ(usage[0].name, "fix_session_PX");
+  EXPECT_EQ(usage[0].total.last_cpu, 3);
+  EXPECT_DOUBLE_EQ(usage[0].cpu_pct, 50.0);
+  EXPECT_DOUBLE_EQ(usage[0].run_delay_pct, 5.0);
+  EXPECT_DOUBLE_EQ(usage[0].voluntary_per_sec, 0.0);
+  EXPECT_DOUBLE_EQ(usage[0].involuntary_per_sec, 10.0);
+  EXPECT_DOUBLE_EQ(usage[0].minor_faults_per_sec, 100.0);
+  EXPECT_DOUBLE_EQ(usage[0].major_faults_per_sec, 1.0);
+  EXPECT_EQ(telemetry.get_version(), 2u);
+  EXPECT_TRUE(usage[0].format_metrics().starts_with(
+      "thread=fix_session_PX tid=11 last_cpu=3 cpu_pct=50.0 run_delay_pct=5.0 "
+      "cpu_time_ms=2000 voluntary_switches=10 involuntary_switches=21 "
+      "involuntary_per_sec=10.0 "));
+}
+
+TEST(ThreadTelemetry, SamplesNamedThreads) {
+  std::jthread thread([] { utils::Threading::set_thread_name("telemetry_test"); });
+  thread.join();
+  std::vector<NamedThread> named = utils::Threading::get_named_threads();
+  const auto it = std::ranges::find(named, "telemetry_test", &NamedThread::name);
+  ASSERT_NE(it, named.end());
+
+  // the thread exited
+  ThreadTelemetry telemetry(std::chrono::seconds(1));
+  utils::Threading::set_thread_name("telemetry_main");
+  const std::vector<NamedThread> threads = {
+      *it, {.name = "telemetry_main", .tid = utils::Threading::get_os_thread_id()}};
+  EXPECT_EQ(telemetry.sample(threads, std::chrono::steady_clock::now()),
+            (std::vector<uint64_t>{it->tid}));
+  ASSERT_EQ(telemetry.get_usage().size(), 1u);
+  EXPECT_GE(telemetry.get_usage().front().total.last_cpu, 0);
+
+  utils::Threading::forget_thread(it->tid);
+  named = utils::Threading::get_named_threads();
+  EXPECT_EQ(std::ranges::find(named, "telemetry_test", &NamedThread::name), named.end());
+}
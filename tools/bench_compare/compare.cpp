@@ -0,0 +1,156 @@
+#include "compare.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "statistics.h"
+
+namespace tools {
+
+namespace {
+
+Comparison compare_one(const std::string& name,
+                       const std::vector<double>& baseline,
+                       const std::vector<double>& contender,
+                       const bool is_hot_path,
+                       const CompareConfig& config) {
+  Comparison c;
+  c.name = name;
+  c.is_hot_path = is_hot_path;
+  c.baseline_count = baseline.size();
+  c.contender_count = contender.size();
+  c.baseline_median = median(baseline);
+  c.contender_median = median(contender);
+  if (c.baseline_median <= 0) {
+    return c;
+  }
+  c.delta = (c.contender_median - c.baseline_median) / c.baseline_median;
+
+  const Shift shift = Shift::estimate_of(baseline, contender, 1.0 - config.alpha);
+  if (shift.low && shift.high) {
+    c.delta_low = *shift.low / c.baseline_median;
+    c.delta_high = *shift.high / c.baseline_median;
+  }
+  c.p_value = MannWhitney::test(baseline, contender).p_value;
+
+  if (c.p_value < config.alpha && c.delta > config.threshold) {
+    c.verdict = c.is_hot_path ? Verdict::REGRESSION : Verdict::SLOWER;
+  } else if (c.p_value < config.alpha && c.delta < -config.threshold) {
+    c.verdict = Verdict::FASTER;
+  }
+  return c;
+}
+
+std::string format_time(const double ns) {
+  if (ns >= 1e9) {
+    return std::format("{:.3f}s", ns / 1e9);
+  }
+  if (ns >= 1e6) {
+    return std::format("{:.3f}ms", ns / 1e6);
+  }
+  if (ns >= 1e3) {
+    return std::format("{:.3f}us", ns / 1e3);
+  }
+  return std::format("{:.1f}ns", ns);
+}
+
+}  // namespace
+
+std::vector<Comparison> compare(const Results& baseline,
+                                const Results& contender,
+                                const CompareConfig& config) {
+  const std::regex hot_path(config.hot_path.empty() ? ".*" : config.hot_path);
+  std::vector<Comparison> out;
+  for (const auto& [name, values] : baseline) {
+    const bool is_hot_path = std::regex_search(name, hot_path);
+    const auto it = contender.find(name);
+    if (it == contender.end()) {
+      out.push_back({.name = name,
+                     .baseline_count = values.size(),
+                     .baseline_median = median(values),
+                     .is_hot_path = is_hot_path,
+                     .verdict = Verdict::UNMATCHED});
+      continue;
+    }
+    out.push_back(compare_one(name, values, it->second, is_hot_path, config));
+  }
+  for (const auto& [name, values] : contender) {
+    if (!baseline.contains(name)) {
+      out.push_back({.name = name,
+                     .contender_count = values.size(),
+                     .contender_median = median(values),
+                     .is_hot_path = std::regex_search(name, hot_path),
+                     .verdict = Verdict::UNMATCHED});
+    }
+  }
+  std::ranges::sort(out, {}, &Comparison::name);
+  return out;
+}
+
+std::string format_report(const std::vector<Comparison>& comparisons,
+                          const CompareConfig& config) {
+  size_t width = 9;
+  for (const Comparison& c : comparisons) {
+    width = std::max(width, c.name.size());
+  }
+  std::string out = std::format("{:<{}}  {:>12}  {:>12}  {:>8}  {:>19}  {:>7}  {:>3}\n",
+                                "Benchmark", width, "Baseline", "Contender", "Delta",
+                                "CI", "p", "n");
+  bool is_underpowered = false;
+  for (const Comparison& c : comparisons) {
+    const std::string hot = c.is_hot_path ? " (hot)" : "";
+    if (c.verdict == Verdict::UNMATCHED) {
+      const std::string baseline =
+          c.baseline_count ? format_time(c.baseline_median) : "-";
+      const std::string contender =
+          c.contender_count ? format_time(c.contender_median) : "-";
+      out += std::format("{:<{}}  {:>12}  {:>12}  {:>8}  {:>19}  {:>7}  {:>3}  {}{}\n",
+                         c.name, width, baseline, contender, "", "", "", "",
+                         to_str_view(c.verdict), hot);
+      continue;
+    }
+    const std::string ci = c.delta_low && c.delta_high
+                               ? std::format("[{:+.1f}%, {:+.1f}%]", *c.delta_low * 100,
+                                             *c.delta_high * 100)
+                               : "-";
+    is_underpowered |= !c.delta_low;
+    out += std::format(
+        "{:<{}}  {:>12}  {:>12}  {:>+7.1f}%  {:>19}  {:>7.4f}  {:>3}  {}{}\n", c.name,
+        width, format_time(c.baseline_median), format_time(c.contender_median),
+        c.delta * 100, ci, c.p_value, std::min(c.baseline_count, c.contender_count),
+        to_str_view(c.verdict), hot);
+  }
+  out += std::format("threshold [{:.1f}%], alpha [{}], hot path [{}]\n",
+                     config.threshold * 100, config.alpha,
+                     config.hot_path.empty() ? "all" : config.hot_path);
+  if (is_underpowered) {
+    out +=
+        "too few repetitions for a confidence interval on some benchmarks, "
+        "run them with --benchmark_repetitions=10\n";
+  }
+  return out;
+}
+
+std::string_view to_str_view(const Verdict verdict) {
+  switch (verdict) {
+    case Verdict::SAME:
+      return "~";
+    case Verdict::FASTER:
+      return "faster";
+    case Verdict::SLOWER:
+      return "slower";
+    case Verdict::REGRESSION:
+      return "REGRESSION";
+    case Verdict::UNMATCHED:
+      return "unmatched";
+  }
+  return "?";
+}
+
+}  // namespace tools
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tools {
+
+/// @brief per benchmark (run name), the metric of each repetition, in nanoseconds
+using Results = std::map<std::string, std::vector<double>>;
+
+/// @brief read a Google Benchmark JSON output (`--benchmark_out_format=json`).
+/// Aggregates (mean, median, ...) and failed runs are skipped, repetitions are kept.
+/// @param metric "real_time" or "cpu_time"
+/// @throws std::runtime_error when the document is not a benchmark output
+Results load_results(std::string_view json, std::string_view metric);
+
+struct CompareConfig {
+  /// @brief relative slowdown of the median that counts as a regression, e.g. 0.05
+  double threshold = 0.05;
+  /// @brief significance level of the Mann-Whitney test
+  double alpha = 0.05;
+  /// @brief ECMAScript regex on the run name: which benchmarks gate. empty: all of them
+  std::string hot_path;
+};
+
+enum class Verdict : uint8_t {
+  /// @brief no significant difference past the threshold
+  SAME = 0,
+  FASTER = 1,
+  /// @brief significantly slower past the threshold, not on the hot path
+  SLOWER = 2,
+  /// @brief significantly slower past the threshold, on the hot path
+  REGRESSION = 3,
+  /// @brief in one of the two results only
+  UNMATCHED = 4,
+};
+
+struct Comparison {
+  std::string name;
+  size_t baseline_count = 0;
+  size_t contender_count = 0;
+  double baseline_median = 0;
+  double contender_median = 0;
+  /// @brief relative change of the median, (contender - baseline) / baseline
+  double delta = 0;
+  /// @brief confidence interval of the relative shift, when enough repetitions
+  std::optional<double> delta_low = std::nullopt;
+  std::optional<double> delta_high = std::nullopt;
+  double p_value = 1;
+  bool is_hot_path = false;
+  Verdict verdict = Verdict::SAME;
+};
+
+/// @brief compare every benchmark of both results, in name order
+std::vector<Comparison> compare(const Results& baseline,
+                                const Results& contender,
+                                const CompareConfig& config);
+
+/// @brief human readable table of the comparisons
+std::string format_report(const std::vector<Comparison>& comparisons,
+                          const CompareConfig& config);
+
+std::string_view to_str_view(Verdict verdict);
+
+}  // namespace tools
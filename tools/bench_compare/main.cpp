@@ -0,0 +1,89 @@
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "compare.h"
+
+/// Compares two Google Benchmark JSON outputs, typically a checked-in baseline and a
+/// fresh run, both with `--benchmark_repetitions`, and gates on hot-path regressions.
+///
+/// usage: bench_compare <baseline.json> <contender.json>
+///          [--threshold=0.05] [--alpha=0.05] [--hot=<regex>] [--metric=real_time]
+/// exit: 0 no regression, 1 a hot-path benchmark regressed, 2 bad usage or input
+
+namespace {
+
+constexpr int EXIT_REGRESSION = 1;
+constexpr int EXIT_USAGE = 2;
+
+std::string read_file(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error(std::format("cannot open benchmark results. path [{}]", path));
+  }
+  std::ostringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+bool take_flag(const std::string_view arg, const std::string_view flag, std::string& out) {
+  if (!arg.starts_with(flag)) {
+    return false;
+  }
+  out = arg.substr(flag.size());
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    tools::CompareConfig config;
+    std::string metric = "real_time";
+    std::string value;
+    std::string paths[2];
+    int path_count = 0;
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view arg = argv[i];
+      if (take_flag(arg, "--threshold=", value)) {
+        config.threshold = std::stod(value);
+      } else if (take_flag(arg, "--alpha=", value)) {
+        config.alpha = std::stod(value);
+      } else if (take_flag(arg, "--hot=", value)) {
+        config.hot_path = value;
+      } else if (take_flag(arg, "--metric=", value)) {
+        metric = value;
+      } else if (!arg.starts_with("--") && path_count < 2) {
+        paths[path_count++] = arg;
+      } else {
+        throw std::runtime_error(std::format("unexpected argument. arg [{}]", arg));
+      }
+    }
+    if (path_count != 2) {
+      throw std::runtime_error(
+          "usage: bench_compare <baseline.json> <contender.json> [--threshold=0.05] "
+          "[--alpha=0.05] [--hot=<regex>] [--metric=real_time|cpu_time]");
+    }
+
+    const auto baseline = tools::load_results(read_file(paths[0]), metric);
+    const auto contender = tools::load_results(read_file(paths[1]), metric);
+    const auto comparisons = tools::compare(baseline, contender, config);
+    std::cout << tools::format_report(comparisons, config);
+
+    for (const auto& c : comparisons) {
+      if (c.verdict == tools::Verdict::REGRESSION) {
+        std::cout << "hot-path regression past the threshold\n";
+        return EXIT_REGRESSION;
+      }
+    }
+    return 0;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return EXIT_USAGE;
+  }
+}
@@ -0,0 +1,71 @@
+#include <boost/json.hpp>
+
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "compare.h"
+
+namespace tools {
+
+namespace {
+
+double to_nanoseconds(const std::string_view unit) {
+  if (unit == "ns") {
+    return 1;
+  }
+  if (unit == "us") {
+    return 1e3;
+  }
+  if (unit == "ms") {
+    return 1e6;
+  }
+  if (unit == "s") {
+    return 1e9;
+  }
+  throw std::runtime_error(std::format("unknown benchmark time unit. unit [{}]", unit));
+}
+
+}  // namespace
+
+Results load_results(const std::string_view json, const std::string_view metric) {
+  boost::system::error_code ec;
+  const boost::json::value root = boost::json::parse(json, ec);
+  if (ec) {
+    throw std::runtime_error(
+        std::format("invalid benchmark json. error [{}]", ec.message()));
+  }
+  const boost::json::object* doc = root.if_object();
+  const boost::json::value* benchmarks = doc ? doc->if_contains("benchmarks") : nullptr;
+  if (!benchmarks || !benchmarks->is_array()) {
+    throw std::runtime_error("not a google benchmark json output, no benchmarks array");
+  }
+
+  Results results;
+  for (const boost::json::value& entry : benchmarks->as_array()) {
+    const boost::json::object& bm = entry.as_object();
+    // repetitions are "iteration" runs, mean/median/stddev are "aggregate" runs
+    if (const auto* run_type = bm.if_contains("run_type");
+        run_type && run_type->as_string() != "iteration") {
+      continue;
+    }
+    if (const auto* error = bm.if_contains("error_occurred");
+        error && error->is_bool() && error->as_bool()) {
+      continue;
+    }
+    const auto* value = bm.if_contains(metric);
+    if (!value) {
+      throw std::runtime_error(
+          std::format("benchmark has no metric. metric [{}]", metric));
+    }
+    const auto* run_name = bm.if_contains("run_name");
+    const std::string name(run_name ? run_name->as_string() : bm.at("name").as_string());
+    const auto* unit = bm.if_contains("time_unit");
+    const double scale = unit ? to_nanoseconds(unit->as_string()) : 1;
+    results[name].push_back(boost::json::value_to<double>(*value) * scale);
+  }
+  return results;
+}
+
+}  // namespace tools
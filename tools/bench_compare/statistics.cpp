@@ -0,0 +1,121 @@
+#include "statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tools {
+
+// static
+MannWhitney MannWhitney::test(const std::span<const double> a,
+                              const std::span<const double> b) {
+  const auto n1 = static_cast<double>(a.size());
+  const auto n2 = static_cast<double>(b.size());
+  if (a.empty() || b.empty()) {
+    return {};
+  }
+
+  // rank the pooled samples, ties get the average of their ranks
+  std::vector<std::pair<double, bool>> pooled;  // value, is from `a`
+  pooled.reserve(a.size() + b.size());
+  for (const double v : a) {
+    pooled.emplace_back(v, true);
+  }
+  for (const double v : b) {
+    pooled.emplace_back(v, false);
+  }
+  std::ranges::sort(pooled, {}, &std::pair<double, bool>::first);
+
+  double rank_sum_a = 0;
+  double tie_term = 0;  // sum of t^3 - t over groups of t ties
+  for (size_t i = 0; i < pooled.size();) {
+    size_t j = i;
+    while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+      ++j;
+    }
+    const double average_rank = static_cast<double>(i + j + 1) / 2.0;
+    for (size_t k = i; k < j; ++k) {
+      if (pooled[k].second) {
+        rank_sum_a += average_rank;
+      }
+    }
+    const auto t = static_cast<double>(j - i);
+    tie_term += t * t * t - t;
+    i = j;
+  }
+
+  MannWhitney result;
+  result.u = rank_sum_a - n1 * (n1 + 1) / 2.0;
+  const double n = n1 + n2;
+  const double variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)));
+  if (variance <= 0) {
+    return result;
+  }
+  const double mean = n1 * n2 / 2.0;
+  const double distance = std::max(0.0, std::abs(result.u - mean) - 0.5);
+  const double z = distance / std::sqrt(variance);
+  result.p_value = std::min(1.0, std::erfc(z / std::numbers::sqrt2));
+  return result;
+}
+
+// static
+Shift Shift::estimate_of(const std::span<const double> a,
+                         const std::span<const double> b,
+                         const double confidence) {
+  if (a.empty() || b.empty()) {
+    return {};
+  }
+  std::vector<double> diffs;
+  diffs.reserve(a.size() * b.size());
+  for (const double x : a) {
+    for (const double y : b) {
+      diffs.push_back(y - x);
+    }
+  }
+  std::ranges::sort(diffs);
+
+  Shift shift;
+  shift.estimate = median(diffs);
+  // the interval excludes the k - 1 smallest and largest differences, where k is the
+  // critical value of U at this confidence
+  const auto n1 = static_cast<double>(a.size());
+  const auto n2 = static_cast<double>(b.size());
+  const double z = normal_quantile(0.5 + confidence / 2.0);
+  const double k =
+      std::floor(n1 * n2 / 2.0 - z * std::sqrt(n1 * n2 * (n1 + n2 + 1) / 12.0));
+  if (k >= 1) {
+    const auto i = static_cast<size_t>(k);
+    shift.low = diffs[i - 1];
+    shift.high = diffs[diffs.size() - i];
+  }
+  return shift;
+}
+
+double median(const std::span<const double> values) {
+  if (values.empty()) {
+    return 0;
+  }
+  std::vector<double> sorted(values.begin(), values.end());
+  std::ranges::sort(sorted);
+  const size_t mid = sorted.size() / 2;
+  return sorted.size() % 2 == 1 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2.0;
+}
+
+double normal_quantile(const double p) {
+  // bisection on the normal cdf, plenty fast and precise for a handful of calls
+  double low = -10;
+  double high = 10;
+  for (int i = 0; i < 100; ++i) {
+    const double mid = (low + high) / 2.0;
+    const double cdf = 0.5 * std::erfc(-mid / std::numbers::sqrt2);
+    (cdf < p ? low : high) = mid;
+  }
+  return (low + high) / 2.0;
+}
+
+}  // namespace tools
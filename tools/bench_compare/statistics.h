@@ -0,0 +1,42 @@
+#pragma once
+
+#include <optional>
+#include <span>
+
+namespace tools {
+
+/// @brief Two-sided Mann-Whitney U test: do two samples come from the same
+/// distribution? Distribution-free, so it copes with the skewed, outlier-prone timings
+/// of benchmark repetitions. Normal approximation with tie and continuity corrections,
+/// reasonable from about 5 samples per side.
+struct MannWhitney {
+  /// @brief U statistic of the first sample
+  double u = 0;
+  /// @brief probability of a difference at least this large between identical
+  /// distributions. 1 when either sample is empty or every value is tied
+  double p_value = 1;
+
+  static MannWhitney test(std::span<const double> a, std::span<const double> b);
+};
+
+/// @brief Hodges-Lehmann estimate of the shift `b - a`, the median of all pairwise
+/// differences, with its distribution-free confidence interval (the one matching the
+/// Mann-Whitney test)
+struct Shift {
+  double estimate = 0;
+  /// @brief nullopt when the samples are too small for the requested confidence
+  std::optional<double> low;
+  std::optional<double> high;
+
+  static Shift estimate_of(std::span<const double> a,
+                           std::span<const double> b,
+                           double confidence);
+};
+
+/// @brief median of an unsorted sample, 0 when empty
+double median(std::span<const double> values);
+
+/// @brief standard normal quantile, e.g. 1.96 for 0.975
+double normal_quantile(double p);
+
+}  // namespace tools
@@ -0,0 +1,463 @@
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "binance/config.h"
+#include "binance/feed_arbiter.h"
+#include "binance/market_message_variant.h"
+#include "binance/top_of_book.h"
+#include "concurrentqueue.h"
+#include "core/bid_ask.h"
+#include "core/order_book.h"
+#include "utils/logging.h"
+#include "utils/threading.h"
+
+/// Dual-depth fusion simulator: a mock acceptor plays the price session's two
+/// subscriptions from one simulated market - the depth-1 stream, a message each time
+/// the top moves, and the deep stream, the levels changed since its previous message
+/// on a fixed cadence. The messages go through @ref binance::FeedArbiter onto the
+/// order queue and a book thread applies them to a @ref core::OrderBook, as in the
+/// app. The same market (same seed) runs deep only, then fused.
+/// Reported per run: how long after the market moved its top the book had it
+/// (latency percentiles), books seen crossed, and whether the book ended the same as
+/// the market.
+///
+/// usage: depth_fusion_sim [--seconds=5] [--event_us=200] [--deep_interval_ms=100]
+///          [--seed=1]
+
+namespace {
+
+constexpr std::string_view THREAD_NAME_ACCEPTOR = "sim_acceptor";
+constexpr std::string_view THREAD_NAME_BOOK = "sim_book";
+constexpr binance::SymbolEnum SYMBOL = binance::SymbolEnum::BTCUSDT;
+constexpr uint64_t MID_PX = 10'000'000;
+/// @brief quarter units, which survive the trip through the messages' doubles exactly
+constexpr uint64_t PX_STEP = 25;
+constexpr uint64_t SZ_STEP = 25'000;
+/// @brief levels a side starts with, and is topped back up to
+constexpr uint64_t MIN_LEVELS = 50;
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::chrono::seconds duration{5};
+  std::chrono::microseconds event_interval{200};
+  std::chrono::milliseconds deep_interval{100};
+  uint64_t seed = 1;
+};
+
+Options parse_options(const int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const auto value =
+        [&arg](const std::string_view flag) -> std::optional<std::string_view> {
+          if (!arg.starts_with(flag)) {
+            return std::nullopt;
+          }
+          return arg.substr(flag.size());
+        };
+    if (const auto v = value("--seconds=")) {
+      options.duration = std::chrono::seconds(std::stoull(std::string(*v)));
+    } else if (const auto v = value("--event_us=")) {
+      options.event_interval = std::chrono::microseconds(std::stoull(std::string(*v)));
+    } else if (const auto v = value("--deep_interval_ms=")) {
+      options.deep_interval = std::chrono::milliseconds(std::stoull(std::string(*v)));
+    } else if (const auto v = value("--seed=")) {
+      options.seed = std::stoull(std::string(*v));
+    } else {
+      throw std::runtime_error(std::format("unexpected argument. arg [{}]", arg));
+    }
+  }
+  if (options.event_interval.count() == 0 || options.deep_interval.count() == 0) {
+    throw std::runtime_error("intervals must be above 0");
+  }
+  return options;
+}
+
+double to_px(const uint64_t ticks) {
+  return static_cast<double>(ticks) /
+         static_cast<double>(binance::Config::get_price_ticks_per_unit(SYMBOL));
+}
+
+double to_sz(const uint64_t ticks) {
+  return static_cast<double>(ticks) /
+         static_cast<double>(binance::Config::get_size_ticks_per_unit(SYMBOL));
+}
+
+/// @brief a book that changes one level per step, with the top moving now and then.
+/// prices and sizes in ticks
+class Market {
+ public:
+  explicit Market(const uint64_t seed) : rng_(seed) {
+    for (uint64_t i = 1; i <= MIN_LEVELS; ++i) {
+      bids_[MID_PX - i * PX_STEP] = random_size();
+      asks_[MID_PX + i * PX_STEP] = random_size();
+    }
+  }
+
+  /// @brief one book update, one update id
+  /// @return whether the top (best prices or sizes) moved
+  bool step() {
+    const auto top = get_top();
+    ++update_id_;
+    const bool is_bid = coin(0.5);
+    const double dice = std::uniform_real_distribution<>(0.0, 1.0)(rng_);
+    if (dice < 0.6) {
+      // resize one of the best ten levels
+      const uint64_t depth = std::uniform_int_distribution<uint64_t>(0, 9)(rng_);
+      if (is_bid) {
+        set_level(true, std::next(bids_.begin(), depth)->first, random_size());
+      } else {
+        set_level(false, std::next(asks_.begin(), depth)->first, random_size());
+      }
+    } else if (dice < 0.75) {
+      // the best level trades away
+      if (is_bid) {
+        set_level(true, bids_.begin()->first, 0);
+      } else {
+        set_level(false, asks_.begin()->first, 0);
+      }
+    } else if (dice < 0.9) {
+      // a level inside the spread, if there is room
+      const uint64_t bid = bids_.begin()->first;
+      const uint64_t ask = asks_.begin()->first;
+      if (ask - bid > PX_STEP) {
+        set_level(is_bid, is_bid ? bid + PX_STEP : ask - PX_STEP, random_size());
+      }
+    } else {
+      const uint64_t offset =
+          std::uniform_int_distribution<uint64_t>(1, 20)(rng_) * PX_STEP;
+      if (is_bid) {
+        set_level(true, bids_.begin()->first - offset, random_size());
+      } else {
+        set_level(false, asks_.begin()->first + offset, random_size());
+      }
+    }
+    refill();
+    return get_top() != top;
+  }
+
+  uint64_t get_update_id() const { return update_id_; }
+
+  /// @brief the levels changed since the previous call, as a deep stream increment
+  /// @return nullopt if none changed
+  std::optional<FIX44::MarketDataIncrementalRefresh> take_deep_increment() {
+    if (pending_.empty()) {
+      return std::nullopt;
+    }
+    FIX44::MarketDataIncrementalRefresh msg;
+    bool is_first = true;
+    for (const auto& [key, sz] : pending_) {
+      const auto& [is_bid, px] = key;
+      FIX44::MarketDataIncrementalRefresh::NoMDEntries group;
+      if (is_first) {
+        group.set(FIX::Symbol(binance::Symbol::to_str(SYMBOL)));
+        group.setField(binance::FeedArbiter::FIRST_BOOK_UPDATE_ID_TAG,
+                       std::to_string(first_pending_id_));
+        group.setField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG,
+                       std::to_string(update_id_));
+        is_first = false;
+      }
+      group.set(FIX::MDUpdateAction(sz == 0 ? FIX::MDUpdateAction_DELETE
+                                            : FIX::MDUpdateAction_CHANGE));
+      group.set(
+          FIX::MDEntryType(is_bid ? FIX::MDEntryType_BID : FIX::MDEntryType_OFFER));
+      group.set(FIX::MDEntryPx(to_px(px)));
+      if (sz != 0) {
+        group.set(FIX::MDEntrySize(to_sz(sz)));
+      }
+      msg.addGroup(group);
+    }
+    pending_.clear();
+    return msg;
+  }
+
+  /// @brief the best bid and offer, as the depth-1 stream sends it
+  FIX44::MarketDataIncrementalRefresh make_top_increment() const {
+    FIX44::MarketDataIncrementalRefresh msg;
+    FIX44::MarketDataIncrementalRefresh::NoMDEntries bid;
+    bid.set(FIX::Symbol(binance::Symbol::to_str(SYMBOL)));
+    bid.setField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG,
+                 std::to_string(update_id_));
+    bid.set(FIX::MDUpdateAction(FIX::MDUpdateAction_NEW));
+    bid.set(FIX::MDEntryType(FIX::MDEntryType_BID));
+    bid.set(FIX::MDEntryPx(to_px(bids_.begin()->first)));
+    bid.set(FIX::MDEntrySize(to_sz(bids_.begin()->second)));
+    msg.addGroup(bid);
+    FIX44::MarketDataIncrementalRefresh::NoMDEntries ask;
+    ask.set(FIX::MDUpdateAction(FIX::MDUpdateAction_NEW));
+    ask.set(FIX::MDEntryType(FIX::MDEntryType_OFFER));
+    ask.set(FIX::MDEntryPx(to_px(asks_.begin()->first)));
+    ask.set(FIX::MDEntrySize(to_sz(asks_.begin()->second)));
+    msg.addGroup(ask);
+    return msg;
+  }
+
+  FIX44::MarketDataSnapshotFullRefresh make_snapshot() const {
+    FIX44::MarketDataSnapshotFullRefresh msg;
+    msg.set(FIX::Symbol(binance::Symbol::to_str(SYMBOL)));
+    msg.setField(binance::FeedArbiter::LAST_BOOK_UPDATE_ID_TAG,
+                 std::to_string(update_id_));
+    const auto add = [&msg](const char type, const uint64_t px, const uint64_t sz) {
+      FIX44::MarketDataSnapshotFullRefresh::NoMDEntries group;
+      group.set(FIX::MDEntryType(type));
+      group.set(FIX::MDEntryPx(to_px(px)));
+      group.set(FIX::MDEntrySize(to_sz(sz)));
+      msg.addGroup(group);
+    };
+    for (const auto& [px, sz] : bids_) {
+      add(FIX::MDEntryType_BID, px, sz);
+    }
+    for (const auto& [px, sz] : asks_) {
+      add(FIX::MDEntryType_OFFER, px, sz);
+    }
+    return msg;
+  }
+
+  /// @brief laid out as `core::OrderBook::to_vector`
+  std::vector<core::BidAsk> to_vector() const {
+    std::vector<core::BidAsk> out;
+    auto bid_it = bids_.begin();
+    auto ask_it = asks_.begin();
+    while (bid_it != bids_.end() || ask_it != asks_.end()) {
+      core::BidAsk row{};
+      if (bid_it != bids_.end()) {
+        row.bid_px = bid_it->first;
+        row.bid_sz = bid_it->second;
+        ++bid_it;
+      }
+      if (ask_it != asks_.end()) {
+        row.ask_px = ask_it->first;
+        row.ask_sz = ask_it->second;
+        ++ask_it;
+      }
+      out.push_back(row);
+    }
+    return out;
+  }
+
+ private:
+  std::mt19937_64 rng_;
+  std::map<uint64_t, uint64_t, std::greater<>> bids_;
+  std::map<uint64_t, uint64_t> asks_;
+  uint64_t update_id_ = 1;
+  /// @brief (is bid, px) -> size changed since the last deep increment, 0 deleted
+  std::map<std::pair<bool, uint64_t>, uint64_t> pending_;
+  uint64_t first_pending_id_ = 0;
+
+  bool coin(const double p) { return std::bernoulli_distribution(p)(rng_); }
+
+  uint64_t random_size() {
+    return std::uniform_int_distribution<uint64_t>(1, 40)(rng_) * SZ_STEP;
+  }
+
+  std::tuple<uint64_t, uint64_t, uint64_t, uint64_t> get_top() const {
+    return {bids_.begin()->first, bids_.begin()->second, asks_.begin()->first,
+            asks_.begin()->second};
+  }
+
+  void set_level(const bool is_bid, const uint64_t px, const uint64_t sz) {
+    if (pending_.empty()) {
+      first_pending_id_ = update_id_;
+    }
+    if (is_bid && sz == 0) {
+      bids_.erase(px);
+    } else if (is_bid) {
+      bids_[px] = sz;
+    } else if (sz == 0) {
+      asks_.erase(px);
+    } else {
+      asks_[px] = sz;
+    }
+    pending_[{is_bid, px}] = sz;
+  }
+
+  /// @brief keep both sides deep enough, below what the touch changes
+  void refill() {
+    while (bids_.size() < MIN_LEVELS) {
+      set_level(true, std::prev(bids_.end())->first - PX_STEP, random_size());
+    }
+    while (asks_.size() < MIN_LEVELS) {
+      set_level(false, std::prev(asks_.end())->first + PX_STEP, random_size());
+    }
+  }
+};
+
+struct Result {
+  uint64_t top_moves = 0;
+  /// @brief market top move to the book having it, microseconds, sorted
+  std::vector<double> latencies_us{};
+  uint64_t crossed = 0;
+  bool is_book_same = false;
+  binance::FeedArbiter::Stats arbiter;
+};
+
+double percentile(const std::vector<double>& sorted, const double p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  const auto i = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+  return sorted[i];
+}
+
+Result run(const Options& options, const bool is_fused) {
+  Market market(options.seed);
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> queue;
+  binance::FeedArbiter arbiter(queue);
+  arbiter.on_session_up(binance::FeedSource::PRIMARY);
+  core::OrderBook book;
+
+  // book thread: (highest update id applied so far, when), in order
+  std::vector<std::pair<uint64_t, Clock::time_point>> applied;
+  uint64_t crossed = 0;
+  std::atomic<bool> is_acceptor_done{false};
+  std::thread book_thread([&] {
+    utils::Threading::set_thread_name(std::string(THREAD_NAME_BOOK));
+    binance::MarketMessageVariant msg;
+    uint64_t max_id = 0;
+    while (true) {
+      if (!queue.try_dequeue(msg)) {
+        if (is_acceptor_done.load(std::memory_order_acquire) &&
+            queue.size_approx() == 0) {
+          break;
+        }
+        std::this_thread::yield();
+        continue;
+      }
+      std::visit(
+          [&book](const auto& m) {
+            using T = std::decay_t<decltype(m)>;
+            if constexpr (std::is_same_v<T, FIX44::MarketDataSnapshotFullRefresh>) {
+              book.apply_snapshot(m);
+            } else if constexpr (std::is_same_v<T, FIX44::MarketDataIncrementalRefresh>) {
+              book.apply_increment(m, false);
+            } else {
+              book.apply_top(m);
+            }
+          },
+          msg);
+      const auto now = Clock::now();
+      const auto ids = std::visit(
+          [](const auto& m) { return binance::FeedArbiter::get_update_ids(m); }, msg);
+      max_id = std::max(max_id, ids ? ids->last : 0);
+      applied.emplace_back(max_id, now);
+      std::array<core::BidAsk, 1> top{};
+      if (book.top_levels(top) == 1 && top[0].bid_px != core::BidAsk::SENTINEL_ &&
+          top[0].ask_px != core::BidAsk::SENTINEL_ && top[0].bid_px >= top[0].ask_px) {
+        ++crossed;
+      }
+    }
+  });
+
+  // acceptor thread: the price session, both subscriptions
+  std::vector<std::pair<uint64_t, Clock::time_point>> top_moves;
+  std::thread acceptor_thread([&] {
+    utils::Threading::set_thread_name(std::string(THREAD_NAME_ACCEPTOR));
+    arbiter.on_snapshot(market.make_snapshot(), binance::FeedSource::PRIMARY);
+    const auto start = Clock::now();
+    const auto end = start + options.duration;
+    auto next_event = start + options.event_interval;
+    auto next_deep = start + options.deep_interval;
+    while (true) {
+      std::this_thread::sleep_until(std::min(next_event, next_deep));
+      const auto now = Clock::now();
+      if (now >= end) {
+        break;
+      }
+      if (now >= next_event) {
+        if (market.step()) {
+          top_moves.emplace_back(market.get_update_id(), now);
+          if (is_fused) {
+            arbiter.on_top(market.make_top_increment(), binance::FeedSource::PRIMARY);
+          }
+        }
+        next_event += options.event_interval;
+      }
+      if (now >= next_deep) {
+        if (auto msg = market.take_deep_increment()) {
+          arbiter.on_increment(*msg, binance::FeedSource::PRIMARY);
+        }
+        next_deep += options.deep_interval;
+      }
+    }
+    // the deep stream's last message, so that the book can end up as the market
+    if (auto msg = market.take_deep_increment()) {
+      arbiter.on_increment(*msg, binance::FeedSource::PRIMARY);
+    }
+    is_acceptor_done.store(true, std::memory_order_release);
+  });
+  acceptor_thread.join();
+  book_thread.join();
+
+  Result result{.top_moves = top_moves.size(),
+                .crossed = crossed,
+                .is_book_same = book.to_vector() == market.to_vector(),
+                .arbiter = arbiter.get_stats()};
+  for (const auto& [id, moved_at] : top_moves) {
+    const auto it = std::ranges::lower_bound(
+        applied, id, {}, &std::pair<uint64_t, Clock::time_point>::first);
+    if (it != applied.end()) {
+      result.latencies_us.push_back(
+          std::chrono::duration<double, std::micro>(it->second - moved_at).count());
+    }
+  }
+  std::ranges::sort(result.latencies_us);
+  return result;
+}
+
+void report(const std::string_view mode, const Result& r) {
+  const uint64_t tops = r.arbiter.top_forwarded + r.arbiter.top_behind;
+  std::cout << std::format(
+      "mode [{}], top moves [{}], latency us p50 [{:.0f}], p90 [{:.0f}], p99 [{:.0f}], "
+      "max [{:.0f}], top led [{}/{}], crossed [{}], book same as market [{}]\n",
+      mode, r.top_moves, percentile(r.latencies_us, 0.5),
+      percentile(r.latencies_us, 0.9), percentile(r.latencies_us, 0.99),
+      r.latencies_us.empty() ? 0.0 : r.latencies_us.back(), r.arbiter.top_forwarded,
+      tops, r.crossed, r.is_book_same);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    setenv("LOG_PATH", "logs/depth_fusion_sim", 0);
+    setenv("LOG_LEVEL", "warn", 0);
+    utils::Logging::configure();
+    const Options options = parse_options(argc, argv);
+    std::cout << std::format(
+        "seconds [{}], event us [{}], deep interval ms [{}], seed [{}]\n",
+        options.duration.count(), options.event_interval.count(),
+        options.deep_interval.count(), options.seed);
+    const Result deep = run(options, false);
+    report("deep only", deep);
+    const Result fused = run(options, true);
+    report("fused", fused);
+    return deep.is_book_same && fused.is_book_same ? 0 : 1;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+}
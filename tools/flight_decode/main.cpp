@@ -0,0 +1,40 @@
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "utils/flight_recorder.h"
+
+/// Prints a flight recorder dump, as written by the crash handler: one line per
+/// thread, then every thread's recent hot-path events merged into one timeline, oldest
+/// first, each with its age relative to the crash (see @ref utils::FlightRecorder).
+///
+/// usage: flight_decode [flight_recorder.bin]
+/// exit: 0 printed, 2 bad usage or input
+
+namespace {
+
+constexpr int EXIT_USAGE = 2;
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    if (argc > 2) {
+      throw std::runtime_error("usage: flight_decode [flight_recorder.bin]");
+    }
+    const std::string path =
+        argc == 2 ? argv[1] : std::string(utils::FlightRecorder::DEFAULT_DUMP_PATH);
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      throw std::runtime_error(std::format("cannot open dump. path [{}]", path));
+    }
+    utils::FlightRecorder::print_dump(utils::FlightRecorder::read_dump(file), std::cout);
+    return 0;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return EXIT_USAGE;
+  }
+}
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/cpu_topology.h"
+#include "utils/jitter_probe.h"
+
+/// Checks on demand that CPUs are quiet, e.g. after `scripts/pin_cpus.sh` and
+/// `scripts/pin_irqs.sh`: spins on each CPU for a while and prints a logfmt line per
+/// CPU with the interruptions seen, by duration (see @ref utils::JitterProbe).
+/// The CPUs default to the isolated ones.
+///
+/// usage: jitter_probe [--cpus=<list>] [--ms=1000] [--threshold_ns=1000]
+///          [--warn_ns=20000]
+/// exit: 0 quiet, 1 a CPU had a gap of `warn_ns` or more, 2 bad usage
+
+namespace {
+
+constexpr int EXIT_NOT_QUIET = 1;
+constexpr int EXIT_USAGE = 2;
+
+struct Options {
+  std::vector<unsigned> cpus;
+  std::chrono::milliseconds duration{1'000};
+  std::chrono::nanoseconds threshold = utils::JitterProbe::DEFAULT_THRESHOLD;
+  std::chrono::nanoseconds warn_gap = utils::JitterProbe::DEFAULT_WARN_GAP;
+};
+
+Options parse_options(const int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const auto value =
+        [&arg](const std::string_view flag) -> std::optional<std::string_view> {
+          if (!arg.starts_with(flag)) {
+            return std::nullopt;
+          }
+          return arg.substr(flag.size());
+        };
+    if (const auto v = value("--cpus=")) {
+      options.cpus = utils::CpuTopology::parse_cpu_list(*v);
+    } else if (const auto v = value("--ms=")) {
+      options.duration = std::chrono::milliseconds(std::stoll(std::string(*v)));
+    } else if (const auto v = value("--threshold_ns=")) {
+      options.threshold = std::chrono::nanoseconds(std::stoll(std::string(*v)));
+    } else if (const auto v = value("--warn_ns=")) {
+      options.warn_gap = std::chrono::nanoseconds(std::stoll(std::string(*v)));
+    } else {
+      throw std::runtime_error(std::format(
+          "unexpected argument. arg [{}]\nusage: jitter_probe [--cpus=<list>] "
+          "[--ms=1000] [--threshold_ns=1000] [--warn_ns=20000]",
+          arg));
+    }
+  }
+  if (options.cpus.empty()) {
+    options.cpus = utils::CpuTopology::from_sysfs().get_isolated();
+  }
+  if (options.cpus.empty()) {
+    throw std::runtime_error("no isolated cpus, pass --cpus=<list>");
+  }
+  return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    const Options options = parse_options(argc, argv);
+    const utils::JitterProbe probe(options.duration, options.threshold,
+                                   options.warn_gap);
+    std::cerr << std::format("probing cpus [{}] for {}ms\n",
+                             utils::CpuTopology::to_cpu_list(options.cpus),
+                             options.duration.count());
+    bool is_all_quiet = true;
+    for (const utils::JitterReport& report : probe.run(options.cpus)) {
+      std::cout << report.format_metrics() << '\n';
+      is_all_quiet = is_all_quiet && probe.is_quiet(report);
+    }
+    return is_all_quiet ? 0 : EXIT_NOT_QUIET;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return EXIT_USAGE;
+  }
+}
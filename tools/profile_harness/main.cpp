@@ -0,0 +1,257 @@
+#include <gperftools/heap-profiler.h>
+#include <gperftools/profiler.h>
+#include <quickfix/DataDictionary.h>
+#include <quickfix/Message.h>
+#include <quickfix/SessionID.h>
+#include <quickfix/fix44/MarketDataIncrementalRefresh.h>
+#include <quickfix/fix44/MarketDataSnapshotFullRefresh.h>
+#include <quickfix/fix44/MessageCracker.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "binance/config.h"
+#include "binance/market_message_variant.h"
+#include "concurrentqueue.h"
+#include "core/bbo_book.h"
+#include "engine/conflator.h"
+#include "engine/engine.h"
+#include "spdlog/spdlog.h"
+#include "utils/logging.h"
+#include "utils/threading.h"
+
+/// Headless profiling harness: replays a fixed number of FIX messages through the
+/// order-book and trade pipelines, the way the app runs them minus the FIX session and
+/// the UI. A "FIX" thread parses, validates and cracks the raw messages onto the order
+/// and trade queues, the @ref engine::Engine workers apply them to the book and build
+/// the bars.
+/// The workload is the recorded-message fixtures of the benchmarks, cycled: the price
+/// stream restarts from its snapshot, as after a reconnect, and one message in five is a
+/// trade. Same input, same work, on any machine, no Binance connection.
+/// `--burst` queues every message before the engine starts, a load above what the book
+/// worker can keep up with, and `--conflate` lets it conflate the backlog
+/// ( @ref engine::Conflator ) from that order queue depth.
+///
+/// usage: profile_harness [--messages=200000] [--fixtures=<dir>]
+///          [--cpu_profile=<file>] [--heap_profile=<prefix>] [--burst]
+///          [--conflate=<depth>]
+
+namespace {
+
+constexpr std::string_view THREAD_NAME_FIX = "harness_fix";
+/// @brief every fifth message is from the trade stream
+constexpr uint64_t TRADE_EVERY = 5;
+
+struct Options {
+  uint64_t messages = 200'000;
+  std::filesystem::path fixtures;
+  std::string cpu_profile;
+  std::string heap_profile;
+  bool burst = false;
+  /// @brief order queue depth to conflate from, 0 for off
+  size_t conflate_depth = 0;
+};
+
+std::filesystem::path repo_root() {
+  return std::filesystem::absolute(__FILE__).parent_path().parent_path().parent_path();
+}
+
+Options parse_options(const int argc, char** argv) {
+  Options options;
+  options.fixtures = repo_root() / "benchmarks" / "fixtures";
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const auto value =
+        [&arg](const std::string_view flag) -> std::optional<std::string_view> {
+          if (!arg.starts_with(flag)) {
+            return std::nullopt;
+          }
+          return arg.substr(flag.size());
+        };
+    if (const auto v = value("--messages=")) {
+      options.messages = std::stoull(std::string(*v));
+    } else if (const auto v = value("--fixtures=")) {
+      options.fixtures = *v;
+    } else if (const auto v = value("--cpu_profile=")) {
+      options.cpu_profile = *v;
+    } else if (const auto v = value("--heap_profile=")) {
+      options.heap_profile = *v;
+    } else if (arg == "--burst") {
+      options.burst = true;
+    } else if (const auto v = value("--conflate=")) {
+      options.conflate_depth = std::stoull(std::string(*v));
+    } else {
+      throw std::runtime_error(std::format("unexpected argument. arg [{}]", arg));
+    }
+  }
+  return options;
+}
+
+/// @brief one FIX message per line, SOH written as '|'
+std::vector<std::string> load_messages(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error(
+        std::format("cannot open fixture. path [{}]", path.string()));
+  }
+  std::vector<std::string> out;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty()) {
+      std::ranges::replace(line, '|', '\x01');
+      out.push_back(std::move(line));
+    }
+  }
+  if (out.empty()) {
+    throw std::runtime_error(std::format("empty fixture. path [{}]", path.string()));
+  }
+  return out;
+}
+
+/// @brief routes cracked messages onto the queues, as `binance::FixApp` does
+class QueueingCracker : public FIX44::MessageCracker {
+ public:
+  using FIX44::MessageCracker::onMessage;
+
+  moodycamel::ConcurrentQueue<binance::MarketMessageVariant> order_queue;
+  moodycamel::ConcurrentQueue<FIX44::MarketDataIncrementalRefresh> trade_queue;
+
+  void onMessage(const FIX44::MarketDataSnapshotFullRefresh& m,
+                 const FIX::SessionID&) override {
+    order_queue.enqueue(binance::MarketMessageVariant{m});
+  }
+  void onMessage(const FIX44::MarketDataIncrementalRefresh& m,
+                 const FIX::SessionID& session_id) override {
+    if (session_id.getSessionQualifier() == "TX") {
+      trade_queue.enqueue(m);
+    } else {
+      order_queue.enqueue(binance::MarketMessageVariant{m});
+    }
+  }
+};
+
+int run(const Options& options) {
+  const FIX::DataDictionary dictionary(
+      (repo_root() / "binance" / "spot-fix-md.xml").string());
+  const auto snapshot = load_messages(options.fixtures / "md_snapshot_5000.fix");
+  const auto increments = load_messages(options.fixtures / "md_increments.fix");
+  const auto trades = load_messages(options.fixtures / "md_trades.fix");
+  const FIX::SessionID px_session{"FIX.4.4", "TRDR2", "SPOT", "PX"};
+  const FIX::SessionID tx_session{"FIX.4.4", "TRDR2", "SPOT", "TX"};
+  spdlog::info("profile harness workload. messages [{}], fixtures [{}], burst [{}], "
+               "conflate [{}]",
+               options.messages, options.fixtures.string(), options.burst,
+               options.conflate_depth);
+
+  QueueingCracker cracker;
+  engine::Engine engine(
+      cracker.order_queue, cracker.trade_queue, binance::Config::MAX_DEPTH,
+      core::BookFor<binance::Config::MAX_DEPTH>{}, nullptr, nullptr, nullptr,
+      options.conflate_depth > 0
+          ? std::make_unique<engine::Conflator>(options.conflate_depth)
+          : nullptr);
+
+  // this thread plays the FIX session: parse, validate, crack, enqueue
+  utils::Threading::set_thread_name(std::string(THREAD_NAME_FIX));
+  uint64_t bytes = 0;
+  uint64_t trade_messages = 0;
+  const auto crack_all = [&] {
+    size_t price_pos = 0;
+    size_t trade_pos = 0;
+    for (uint64_t i = 0; i < options.messages; ++i) {
+      const bool is_trade = i % TRADE_EVERY == TRADE_EVERY - 1;
+      const std::string* raw = nullptr;
+      if (is_trade) {
+        raw = &trades[trade_pos++ % trades.size()];
+      } else {
+        // the price stream: snapshot, then every increment, then again
+        raw = price_pos == 0 ? &snapshot[0] : &increments[price_pos - 1];
+        price_pos = (price_pos + 1) % (increments.size() + 1);
+      }
+      FIX::Message msg(*raw, dictionary, true);
+      dictionary.validate(msg);
+      cracker.crack(msg, is_trade ? tx_session : px_session);
+      bytes += raw->size();
+      trade_messages += is_trade ? 1 : 0;
+    }
+  };
+  // a burst is all queued up front, only the engine's time is measured
+  if (options.burst) {
+    crack_all();
+  }
+
+  if (!options.cpu_profile.empty()) {
+    ProfilerStart(options.cpu_profile.c_str());
+  }
+  if (!options.heap_profile.empty()) {
+    HeapProfilerStart(options.heap_profile.c_str());
+  }
+  const auto start = std::chrono::steady_clock::now();
+
+  engine.start();
+  if (!options.burst) {
+    crack_all();
+  }
+  // wait for the engine to drain both queues
+  const uint64_t book_messages = options.messages - trade_messages;
+  while (true) {
+    const engine::Stats stats = engine.get_stats();
+    if (stats.book_messages >= book_messages && stats.trade_messages >= trade_messages) {
+      break;
+    }
+    if (const std::exception_ptr e = engine.get_exception()) {
+      std::rethrow_exception(e);
+    }
+    std::this_thread::yield();
+  }
+  engine.stop();
+
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (!options.heap_profile.empty()) {
+    HeapProfilerDump("end");
+    HeapProfilerStop();
+  }
+  if (!options.cpu_profile.empty()) {
+    ProfilerStop();
+  }
+
+  const engine::Stats stats = engine.get_stats();
+  std::cout << std::format(
+      "messages [{}], bytes [{}], seconds [{:.3f}], messages/sec [{:.0f}], "
+      "book levels [{}], trades [{}], book publishes [{}], conflated messages [{}], "
+      "conflated updates [{}], conflated levels [{}]\n",
+      options.messages, bytes, seconds, static_cast<double>(options.messages) / seconds,
+      engine.get_book().row_count, engine.get_aggregator().get_totals().trade_count,
+      stats.book_publishes, stats.conflated_messages, stats.conflated_updates,
+      stats.conflated_levels);
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    setenv("LOG_PATH", "logs/profile_harness", 0);
+    setenv("LOG_LEVEL", "warn", 0);
+    utils::Logging::configure();
+    return run(parse_options(argc, argv));
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+}